@@ -23,6 +23,8 @@ class Settings:
     # 服务器配置
     TCP_HOST: str = os.getenv("TCP_HOST") or os.getenv("UDP_HOST", "0.0.0.0")
     TCP_PORT: int = int(os.getenv("TCP_PORT") or os.getenv("UDP_PORT", "8888"))
+    # HK 数据报（UDP）监听端口，与 TCP 端口号可以相同；0 表示不启用
+    HK_UDP_PORT: int = int(os.getenv("HK_UDP_PORT", "8888"))
     SERVER_HOST: str = os.getenv("SERVER_HOST", "0.0.0.0")
     SERVER_PORT: int = int(os.getenv("SERVER_PORT", "8000"))
 
@@ -6,8 +6,9 @@ import os
 import asyncio
 import json
 import base64
-from datetime import datetime
-from typing import List, Optional, Dict, Any, Tuple
+from collections import deque
+from datetime import datetime, timedelta
+from typing import List, Optional, Dict, Any, Set, Tuple
 from sqlalchemy.orm import Session
 from pydantic import BaseModel, Field
 
@@ -26,7 +27,11 @@ from pus import (
     PUS_SERVICE_EVENT_REPORTING,
     PUS_SERVICE_HOUSEKEEPING,
     PUS_SERVICE_TC_VERIFICATION,
+    make_tc_calibrate,
+    make_tc_history,
+    make_tc_sched,
     make_tc_set_rate,
+    make_tc_telemetry,
     make_tc_tm_ack,
     parse_primary_header,
     parse_pus_packet,
@@ -94,6 +99,7 @@ manager = ConnectionManager()
 # TCP服务器配置（从配置文件读取，兼容旧的UDP环境变量）
 TCP_HOST = settings.TCP_HOST
 TCP_PORT = settings.TCP_PORT
+HK_UDP_PORT = settings.HK_UDP_PORT
 
 # ==================== 自适应采样控制 ====================
 # 活跃的TCP连接（硬件设备）
@@ -103,10 +109,19 @@ device_supports_pus: Dict[str, bool] = {}
 # 下行 PUS Telecommand 等待 Verification（Service 1）
 pending_downlink_pus_tcs: Dict[str, Dict[Tuple[int, int], Dict[str, Any]]] = {}
 _downlink_tc_seq: int = 1
+# 后台服务协程（TCP/UDP 监听）；保留引用，防止任务被回收
+_server_tasks: Set["asyncio.Task[None]"] = set()
 
 # 事件下传缓存（地面侧最近事件，便于调试/展示；不入库）
 MAX_EVENTS_PER_DEVICE = 200
 recent_link_events: Dict[str, List[Dict[str, Any]]] = {}
+# 事件去重窗口：设备经主/备两条连接（CIPMUX=1）发出同一份事件字节，
+# 或未收到 TM-ACK 时重传，按 (APID, 序号, 内容) 只记录一次（仍逐条回 ACK）
+EVENT_DEDUP_WINDOW = 64
+recent_event_keys: Dict[str, "deque[Tuple[int, int, bytes]]"] = {}
+# 历史回传（TC 129/4）：按 (sensor, res) 汇总各页记录，以设备 tick 为键（重传页自然合并）
+MAX_HISTORY_POINTS = 5000
+recent_history: Dict[str, Dict[Tuple[str, int], Dict[int, Dict[str, Any]]]] = {}
 # 当前采样率（毫秒）
 current_sampling_rate_ms = 5000
 # 高采样模式的采样率
@@ -200,6 +215,52 @@ def _record_pus_event(peer_id: str, pkt, payload: Any) -> None:
         del bucket[0: max(0, len(bucket) - MAX_EVENTS_PER_DEVICE)]
 
 
+def _record_history_page(peer_id: str, payload: Dict[str, Any]) -> bool:
+    """
+    记录一页历史回传：r 中每条为 [相对 t0 的 ms, min, max, mean]（原始层为 [ms, 值]）。
+    设备没有绝对时间，按“收到时刻 - (now - tick)”估算每条记录的时间。
+    """
+    try:
+        sensor = str(payload["sensor"])
+        res = int(payload["res"])
+        now = int(payload["now"])
+        t0 = int(payload["t0"])
+        rows = list(payload.get("r") or [])
+    except (KeyError, TypeError, ValueError):
+        return False
+
+    received = datetime.now()
+    series = recent_history.setdefault(peer_id, {}).setdefault((sensor, res), {})
+    for row in rows:
+        if not isinstance(row, list) or len(row) not in (2, 4):
+            continue
+        tick = t0 + int(row[0])
+        point: Dict[str, Any] = {
+            "tick": tick,
+            "time": (received - timedelta(milliseconds=now - tick)).strftime("%Y-%m-%d %H:%M:%S"),
+        }
+        if len(row) == 2:
+            point["value"] = row[1]
+        else:
+            point.update({"min": row[1], "max": row[2], "mean": row[3]})
+        series[tick] = point
+
+    if len(series) > MAX_HISTORY_POINTS:
+        for tick in sorted(series)[: len(series) - MAX_HISTORY_POINTS]:
+            del series[tick]
+    return True
+
+
+def _is_duplicate_event(peer_id: str, pkt) -> bool:
+    """最近窗口内是否已收到过同一事件（命中返回 True，否则记入窗口）"""
+    key = (pkt.primary.apid, pkt.primary.seq_count, bytes(pkt.user_data))
+    window = recent_event_keys.setdefault(peer_id, deque(maxlen=EVENT_DEDUP_WINDOW))
+    if key in window:
+        return True
+    window.append(key)
+    return False
+
+
 def _tm_packet_id_and_seq_ctrl(apid: int, seq_flags: int, seq_count: int) -> Tuple[int, int]:
     packet_id = (0 << 13) | (0 << 12) | (1 << 11) | (apid & 0x07FF)
     seq_ctrl = ((seq_flags & 0x3) << 14) | (seq_count & 0x3FFF)
@@ -219,6 +280,40 @@ def _alloc_tc_seq_count() -> int:
     return seq_count
 
 
+async def _send_mission_tc(peer_id: str, pkt: bytes, meta: Dict[str, Any], send_if_connected: bool) -> Dict[str, Any]:
+    """
+    登记待回报的任务 TC，按需经 TCP 直接下发，返回各 `/api/pus/*` 指令接口的统一响应。
+
+    meta 为指令参数（至少含 "cmd"），与验收/完成状态一起记入 pending_downlink_pus_tcs。
+    """
+    primary = parse_primary_header(pkt[:6])
+    tc_pid, tc_sc = _tc_packet_id_and_seq_ctrl(primary.apid, primary.seq_flags, primary.seq_count)
+
+    pending_downlink_pus_tcs.setdefault(peer_id, {})[(tc_pid, tc_sc)] = {
+        "sent_at": _now_str(),
+        **meta,
+        "accepted": False,
+    }
+
+    sent = False
+    if send_if_connected and peer_id in active_tcp_writers and device_supports_pus.get(peer_id):
+        writer = active_tcp_writers[peer_id]
+        try:
+            writer.write(pkt)
+            await writer.drain()
+            sent = True
+        except Exception as e:
+            return {"success": False, "error": f"TCP下发失败: {e}"}
+
+    return {
+        "success": True,
+        "seq": primary.seq_count,
+        "packet_b64": base64.b64encode(pkt).decode("ascii"),
+        "sent": sent,
+        "tc_key": f"{tc_pid:04X}:{tc_sc:04X}",
+    }
+
+
 async def _handle_pus_packet(
     peer_id: str, packet: bytes, writer: Optional[asyncio.StreamWriter]
 ) -> Optional[bytes]:
@@ -265,8 +360,15 @@ async def _handle_pus_packet(
             except Exception:
                 payload = {"raw": pkt.user_data.decode("utf-8", errors="replace")}
 
-            _record_pus_event(peer_id, pkt, payload)
-            print(f"✓(PUS) 收到事件: {peer_id} seq={pkt.primary.seq_count} payload={payload}")
+            if _is_duplicate_event(peer_id, pkt):
+                print(f"✓(PUS) 重复事件（已去重，仍回 ACK）: {peer_id} seq={pkt.primary.seq_count}")
+            elif isinstance(payload, dict) and payload.get("kind") == "history":
+                _record_history_page(peer_id, payload)
+                print(f"✓(PUS) 历史回传: {peer_id} sensor={payload.get('sensor')} res={payload.get('res')} "
+                      f"seq={payload.get('seq')} last={payload.get('last')}")
+            else:
+                _record_pus_event(peer_id, pkt, payload)
+                print(f"✓(PUS) 收到事件: {peer_id} seq={pkt.primary.seq_count} payload={payload}")
 
             # 事件可靠下传：收到事件后回 TM-ACK（任务自定义服务 129/2）
             seq_count = _alloc_tc_seq_count()
@@ -388,11 +490,10 @@ async def handle_tcp_client(reader: asyncio.StreamReader, writer: asyncio.Stream
     except asyncio.CancelledError:
         pass
     finally:
-        # 清理连接引用
-        if peer_ip in active_tcp_writers:
+        # 清理连接引用（同一设备可能同时有主/备两条连接，只清理属于本连接的）
+        if active_tcp_writers.get(peer_ip) is writer:
             del active_tcp_writers[peer_ip]
-        if peer_ip in last_decision_state:
-            del last_decision_state[peer_ip]
+            last_decision_state.pop(peer_ip, None)
         writer.close()
         await writer.wait_closed()
         print(f"✗ TCP客户端断开: {peer_ip}")
@@ -406,6 +507,63 @@ async def tcp_server():
         await server.serve_forever()
 
 
+# UDP 数据报排队后由 udp_server() 单个协程顺序处理：与 TCP 每连接顺序处理一致，
+# 避免同一设备的多个数据报在 _process_sensor_sample 内交错（重复下发 set_rate、入库乱序）
+UDP_RX_QUEUE_MAX = 1024
+
+
+class PusDatagramProtocol(asyncio.DatagramProtocol):
+    """UDP 接收：每个数据报是一个完整的 PUS 包（设备把 HK 改走 UDP 时使用）"""
+
+    def __init__(self, queue: "asyncio.Queue[Tuple[bytes, Tuple[str, int]]]") -> None:
+        self.queue = queue
+        self.dropped = 0
+
+    def connection_made(self, transport: asyncio.BaseTransport) -> None:
+        self.transport = transport
+
+    def datagram_received(self, data: bytes, addr: Tuple[str, int]) -> None:
+        try:
+            self.queue.put_nowait((data, addr))
+        except asyncio.QueueFull:
+            # UDP 本就可丢；积压时丢新包，不让队列无限增长
+            self.dropped += 1
+            if self.dropped % 100 == 1:
+                print(f"⚠ UDP接收队列已满，已丢弃 {self.dropped} 个数据报")
+
+    async def handle(self, data: bytes, addr: Tuple[str, int]) -> None:
+        # peer_id 与 TCP 一致（设备 IP），同一设备的 HK 与事件归到一起
+        if len(data) < 13 or not looks_like_primary_header(data[:6]):
+            return
+        try:
+            if parse_primary_header(data[:6]).total_len != len(data):
+                return
+        except Exception:
+            return
+        reply = await _handle_pus_packet(addr[0], data, writer=None)
+        if reply:
+            self.transport.sendto(reply, addr)
+
+
+async def udp_server():
+    """UDP服务器，接收走数据报的 PUS 包（HK）；本协程即唯一的消费者"""
+    loop = asyncio.get_running_loop()
+    queue: "asyncio.Queue[Tuple[bytes, Tuple[str, int]]]" = asyncio.Queue(maxsize=UDP_RX_QUEUE_MAX)
+    transport, protocol = await loop.create_datagram_endpoint(
+        lambda: PusDatagramProtocol(queue), local_addr=(TCP_HOST, HK_UDP_PORT)
+    )
+    print(f"✓ UDP服务器启动在 {TCP_HOST}:{HK_UDP_PORT}")
+    try:
+        while True:
+            data, addr = await queue.get()
+            try:
+                await protocol.handle(data, addr)
+            except Exception as e:
+                print(f"⚠ UDP数据报处理失败 {addr[0]}: {e}")
+    finally:
+        transport.close()
+
+
 class PusIngestIn(BaseModel):
     peer_id: str = Field(..., min_length=1, description="设备标识，例如 192.168.1.10 或 lora:dev1")
     packet_b64: str = Field(..., min_length=1, description="原始 PUS 包（二进制）base64 编码")
@@ -447,33 +605,141 @@ async def pus_set_rate(body: PusSetRateIn):
     """
     seq_count = _alloc_tc_seq_count()
     pkt = make_tc_set_rate(rate_ms=int(body.rate_ms), apid=DEFAULT_APID, seq_count=seq_count)
-    primary = parse_primary_header(pkt[:6])
-    tc_pid, tc_sc = _tc_packet_id_and_seq_ctrl(primary.apid, primary.seq_flags, primary.seq_count)
-
-    pending_downlink_pus_tcs.setdefault(body.peer_id, {})[(tc_pid, tc_sc)] = {
-        "sent_at": _now_str(),
+    meta = {
         "cmd": "set_rate",
         "rate_ms": int(body.rate_ms),
-        "accepted": False,
     }
+    return await _send_mission_tc(body.peer_id, pkt, meta, body.send_if_connected)
 
-    sent = False
-    if body.send_if_connected and body.peer_id in active_tcp_writers and device_supports_pus.get(body.peer_id):
-        writer = active_tcp_writers[body.peer_id]
-        try:
-            writer.write(pkt)
-            await writer.drain()
-            sent = True
-        except Exception as e:
-            return {"success": False, "error": f"TCP下发失败: {e}"}
 
-    return {
-        "success": True,
-        "seq": seq_count,
-        "packet_b64": base64.b64encode(pkt).decode("ascii"),
-        "sent": sent,
-        "tc_key": f"{tc_pid:04X}:{tc_sc:04X}",
+class PusCalibrateIn(BaseModel):
+    peer_id: str = Field(..., min_length=1, description="目标设备标识（TCP设备用IP；LoRa可用自定义ID）")
+    send_if_connected: bool = Field(default=True, description="若目标为TCP直连设备，是否直接下发（默认True）")
+
+
+@app.post("/api/pus/calibrate")
+async def pus_calibrate(body: PusCalibrateIn):
+    """
+    生成/下发 PUS Telecommand（任务自定义服务 129/3）：在清洁空气中重新校准 MQ-3 的 R0。
+
+    设备后台累积样本，不阻塞遥测；Completion 表示校准已启动，
+    结果随后以 `{"kind":"calibration",...}` 事件上报（见 `/api/pus/events`）。
+    """
+    seq_count = _alloc_tc_seq_count()
+    pkt = make_tc_calibrate(apid=DEFAULT_APID, seq_count=seq_count)
+    meta = {
+        "cmd": "calibrate",
+    }
+    return await _send_mission_tc(body.peer_id, pkt, meta, body.send_if_connected)
+
+
+class PusHistoryIn(BaseModel):
+    peer_id: str = Field(..., min_length=1, description="目标设备标识（TCP设备用IP；LoRa可用自定义ID）")
+    sensor: str = Field(default="mq3", min_length=1, max_length=15, description="传感器（HK 字段前缀，如 mq3）")
+    res: int = Field(default=10, description="分辨率（秒）：0 为原始样本，或 1 / 10 / 60")
+    from_s: int = Field(default=600, ge=0, description="起点：距现在多少秒")
+    to_s: int = Field(default=0, ge=0, description="终点：距现在多少秒")
+    send_if_connected: bool = Field(default=True, description="若目标为TCP直连设备，是否直接下发（默认True）")
+
+
+@app.post("/api/pus/history")
+async def pus_history(body: PusHistoryIn):
+    """
+    生成/下发 PUS Telecommand（任务自定义服务 129/4）：取回板上历史。
+
+    设备按页回传 `{"kind":"history",...}` 事件（要求 TM-ACK），汇总结果见 `GET /api/pus/history`。
+    板上保留：原始样本约 1 分钟、1 s 聚合 4 分钟、10 s 聚合 1 小时、60 s 聚合 12 小时。
+    """
+    if body.res not in (0, 1, 10, 60):
+        return {"success": False, "error": "res 只支持 0 / 1 / 10 / 60"}
+    if body.from_s < body.to_s:
+        return {"success": False, "error": "from_s 需不小于 to_s"}
+
+    seq_count = _alloc_tc_seq_count()
+    pkt = make_tc_history(
+        sensor=body.sensor, res_s=body.res, from_s=body.from_s, to_s=body.to_s,
+        apid=DEFAULT_APID, seq_count=seq_count,
+    )
+    meta = {
+        "cmd": "history",
+        "sensor": body.sensor,
+        "res": body.res,
+    }
+    return await _send_mission_tc(body.peer_id, pkt, meta, body.send_if_connected)
+
+
+@app.get("/api/pus/history")
+async def get_pus_history(
+    peer_id: str = Query(..., min_length=1, description="设备标识"),
+    sensor: str = Query(default="mq3", description="传感器（HK 字段前缀）"),
+    res: int = Query(default=10, description="分辨率（秒）：0 / 1 / 10 / 60"),
+):
+    """已收到的历史回传记录（按设备 tick 排序，内存缓存）"""
+    series = recent_history.get(peer_id, {}).get((sensor, res), {})
+    data = [series[tick] for tick in sorted(series)]
+    return {"success": True, "count": len(data), "data": data}
+
+
+class PusTelemetryIn(BaseModel):
+    peer_id: str = Field(..., min_length=1, description="目标设备标识（TCP设备用IP；LoRa可用自定义ID）")
+    mode: Optional[str] = Field(default=None, description="gated：平静期只发心跳；full：每轮都发 HK")
+    heartbeat_s: Optional[int] = Field(default=None, ge=1, le=3600, description="平静期心跳间隔（秒）")
+    z: Optional[int] = Field(default=None, ge=1, le=50, description="板上异常检测阈值（z 分数）")
+    db: Optional[str] = Field(default=None, max_length=23, description="要修改死区的 HK 字段，如 alcohol_ppm / mq3_adc / voltage")
+    db_abs: float = Field(default=0.0, ge=0, description="绝对死区（字段单位），0 表示不启用")
+    db_rel: float = Field(default=0.0, ge=0, description="相对死区（比例，0.05 = 5%），0 表示不启用")
+    send_if_connected: bool = Field(default=True, description="若目标为TCP直连设备，是否直接下发（默认True）")
+
+
+@app.post("/api/pus/telemetry")
+async def pus_telemetry(body: PusTelemetryIn):
+    """
+    生成/下发 PUS Telecommand（任务自定义服务 129/5）：设置 HK 下传粒度。
+
+    gated 模式下设备只在异常/告警期间逐轮下传 HK；平静期某个字段越出死区
+    （与上次下传值相差超过 max(db_abs, db_rel·|上次值|)）时下传，否则最长静默 heartbeat_s 秒发一个心跳
+    （带 `tx` 决定原因、省略轮数 `supp` 与期间浓度摘要 `<ppm_key>_rng`）。未给出的字段保持不变；
+    设备处理后回报 `{"kind":"telemetry",...}` 事件（含累计下传/省略计数 `n_tx` / `n_supp`）。
+    """
+    if body.mode is not None and body.mode not in ("gated", "full"):
+        return {"success": False, "error": "mode 只支持 gated / full"}
+
+    seq_count = _alloc_tc_seq_count()
+    pkt = make_tc_telemetry(
+        mode=body.mode, heartbeat_s=body.heartbeat_s, z=body.z,
+        apid=DEFAULT_APID, seq_count=seq_count,
+        db=body.db, db_abs=body.db_abs, db_rel=body.db_rel,
+    )
+    meta = {
+        "cmd": "telemetry",
+        "mode": body.mode,
+        "heartbeat_s": body.heartbeat_s,
+        "z": body.z,
+        "db": body.db,
+    }
+    return await _send_mission_tc(body.peer_id, pkt, meta, body.send_if_connected)
+
+
+class PusSchedIn(BaseModel):
+    peer_id: str = Field(..., min_length=1, description="目标设备标识（TCP设备用IP；LoRa可用自定义ID）")
+    reset: bool = Field(default=False, description="回报后清零设备端统计")
+    send_if_connected: bool = Field(default=True, description="若目标为TCP直连设备，是否直接下发（默认True）")
+
+
+@app.post("/api/pus/sched")
+async def pus_sched(body: PusSchedIn):
+    """
+    生成/下发 PUS Telecommand（任务自定义服务 129/6）：查询星上调度任务的运行统计。
+
+    设备回报 `{"kind":"sched","up":..,"load":..,"tasks":{"rx":[runs,avg_us,max_us,late_ms,miss],...}}` 事件。
+    """
+    seq_count = _alloc_tc_seq_count()
+    pkt = make_tc_sched(reset=body.reset, apid=DEFAULT_APID, seq_count=seq_count)
+    meta = {
+        "cmd": "sched",
+        "reset": body.reset,
     }
+    return await _send_mission_tc(body.peer_id, pkt, meta, body.send_if_connected)
 
 
 @app.get("/api/pus/events")
@@ -512,11 +778,15 @@ async def startup_event():
           f"scenario_model={ml_status.get('scenario', {}).get('model', {}).get('enabled')}, "
           f"anomaly_model={ml_status.get('anomaly', {}).get('model', {}).get('enabled')}")
     
-    # 启动TCP服务器
-    asyncio.create_task(tcp_server())
+    # 启动TCP服务器（以及 HK 用的 UDP 监听）
+    _server_tasks.add(asyncio.create_task(tcp_server()))
+    if HK_UDP_PORT > 0:
+        _server_tasks.add(asyncio.create_task(udp_server()))
     
     print(f"✓ HTTP服务: http://127.0.0.1:{settings.SERVER_PORT}")
     print(f"✓ TCP服务: {TCP_HOST}:{TCP_PORT}")
+    if HK_UDP_PORT > 0:
+        print(f"✓ UDP服务(HK): {TCP_HOST}:{HK_UDP_PORT}")
     print(f"✓ WebSocket: ws://127.0.0.1:{settings.SERVER_PORT}/ws")
     print("========================================")
 
@@ -39,6 +39,10 @@ PUS_SERVICE_EVENT_REPORTING = 5
 PUS_SERVICE_MISSION = 129
 MISSION_SUBTYPE_SET_RATE = 1
 MISSION_SUBTYPE_TM_ACK = 2
+MISSION_SUBTYPE_CALIBRATE = 3
+MISSION_SUBTYPE_HISTORY = 4
+MISSION_SUBTYPE_TELEMETRY = 5
+MISSION_SUBTYPE_SCHED = 6
 
 # Service 3: Housekeeping
 PUS3_HK_REPORT = 25
@@ -314,6 +318,72 @@ def make_tc_set_rate(*, rate_ms: int, apid: int, seq_count: int) -> bytes:
     )
 
 
+def make_tc_calibrate(*, apid: int, seq_count: int) -> bytes:
+    payload = b"{\"cmd\":\"calibrate\"}"
+    return build_tc(
+        apid=apid,
+        seq_count=seq_count,
+        service_type=PUS_SERVICE_MISSION,
+        service_subtype=MISSION_SUBTYPE_CALIBRATE,
+        user_data=payload,
+    )
+
+
+def make_tc_history(*, sensor: str, res_s: int, from_s: int, to_s: int, apid: int, seq_count: int) -> bytes:
+    payload = (
+        "{\"cmd\":\"history\",\"sensor\":\"%s\",\"res\":%d,\"from_s\":%d,\"to_s\":%d}"
+        % (sensor, int(res_s), int(from_s), int(to_s))
+    ).encode("utf-8")
+    return build_tc(
+        apid=apid,
+        seq_count=seq_count,
+        service_type=PUS_SERVICE_MISSION,
+        service_subtype=MISSION_SUBTYPE_HISTORY,
+        user_data=payload,
+    )
+
+
+def make_tc_telemetry(
+    *,
+    mode: Optional[str],
+    heartbeat_s: Optional[int],
+    z: Optional[int],
+    apid: int,
+    seq_count: int,
+    db: Optional[str] = None,
+    db_abs: float = 0.0,
+    db_rel: float = 0.0,
+) -> bytes:
+    fields = ["\"cmd\":\"telemetry\""]
+    if mode is not None:
+        fields.append("\"mode\":\"%s\"" % mode)
+    if heartbeat_s is not None:
+        fields.append("\"heartbeat_s\":%d" % int(heartbeat_s))
+    if z is not None:
+        fields.append("\"z\":%d" % int(z))
+    if db is not None:
+        fields.append("\"db\":\"%s\",\"abs\":%g,\"rel\":%g" % (db, float(db_abs), float(db_rel)))
+    payload = ("{" + ",".join(fields) + "}").encode("utf-8")
+    return build_tc(
+        apid=apid,
+        seq_count=seq_count,
+        service_type=PUS_SERVICE_MISSION,
+        service_subtype=MISSION_SUBTYPE_TELEMETRY,
+        user_data=payload,
+    )
+
+
+def make_tc_sched(*, reset: bool, apid: int, seq_count: int) -> bytes:
+    payload = ("{\"cmd\":\"sched\",\"reset\":%d}" % (1 if reset else 0)).encode("utf-8")
+    return build_tc(
+        apid=apid,
+        seq_count=seq_count,
+        service_type=PUS_SERVICE_MISSION,
+        service_subtype=MISSION_SUBTYPE_SCHED,
+        user_data=payload,
+    )
+
+
 def make_tc_tm_ack(*, tm_packet_id: int, tm_seq_ctrl: int, apid: int, seq_count: int) -> bytes:
     user_data = _p16(tm_packet_id) + _p16(tm_seq_ctrl)
     return build_tc(
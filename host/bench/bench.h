@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file           : bench.h
+ * @brief          : 主机端基准测试公共定义
+ ******************************************************************************
+ * @description    : host_bench 程序由若干子基准组成，通过第一个命令行参数选择：
+ *                     host_bench <name> [options...]
+ *                   每个子基准在 bench_main.c 的注册表中登记一行。
+ ******************************************************************************
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include <stdint.h>
+
+typedef int (*bench_fn_t)(int argc, char** argv);
+
+typedef struct {
+    const char* name;
+    const char* summary;
+    bench_fn_t run;
+} bench_entry_t;
+
+/* 子基准 */
+int Bench_Dsp(int argc, char** argv);
+int Bench_Esp8266(int argc, char** argv);
+int Bench_Fleet(int argc, char** argv);
+int Bench_Ground(int argc, char** argv);
+int Bench_PpmLut(int argc, char** argv);
+int Bench_TinyMl(int argc, char** argv);
+int Bench_TmWriter(int argc, char** argv);
+
+/* 工具函数 */
+uint64_t Bench_NowNs(void);
+const char* Bench_ArgStr(int argc, char** argv, const char* key, const char* def);
+long Bench_ArgInt(int argc, char** argv, const char* key, long def);
+
+/* 延迟样本统计（毫秒） */
+typedef struct {
+    uint32_t* samples;
+    uint32_t capacity;
+    uint32_t count;
+} bench_stats_t;
+
+void Bench_StatsAdd(bench_stats_t* st, uint32_t value);
+void Bench_StatsReset(bench_stats_t* st);                         /* 清空样本，缓冲区复用（按窗口统计） */
+uint32_t Bench_StatsPercentile(bench_stats_t* st, uint32_t pct); /* 就地排序；无样本返回 0 */
+void Bench_StatsPrint(const char* label, bench_stats_t* st, const char* unit);
+
+#endif /* __BENCH_H */
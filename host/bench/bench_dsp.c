@@ -0,0 +1,280 @@
+/**
+ ******************************************************************************
+ * @file           : bench_dsp.c
+ * @brief          : 定点 DSP 小核（dsp.c）各实现逐位校验与吞吐基准
+ ******************************************************************************
+ * @description    : 对 Dsp_Implementations 列出的每个实现，以 [0]（可移植 C）为参考：
+ *                   - 随机数据，长度 0..96 及若干长块，起始地址错开 0..3 个元素
+ *                     （覆盖 SIMD 主循环的尾部与非对齐加载）；
+ *                   - 极值：q7 全 -128、q15 全 -32768（pmaddwd 两两和回绕的唯一情形）、
+ *                     u16 全 0 / 全 0xFFFF；
+ *                   任何不一致都返回非 0。FIR 另对照逐抽头 int64 参考，双二阶对照
+ *                   整块一次滤波（校验分块调用时的状态衔接）。随后给出各实现的吞吐。
+ *
+ *                   x86-64 默认只有 SSE2；编译 host_bench 时加 -mavx2 才会出现 avx2 实现。
+ *
+ *                   用法：
+ *                     host_bench dsp
+ *                     host_bench dsp --len 4096 --rounds 20000
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "dsp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DSP_BENCH_MAX_LEN   8192
+#define DSP_BENCH_FIR_TAPS  31
+
+static uint32_t g_rng = 0x2545F491u;
+
+static uint32_t rnd(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static int8_t s_a8[DSP_BENCH_MAX_LEN + 4];
+static int8_t s_b8[DSP_BENCH_MAX_LEN + 4];
+static int16_t s_a16[DSP_BENCH_MAX_LEN + 4];
+static int16_t s_b16[DSP_BENCH_MAX_LEN + 4];
+static uint16_t s_u16[DSP_BENCH_MAX_LEN + 4];
+
+static void fill_random(void) {
+    for (uint32_t i = 0; i < DSP_BENCH_MAX_LEN + 4; i++) {
+        s_a8[i] = (int8_t)rnd();
+        s_b8[i] = (int8_t)rnd();
+        s_a16[i] = (int16_t)rnd();
+        s_b16[i] = (int16_t)rnd();
+        s_u16[i] = (uint16_t)rnd();
+    }
+}
+
+/* 以 ref 为参考校验 impl 在 (长度, 偏移) 上的三个核，返回不一致数 */
+static uint32_t check_one(const DspImpl_t* ref, const DspImpl_t* impl, uint32_t n, uint32_t off) {
+    uint32_t bad = 0;
+
+    int32_t r7 = ref->dot_q7(s_a8 + off, s_b8 + off, n);
+    int32_t i7 = impl->dot_q7(s_a8 + off, s_b8 + off, n);
+    if (r7 != i7) {
+        if (bad++ == 0) {
+            fprintf(stderr, "    %s dot_q7 n=%lu off=%lu：%ld/%ld（实际/期望）\n", impl->name,
+                    (unsigned long)n, (unsigned long)off, (long)i7, (long)r7);
+        }
+    }
+    int64_t r15 = ref->dot_q15(s_a16 + off, s_b16 + off, n);
+    int64_t i15 = impl->dot_q15(s_a16 + off, s_b16 + off, n);
+    if (r15 != i15) {
+        if (bad++ == 0) {
+            fprintf(stderr, "    %s dot_q15 n=%lu off=%lu：%lld/%lld（实际/期望）\n", impl->name,
+                    (unsigned long)n, (unsigned long)off, (long long)i15, (long long)r15);
+        }
+    }
+    DspStatsU16_t rs;
+    DspStatsU16_t is;
+    ref->stats_u16(s_u16 + off, n, &rs);
+    impl->stats_u16(s_u16 + off, n, &is);
+    if (rs.sum != is.sum || rs.min != is.min || rs.max != is.max) {
+        if (bad++ == 0) {
+            fprintf(stderr, "    %s stats_u16 n=%lu off=%lu：%lu/%u/%u（实际）%lu/%u/%u（期望）\n", impl->name,
+                    (unsigned long)n, (unsigned long)off, (unsigned long)is.sum, is.min, is.max,
+                    (unsigned long)rs.sum, rs.min, rs.max);
+        }
+    }
+    return bad;
+}
+
+static uint32_t check_impl(const DspImpl_t* ref, const DspImpl_t* impl) {
+    static const uint32_t k_long[] = {255, 256, 257, 1000, 4097, DSP_BENCH_MAX_LEN};
+    uint32_t bad = 0;
+    uint32_t cases = 0;
+
+    for (uint32_t round = 0; round < 8; round++) {
+        fill_random();
+        for (uint32_t n = 0; n <= 96; n++) {
+            for (uint32_t off = 0; off < 4; off++) {
+                bad += check_one(ref, impl, n, off);
+                cases++;
+            }
+        }
+        for (uint32_t k = 0; k < sizeof(k_long) / sizeof(k_long[0]); k++) {
+            bad += check_one(ref, impl, k_long[k], round & 3u);
+            cases++;
+        }
+    }
+
+    /* 极值 */
+    memset(s_a8, 0x80, sizeof(s_a8));
+    memset(s_b8, 0x80, sizeof(s_b8));
+    for (uint32_t i = 0; i < DSP_BENCH_MAX_LEN + 4; i++) {
+        s_a16[i] = -32768;
+        s_b16[i] = -32768;
+        s_u16[i] = 0xFFFF;
+    }
+    for (uint32_t n = 0; n <= 64; n++) {
+        bad += check_one(ref, impl, n, n & 3u);
+        cases++;
+    }
+    bad += check_one(ref, impl, DSP_BENCH_MAX_LEN, 0);
+    memset(s_u16, 0, sizeof(s_u16));
+    for (uint32_t n = 0; n <= 64; n++) {
+        bad += check_one(ref, impl, n, n & 3u);
+        cases++;
+    }
+
+    fprintf(stderr, "  %-10s 逐位校验：%lu/%lu 组一致\n", impl->name,
+            (unsigned long)(cases - bad), (unsigned long)cases);
+    return bad;
+}
+
+static double mega_per_s(uint64_t items, uint64_t ns) {
+    return ns ? (double)items * 1000.0 / (double)ns : 0.0;
+}
+
+static void bench_impl(const DspImpl_t* impl, uint32_t len, uint32_t rounds, const double* base, double* out) {
+    volatile int64_t sink = 0;
+    uint64_t items = (uint64_t)len * rounds;
+    DspStatsU16_t st;
+
+    uint64_t t0 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        sink += impl->dot_q7(s_a8 + (r & 3u), s_b8, len);
+    }
+    uint64_t t1 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        sink += impl->dot_q15(s_a16 + (r & 3u), s_b16, len);
+    }
+    uint64_t t2 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        impl->stats_u16(s_u16 + (r & 3u), len, &st);
+        sink += st.sum;
+    }
+    uint64_t t3 = Bench_NowNs();
+    (void)sink;
+
+    out[0] = mega_per_s(items, t1 - t0);
+    out[1] = mega_per_s(items, t2 - t1);
+    out[2] = mega_per_s(items, t3 - t2);
+    fprintf(stderr, "  %-10s %10.0f %6.1fx %10.0f %6.1fx %10.0f %6.1fx\n", impl->name,
+            out[0], base ? out[0] / base[0] : 1.0,
+            out[1], base ? out[1] / base[1] : 1.0,
+            out[2], base ? out[2] / base[2] : 1.0);
+}
+
+/* FIR：对照逐抽头参考，并测吞吐 */
+static uint32_t bench_fir(uint32_t len, uint32_t rounds) {
+    static int16_t x[DSP_BENCH_MAX_LEN + DSP_BENCH_FIR_TAPS];
+    static int16_t y[DSP_BENCH_MAX_LEN];
+    int16_t coeff[DSP_BENCH_FIR_TAPS];
+    const uint8_t shift = 15;
+    uint32_t bad = 0;
+
+    /* 汉宁窗低通，系数和约 2^15 */
+    for (uint32_t k = 0; k < DSP_BENCH_FIR_TAPS; k++) {
+        uint32_t tri = (k < DSP_BENCH_FIR_TAPS / 2) ? k + 1 : DSP_BENCH_FIR_TAPS - k;
+        coeff[k] = (int16_t)(tri * 32768u / ((DSP_BENCH_FIR_TAPS / 2 + 1) * (DSP_BENCH_FIR_TAPS / 2 + 1)));
+    }
+    coeff[0] = -32768;   // 覆盖最负系数
+    for (uint32_t i = 0; i < len + DSP_BENCH_FIR_TAPS - 1; i++) {
+        x[i] = (int16_t)rnd();
+    }
+    Dsp_FirQ15(coeff, DSP_BENCH_FIR_TAPS, shift, x, y, len);
+    for (uint32_t i = 0; i < len; i++) {
+        int64_t acc = 0;
+        for (uint32_t k = 0; k < DSP_BENCH_FIR_TAPS; k++) {
+            acc += (int64_t)coeff[k] * x[i + k];
+        }
+        acc = (acc + (1 << (shift - 1))) >> shift;
+        acc = (acc < -32768) ? -32768 : (acc > 32767) ? 32767 : acc;
+        if (acc != y[i] && bad++ == 0) {
+            fprintf(stderr, "    FIR y[%lu] = %d，期望 %lld\n", (unsigned long)i, y[i], (long long)acc);
+        }
+    }
+
+    uint64_t t0 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        Dsp_FirQ15(coeff, DSP_BENCH_FIR_TAPS, shift, x, y, len);
+    }
+    uint64_t ns = Bench_NowNs() - t0;
+    fprintf(stderr, "  FIR %u 抽头：逐位校验 %s，%.1f M 样本/s\n", DSP_BENCH_FIR_TAPS,
+            bad ? "失败" : "一致", mega_per_s((uint64_t)len * rounds, ns));
+    return bad;
+}
+
+/* 双二阶：分块调用与整块一次滤波结果必须一致；测吞吐 */
+static uint32_t bench_biquad(uint32_t len, uint32_t rounds) {
+    static int16_t x[DSP_BENCH_MAX_LEN];
+    static int16_t y_whole[DSP_BENCH_MAX_LEN];
+    static int16_t y_parts[DSP_BENCH_MAX_LEN];
+    /* 二阶巴特沃斯低通，fc = fs/20（Q14） */
+    const DspBiquadQ14_t proto = {328, 656, 328, -26956, 11885, 0, 0, 0, 0};
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        x[i] = (int16_t)((i & 64u) ? 20000 : -20000) + (int16_t)(rnd() & 0x3FF);
+    }
+    DspBiquadQ14_t f = proto;
+    Dsp_BiquadQ14(&f, x, y_whole, len);
+    f = proto;
+    for (uint32_t i = 0; i < len;) {
+        uint32_t n = 1 + rnd() % 37;
+        n = (n > len - i) ? len - i : n;
+        Dsp_BiquadQ14(&f, x + i, y_parts, n);
+        if (memcmp(y_parts, y_whole + i, n * sizeof(int16_t)) != 0) {
+            bad++;
+        }
+        i += n;
+    }
+
+    f = proto;
+    uint64_t t0 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        Dsp_BiquadQ14(&f, x, y_whole, len);
+    }
+    uint64_t ns = Bench_NowNs() - t0;
+    fprintf(stderr, "  双二阶：分块衔接 %s，%.1f M 样本/s\n", bad ? "失败" : "一致",
+            mega_per_s((uint64_t)len * rounds, ns));
+    return bad;
+}
+
+int Bench_Dsp(int argc, char** argv) {
+    uint32_t len = (uint32_t)Bench_ArgInt(argc, argv, "--len", 1024);
+    uint32_t rounds = (uint32_t)Bench_ArgInt(argc, argv, "--rounds", 20000);
+    uint8_t count = 0;
+    const DspImpl_t* impls = Dsp_Implementations(&count);
+    uint32_t bad = 0;
+
+    if (len == 0 || len > DSP_BENCH_MAX_LEN) {
+        fprintf(stderr, "--len 需在 1..%u\n", DSP_BENCH_MAX_LEN);
+        return 2;
+    }
+
+    fprintf(stderr, "\n===== dsp（%u 种实现，Dsp_* 使用 %s） =====\n", count, impls[count - 1].name);
+    for (uint8_t i = 1; i < count; i++) {
+        bad += check_impl(&impls[0], &impls[i]);
+    }
+    if (count == 1) {
+        fprintf(stderr, "  仅可移植 C 实现，无需交叉校验\n");
+    }
+
+    fill_random();
+    double base[3];
+    double cur[3];
+    fprintf(stderr, "\n  吞吐（M 元素/s，块长 %lu，%lu 轮）\n", (unsigned long)len, (unsigned long)rounds);
+    fprintf(stderr, "  %-10s %10s %7s %10s %7s %10s %7s\n", "实现", "dot_q7", "", "dot_q15", "", "stats_u16", "");
+    bench_impl(&impls[0], len, rounds, NULL, base);
+    for (uint8_t i = 1; i < count; i++) {
+        bench_impl(&impls[i], len, rounds, base, cur);
+    }
+
+    fprintf(stderr, "\n");
+    bad += bench_fir(len, rounds / 16 + 1);
+    bad += bench_biquad(len, rounds / 4 + 1);
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+/**
+ ******************************************************************************
+ * @file           : bench_esp8266.c
+ * @brief          : ESP8266 驱动 + PUS 链路端到端基准
+ ******************************************************************************
+ * @description    : 在 PC 上运行真实的 esp8266_driver.c / pus_link.c，
+ *                   USART2 经主机 HAL 垫片连到 tools/esp8266_emu.py，
+ *                   模拟器再桥接到 backend/main.py 的 TCP 服务器。
+ *
+ *                   测量项：
+ *                   - 上电到 AT/WiFi/TCP 就绪的耗时
+ *                   - 每次 ESP8266_SendTCP 的耗时与总吞吐
+ *                   - 链路中断（模拟器注入）后的重连耗时
+ *
+ *                   用法：
+ *                     python tools/esp8266_emu.py --link /tmp/spacenose-esp8266 --disconnect-every-s 20
+ *                     host_bench esp8266 --duration-s 120 --port 8888
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "stm32f4xx_hal.h"
+#include "esp8266_driver.h"
+#include "pus_link.h"
+#include "dlog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+UART_HandleTypeDef huart1;
+UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart1_tx;
+DMA_HandleTypeDef hdma_adc1;       // stm32f4xx_it.c 引用（ADC 扫描 DMA）
+ADC_HandleTypeDef hadc1;           // stm32f4xx_it.c 引用（ADC 全局中断）
+
+#define BENCH_MAX_SAMPLES 8192
+
+static uint32_t g_send_samples[BENCH_MAX_SAMPLES];
+static uint32_t g_reconnect_samples[256];
+static bench_stats_t g_send_stats = {g_send_samples, BENCH_MAX_SAMPLES, 0};
+static bench_stats_t g_reconnect_stats = {g_reconnect_samples, 256, 0};
+
+static uint64_t g_tx_bytes = 0;
+static uint32_t g_tx_fail = 0;
+static uint64_t g_rx_bytes = 0;
+
+static uint8_t bench_send(const uint8_t* data, uint16_t len) {
+    uint32_t t0 = HAL_GetTick();
+    uint8_t ok = ESP8266_SendTCP(data, len);
+    Bench_StatsAdd(&g_send_stats, HAL_GetTick() - t0);
+    if (ok) {
+        g_tx_bytes += len;
+    } else {
+        g_tx_fail++;
+    }
+    return ok;
+}
+
+static void bench_sink(uint8_t link_id, const uint8_t* data, uint16_t len) {
+    (void)link_id;
+    g_rx_bytes += len;
+    PusLink_FeedBytes(data, len);
+}
+
+static void bench_cmd(const char* json_cmd) {
+    printf("[bench] TC: %s\r\n", json_cmd);
+}
+
+static void uart_init(void) {
+    huart1.Instance = USART1;
+    huart1.Init.BaudRate = 115200;
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = 115200;
+    HAL_UART_Init(&huart1);
+    DLog_Init(&huart1);
+    if (HAL_UART_Init(&huart2) != HAL_OK) {
+        fprintf(stderr, "[bench] USART2 打开失败（先启动 tools/esp8266_emu.py，或设置 SPACENOSE_ESP_TTY）\n");
+    }
+}
+
+int Bench_Esp8266(int argc, char** argv) {
+    const char* ssid = Bench_ArgStr(argc, argv, "--ssid", "spacenose");
+    const char* password = Bench_ArgStr(argc, argv, "--pass", "spacenose");
+    const char* ip = Bench_ArgStr(argc, argv, "--ip", "127.0.0.1");
+    uint16_t port = (uint16_t)Bench_ArgInt(argc, argv, "--port", 8888);
+    uint32_t duration_ms = (uint32_t)Bench_ArgInt(argc, argv, "--duration-s", 60) * 1000u;
+    uint32_t hk_interval_ms = (uint32_t)Bench_ArgInt(argc, argv, "--hk-interval-ms", 0);
+    uint32_t event_every = (uint32_t)Bench_ArgInt(argc, argv, "--event-every", 20);
+
+    HAL_Init();
+    uart_init();
+    ESP8266_Init();
+    PusLink_Init(bench_send, 0x001, 0x01, 0x00);
+    PusLink_SetCommandHandler(bench_cmd);
+    ESP8266_SetIPDSink(bench_sink);
+
+    uint32_t t_boot = HAL_GetTick();
+    if (!ESP8266_Test()) {
+        fprintf(stderr, "[bench] ESP8266 无响应\n");
+        return 1;
+    }
+    uint32_t t_at = HAL_GetTick();
+    if (!ESP8266_ConnectWiFi(ssid, password)) {
+        fprintf(stderr, "[bench] WiFi 连接失败\n");
+        return 1;
+    }
+    uint32_t t_wifi = HAL_GetTick();
+    if (!ESP8266_StartConnection("TCP", ip, port)) {
+        fprintf(stderr, "[bench] TCP 连接失败\n");
+        return 1;
+    }
+    uint32_t t_tcp = HAL_GetTick();
+    PusLink_SetConnected(1);
+
+    uint8_t connected = 1;
+    uint32_t down_since = 0;
+    uint32_t counter = 0;
+    uint32_t hk_queued = 0;
+    uint32_t events_queued = 0;
+    uint32_t last_hk = 0;
+    uint32_t t_run = HAL_GetTick();
+
+    while ((HAL_GetTick() - t_run) < duration_ms) {
+        if (!connected) {
+            if (ESP8266_StartConnection("TCP", ip, port)) {
+                Bench_StatsAdd(&g_reconnect_stats, HAL_GetTick() - down_since);
+                connected = 1;
+                PusLink_SetConnected(1);
+            } else {
+                HAL_Delay(200);
+                continue;
+            }
+        }
+
+        uint32_t now = HAL_GetTick();
+        if ((now - last_hk) >= hk_interval_ms) {
+            char payload[160];
+            snprintf(payload, sizeof(payload),
+                     "{\"counter\":%lu,\"adc\":%lu,\"voltage\":1.234,\"mq3_adc\":%lu,"
+                     "\"mq3_voltage\":1.234,\"alcohol_ppm\":12.34,\"sensor_status\":0}",
+                     (unsigned long)counter, (unsigned long)(counter & 0xFFF),
+                     (unsigned long)(counter & 0xFFF));
+            hk_queued += PusLink_QueueHousekeeping(payload);
+            if (event_every > 0 && (counter % event_every) == 0) {
+                snprintf(payload, sizeof(payload),
+                         "{\"kind\":\"bench\",\"counter\":%lu}", (unsigned long)counter);
+                events_queued += PusLink_QueueEvent(PUS5_EVENT_INFO, payload, 1);
+            }
+            counter++;
+            last_hk = now;
+        }
+
+        if (!PusLink_Poll()) {
+            connected = 0;
+            down_since = HAL_GetTick();
+            PusLink_SetConnected(0);
+        }
+        ESP8266_PollIPD();
+    }
+
+    uint32_t run_ms = HAL_GetTick() - t_run;
+    DLog_Flush(1000);
+
+    fprintf(stderr, "\n===== esp8266 bench =====\n");
+    fprintf(stderr, "  启动: AT=%lums WiFi=%lums TCP=%lums（累计 %lums）\n",
+            (unsigned long)(t_at - t_boot),
+            (unsigned long)(t_wifi - t_at),
+            (unsigned long)(t_tcp - t_wifi),
+            (unsigned long)(t_tcp - t_boot));
+    fprintf(stderr, "  运行: %lums，HK 入队 %lu，事件入队 %lu\n",
+            (unsigned long)run_ms, (unsigned long)hk_queued, (unsigned long)events_queued);
+    fprintf(stderr, "  上行: %llu B，%.1f B/s，发送失败 %lu 次\n",
+            (unsigned long long)g_tx_bytes,
+            run_ms ? (double)g_tx_bytes * 1000.0 / run_ms : 0.0,
+            (unsigned long)g_tx_fail);
+    fprintf(stderr, "  下行: %llu B（TC/TM-ACK）\n", (unsigned long long)g_rx_bytes);
+    Bench_StatsPrint("SendTCP", &g_send_stats, "ms");
+    Bench_StatsPrint("reconnect", &g_reconnect_stats, "ms");
+    return 0;
+}
@@ -0,0 +1,815 @@
+/**
+ ******************************************************************************
+ * @file           : bench_fleet.c
+ * @brief          : 地面段压力测试：成千上万台模拟设备直连后端 TCP 端口
+ ******************************************************************************
+ * @description    : 每台模拟设备一个 PusLink_t 上下文（真实的 pus_link.c：组包、队列、
+ *                   TM-ACK 重传、TC 验收/完成回报），各用一条非阻塞 TCP 连接，
+ *                   由一个 epoll 循环驱动；不经 ESP8266，直接压 backend/main.py。
+ *
+ *                   - HK（3/25）按 --hk-interval-ms 周期发出（各设备相位随机错开），
+ *                     每 --event-every 个 HK 夹一个要求 TM-ACK 的事件（5/x，级别按比例混合）；
+ *                   - 后端下发的 TC 经 pus_link 回 1/1、1/7，set_rate 改变该设备的 HK 周期；
+ *                   - 事件 ACK 往返：首次发出 → 收到 129/2；
+ *                   - HK 入库时延：生成 → 后端经 WebSocket（/ws）广播出该条 HK
+ *                     （解析、ML、写库、广播都在其中）；--ws-port 0 关闭；
+ *                   - 目标为环回地址时，每台设备绑定不同的源地址（127.1.x.y），
+ *                     后端按对端 IP 区分设备的状态（去重窗口、指令下发）才与真实部署一致。
+ *
+ *                   每 --report-s 秒一行窗口统计（在线数、各类速率、时延分位、积压），
+ *                   随设备数 / 速率上升时 ACK 往返与入库时延的拐点即地面段饱和点。
+ *                   结束时给出全程汇总。
+ *
+ *                   用法：
+ *                     cd backend && python main.py
+ *                     host_bench fleet --devices 2000 --ramp-s 20 --hk-interval-ms 1000 --duration-s 60
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "stm32f4xx_hal.h"
+#include "pus_link.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define FLEET_OUT_SIZE        4096     // 每设备发送积压上限（内核缓冲满之后）
+#define FLEET_RX_SIZE         PUS_MAX_PACKET_LEN
+#define FLEET_EVT_TRACK       32       // 每设备跟踪的在途事件数（按序号取模）
+#define FLEET_HK_TRACK        64       // 每设备跟踪的 HK 生成时刻（按 counter 取模）
+#define FLEET_RECONNECT_MS    1000
+#define FLEET_TICK_MS         5
+#define FLEET_STATS_CAP       (1u << 20)
+#define FLEET_WIN_STATS_CAP   (FLEET_STATS_CAP / 16)   // 单个报告窗口的样本上限
+#define FLEET_WS_BUF_SIZE     65536
+#define FLEET_EPOLL_BATCH     256
+
+#define FLEET_WS_TOKEN        ((uint64_t)UINT32_MAX)   // epoll data：WebSocket 连接
+
+typedef enum {
+    DEV_IDLE = 0,             // 等待连接（爬坡或重连退避）
+    DEV_CONNECTING,
+    DEV_UP,
+} DevState_t;
+
+typedef struct {
+    uint16_t seq;             // TM 序号（14 位）
+    uint8_t live;
+    uint8_t sends;
+    uint32_t first_ms;
+} FleetEvt_t;
+
+typedef struct {
+    uint32_t id;
+    int fd;
+    uint8_t state;
+    uint8_t want_out;         // 已登记 EPOLLOUT
+    uint32_t next_connect_ms;
+    uint32_t connect_start_ms;
+    uint32_t hk_interval_ms;
+    uint32_t next_hk_ms;
+    uint32_t counter;
+    uint32_t sends;           // send_fn 调用次数（判断 Poll 是否有进展）
+
+    PusLink_t pus;
+
+    uint8_t out[FLEET_OUT_SIZE];
+    uint16_t out_len;
+    uint8_t rx[FLEET_RX_SIZE];
+    uint16_t rx_len;
+
+    FleetEvt_t evt[FLEET_EVT_TRACK];
+    uint32_t hk_ms[FLEET_HK_TRACK];
+} FleetDev_t;
+
+/* 窗口计数（每 --report-s 清零）与全程累计 */
+typedef struct {
+    uint32_t connects;
+    uint32_t connect_fail;
+    uint32_t disconnects;
+    uint32_t hk;
+    uint32_t events;
+    uint32_t retrans;
+    uint32_t acks;
+    uint32_t acks_dup;
+    uint32_t ws_hk;
+    uint32_t tcs;
+    uint32_t backpressure;
+    uint64_t tx_bytes;
+} FleetCounters_t;
+
+static FleetDev_t* g_devs = NULL;
+static uint32_t g_dev_count = 0;
+static int g_ep = -1;
+static FleetDev_t* g_cur = NULL;      // 正在处理下行的设备（TC 回调无上下文参数）
+
+static struct sockaddr_in g_server;
+static uint32_t g_src_base = 0;       // 主机字节序；0 = 不绑定源地址
+
+static FleetCounters_t g_win;
+static FleetCounters_t g_total;
+static uint32_t g_tc_set_rate = 0;
+static uint32_t g_tc_other = 0;
+
+static bench_stats_t g_connect_stats;
+static bench_stats_t g_ack_stats;
+static bench_stats_t g_ingest_stats;
+static bench_stats_t g_win_ack;
+static bench_stats_t g_win_ingest;
+
+static uint32_t g_rng = 1;
+
+/* WebSocket（入库时延） */
+static int g_ws_fd = -1;
+static uint8_t g_ws_open = 0;
+static uint8_t* g_ws_buf = NULL;
+static uint32_t g_ws_len = 0;
+
+static uint32_t xorshift32(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static inline uint16_t rd_u16(const uint8_t* p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static void counters_add(FleetCounters_t* dst, const FleetCounters_t* src) {
+    dst->connects += src->connects;
+    dst->connect_fail += src->connect_fail;
+    dst->disconnects += src->disconnects;
+    dst->hk += src->hk;
+    dst->events += src->events;
+    dst->retrans += src->retrans;
+    dst->acks += src->acks;
+    dst->acks_dup += src->acks_dup;
+    dst->ws_hk += src->ws_hk;
+    dst->tcs += src->tcs;
+    dst->backpressure += src->backpressure;
+    dst->tx_bytes += src->tx_bytes;
+}
+
+/* ----------------- 连接 ----------------- */
+
+static void ep_set(int fd, uint64_t token, uint32_t events, int op) {
+    struct epoll_event ev = {.events = events, .data.u64 = token};
+    epoll_ctl(g_ep, op, fd, &ev);
+}
+
+static void dev_close(FleetDev_t* d, uint32_t now, uint8_t failed_connect) {
+    if (d->fd >= 0) {
+        close(d->fd);   // 关闭即从 epoll 中移除
+        d->fd = -1;
+    }
+    if (failed_connect) {
+        g_win.connect_fail++;
+    } else if (d->state == DEV_UP) {
+        g_win.disconnects++;
+    }
+    d->state = DEV_IDLE;
+    d->want_out = 0;
+    d->out_len = 0;
+    d->rx_len = 0;
+    d->next_connect_ms = now + FLEET_RECONNECT_MS + (xorshift32() % FLEET_RECONNECT_MS);
+    PusLinkCtx_SetConnected(&d->pus, 0);   // 队列保留：重连后补发，与固件断链缓存一致
+}
+
+static void dev_connect(FleetDev_t* d, uint32_t now) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        g_win.connect_fail++;
+        d->next_connect_ms = now + FLEET_RECONNECT_MS;
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (g_src_base != 0) {
+        struct sockaddr_in src = {.sin_family = AF_INET, .sin_port = 0};
+        src.sin_addr.s_addr = htonl(g_src_base + d->id);
+        setsockopt(fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &one, sizeof(one));
+        if (bind(fd, (struct sockaddr*)&src, sizeof(src)) != 0) {
+            close(fd);
+            g_win.connect_fail++;
+            d->next_connect_ms = now + FLEET_RECONNECT_MS;
+            return;
+        }
+    }
+    d->fd = fd;
+    d->state = DEV_CONNECTING;
+    d->connect_start_ms = now;
+    if (connect(fd, (struct sockaddr*)&g_server, sizeof(g_server)) != 0 && errno != EINPROGRESS) {
+        dev_close(d, now, 1);
+        return;
+    }
+    d->want_out = 1;
+    ep_set(fd, d->id, EPOLLIN | EPOLLOUT | EPOLLRDHUP, EPOLL_CTL_ADD);
+}
+
+static void dev_connected(FleetDev_t* d, uint32_t now) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(d->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+        dev_close(d, now, 1);
+        return;
+    }
+    d->state = DEV_UP;
+    g_win.connects++;
+    Bench_StatsAdd(&g_connect_stats, now - d->connect_start_ms);
+    PusLinkCtx_SetConnected(&d->pus, 1);
+}
+
+/* ----------------- 发送 ----------------- */
+
+static void dev_watch_out(FleetDev_t* d, uint8_t on) {
+    if (d->want_out != on && d->fd >= 0) {
+        d->want_out = on;
+        ep_set(d->fd, d->id, EPOLLIN | EPOLLRDHUP | (on ? EPOLLOUT : 0), EPOLL_CTL_MOD);
+    }
+}
+
+/**
+ * @brief 发出的事件记下首次发送时刻（重传只计次数）
+ */
+static void track_event_send(FleetDev_t* d, const uint8_t* pkt, uint16_t len, uint32_t now) {
+    if (len < 13 || ((rd_u16(&pkt[0]) >> 12) & 0x1) != 0 || pkt[7] != 5) {
+        return;
+    }
+    uint16_t seq = (uint16_t)(rd_u16(&pkt[2]) & 0x3FFF);
+    FleetEvt_t* e = &d->evt[seq % FLEET_EVT_TRACK];
+    if (e->live && e->seq == seq) {
+        e->sends++;
+        g_win.retrans++;
+        return;
+    }
+    *e = (FleetEvt_t){seq, 1, 1, now};
+}
+
+static uint8_t fleet_send(void* user, const uint8_t* data, uint16_t len) {
+    FleetDev_t* d = user;
+    if (d->state != DEV_UP) {
+        return 0;
+    }
+    uint16_t off = 0;
+    if (d->out_len == 0) {
+        ssize_t n = send(d->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return 0;   // 连接已坏：由读事件（EPOLLRDHUP/HUP）收尾
+        }
+        off = (n > 0) ? (uint16_t)n : 0;
+    }
+    if (off < len) {
+        if ((uint32_t)d->out_len + (len - off) > FLEET_OUT_SIZE) {
+            g_win.backpressure++;
+            return 0;   // 积压已满：消息留在 PUS 队列，等可写后再发
+        }
+        memcpy(&d->out[d->out_len], data + off, (size_t)(len - off));
+        d->out_len = (uint16_t)(d->out_len + (len - off));
+        dev_watch_out(d, 1);
+    }
+    d->sends++;
+    g_win.tx_bytes += len;
+    track_event_send(d, data, len, HAL_GetTick());
+    return 1;
+}
+
+static void dev_flush(FleetDev_t* d, uint32_t now) {
+    while (d->out_len > 0) {
+        ssize_t n = send(d->fd, d->out, d->out_len, MSG_NOSIGNAL);
+        if (n > 0) {
+            memmove(d->out, &d->out[n], (size_t)(d->out_len - n));
+            d->out_len = (uint16_t)(d->out_len - n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            dev_close(d, now, 0);
+            return;
+        }
+    }
+    dev_watch_out(d, 0);
+}
+
+/**
+ * @brief 把 PUS 队列中可发的消息尽量发完（Poll 一次最多发一条，没有进展即停）
+ */
+static void dev_pump(FleetDev_t* d) {
+    for (int i = 0; i < PUS_QUEUE_SIZE && d->state == DEV_UP; i++) {
+        uint32_t before = d->sends;
+        PusLinkCtx_Poll(&d->pus);
+        if (d->sends == before) {
+            break;
+        }
+    }
+}
+
+/* ----------------- 产生 HK / 事件 ----------------- */
+
+static const struct {
+    uint8_t subtype;
+    const char* kind;
+    uint8_t weight;           // 事件级别混合比例
+} k_event_mix[] = {
+    {PUS5_EVENT_INFO, "status", 60},
+    {PUS5_EVENT_LOW, "anomaly", 20},
+    {PUS5_EVENT_MEDIUM, "gas_alert", 15},
+    {PUS5_EVENT_HIGH, "exposure", 5},
+};
+
+static void dev_generate(FleetDev_t* d, uint32_t now, uint32_t event_every) {
+    char payload[PUS_MAX_TM_JSON_LEN + 1];
+    uint32_t n = d->counter++;
+    uint32_t adc = 780u + (xorshift32() % 40u);
+    uint32_t ppm_x100 = 20u + (xorshift32() % 300u);
+
+    snprintf(payload, sizeof(payload),
+             "{\"counter\":%lu,\"adc\":%lu,\"voltage\":%lu.%03lu,\"mq3_adc\":%lu,\"mq3_voltage\":%lu.%03lu,"
+             "\"alcohol_ppm\":%lu.%02lu,\"tx\":\"full\",\"z\":0.0,\"supp\":0,\"dev\":%lu,\"sensor_status\":0}",
+             (unsigned long)n, (unsigned long)adc,
+             (unsigned long)(adc * 3300u / 4095u / 1000u), (unsigned long)(adc * 3300u / 4095u % 1000u),
+             (unsigned long)adc,
+             (unsigned long)(adc * 3300u / 4095u / 1000u), (unsigned long)(adc * 3300u / 4095u % 1000u),
+             (unsigned long)(ppm_x100 / 100u), (unsigned long)(ppm_x100 % 100u),
+             (unsigned long)d->id);
+    if (PusLinkCtx_QueueHousekeeping(&d->pus, payload)) {
+        d->hk_ms[n % FLEET_HK_TRACK] = now;
+        g_win.hk++;
+    }
+
+    if (event_every > 0 && (n % event_every) == event_every - 1) {
+        uint32_t r = xorshift32() % 100u;
+        size_t k = 0;
+        while (k + 1 < sizeof(k_event_mix) / sizeof(k_event_mix[0]) && r >= k_event_mix[k].weight) {
+            r -= k_event_mix[k].weight;
+            k++;
+        }
+        snprintf(payload, sizeof(payload), "{\"kind\":\"%s\",\"dev\":%lu,\"counter\":%lu,\"alcohol_ppm\":%lu.%02lu}",
+                 k_event_mix[k].kind, (unsigned long)d->id, (unsigned long)n,
+                 (unsigned long)(ppm_x100 / 100u), (unsigned long)(ppm_x100 % 100u));
+        if (PusLinkCtx_QueueEvent(&d->pus, k_event_mix[k].subtype, payload, 1)) {
+            g_win.events++;
+        }
+    }
+}
+
+/* ----------------- 接收 ----------------- */
+
+static void fleet_cmd(const char* json_cmd) {
+    g_win.tcs++;
+    const char* p = strstr(json_cmd, "\"rate_ms\"");
+    if (strstr(json_cmd, "set_rate") != NULL && p != NULL && g_cur != NULL) {
+        p = strchr(p, ':');
+        long rate = (p != NULL) ? strtol(p + 1, NULL, 10) : 0;
+        if (rate >= 100 && rate <= 60000) {
+            g_cur->hk_interval_ms = (uint32_t)rate;   // 与固件一致：立即按新周期发 HK
+            g_cur->next_hk_ms = HAL_GetTick() + (uint32_t)rate;
+        }
+        g_tc_set_rate++;
+    } else {
+        g_tc_other++;
+    }
+}
+
+/**
+ * @brief 一个完整的下行包：TM-ACK 先记往返，再交给 pus_link（清队列 / 回 TC 验收）
+ */
+static void dev_on_packet(FleetDev_t* d, const uint8_t* pkt, uint16_t len, uint32_t now) {
+    if (len >= 15 && pkt[7] == 129 && pkt[8] == 2) {
+        uint16_t seq = (uint16_t)(rd_u16(&pkt[13]) & 0x3FFF);
+        FleetEvt_t* e = &d->evt[seq % FLEET_EVT_TRACK];
+        if (e->live && e->seq == seq) {
+            e->live = 0;
+            g_win.acks++;
+            Bench_StatsAdd(&g_ack_stats, now - e->first_ms);
+            Bench_StatsAdd(&g_win_ack, now - e->first_ms);
+        } else {
+            g_win.acks_dup++;   // 重传的事件后端照样回 ACK
+        }
+    }
+    g_cur = d;
+    PusLinkCtx_FeedBytes(&d->pus, pkt, len);
+    g_cur = NULL;
+}
+
+static void dev_read(FleetDev_t* d, uint32_t now) {
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(d->fd, buf, sizeof(buf), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            dev_close(d, now, 0);
+            return;
+        }
+        if (n < 0) {
+            break;
+        }
+        /* 分帧：6B 主头给出包长 */
+        for (ssize_t i = 0; i < n;) {
+            uint16_t want = 6;
+            if (d->rx_len >= 6) {
+                want = (uint16_t)(rd_u16(&d->rx[4]) + 7u);
+                if (want > FLEET_RX_SIZE || want < 13) {
+                    d->rx_len = 0;   // 失步：丢弃
+                    continue;
+                }
+            }
+            uint16_t take = (uint16_t)(want - d->rx_len);
+            if ((ssize_t)take > n - i) {
+                take = (uint16_t)(n - i);
+            }
+            memcpy(&d->rx[d->rx_len], &buf[i], take);
+            d->rx_len = (uint16_t)(d->rx_len + take);
+            i += take;
+            if (d->rx_len >= 6 && d->rx_len == (uint16_t)(rd_u16(&d->rx[4]) + 7u)) {
+                dev_on_packet(d, d->rx, d->rx_len, now);
+                d->rx_len = 0;
+            }
+        }
+    }
+    dev_pump(d);   // TC 验收回报与释放出的槽位
+}
+
+/* ----------------- WebSocket：HK 入库时延 ----------------- */
+
+static int ws_open(const char* ip, uint16_t port, const char* path) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    if (fd < 0 || inet_pton(AF_INET, ip, &addr.sin_addr) != 1 ||
+        connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    char req[256];
+    int n = snprintf(req, sizeof(req),
+                     "GET %s HTTP/1.1\r\nHost: %s:%u\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     "Sec-WebSocket-Key: c3BhY2Vub3NlLWZsZWV0IQ==\r\nSec-WebSocket-Version: 13\r\n\r\n",
+                     path, ip, port);
+    char resp[1024];
+    size_t got = 0;
+    if (send(fd, req, (size_t)n, MSG_NOSIGNAL) != n) {
+        close(fd);
+        return -1;
+    }
+    while (got < sizeof(resp) - 1) {
+        ssize_t r = recv(fd, &resp[got], 1, 0);   // 逐字节读到头部结束，不吞掉第一帧
+        if (r <= 0) {
+            close(fd);
+            return -1;
+        }
+        got++;
+        resp[got] = '\0';
+        if (got >= 4 && memcmp(&resp[got - 4], "\r\n\r\n", 4) == 0) {
+            break;
+        }
+    }
+    if (strstr(resp, " 101 ") == NULL) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static void ws_send_frame(uint8_t opcode, const uint8_t* data, uint8_t len) {
+    uint8_t frame[2 + 4 + 125];
+    frame[0] = (uint8_t)(0x80 | opcode);
+    frame[1] = (uint8_t)(0x80 | len);   // 客户端帧必须带掩码；掩码键取 0，载荷不变
+    memset(&frame[2], 0, 4);
+    memcpy(&frame[6], data, len);
+    (void)send(g_ws_fd, frame, (size_t)(6 + len), MSG_NOSIGNAL);
+}
+
+static void ws_on_text(const char* text, uint32_t now) {
+    const char* p = strstr(text, "\"dev\": ");
+    const char* c = strstr(text, "\"counter\": ");
+    if (p == NULL || c == NULL) {
+        return;
+    }
+    unsigned long dev = strtoul(p + 7, NULL, 10);
+    unsigned long counter = strtoul(c + 11, NULL, 10);
+    if (dev >= g_dev_count) {
+        return;
+    }
+    const FleetDev_t* d = &g_devs[dev];
+    if (counter >= d->counter || d->counter - counter > FLEET_HK_TRACK) {
+        return;   // 早已被覆盖的记录
+    }
+    uint32_t lat = now - d->hk_ms[counter % FLEET_HK_TRACK];
+    g_win.ws_hk++;
+    Bench_StatsAdd(&g_ingest_stats, lat);
+    Bench_StatsAdd(&g_win_ingest, lat);
+}
+
+static void ws_read(uint32_t now) {
+    for (;;) {
+        if (g_ws_len == FLEET_WS_BUF_SIZE) {
+            g_ws_len = 0;   // 单帧超过缓冲：丢弃（HK 广播远小于此）
+        }
+        ssize_t n = recv(g_ws_fd, &g_ws_buf[g_ws_len], FLEET_WS_BUF_SIZE - g_ws_len, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            fprintf(stderr, "[fleet] WebSocket 已断开，之后不再统计入库时延\n");
+            close(g_ws_fd);
+            g_ws_fd = -1;
+            g_ws_open = 0;
+            return;
+        }
+        if (n < 0) {
+            break;
+        }
+        g_ws_len += (uint32_t)n;
+    }
+
+    uint32_t off = 0;
+    while (g_ws_len - off >= 2) {
+        const uint8_t* f = &g_ws_buf[off];
+        uint8_t opcode = f[0] & 0x0F;
+        uint64_t plen = f[1] & 0x7F;
+        uint32_t hdr = 2;
+        if (plen == 126) {
+            if (g_ws_len - off < 4) {
+                break;
+            }
+            plen = rd_u16(&f[2]);
+            hdr = 4;
+        } else if (plen == 127) {
+            if (g_ws_len - off < 10) {
+                break;
+            }
+            plen = 0;
+            for (int i = 0; i < 8; i++) {
+                plen = (plen << 8) | f[2 + i];
+            }
+            hdr = 10;
+        }
+        if (plen > FLEET_WS_BUF_SIZE - 16) {
+            g_ws_len = 0;
+            return;
+        }
+        if (g_ws_len - off < hdr + plen) {
+            break;
+        }
+        uint8_t* payload = &g_ws_buf[off + hdr];
+        if (opcode == 0x1) {
+            char saved = (char)payload[plen - (plen > 0)];
+            payload[plen - (plen > 0)] = '\0';
+            ws_on_text((const char*)payload, now);
+            payload[plen - (plen > 0)] = (uint8_t)saved;
+        } else if (opcode == 0x9) {
+            ws_send_frame(0xA, payload, (uint8_t)((plen < 125) ? plen : 125));
+        }
+        off += hdr + (uint32_t)plen;
+    }
+    memmove(g_ws_buf, &g_ws_buf[off], g_ws_len - off);
+    g_ws_len -= off;
+}
+
+/* ----------------- 主循环 ----------------- */
+
+static void raise_fd_limit(uint32_t want) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) {
+        return;
+    }
+    if (rl.rlim_cur < want + 64) {
+        rl.rlim_cur = (rl.rlim_max < want + 64) ? rl.rlim_max : want + 64;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    if (rl.rlim_cur < want + 64) {
+        fprintf(stderr, "[fleet] 文件描述符上限 %lu，不足 %lu 台设备（ulimit -n）\n",
+                (unsigned long)rl.rlim_cur, (unsigned long)want);
+    }
+}
+
+static void report_window(uint32_t t_ms, uint32_t window_ms) {
+    uint32_t online = 0;
+    uint32_t queued = 0;
+    uint32_t backlog = 0;
+    for (uint32_t i = 0; i < g_dev_count; i++) {
+        online += (g_devs[i].state == DEV_UP);
+        queued += PusLinkCtx_QueueDepth(&g_devs[i].pus);
+        backlog += g_devs[i].out_len;
+    }
+    uint32_t ack50 = Bench_StatsPercentile(&g_win_ack, 50);
+    uint32_t ack95 = Bench_StatsPercentile(&g_win_ack, 95);
+    uint32_t ing50 = Bench_StatsPercentile(&g_win_ingest, 50);
+    uint32_t ing95 = Bench_StatsPercentile(&g_win_ingest, 95);
+    double s = (window_ms > 0) ? window_ms / 1000.0 : 1.0;
+    fprintf(stderr, "%6.1f %6lu %5lu %5lu %8.1f %7.1f %7.1f %7.1f %6lu %6lu %6lu %6lu %7lu %8lu %6lu\n",
+            t_ms / 1000.0, (unsigned long)online, (unsigned long)g_win.connect_fail,
+            (unsigned long)g_win.disconnects, g_win.hk / s, g_win.events / s, g_win.acks / s, g_win.ws_hk / s,
+            (unsigned long)ack50, (unsigned long)ack95, (unsigned long)ing50, (unsigned long)ing95,
+            (unsigned long)queued, (unsigned long)backlog, (unsigned long)g_win.retrans);
+    counters_add(&g_total, &g_win);
+    memset(&g_win, 0, sizeof(g_win));
+    Bench_StatsReset(&g_win_ack);
+    Bench_StatsReset(&g_win_ingest);
+}
+
+int Bench_Fleet(int argc, char** argv) {
+    const char* ip = Bench_ArgStr(argc, argv, "--ip", "127.0.0.1");
+    uint16_t port = (uint16_t)Bench_ArgInt(argc, argv, "--port", 8888);
+    uint32_t devices = (uint32_t)Bench_ArgInt(argc, argv, "--devices", 1000);
+    uint32_t ramp_ms = (uint32_t)Bench_ArgInt(argc, argv, "--ramp-s", 10) * 1000u;
+    uint32_t duration_ms = (uint32_t)Bench_ArgInt(argc, argv, "--duration-s", 60) * 1000u;
+    uint32_t drain_ms = (uint32_t)Bench_ArgInt(argc, argv, "--drain-s", 5) * 1000u;
+    uint32_t hk_interval_ms = (uint32_t)Bench_ArgInt(argc, argv, "--hk-interval-ms", 5000);
+    uint32_t event_every = (uint32_t)Bench_ArgInt(argc, argv, "--event-every", 10);
+    uint32_t report_ms = (uint32_t)Bench_ArgInt(argc, argv, "--report-s", 5) * 1000u;
+    uint16_t ws_port = (uint16_t)Bench_ArgInt(argc, argv, "--ws-port", 8000);
+    const char* ws_path = Bench_ArgStr(argc, argv, "--ws-path", "/ws");
+    const char* src_base = Bench_ArgStr(argc, argv, "--src-base", (strncmp(ip, "127.", 4) == 0) ? "127.1.0.1" : "none");
+    g_rng = (uint32_t)Bench_ArgInt(argc, argv, "--seed", 1);
+    if (g_rng == 0) {
+        g_rng = 1;
+    }
+
+    memset(&g_server, 0, sizeof(g_server));
+    g_server.sin_family = AF_INET;
+    g_server.sin_port = htons(port);
+    if (devices == 0 || hk_interval_ms == 0 || inet_pton(AF_INET, ip, &g_server.sin_addr) != 1) {
+        fprintf(stderr, "[fleet] 参数无效（--ip / --devices / --hk-interval-ms）\n");
+        return 2;
+    }
+    struct in_addr src;
+    g_src_base = (strcmp(src_base, "none") != 0 && inet_pton(AF_INET, src_base, &src) == 1) ? ntohl(src.s_addr) : 0;
+
+    HAL_Init();
+    raise_fd_limit(devices + 1);
+    g_ep = epoll_create1(EPOLL_CLOEXEC);
+    g_devs = calloc(devices, sizeof(FleetDev_t));
+    g_connect_stats = (bench_stats_t){calloc(FLEET_STATS_CAP, sizeof(uint32_t)), FLEET_STATS_CAP, 0};
+    g_ack_stats = (bench_stats_t){calloc(FLEET_STATS_CAP, sizeof(uint32_t)), FLEET_STATS_CAP, 0};
+    g_ingest_stats = (bench_stats_t){calloc(FLEET_STATS_CAP, sizeof(uint32_t)), FLEET_STATS_CAP, 0};
+    g_win_ack = (bench_stats_t){calloc(FLEET_WIN_STATS_CAP, sizeof(uint32_t)), FLEET_WIN_STATS_CAP, 0};
+    g_win_ingest = (bench_stats_t){calloc(FLEET_WIN_STATS_CAP, sizeof(uint32_t)), FLEET_WIN_STATS_CAP, 0};
+    g_ws_buf = malloc(FLEET_WS_BUF_SIZE);
+    if (g_ep < 0 || g_devs == NULL || g_connect_stats.samples == NULL || g_ack_stats.samples == NULL ||
+        g_ingest_stats.samples == NULL || g_win_ack.samples == NULL || g_win_ingest.samples == NULL ||
+        g_ws_buf == NULL) {
+        fprintf(stderr, "[fleet] 初始化失败（内存 / epoll）\n");
+        return 1;
+    }
+    g_dev_count = devices;
+
+    uint32_t t0 = HAL_GetTick();
+    for (uint32_t i = 0; i < devices; i++) {
+        FleetDev_t* d = &g_devs[i];
+        d->id = i;
+        d->fd = -1;
+        d->hk_interval_ms = hk_interval_ms;
+        d->next_connect_ms = t0 + (uint32_t)((uint64_t)ramp_ms * i / devices);
+        d->next_hk_ms = d->next_connect_ms + (xorshift32() % hk_interval_ms);   // 相位错开，避免同步突发
+        /* APID 相同（与真实机队一致），source_id 区分设备 */
+        PusLinkCtx_Init(&d->pus, fleet_send, d, 0x001, (uint16_t)(i + 1), 0x00);
+        PusLinkCtx_SetCommandHandler(&d->pus, fleet_cmd);
+    }
+
+    if (ws_port != 0) {
+        g_ws_fd = ws_open(ip, ws_port, ws_path);
+        if (g_ws_fd < 0) {
+            fprintf(stderr, "[fleet] WebSocket ws://%s:%u%s 连接失败，不统计 HK 入库时延\n", ip, ws_port, ws_path);
+        } else {
+            g_ws_open = 1;
+            ep_set(g_ws_fd, FLEET_WS_TOKEN, EPOLLIN, EPOLL_CTL_ADD);
+        }
+    }
+
+    fprintf(stderr, "[fleet] %lu 台设备 → %s:%u，爬坡 %lus，HK 每 %lums，每 %lu 个 HK 一个事件，源地址 %s\n",
+            (unsigned long)devices, ip, port, (unsigned long)(ramp_ms / 1000u), (unsigned long)hk_interval_ms,
+            (unsigned long)event_every, g_src_base ? src_base : "（默认）");
+    fprintf(stderr, "%6s %6s %5s %5s %8s %7s %7s %7s %6s %6s %6s %6s %7s %8s %6s\n",
+            "t_s", "online", "cfail", "disc", "hk/s", "ev/s", "ack/s", "ws/s",
+            "ack50", "ack95", "ing50", "ing95", "queued", "backlog", "retx");
+
+    uint32_t last_report = t0;
+    uint32_t gen_end = t0 + duration_ms;
+    uint32_t run_end = gen_end + drain_ms;
+    struct epoll_event events[FLEET_EPOLL_BATCH];
+    uint32_t last_tick = 0;
+
+    for (;;) {
+        uint32_t now = HAL_GetTick();
+        if ((int32_t)(now - run_end) >= 0) {
+            break;
+        }
+
+        int n = epoll_wait(g_ep, events, FLEET_EPOLL_BATCH, FLEET_TICK_MS);
+        now = HAL_GetTick();
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.u64 == FLEET_WS_TOKEN) {
+                ws_read(now);
+                continue;
+            }
+            FleetDev_t* d = &g_devs[events[i].data.u64];
+            if (d->fd < 0) {
+                continue;
+            }
+            if (d->state == DEV_CONNECTING) {
+                if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                    dev_connected(d, now);
+                    if (d->state == DEV_UP) {
+                        dev_watch_out(d, 0);
+                        dev_pump(d);   // 断链期间缓存的消息
+                    }
+                }
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                dev_flush(d, now);
+                if (d->state == DEV_UP) {
+                    dev_pump(d);
+                }
+            }
+            if (d->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                dev_read(d, now);
+            }
+        }
+
+        /* 定时：连接爬坡 / 重连、HK 与事件、ACK 重传 */
+        if (now - last_tick >= FLEET_TICK_MS) {
+            last_tick = now;
+            for (uint32_t i = 0; i < g_dev_count; i++) {
+                FleetDev_t* d = &g_devs[i];
+                if (d->state == DEV_IDLE) {
+                    if ((int32_t)(now - d->next_connect_ms) >= 0 && (int32_t)(now - gen_end) < 0) {
+                        dev_connect(d, now);
+                    }
+                } else if (d->state == DEV_CONNECTING) {
+                    continue;
+                }
+                /* 断链期间照常产生（固件的断链缓存），上线后补发 */
+                if ((int32_t)(now - gen_end) < 0 && (int32_t)(now - d->next_hk_ms) >= 0) {
+                    dev_generate(d, now, event_every);
+                    d->next_hk_ms += d->hk_interval_ms;
+                    if ((int32_t)(now - d->next_hk_ms) >= 0) {
+                        d->next_hk_ms = now + d->hk_interval_ms;   // 落后太多（进程被挂起）：不补发
+                    }
+                }
+                if (d->state == DEV_UP && d->out_len == 0) {
+                    dev_pump(d);
+                }
+            }
+        }
+
+        if (report_ms > 0 && now - last_report >= report_ms) {
+            report_window(now - t0, now - last_report);
+            last_report = now;
+        }
+    }
+    uint32_t now = HAL_GetTick();
+    report_window(now - t0, now - last_report);
+
+    /* 汇总 */
+    uint32_t unacked = 0;
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < g_dev_count; i++) {
+        for (uint32_t k = 0; k < FLEET_EVT_TRACK; k++) {
+            unacked += g_devs[i].evt[k].live;
+        }
+        dropped += g_devs[i].pus.dropped;
+        if (g_devs[i].fd >= 0) {
+            close(g_devs[i].fd);
+        }
+    }
+    double run_s = (now - t0) / 1000.0;
+    fprintf(stderr, "\n===== fleet bench =====\n");
+    fprintf(stderr, "  连接: 成功 %lu，失败 %lu，断开 %lu\n", (unsigned long)g_total.connects,
+            (unsigned long)g_total.connect_fail, (unsigned long)g_total.disconnects);
+    fprintf(stderr, "  上行: HK %lu，事件 %lu（重传 %lu），%.1f KB/s，PUS 队列溢出 %lu，发送积压满 %lu 次\n",
+            (unsigned long)g_total.hk, (unsigned long)g_total.events, (unsigned long)g_total.retrans,
+            run_s > 0 ? (double)g_total.tx_bytes / 1024.0 / run_s : 0.0, (unsigned long)dropped,
+            (unsigned long)g_total.backpressure);
+    fprintf(stderr, "  下行: TM-ACK %lu（重复 %lu，未确认 %lu），TC %lu（set_rate %lu，其他 %lu）\n",
+            (unsigned long)g_total.acks, (unsigned long)g_total.acks_dup, (unsigned long)unacked,
+            (unsigned long)g_total.tcs, (unsigned long)g_tc_set_rate, (unsigned long)g_tc_other);
+    if (g_ws_open || g_total.ws_hk > 0) {
+        fprintf(stderr, "  入库: WebSocket 收到 HK %lu / %lu（%.1f%%）\n", (unsigned long)g_total.ws_hk,
+                (unsigned long)g_total.hk, g_total.hk ? 100.0 * g_total.ws_hk / g_total.hk : 0.0);
+    }
+    Bench_StatsPrint("connect", &g_connect_stats, "ms");
+    Bench_StatsPrint("ack_rtt", &g_ack_stats, "ms");
+    Bench_StatsPrint("hk_ingest", &g_ingest_stats, "ms");
+
+    if (g_ws_fd >= 0) {
+        close(g_ws_fd);
+    }
+    close(g_ep);
+    free(g_devs);
+    free(g_ws_buf);
+    free(g_connect_stats.samples);
+    free(g_ack_stats.samples);
+    free(g_ingest_stats.samples);
+    return 0;
+}
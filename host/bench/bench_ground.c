@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file           : bench_ground.c
+ * @brief          : 多地面站（CIPMUX=1）故障切换基准
+ ******************************************************************************
+ * @description    : 在 PC 上运行真实的 ground_link.c / pus_link.c / esp8266_driver.c，
+ *                   经 tools/esp8266_emu.py 同时连接主站与备站。
+ *
+ *                   测量项：
+ *                   - 各站点发送包数、失败次数、重连次数、分到的 HK 数
+ *                   - 全部站点同时离线的累计时长（HK 无处可发的时间）
+ *                   - 指定 --udp-port 时 HK 走 UDP 的包数与失败数
+ *
+ *                   用法（两个地面站分别监听 8888 / 8889）：
+ *                     python tools/esp8266_emu.py --disconnect-every-s 15 --disconnect-link 0
+ *                     host_bench ground --port 8888 --backup-port 8889 --policy balance
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "stm32f4xx_hal.h"
+#include "esp8266_driver.h"
+#include "ground_link.h"
+#include "dlog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
+
+static uint64_t g_rx_bytes = 0;
+
+static void bench_cmd(const char* json_cmd) {
+    printf("[bench] TC: %s\r\n", json_cmd);
+}
+
+static void bench_sink(uint8_t link_id, const uint8_t* data, uint16_t len) {
+    g_rx_bytes += len;
+    GroundLink_OnIPD(link_id, data, len);
+}
+
+int Bench_Ground(int argc, char** argv) {
+    const char* ssid = Bench_ArgStr(argc, argv, "--ssid", "spacenose");
+    const char* password = Bench_ArgStr(argc, argv, "--pass", "spacenose");
+    const char* ip = Bench_ArgStr(argc, argv, "--ip", "127.0.0.1");
+    const char* backup_ip = Bench_ArgStr(argc, argv, "--backup-ip", ip);
+    uint16_t port = (uint16_t)Bench_ArgInt(argc, argv, "--port", 8888);
+    uint16_t backup_port = (uint16_t)Bench_ArgInt(argc, argv, "--backup-port", 8889);
+    uint16_t udp_port = (uint16_t)Bench_ArgInt(argc, argv, "--udp-port", 0);
+    uint16_t backup_udp_port = (uint16_t)Bench_ArgInt(argc, argv, "--backup-udp-port", 0);
+    const char* policy = Bench_ArgStr(argc, argv, "--policy", "failover");
+    uint32_t duration_ms = (uint32_t)Bench_ArgInt(argc, argv, "--duration-s", 60) * 1000u;
+    uint32_t hk_interval_ms = (uint32_t)Bench_ArgInt(argc, argv, "--hk-interval-ms", 200);
+    uint32_t event_every = (uint32_t)Bench_ArgInt(argc, argv, "--event-every", 10);
+    uint32_t retry_ms = (uint32_t)Bench_ArgInt(argc, argv, "--retry-ms", 1000);
+
+    HAL_Init();
+    huart1.Instance = USART1;
+    huart2.Instance = USART2;
+    HAL_UART_Init(&huart1);
+    DLog_Init(&huart1);
+    if (HAL_UART_Init(&huart2) != HAL_OK) {
+        fprintf(stderr, "[bench] USART2 打开失败（先启动 tools/esp8266_emu.py，或设置 SPACENOSE_ESP_TTY）\n");
+        return 1;
+    }
+    ESP8266_Init();
+
+    GroundLink_Init(0x001, 0x01, 0x00,
+                    (strcmp(policy, "balance") == 0) ? GROUND_HK_BALANCE : GROUND_HK_FAILOVER);
+    GroundLink_AddDatagram(GroundLink_AddStation("TCP", ip, port, GROUND_ROLE_ALL), udp_port);
+    GroundLink_AddDatagram(GroundLink_AddStation("TCP", backup_ip, backup_port, GROUND_ROLE_ALL),
+                           backup_udp_port);
+    GroundLink_SetCommandHandler(bench_cmd);
+    ESP8266_SetIPDSink(bench_sink);
+
+    if (!ESP8266_Test() || !ESP8266_ConnectWiFi(ssid, password)) {
+        fprintf(stderr, "[bench] ESP8266/WiFi 不可用\n");
+        return 1;
+    }
+    uint32_t t0 = HAL_GetTick();
+    uint8_t up = GroundLink_Connect();
+    uint32_t t_connect = HAL_GetTick() - t0;
+    if (up == 0) {
+        fprintf(stderr, "[bench] 地面站全部连接失败\n");
+        return 1;
+    }
+
+    uint32_t counter = 0;
+    uint32_t hk_queued = 0;
+    uint32_t events_queued = 0;
+    uint32_t last_hk = 0;
+    uint32_t last_retry = HAL_GetTick();
+    uint32_t outage_ms = 0;
+    uint32_t outage_since = 0;
+    uint32_t t_run = HAL_GetTick();
+
+    while ((HAL_GetTick() - t_run) < duration_ms) {
+        uint32_t now = HAL_GetTick();
+
+        if (!GroundLink_AllUp() && (now - last_retry) >= retry_ms) {
+            GroundLink_Reconnect();
+            last_retry = HAL_GetTick();
+        }
+
+        if ((now - last_hk) >= hk_interval_ms) {
+            char payload[160];
+            snprintf(payload, sizeof(payload),
+                     "{\"counter\":%lu,\"adc\":%lu,\"voltage\":1.234,\"mq3_adc\":%lu,"
+                     "\"mq3_voltage\":1.234,\"alcohol_ppm\":12.34,\"sensor_status\":0}",
+                     (unsigned long)counter, (unsigned long)(counter & 0xFFF),
+                     (unsigned long)(counter & 0xFFF));
+            hk_queued += GroundLink_QueueHousekeeping(payload);
+            if (event_every > 0 && (counter % event_every) == 0) {
+                snprintf(payload, sizeof(payload),
+                         "{\"kind\":\"bench\",\"counter\":%lu}", (unsigned long)counter);
+                events_queued += GroundLink_QueueEvent(PUS5_EVENT_INFO, payload, 1);
+            }
+            counter++;
+            last_hk = now;
+        }
+
+        uint8_t n_up = GroundLink_Poll();
+        now = HAL_GetTick();
+        if (n_up == 0 && outage_since == 0) {
+            outage_since = now;
+        } else if (n_up > 0 && outage_since != 0) {
+            outage_ms += now - outage_since;
+            outage_since = 0;
+        }
+        ESP8266_PollIPD();
+        HAL_Delay(1);
+    }
+    if (outage_since != 0) {
+        outage_ms += HAL_GetTick() - outage_since;
+    }
+
+    uint32_t run_ms = HAL_GetTick() - t_run;
+    DLog_Flush(1000);
+
+    fprintf(stderr, "\n===== ground bench（HK 策略: %s） =====\n", policy);
+    fprintf(stderr, "  建链: %lums，运行: %lums\n", (unsigned long)t_connect, (unsigned long)run_ms);
+    fprintf(stderr, "  HK 入队 %lu，事件入队 %lu 份（每个事件按站点数复制），下行 %llu B\n",
+            (unsigned long)hk_queued, (unsigned long)events_queued, (unsigned long long)g_rx_bytes);
+    fprintf(stderr, "  全部站点离线累计: %lums\n", (unsigned long)outage_ms);
+    for (uint8_t i = 0; i < GroundLink_StationCount(); i++) {
+        const GroundLinkStats_t* st = GroundLink_GetStats(i);
+        fprintf(stderr, "  站点%u: TCP 发送 %lu 包，失败 %lu，重连 %lu，HK %lu，UDP %lu 包/失败 %lu，当前%s\n",
+                i, (unsigned long)st->tx_packets, (unsigned long)st->tx_failures,
+                (unsigned long)st->reconnects, (unsigned long)st->hk_queued,
+                (unsigned long)st->udp_packets, (unsigned long)st->udp_failures,
+                GroundLink_IsUp(i) ? "在线" : "离线");
+    }
+    return 0;
+}
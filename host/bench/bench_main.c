@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file           : bench_main.c
+ * @brief          : 主机端基准测试入口
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const bench_entry_t k_benches[] = {
+    {"dsp", "定点 DSP 小核各实现（C / SSE2 / AVX2）的逐位校验与吞吐", Bench_Dsp},
+    {"esp8266", "驱动+PUS 经 ESP8266 模拟器的端到端吞吐与重连时间", Bench_Esp8266},
+    {"fleet", "成千上万台模拟设备（真实 PUS 栈）直连后端：ACK 往返、HK 入库时延与饱和点", Bench_Fleet},
+    {"ground", "主/备地面站多连接：事件双发、HK 分担与故障切换", Bench_Ground},
+    {"ppm_lut", "浓度查找表对照浮点参考的逐码误差与单次耗时", Bench_PpmLut},
+    {"tinyml", "板上 int8 分类器对照导出工具整数参考的逐位校验与单次耗时", Bench_TinyMl},
+    {"tm_writer", "遥测序列化对照 snprintf 的逐字节校验、单包耗时与 CBOR 体积", Bench_TmWriter},
+};
+
+#define BENCH_COUNT (sizeof(k_benches) / sizeof(k_benches[0]))
+
+uint64_t Bench_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+const char* Bench_ArgStr(int argc, char** argv, const char* key, const char* def) {
+    for (int i = 0; i + 1 < argc; i++) {
+        if (strcmp(argv[i], key) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return def;
+}
+
+long Bench_ArgInt(int argc, char** argv, const char* key, long def) {
+    const char* v = Bench_ArgStr(argc, argv, key, NULL);
+    return (v != NULL) ? strtol(v, NULL, 0) : def;
+}
+
+void Bench_StatsAdd(bench_stats_t* st, uint32_t value) {
+    if (st->count < st->capacity) {
+        st->samples[st->count] = value;
+    }
+    st->count++;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void Bench_StatsReset(bench_stats_t* st) {
+    st->count = 0;
+}
+
+uint32_t Bench_StatsPercentile(bench_stats_t* st, uint32_t pct) {
+    uint32_t n = (st->count < st->capacity) ? st->count : st->capacity;
+    if (n == 0) {
+        return 0;
+    }
+    qsort(st->samples, n, sizeof(uint32_t), cmp_u32);
+    uint32_t i = (n * pct) / 100u;
+    return st->samples[(i < n) ? i : n - 1];
+}
+
+void Bench_StatsPrint(const char* label, bench_stats_t* st, const char* unit) {
+    uint32_t n = (st->count < st->capacity) ? st->count : st->capacity;
+    if (n == 0) {
+        fprintf(stderr, "  %-18s n=0\n", label);
+        return;
+    }
+    uint32_t p50 = Bench_StatsPercentile(st, 50);
+    uint32_t p95 = Bench_StatsPercentile(st, 95);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum += st->samples[i];
+    }
+    fprintf(stderr, "  %-18s n=%lu avg=%.1f p50=%lu p95=%lu max=%lu %s\n",
+            label,
+            (unsigned long)st->count,
+            (double)sum / n,
+            (unsigned long)p50,
+            (unsigned long)p95,
+            (unsigned long)st->samples[n - 1],
+            unit);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "用法: %s <bench> [options]\n\n可用基准:\n", prog);
+    for (size_t i = 0; i < BENCH_COUNT; i++) {
+        fprintf(stderr, "  %-12s %s\n", k_benches[i].name, k_benches[i].summary);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (size_t i = 0; i < BENCH_COUNT; i++) {
+        if (strcmp(argv[1], k_benches[i].name) == 0) {
+            return k_benches[i].run(argc - 1, argv + 1);
+        }
+    }
+    usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file           : bench_ppm_lut.c
+ * @brief          : 浓度查找表（mq_curve.c）精度与耗时基准
+ ******************************************************************************
+ * @description    : 对每个 R0 逐个码值比较 MqCurve_Lookup 与浮点参考
+ *                   MqCurve_Reference，给出最大绝对误差、最大相对误差
+ *                   （仅统计参考值 ≥ 1 ppm 的码值），并对比两者的单次耗时。
+ *                   相对误差超过 --max-rel-pct 时返回非 0，可用作回归检查。
+ *
+ *                   用法：
+ *                     host_bench ppm_lut --bits 16 --max-rel-pct 0.5
+ *                     host_bench ppm_lut --r0 60
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "mq_curve.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 与 sensor_manager.c 中 MQ-3 的曲线参数一致 */
+static MqCurveParams_t mq3_params(float r0) {
+    MqCurveParams_t p = {
+        .a = 0.4f,
+        .b = -1.431f,
+        .rl_kohm = 10.0f,
+        .vc = 5.0f,
+        .v_full_scale = 3.3f * (5.0f / 3.0f),
+        .r0_kohm = r0,
+        .ppm_max = 1000.0f,
+    };
+    return p;
+}
+
+/**
+ * @brief 原采样路径：电压 → Rs（除法）→ powf
+ */
+static float float_path(const MqCurveParams_t* p, uint32_t code, uint8_t bits) {
+    float voltage = ((float)code / (float)(1u << bits)) * p->v_full_scale;
+    if (voltage <= 0.01f) {
+        voltage = 0.01f;
+    }
+    float rs = (p->vc - voltage) * p->rl_kohm / voltage;
+    float ppm = p->a * powf(rs / p->r0_kohm, p->b);
+    if (ppm < 0.0f) ppm = 0.0f;
+    if (ppm > p->ppm_max) ppm = p->ppm_max;
+    return ppm;
+}
+
+int Bench_PpmLut(int argc, char** argv) {
+    uint8_t bits = (uint8_t)Bench_ArgInt(argc, argv, "--bits", 16);
+    long r0_arg = Bench_ArgInt(argc, argv, "--r0", 0);
+    double max_rel_pct = atof(Bench_ArgStr(argc, argv, "--max-rel-pct", "0.5"));
+    uint32_t rounds = (uint32_t)Bench_ArgInt(argc, argv, "--rounds", 20);
+    const float k_r0_sweep[] = {5.0f, 20.0f, 60.0f, 200.0f};
+    float r0_list[4];
+    uint32_t n_r0 = 0;
+    int failed = 0;
+
+    if (r0_arg > 0) {
+        r0_list[n_r0++] = (float)r0_arg;
+    } else {
+        for (uint32_t i = 0; i < 4; i++) {
+            r0_list[n_r0++] = k_r0_sweep[i];
+        }
+    }
+
+    fprintf(stderr, "\n===== ppm_lut（%u 位码值，相对误差上限 %.3f%%） =====\n", bits, max_rel_pct);
+    for (uint32_t r = 0; r < n_r0; r++) {
+        MqCurveParams_t p = mq3_params(r0_list[r]);
+        static MqCurveLut_t lut;
+        uint32_t n_codes = 1u << bits;
+
+        uint64_t t0 = Bench_NowNs();
+        if (!MqCurve_Build(&lut, &p, bits)) {
+            fprintf(stderr, "  R0=%.0f: 建表失败\n", r0_list[r]);
+            failed = 1;
+            continue;
+        }
+        uint64_t build_ns = Bench_NowNs() - t0;
+
+        double max_abs = 0.0, max_rel = 0.0;
+        uint32_t at_abs = 0, at_rel = 0;
+        for (uint32_t c = 0; c < n_codes; c++) {
+            double ref = MqCurve_Reference(&p, c, bits);
+            double got = (double)MqCurve_Lookup(&lut, c) / (double)(1u << MQ_CURVE_PPM_FRAC_BITS);
+            double err = fabs(got - ref);
+            if (err > max_abs) {
+                max_abs = err;
+                at_abs = c;
+            }
+            if (ref >= 1.0 && err / ref > max_rel) {
+                max_rel = err / ref;
+                at_rel = c;
+            }
+        }
+
+        volatile float sink_f = 0.0f;
+        volatile uint32_t sink_q = 0;
+        t0 = Bench_NowNs();
+        for (uint32_t i = 0; i < rounds; i++) {
+            for (uint32_t c = 0; c < n_codes; c++) {
+                sink_f = float_path(&p, c, bits);
+            }
+        }
+        double float_ns = (double)(Bench_NowNs() - t0) / ((double)rounds * n_codes);
+        t0 = Bench_NowNs();
+        for (uint32_t i = 0; i < rounds; i++) {
+            for (uint32_t c = 0; c < n_codes; c++) {
+                sink_q = MqCurve_Lookup(&lut, c);
+            }
+        }
+        double lut_ns = (double)(Bench_NowNs() - t0) / ((double)rounds * n_codes);
+        (void)sink_f;
+        (void)sink_q;
+
+        int ok = (max_rel * 100.0) <= max_rel_pct;
+        failed |= !ok;
+        fprintf(stderr, "  R0=%5.0f kΩ: 最大绝对误差 %.3f ppm（码值 %lu），最大相对误差 %.3f%%（码值 %lu）%s\n",
+                r0_list[r], max_abs, (unsigned long)at_abs, max_rel * 100.0, (unsigned long)at_rel,
+                ok ? "" : "  ← 超限");
+        fprintf(stderr, "               建表 %.1f us，浮点 powf %.1f ns/次，查表 %.1f ns/次\n",
+                (double)build_ns / 1000.0, float_ns, lut_ns);
+    }
+    fprintf(stderr, "  表大小 %lu B\n", (unsigned long)sizeof(MqCurveLut_t));
+    return failed;
+}
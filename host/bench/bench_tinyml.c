@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file           : bench_tinyml.c
+ * @brief          : 板上分类器（tinyml.c + gas_model_weights.h）逐位校验与耗时基准
+ ******************************************************************************
+ * @description    : 测试向量由 tools/tinyml_export.py 与权重一同生成（gas_model_vectors.h），
+ *                   期望 logits 来自导出工具的 Python 整数参考。逐个向量运行
+ *                   TinyMl_Run 并逐字节比较，任何不一致都返回非 0，可用作回归检查；
+ *                   另给出单次推理耗时与模型的 RAM / Flash / 乘加数预算。
+ *
+ *                   用法：
+ *                     host_bench tinyml
+ *                     host_bench tinyml --rounds 20000
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "tinyml.h"
+#include "gas_model_weights.h"
+#include "gas_model_vectors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int Bench_TinyMl(int argc, char** argv) {
+    uint32_t rounds = (uint32_t)Bench_ArgInt(argc, argv, "--rounds", 5000);
+    static int8_t arena[GAS_MODEL_ARENA_BYTES];
+    int8_t logits[GAS_MODEL_N_CLASSES];
+    uint32_t mismatched = 0;
+    uint32_t hist[GAS_MODEL_N_CLASSES] = {0};
+
+    fprintf(stderr, "\n===== tinyml（%u×%u 输入，%u 类%s） =====\n",
+            GAS_MODEL_IN_FEATURES, GAS_MODEL_SEQ_LEN, GAS_MODEL_N_CLASSES,
+            GAS_MODEL_PLACEHOLDER ? "，占位模型" : "");
+    fprintf(stderr, "  层数 %u，乘加 %lu 次，工作区 %u B，权重 %u B\n",
+            k_gas_model.n_layers, (unsigned long)GAS_MODEL_MACS, GAS_MODEL_ARENA_BYTES, GAS_MODEL_WEIGHT_BYTES);
+
+    for (uint32_t v = 0; v < GAS_MODEL_VECTOR_COUNT; v++) {
+        if (!TinyMl_Run(&k_gas_model, k_gas_vec_in[v], arena, sizeof(arena), logits)) {
+            fprintf(stderr, "  向量 %lu：层表不合法\n", (unsigned long)v);
+            return 1;
+        }
+        if (memcmp(logits, k_gas_vec_logits[v], sizeof(logits)) != 0) {
+            if (mismatched++ < 4) {
+                fprintf(stderr, "  向量 %lu 不一致：", (unsigned long)v);
+                for (uint32_t c = 0; c < GAS_MODEL_N_CLASSES; c++) {
+                    fprintf(stderr, " %d/%d", logits[c], k_gas_vec_logits[v][c]);
+                }
+                fprintf(stderr, "（实际/期望）\n");
+            }
+        }
+        hist[TinyMl_Classify(&k_gas_model, logits, NULL)]++;
+    }
+    fprintf(stderr, "  逐位校验：%lu/%u 组一致\n",
+            (unsigned long)(GAS_MODEL_VECTOR_COUNT - mismatched), GAS_MODEL_VECTOR_COUNT);
+    fprintf(stderr, "  类别分布：");
+    for (uint32_t c = 0; c < GAS_MODEL_N_CLASSES; c++) {
+        fprintf(stderr, " %s=%lu", k_gas_model.class_names[c], (unsigned long)hist[c]);
+    }
+    fprintf(stderr, "\n");
+
+    volatile int8_t sink = 0;
+    uint64_t t0 = Bench_NowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        TinyMl_Run(&k_gas_model, k_gas_vec_in[r % GAS_MODEL_VECTOR_COUNT], arena, sizeof(arena), logits);
+        sink ^= logits[0];
+    }
+    uint64_t run_ns = Bench_NowNs() - t0;
+    (void)sink;
+    fprintf(stderr, "  单次推理 %.2f us（主机，%lu 轮）\n",
+            rounds ? (double)run_ns / rounds / 1000.0 : 0.0, (unsigned long)rounds);
+
+    return mismatched ? 1 : 0;
+}
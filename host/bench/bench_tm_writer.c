@@ -0,0 +1,402 @@
+/**
+ ******************************************************************************
+ * @file           : bench_tm_writer.c
+ * @brief          : 遥测序列化（tm_writer.c）逐字节校验与耗时基准
+ ******************************************************************************
+ * @description    : - 定点数：边界值（±0、恰为一半的舍入、次正规数、2^24 以上的整数、
+ *                     FLT_MAX、±inf）与随机位模式 / 常见量程的随机值，小数 0~6 位，
+ *                     逐字节对照 snprintf("%.*f", d, (double)v)；NaN 的符号各 libc 不同
+ *                     （glibc 输出 "-nan"，newlib 输出 "nan"），不参与对照；
+ *                   - 报文：HK（2 个传感器 + 下传原因字段）、暴露事件、历史页，分别用原先的
+ *                     snprintf 格式串与写入器生成，逐字节比较，并给出单包耗时与 CBOR 体积；
+ *                   - CBOR 已知向量、缓冲区不足时 Finish 返回 0、Mark / Rollback。
+ *                   任何不一致都返回非 0。
+ *
+ *                   用法：
+ *                     host_bench tm_writer
+ *                     host_bench tm_writer --count 2000000 --rounds 200000
+ ******************************************************************************
+ */
+
+#include "bench.h"
+
+#include "tm_writer.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TM_BENCH_BUF 256
+#define BENCH_HK_SENSORS 2
+
+static uint32_t g_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static float rnd_uniform(float lo, float hi) {
+    return lo + (hi - lo) * (float)(rnd() >> 8) / 16777216.0f;
+}
+
+/* 单个值逐位数对照，返回不一致数（只打印前几条） */
+static uint32_t check_fixed(float v, uint32_t* reported) {
+    uint32_t bad = 0;
+
+    for (uint8_t d = 0; d <= 6; d++) {
+        char ref[96];
+        char out[96];
+        int n = snprintf(ref, sizeof(ref), "%.*f", d, (double)v);
+        size_t m = TmWriter_FormatFixed(out, sizeof(out), v, d);
+        if (n < 0 || (size_t)n != m || memcmp(ref, out, m) != 0) {
+            bad++;
+            if ((*reported)++ < 8) {
+                uint32_t bits;
+                memcpy(&bits, &v, sizeof(bits));
+                fprintf(stderr, "    0x%08lx d=%u：\"%.*s\" / \"%s\"（实际/期望）\n", (unsigned long)bits, d,
+                        (int)m, out, ref);
+            }
+        }
+    }
+    return bad;
+}
+
+static uint32_t check_fixed_all(uint32_t count) {
+    static const float k_edges[] = {
+        0.0f, -0.0f, 0.5f, -0.5f, 1.5f, 2.5f, 0.125f, 0.375f, -0.125f, 0.005f, 0.0005f, 0.05f,
+        0.95f, 9.5f, 99.5f, 999.9999f, 1e-7f, 1.4e-45f, 1.1754942e-38f, 1.17549435e-38f,
+        16777216.0f, 16777217.0f, 1099511627776.0f, 9.2233720e18f, 1e20f, 3.4028235e38f,
+        -3.4028235e38f, 123.456f, -0.001f, 4294967296.0f,
+    };
+    uint32_t reported = 0;
+    uint32_t bad = 0;
+    uint32_t checked = 0;
+
+    for (size_t i = 0; i < sizeof(k_edges) / sizeof(k_edges[0]); i++, checked++) {
+        bad += check_fixed(k_edges[i], &reported);
+    }
+    bad += check_fixed(INFINITY, &reported);
+    bad += check_fixed(-INFINITY, &reported);
+    checked += 2;
+
+    /* 随机位模式（跳过 NaN）与常见量程（ppm、电压、比值） */
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t bits = rnd();
+        float v;
+        memcpy(&v, &bits, sizeof(v));
+        if (isnan(v)) {
+            continue;
+        }
+        bad += check_fixed(v, &reported);
+        bad += check_fixed(rnd_uniform(-1000.0f, 1000.0f), &reported);
+        bad += check_fixed(rnd_uniform(0.0f, 5.0f), &reported);
+        checked += 3;
+    }
+
+    char nan_text[8];
+    size_t nan_len = TmWriter_FormatFixed(nan_text, sizeof(nan_text), NAN, 2);
+    if (nan_len != 3 || memcmp(nan_text, "nan", 3) != 0) {
+        bad++;
+        fprintf(stderr, "    NaN 应输出 \"nan\"\n");
+    }
+
+    fprintf(stderr, "  定点数：%lu 个值 × 7 种小数位，对照 snprintf 不一致 %lu\n", (unsigned long)checked,
+            (unsigned long)bad);
+    return bad;
+}
+
+/* ========================= 代表性报文 ========================= */
+
+typedef struct {
+    const char* hk_key;
+    const char* ppm_key;
+    uint16_t adc;
+    float voltage;
+    float ppm;
+    int status;
+} BenchSensor_t;
+
+/* 两个传感器的 HK 正好放进一个 PUS 包；三个传感器时的心跳摘要由固件按 Mark/Rollback 省略 */
+static const BenchSensor_t k_sensors[BENCH_HK_SENSORS] = {
+    {"mq3", "alcohol_ppm", 1873, 1.509f, 23.4567f, 0},
+    {"mq7", "co_ppm", 64, 0.0516f, 0.0f, 1},
+};
+
+static int hk_snprintf(char* buf, size_t size, uint32_t counter) {
+    int n = snprintf(buf, size, "{\"counter\":%lu,\"adc\":%u,\"voltage\":%.3f", (unsigned long)counter,
+                     k_sensors[0].adc, k_sensors[0].voltage);
+    for (uint8_t id = 0; id < BENCH_HK_SENSORS; id++) {
+        const BenchSensor_t* s = &k_sensors[id];
+        n += snprintf(buf + n, size - (size_t)n, ",\"%s_adc\":%u,\"%s_voltage\":%.3f,\"%s\":%.2f", s->hk_key,
+                      s->adc, s->hk_key, s->voltage, s->ppm_key, s->ppm);
+        if (id > 0) {
+            n += snprintf(buf + n, size - (size_t)n, ",\"%s_status\":%d", s->hk_key, s->status);
+        }
+    }
+    n += snprintf(buf + n, size - (size_t)n, ",\"tx\":\"%s\",\"z\":%.1f,\"supp\":%lu", "heartbeat", 1.25f, 11ul);
+    n += snprintf(buf + n, size - (size_t)n, ",\"sensor_status\":%d}", k_sensors[0].status);
+    return n;
+}
+
+static size_t hk_writer(char* buf, size_t size, uint32_t counter, TmEncoding_t enc) {
+    TmWriter_t w;
+
+    TmWriter_Init(&w, buf, size, enc);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Uint(&w, "counter", counter);
+    TmWriter_Uint(&w, "adc", k_sensors[0].adc);
+    TmWriter_Fixed(&w, "voltage", k_sensors[0].voltage, 3);
+    for (uint8_t id = 0; id < BENCH_HK_SENSORS; id++) {
+        const BenchSensor_t* s = &k_sensors[id];
+        TmWriter_Key(&w, s->hk_key, "_adc");
+        TmWriter_Uint(&w, NULL, s->adc);
+        TmWriter_Key(&w, s->hk_key, "_voltage");
+        TmWriter_Fixed(&w, NULL, s->voltage, 3);
+        TmWriter_Fixed(&w, s->ppm_key, s->ppm, 2);
+        if (id > 0) {
+            TmWriter_Key(&w, s->hk_key, "_status");
+            TmWriter_Int(&w, NULL, s->status);
+        }
+    }
+    TmWriter_Str(&w, "tx", "heartbeat");
+    TmWriter_Fixed(&w, "z", 1.25f, 1);
+    TmWriter_Uint(&w, "supp", 11);
+    TmWriter_Int(&w, "sensor_status", k_sensors[0].status);
+    TmWriter_EndObject(&w);
+    return TmWriter_Finish(&w);
+}
+
+static const float k_exposure[10] = {18.25f, 412.5f, 0.8125f, 0.0472f, 12.3f, 4.06f, 37.9f, 55.125f, 141.7f, 2.0f};
+
+static int exposure_snprintf(char* buf, size_t size, uint32_t counter) {
+    const float* x = k_exposure;
+    return snprintf(buf, size,
+                    "{\"kind\":\"exposure\",\"sensor\":\"%s\",\"end\":\"%s\",\"ago\":%.1f,"
+                    "\"base\":%.2f,\"peak\":%.2f,\"dv\":%.3f,\"slope\":%.4f,\"t_rise\":%.1f,"
+                    "\"tau_rise\":%.1f,\"tau_rec\":%.1f,\"area\":%.2f,\"dur\":%.1f}",
+                    "mq3", (counter & 1u) ? "recovered" : "timeout", (float)counter / 1000.0f, x[0], x[1], x[2],
+                    x[3], x[4], x[5], x[6], x[7], x[8]);
+}
+
+static size_t exposure_writer(char* buf, size_t size, uint32_t counter, TmEncoding_t enc) {
+    static const char* const keys[9] = {"base", "peak", "dv", "slope", "t_rise", "tau_rise", "tau_rec", "area", "dur"};
+    static const uint8_t decimals[9] = {2, 2, 3, 4, 1, 1, 1, 2, 1};
+    TmWriter_t w;
+
+    TmWriter_Init(&w, buf, size, enc);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "exposure");
+    TmWriter_Str(&w, "sensor", "mq3");
+    TmWriter_Str(&w, "end", (counter & 1u) ? "recovered" : "timeout");
+    TmWriter_Fixed(&w, "ago", (float)counter / 1000.0f, 1);
+    for (uint8_t i = 0; i < 9; i++) {
+        TmWriter_Fixed(&w, keys[i], k_exposure[i], decimals[i]);
+    }
+    TmWriter_EndObject(&w);
+    return TmWriter_Finish(&w);
+}
+
+/* 历史页：与 SensorManager_FormatHistory 相同的结构与逐条放入规则 */
+#define BENCH_HISTORY_RECORDS 16
+
+static float history_value(uint32_t i, uint32_t k) {
+    return 20.0f + (float)((i * 7u + k * 13u) % 97u) * 1.37f;
+}
+
+static int history_snprintf(char* buf, size_t size, uint32_t counter) {
+    static const char tail[] = "],\"last\":0}";
+    int n = snprintf(buf, size, "{\"kind\":\"history\",\"sensor\":\"%s\",\"res\":%u,\"seq\":%u,\"now\":%lu,\"t0\":%lu,\"r\":[",
+                     "mq3", 10u, 3u, (unsigned long)counter, (unsigned long)(counter - 600000u));
+    uint32_t used = 0;
+    for (; used < BENCH_HISTORY_RECORDS; used++) {
+        char item[64];
+        int m = snprintf(item, sizeof(item), "%s[%lu,%.1f,%.1f,%.1f]", used ? "," : "",
+                         (unsigned long)(used * 10000u), history_value(used, 0), history_value(used, 1),
+                         history_value(used, 2));
+        if ((size_t)(n + m) + sizeof(tail) > size) {
+            break;
+        }
+        memcpy(buf + n, item, (size_t)m + 1);
+        n += m;
+    }
+    n += snprintf(buf + n, size - (size_t)n, "],\"last\":%d}", used == BENCH_HISTORY_RECORDS ? 0 : 1);
+    return n;
+}
+
+static size_t history_writer(char* buf, size_t size, uint32_t counter, TmEncoding_t enc) {
+    static const char tail[] = "],\"last\":0}";
+    TmWriter_t w;
+
+    TmWriter_Init(&w, buf, size, enc);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "history");
+    TmWriter_Str(&w, "sensor", "mq3");
+    TmWriter_Uint(&w, "res", 10);
+    TmWriter_Uint(&w, "seq", 3);
+    TmWriter_Uint(&w, "now", counter);
+    TmWriter_Uint(&w, "t0", counter - 600000u);
+    TmWriter_BeginArray(&w, "r");
+    TmWriter_Reserve(&w, (int32_t)sizeof(tail) - 1);
+    uint32_t used = 0;
+    for (; used < BENCH_HISTORY_RECORDS; used++) {
+        TmWriterMark_t mark = TmWriter_Mark(&w);
+        TmWriter_BeginArray(&w, NULL);
+        TmWriter_Uint(&w, NULL, used * 10000u);
+        TmWriter_Fixed(&w, NULL, history_value(used, 0), 1);
+        TmWriter_Fixed(&w, NULL, history_value(used, 1), 1);
+        TmWriter_Fixed(&w, NULL, history_value(used, 2), 1);
+        TmWriter_EndArray(&w);
+        if (!TmWriter_Ok(&w)) {
+            TmWriter_Rollback(&w, mark);
+            break;
+        }
+    }
+    TmWriter_Reserve(&w, -((int32_t)sizeof(tail) - 1));
+    TmWriter_EndArray(&w);
+    TmWriter_Uint(&w, "last", used == BENCH_HISTORY_RECORDS ? 0u : 1u);
+    TmWriter_EndObject(&w);
+    return TmWriter_Finish(&w);
+}
+
+typedef struct {
+    const char* name;
+    size_t buf_size;
+    int (*ref)(char* buf, size_t size, uint32_t counter);
+    size_t (*writer)(char* buf, size_t size, uint32_t counter, TmEncoding_t enc);
+} BenchPayload_t;
+
+static uint32_t bench_payload(const BenchPayload_t* p, uint32_t rounds) {
+    char ref[TM_BENCH_BUF];
+    char out[TM_BENCH_BUF];
+    uint8_t cbor[TM_BENCH_BUF];
+    uint32_t bad = 0;
+
+    /* 逐字节对照（counter 变化以覆盖不同位数） */
+    for (uint32_t c = 0; c < 2000u; c++) {
+        uint32_t counter = 600000u + c * 7919u;
+        int n = p->ref(ref, p->buf_size, counter);
+        size_t m = p->writer(out, p->buf_size, counter, TM_ENC_JSON);
+        if (n <= 0 || (size_t)n >= p->buf_size || (size_t)n != m || memcmp(ref, out, m + 1) != 0) {
+            if (bad++ == 0) {
+                fprintf(stderr, "    %s 不一致：\n      %s\n      %s\n", p->name, out, ref);
+            }
+        }
+    }
+
+    volatile size_t sink = 0;
+    uint64_t t0 = Bench_NowNs();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sink += (size_t)p->ref(ref, p->buf_size, 600000u + i);
+    }
+    uint64_t t1 = Bench_NowNs();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sink += p->writer(out, p->buf_size, 600000u + i, TM_ENC_JSON);
+    }
+    uint64_t t2 = Bench_NowNs();
+    (void)sink;
+
+    size_t json_len = p->writer(out, p->buf_size, 600000u, TM_ENC_JSON);
+    size_t cbor_len = p->writer((char*)cbor, sizeof(cbor), 600000u, TM_ENC_CBOR);
+    double ns_ref = (double)(t1 - t0) / rounds;
+    double ns_tm = (double)(t2 - t1) / rounds;
+    fprintf(stderr, "  %-10s %6.0f %6.0f %6.2fx %6lu %6lu %6.0f%%   %s\n", p->name, ns_ref, ns_tm,
+            ns_tm > 0.0 ? ns_ref / ns_tm : 0.0, (unsigned long)json_len, (unsigned long)cbor_len,
+            json_len ? 100.0 * (double)cbor_len / (double)json_len : 0.0, bad ? "不一致" : "一致");
+    return bad;
+}
+
+/* CBOR 已知向量、溢出与回退 */
+static uint32_t check_misc(void) {
+    static const uint8_t k_expect[] = {0xBF, 0x61, 'a', 0x01, 0x61, 'b', 0x9F, 0xC4, 0x82, 0x21, 0x18, 0x7D,
+                                       0x20, 0xFF, 0xFF};
+    uint8_t buf[64];
+    char text[16];
+    TmWriter_t w;
+    uint32_t bad = 0;
+
+    TmWriter_Init(&w, buf, sizeof(buf), TM_ENC_CBOR);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Uint(&w, "a", 1);
+    TmWriter_BeginArray(&w, "b");
+    TmWriter_Fixed(&w, NULL, 1.25f, 2);
+    TmWriter_Int(&w, NULL, -1);
+    TmWriter_EndArray(&w);
+    TmWriter_EndObject(&w);
+    size_t n = TmWriter_Finish(&w);
+    if (n != sizeof(k_expect) || memcmp(buf, k_expect, n) != 0) {
+        bad++;
+        fprintf(stderr, "    CBOR 已知向量不一致（%lu 字节）\n", (unsigned long)n);
+    }
+
+    /* {"k":"ab"} 需 11 字节（含 '\0'）：10 字节放不下，不得输出截断报文 */
+    for (size_t size = 10; size <= 11; size++) {
+        TmWriter_Init(&w, text, size, TM_ENC_JSON);
+        TmWriter_BeginObject(&w, NULL);
+        TmWriter_Str(&w, "k", "ab");
+        TmWriter_EndObject(&w);
+        n = TmWriter_Finish(&w);
+        if ((size == 10 && n != 0) || (size == 11 && (n != 10 || strcmp(text, "{\"k\":\"ab\"}") != 0))) {
+            bad++;
+            fprintf(stderr, "    缓冲区 %lu 字节时 Finish 返回 %lu\n", (unsigned long)size, (unsigned long)n);
+        }
+    }
+
+    /* 可选字段放不下时回退，必需字段照常闭合 */
+    TmWriter_Init(&w, text, sizeof(text), TM_ENC_JSON);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Uint(&w, "a", 1);
+    TmWriterMark_t mark = TmWriter_Mark(&w);
+    TmWriter_Str(&w, "opt", "0123456789");
+    if (TmWriter_Ok(&w)) {
+        bad++;
+    }
+    TmWriter_Rollback(&w, mark);
+    TmWriter_Uint(&w, "b", 2);
+    TmWriter_EndObject(&w);
+    n = TmWriter_Finish(&w);
+    if (n == 0 || strcmp(text, "{\"a\":1,\"b\":2}") != 0) {
+        bad++;
+        fprintf(stderr, "    Mark/Rollback 后报文不正确\n");
+    }
+
+    /* 转义 */
+    TmWriter_Init(&w, text, sizeof(text), TM_ENC_JSON);
+    TmWriter_Str(&w, NULL, "a\"\\\n");
+    n = TmWriter_Finish(&w);
+    if (n == 0 || strcmp(text, "\"a\\\"\\\\\\u000a\"") != 0) {
+        bad++;
+        fprintf(stderr, "    字符串转义不正确：%s\n", text);
+    }
+
+    fprintf(stderr, "  CBOR 已知向量 / 溢出 / 回退 / 转义：%s\n", bad ? "失败" : "通过");
+    return bad;
+}
+
+int Bench_TmWriter(int argc, char** argv) {
+    uint32_t count = (uint32_t)Bench_ArgInt(argc, argv, "--count", 300000);
+    uint32_t rounds = (uint32_t)Bench_ArgInt(argc, argv, "--rounds", 100000);
+    static const BenchPayload_t k_payloads[] = {
+        {"hk", 242, hk_snprintf, hk_writer},
+        {"exposure", 242, exposure_snprintf, exposure_writer},
+        {"history", 242, history_snprintf, history_writer},
+    };
+    uint32_t bad = 0;
+
+    if (rounds == 0) {
+        rounds = 1;
+    }
+    fprintf(stderr, "\n===== tm_writer =====\n");
+    bad += check_fixed_all(count);
+    bad += check_misc();
+
+    fprintf(stderr, "\n  报文（ns/包，%lu 轮；CBOR 为同一内容的二进制编码）\n", (unsigned long)rounds);
+    fprintf(stderr, "  %-10s %6s %6s %7s %6s %6s %7s\n", "报文", "printf", "writer", "加速", "JSON", "CBOR", "体积");
+    for (size_t i = 0; i < sizeof(k_payloads) / sizeof(k_payloads[0]); i++) {
+        bad += bench_payload(&k_payloads[i], rounds);
+    }
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file           : gas_model_vectors.h
+ * @brief          : gas_model_weights.h 的整数参考测试向量 —— 由 tools/tinyml_export.py 生成，勿手改
+ ******************************************************************************
+ */
+
+#ifndef __GAS_MODEL_VECTORS_H
+#define __GAS_MODEL_VECTORS_H
+
+#include <stdint.h>
+
+#define GAS_MODEL_VECTOR_COUNT 32
+
+static const int8_t k_gas_vec_in[32][16] = {
+    {48, 54, 2, -29, -41, 1, -38, -54, 7, 5, 20, -34, 0, -2, -56, 20},
+    {12, 89, 8, -5, 46, 7, 34, -14, 8, 38, 26, 5, -40, 17, 3, 27},
+    {8, 41, -2, 8, 25, -41, -15, -19, 74, -3, 24, 23, -10, -58, 36, -15},
+    {27, -49, -16, 47, 53, -49, -50, -2, 27, 6, 11, -37, 22, 42, -16, -54},
+    {-28, 28, -65, -3, -37, -5, -9, 1, 56, 16, 50, -5, -18, 14, -106, -1},
+    {6, -46, 17, -21, -92, -8, -37, -19, -6, 47, 4, -1, 15, -68, 46, -40},
+    {16, -42, -36, -15, 71, 26, -23, -11, -43, -1, -21, 27, -51, -12, -31, -27},
+    {27, 5, 22, 44, 43, -51, 20, -66, -2, 72, -7, -14, 6, 1, 1, -28},
+    {40, 33, -8, 12, 25, 39, 15, 26, -10, -40, -18, 38, 37, 5, -21, 11},
+    {62, 51, -26, -2, -54, -42, 7, 1, 36, 47, 31, 49, -20, -42, 19, 100},
+    {13, -43, 9, 53, -39, 30, -23, 48, 29, 11, 75, -15, -26, 69, -33, 82},
+    {-1, -39, 0, 5, 8, -7, 40, -87, -21, -10, 68, -74, -13, -43, -25, 24},
+    {15, 54, -22, 10, 44, 34, -13, 42, -35, 67, 6, -4, 10, 32, 65, -5},
+    {-14, 22, -33, -63, 31, -14, 42, -38, -108, 11, 6, 60, 20, 12, 22, -14},
+    {3, -50, 19, -30, -17, 26, 34, -38, 75, -22, 31, 36, 8, 6, 67, 33},
+    {17, -68, -28, 43, 7, -36, -24, -11, 26, 14, 37, -31, 37, -19, -11, 65},
+    {3, -5, -8, -14, 58, 51, 27, 7, 39, -3, 17, 15, 3, 62, 66, 49},
+    {-71, 69, 26, -17, -1, 43, 44, 32, 5, 1, 31, -3, -34, -23, -5, 12},
+    {85, -51, 18, -3, 11, 51, 46, -6, -21, -51, -3, 47, -10, 26, 26, 15},
+    {40, -4, -31, -44, 35, -14, -12, 31, -29, 66, 25, -20, -24, 40, -44, -24},
+    {0, 8, 1, 14, -14, -5, 47, 24, -17, 64, -74, 3, 25, 36, 4, -14},
+    {22, -7, 18, -107, 14, -30, 35, 28, 27, -15, 16, -13, 8, -5, -33, 74},
+    {27, -77, 33, -52, -9, -22, -20, 9, -12, -54, 0, 14, 66, -15, -44, -14},
+    {24, -33, -27, 21, 0, 8, -23, -31, -12, -6, -12, 16, 20, 20, 18, -33},
+    {-42, 30, 0, 5, -43, -8, -24, -32, -24, -56, 3, 44, -26, 4, -41, 25},
+    {70, -46, -8, 53, 14, 4, -76, -6, 34, 54, 24, -22, -26, -68, -40, 42},
+    {-4, -50, 49, -62, 47, -12, 13, 25, 10, 47, 1, -12, -25, -54, -26, 37},
+    {31, 52, 102, 27, 19, -49, -9, 82, 20, -5, 12, -71, -31, -49, -80, 29},
+    {36, -7, 13, -38, 17, 29, 57, 58, 18, -5, -31, -23, 23, 21, 1, 62},
+    {24, 1, -7, 3, -35, -37, 13, -22, -10, 46, -7, 49, 0, 57, 17, -66},
+    {46, -8, -73, 4, 6, -48, -23, 20, 53, 43, 46, 42, -93, -27, 7, -100},
+    {29, 33, -29, -14, -35, -1, -2, 0, -38, 14, -13, 35, 12, -55, -54, 3},
+};
+
+static const int8_t k_gas_vec_logits[32][7] = {
+    {-43, 3, 6, 19, 32, -20, 58},
+    {-70, 11, -6, 13, 41, -18, 77},
+    {-51, 11, 3, 12, 45, -11, 73},
+    {-50, 0, -3, 27, 41, -20, 68},
+    {-54, 7, -2, 20, 43, -16, 66},
+    {-56, 1, 4, 24, 41, -28, 71},
+    {-58, -2, -7, 19, 42, -18, 77},
+    {-55, 8, -2, 34, 50, -32, 63},
+    {-57, 9, -5, 18, 37, -18, 59},
+    {-79, 0, -10, 21, 35, -22, 75},
+    {-87, -1, -9, 12, 46, -27, 99},
+    {-50, -13, -7, 28, 40, -25, 75},
+    {-86, 12, -12, 21, 54, -21, 101},
+    {-80, 3, -11, 21, 50, -28, 86},
+    {-71, 1, -12, 13, 40, -16, 85},
+    {-66, -2, -7, 15, 33, -21, 70},
+    {-56, 5, -7, 9, 35, -12, 63},
+    {-69, 15, -2, 22, 39, -17, 72},
+    {-63, -4, -9, 14, 40, -28, 70},
+    {-57, -7, -10, 22, 36, -25, 72},
+    {-58, 1, -5, 17, 44, -19, 71},
+    {-70, -8, -9, 36, 45, -41, 84},
+    {-55, -2, 1, 28, 39, -28, 76},
+    {-33, -1, 1, 13, 22, -20, 44},
+    {-64, 8, 0, 23, 34, -18, 67},
+    {-63, 9, -4, 16, 44, -18, 66},
+    {-60, 0, -6, 10, 37, -16, 75},
+    {-69, 9, -9, 35, 50, -35, 71},
+    {-60, 8, -9, 31, 41, -34, 60},
+    {-49, -4, -7, 20, 33, -26, 60},
+    {-84, 10, -8, 32, 50, -24, 84},
+    {-48, 4, -2, 25, 31, -22, 53},
+};
+
+#endif /* __GAS_MODEL_VECTORS_H */
@@ -0,0 +1,574 @@
+/**
+ ******************************************************************************
+ * @file           : hal_host.c
+ * @brief          : 主机端 HAL 垫片实现（Linux）
+ ******************************************************************************
+ */
+
+#include "stm32f4xx_hal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_ESP_TTY_ENV "SPACENOSE_ESP_TTY"
+#define HOST_ESP_TTY_DEFAULT "/tmp/spacenose-esp8266"
+
+USART_TypeDef host_usart1 = {-1};
+USART_TypeDef host_usart2 = {-1};
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+ADC_TypeDef host_adc1;
+TIM_TypeDef host_tim2;
+GPIO_TypeDef host_gpiof;
+uint32_t SystemCoreClock = 168000000u;
+
+#define HOST_TIM_CLOCK_HZ 84000000ull   /* 与固件一致：APB1 定时器时钟 84MHz */
+#define HOST_ADC_CHANNELS 19
+
+/* ADC1 + TIM2 扫描仿真 */
+static ADC_HandleTypeDef* g_adc = NULL;      /* 已 HAL_ADC_Start_DMA */
+static uint16_t* g_adc_buf = NULL;
+static uint32_t g_adc_len = 0;               /* DMA 传输数（半字） */
+static uint32_t g_adc_pos = 0;               /* 下一次写入位置 */
+static uint8_t g_adc_nranks = 0;
+static TIM_HandleTypeDef* g_tim = NULL;      /* 已 HAL_TIM_Base_Start */
+static uint64_t g_tim_next_us = 0;           /* 下一次 TRGO 时刻 */
+static uint16_t g_adc_values[HOST_ADC_CHANNELS];
+static uint8_t g_adc_in_service = 0;
+
+/* 已调用 HAL_UART_Receive_IT、等待字节的句柄 */
+static UART_HandleTypeDef* g_rx_pending[2] = {NULL, NULL};
+
+/* 已调用 HAL_UART_Transmit_DMA、等待派发完成回调的句柄 */
+static UART_HandleTypeDef* g_tx_pending[2] = {NULL, NULL};
+
+/* DMA 发送完成时刻（虚拟时钟下按波特率计算；单调时钟下为 0，下一次派发即完成） */
+static uint64_t g_tx_done_us[2] = {0, 0};
+
+static struct timespec g_start_ts;
+static uint8_t g_started = 0;
+
+/* 虚拟时钟（HostHal_UseVirtualClock） */
+static const HostHalClock_t* g_vclock = NULL;
+static uint64_t g_vclock_us = 0;
+static const HostHalUartPeer_t* g_peer[2] = {NULL, NULL};
+static uint32_t g_uid0 = 0;
+
+static void clock_start(void) {
+    if (!g_started) {
+        clock_gettime(CLOCK_MONOTONIC, &g_start_ts);
+        g_started = 1;
+    }
+}
+
+static int open_tty(const char* path) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        fprintf(stderr, "[host-hal] 无法打开 %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static uint64_t now_us(void) {
+    if (g_vclock != NULL) {
+        return g_vclock_us;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - g_start_ts.tv_sec) * 1000000ull
+         + (uint64_t)((now.tv_nsec - g_start_ts.tv_nsec) / 1000);
+}
+
+static uint64_t tim_period_us(const TIM_HandleTypeDef* htim) {
+    uint64_t ticks = (uint64_t)(htim->Init.Prescaler + 1) * (uint64_t)(htim->Init.Period + 1);
+    uint64_t us = ticks * 1000000ull / HOST_TIM_CLOCK_HZ;
+    return us > 0 ? us : 1;
+}
+
+/**
+ * @brief 模拟看门狗：被监视通道越出窗口即置位 AWD 标志，已开中断则立即进 ADC 中断
+ */
+static void adc_watchdog_check(ADC_HandleTypeDef* hadc, uint32_t ch, uint16_t value) {
+    const ADC_AnalogWDGConfTypeDef* awd = &hadc->awd;
+    if (awd->WatchdogMode != ADC_ANALOGWATCHDOG_SINGLE_REG || awd->Channel != ch) {
+        return;
+    }
+    if (value > awd->HighThreshold || value < awd->LowThreshold) {
+        hadc->flags |= ADC_FLAG_AWD;
+        if (hadc->it_enabled & ADC_IT_AWD) {
+            HAL_ADC_IRQHandler(hadc);
+        }
+    }
+}
+
+/**
+ * @brief 补齐到当前时刻为止应发生的 TRGO：每次扫描写满一帧，越过半满/全满点时派发回调
+ */
+static void adc_service(void) {
+    if (g_adc == NULL || g_tim == NULL || g_adc_nranks == 0 || g_adc_in_service) {
+        return;
+    }
+    g_adc_in_service = 1;
+    uint64_t now = now_us();
+    uint64_t period = tim_period_us(g_tim);
+    uint32_t burst = 0;
+    while (g_tim_next_us <= now && g_adc != NULL && burst++ < 1000) {
+        g_tim_next_us += period;
+        for (uint8_t r = 0; r < g_adc_nranks; r++) {
+            uint32_t ch = g_adc->channels[r];
+            uint16_t value = (ch < HOST_ADC_CHANNELS) ? g_adc_values[ch] : 0;
+            g_adc_buf[g_adc_pos] = value;
+            g_adc_pos++;
+            adc_watchdog_check(g_adc, ch, value);
+            if (g_adc_pos == g_adc_len / 2) {
+                HAL_ADC_ConvHalfCpltCallback(g_adc);
+            } else if (g_adc_pos == g_adc_len) {
+                g_adc_pos = 0;
+                HAL_ADC_ConvCpltCallback(g_adc);
+            }
+            if (g_adc == NULL) {
+                break;
+            }
+        }
+    }
+    if (g_tim_next_us <= now) {
+        g_tim_next_us = now + period;   /* 进程被挂起过久：丢弃积压的触发 */
+    }
+    g_adc_in_service = 0;
+}
+
+static int rx_slot(const UART_HandleTypeDef* huart) {
+    return (huart->Instance == USART2) ? 1 : 0;
+}
+
+/* 按 8N1（每字节 10 位）计算发送 len 字节所需的时间 */
+static uint64_t uart_bytes_us(const UART_HandleTypeDef* huart, uint32_t len) {
+    uint32_t baud = (huart->Init.BaudRate != 0) ? huart->Init.BaudRate : 115200u;
+    return (uint64_t)len * 10000000ull / baud;
+}
+
+/* 虚拟时钟下一个事件：TIM2 触发、DMA 发送完成、外部模型 */
+static uint64_t vclock_next_event(void) {
+    uint64_t next = UINT64_MAX;
+    if (g_adc != NULL && g_tim != NULL && g_adc_nranks != 0 && g_tim_next_us < next) {
+        next = g_tim_next_us;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (g_tx_pending[i] != NULL && g_tx_done_us[i] < next) {
+            next = g_tx_done_us[i];
+        }
+    }
+    if (g_vclock->next_event_us != NULL) {
+        uint64_t ext = g_vclock->next_event_us();
+        if (ext < next) {
+            next = ext;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief 虚拟时钟逐事件推进到 target_us，每到一个事件派发一次“中断”
+ */
+static void vclock_run_until(uint64_t target_us) {
+    while (g_vclock_us < target_us) {
+        uint64_t next = vclock_next_event();
+        if (next > target_us) {
+            next = target_us;
+        } else if (next <= g_vclock_us) {
+            next = g_vclock_us + 1;   // 模型事件已过期：至少前进 1 µs，防止原地打转
+        }
+        g_vclock_us = next;
+        if (g_vclock->advance != NULL) {
+            g_vclock->advance(g_vclock_us);
+        }
+        HostHal_ServiceIO();
+    }
+}
+
+HAL_StatusTypeDef HAL_Init(void) {
+    clock_start();
+    return HAL_OK;
+}
+
+void HAL_IncTick(void) {
+}
+
+uint32_t HAL_GetUIDw0(void) {
+    return (g_uid0 != 0) ? g_uid0 : (uint32_t)getpid();
+}
+
+uint32_t HAL_GetUIDw1(void) {
+    return 0x484F5354u;   // "HOST"
+}
+
+uint32_t HAL_GetUIDw2(void) {
+    return 0x53504E53u;   // "SPNS"
+}
+
+void HostHal_ServiceIO(void) {
+    adc_service();
+
+    /* 回调里可能立即发起下一次 DMA 发送，逐个取出后再派发 */
+    for (int i = 0; i < 2; i++) {
+        UART_HandleTypeDef* huart = g_tx_pending[i];
+        if (huart != NULL && now_us() >= g_tx_done_us[i]) {
+            g_tx_pending[i] = NULL;
+            HAL_UART_TxCpltCallback(huart);
+        }
+    }
+
+    for (int i = 0; i < 2; i++) {
+        UART_HandleTypeDef* huart = g_rx_pending[i];
+        if (huart == NULL || (g_peer[i] == NULL && huart->Instance->fd < 0)) {
+            continue;
+        }
+        /* 每次只交付登记的一段，交付后由回调重新登记（与中断接收语义一致） */
+        while (g_rx_pending[i] == huart && huart->RxXferCount > 0) {
+            if (g_peer[i] != NULL) {
+                if (!g_peer[i]->read(huart->pRxBuffPtr)) {
+                    break;
+                }
+            } else if (read(huart->Instance->fd, huart->pRxBuffPtr, 1) != 1) {
+                break;
+            }
+            huart->pRxBuffPtr++;
+            huart->RxXferCount--;
+            if (huart->RxXferCount == 0) {
+                g_rx_pending[i] = NULL;
+                HAL_UART_RxCpltCallback(huart);
+            }
+        }
+    }
+}
+
+uint32_t HAL_GetTick(void) {
+    clock_start();
+    if (g_vclock != NULL) {
+        g_vclock_us++;   // 每次读取计 1 µs，忙等节拍的循环也能前进
+        HostHal_ServiceIO();
+        return (uint32_t)(g_vclock_us / 1000u);
+    }
+    HostHal_ServiceIO();
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t ms = (int64_t)(now.tv_sec - g_start_ts.tv_sec) * 1000
+               + (now.tv_nsec - g_start_ts.tv_nsec) / 1000000;
+    return (uint32_t)ms;
+}
+
+void HAL_Delay(uint32_t Delay) {
+    if (g_vclock != NULL) {
+        vclock_run_until(g_vclock_us + (uint64_t)Delay * 1000u);
+        return;
+    }
+    uint32_t start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < Delay) {
+        struct timespec ts = {0, 200000}; /* 0.2ms：兼顾串口接收及时性与 CPU 占用 */
+        nanosleep(&ts, NULL);
+    }
+}
+
+void __WFI(void) {
+    if (g_vclock != NULL) {
+        vclock_run_until((g_vclock_us / 1000u + 1u) * 1000u);   // 下一个 SysTick
+        return;
+    }
+    struct timespec ts = {0, 200000};
+    nanosleep(&ts, NULL);
+    HostHal_ServiceIO();
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart) {
+    if (huart == NULL || huart->Instance == NULL) {
+        return HAL_ERROR;
+    }
+    clock_start();
+
+    if (huart->Instance == USART1) {
+        huart->Instance->fd = STDOUT_FILENO;
+        return HAL_OK;
+    }
+
+    if (g_peer[rx_slot(huart)] != NULL) {
+        return HAL_OK;
+    }
+    if (huart->Instance->fd < 0) {
+        const char* path = getenv(HOST_ESP_TTY_ENV);
+        if (path == NULL || path[0] == '\0') {
+            path = HOST_ESP_TTY_DEFAULT;
+        }
+        huart->Instance->fd = open_tty(path);
+    }
+    return (huart->Instance->fd >= 0) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    if (huart == NULL || huart->Instance == NULL || pData == NULL) {
+        return HAL_ERROR;
+    }
+    if (huart->Instance == USART1) {
+        fwrite(pData, 1, Size, stdout);
+        if (g_vclock == NULL) {
+            fflush(stdout);
+        }
+        return HAL_OK;
+    }
+
+    const HostHalUartPeer_t* peer = g_peer[rx_slot(huart)];
+    if (peer != NULL) {
+        /* 阻塞发送：发完最后一个字节才返回，期间照常派发接收 */
+        if (g_vclock != NULL) {
+            vclock_run_until(g_vclock_us + uart_bytes_us(huart, Size));
+        }
+        peer->write(pData, Size);
+        return HAL_OK;
+    }
+
+    int fd = huart->Instance->fd;
+    if (fd < 0) {
+        return HAL_ERROR;
+    }
+    uint16_t sent = 0;
+    while (sent < Size) {
+        ssize_t n = write(fd, pData + sent, (size_t)(Size - sent));
+        if (n > 0) {
+            sent = (uint16_t)(sent + n);
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            return HAL_ERROR;
+        } else {
+            /* 发送缓冲满：等待对端读走，同时继续派发接收 */
+            HostHal_ServiceIO();
+            usleep(100);
+        }
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+    if (huart == NULL || pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxXferCount = Size;
+    g_rx_pending[rx_slot(huart)] = huart;
+    return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart) {
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+    (void)huart;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    if (huart == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    int slot = rx_slot(huart);
+    if (g_tx_pending[slot] != NULL) {
+        return HAL_BUSY;
+    }
+    /* 数据立即写出，完成回调按波特率延后（虚拟时钟下；本项目只有 USART1 日志使用 DMA 发送） */
+    uint64_t start = now_us();
+    HAL_StatusTypeDef st = HAL_UART_Transmit(huart, pData, Size, HAL_MAX_DELAY);
+    if (st == HAL_OK) {
+        g_tx_pending[slot] = huart;
+        g_tx_done_us[slot] = (g_vclock != NULL) ? start + uart_bytes_us(huart, Size) : 0;
+    }
+    return st;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma) {
+    (void)hdma;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+    (void)huart;
+}
+
+/* ----------------- ADC / TIM ----------------- */
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig) {
+    if (hadc == NULL || sConfig == NULL || sConfig->Rank == 0 || sConfig->Rank > HOST_ADC_MAX_RANKS) {
+        return HAL_ERROR;
+    }
+    hadc->channels[sConfig->Rank - 1] = sConfig->Channel;
+    if (sConfig->Rank > g_adc_nranks) {
+        g_adc_nranks = (uint8_t)sConfig->Rank;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length) {
+    if (hadc == NULL || pData == NULL || Length == 0) {
+        return HAL_ERROR;
+    }
+    g_adc_buf = (uint16_t*)pData;
+    g_adc_len = Length;
+    g_adc_pos = 0;
+    g_adc = hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc) {
+    if (g_adc == hadc) {
+        g_adc = NULL;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef* hadc, ADC_AnalogWDGConfTypeDef* AnalogWDGConfig) {
+    if (hadc == NULL || AnalogWDGConfig == NULL ||
+        AnalogWDGConfig->HighThreshold > 0x0FFF || AnalogWDGConfig->LowThreshold > 0x0FFF) {
+        return HAL_ERROR;
+    }
+    hadc->awd = *AnalogWDGConfig;
+    if (AnalogWDGConfig->ITMode == ENABLE) {
+        __HAL_ADC_ENABLE_IT(hadc, ADC_IT_AWD);
+    } else {
+        __HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
+    }
+    return HAL_OK;
+}
+
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc) {
+    if ((hadc->flags & ADC_FLAG_AWD) && (hadc->it_enabled & ADC_IT_AWD)) {
+        HAL_ADC_LevelOutOfWindowCallback(hadc);
+        __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_AWD);
+    }
+}
+
+__attribute__((weak)) void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+__attribute__((weak)) void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc) {
+    (void)hadc;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim) {
+    if (htim == NULL) {
+        return HAL_ERROR;
+    }
+    clock_start();
+    g_tim = htim;
+    g_tim_next_us = now_us() + tim_period_us(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim) {
+    if (g_tim == htim) {
+        g_tim = NULL;
+    }
+    return HAL_OK;
+}
+
+void HostHal_SetAdcValue(uint32_t channel, uint16_t value) {
+    if (channel < HOST_ADC_CHANNELS) {
+        g_adc_values[channel] = (uint16_t)(value & 0x0FFF);
+    }
+}
+
+void HostHal_SetUid(uint32_t w0) {
+    g_uid0 = w0;
+}
+
+void HostHal_UseVirtualClock(const HostHalClock_t* clock) {
+    g_vclock = clock;
+    g_vclock_us = 0;
+    g_started = 1;
+}
+
+uint64_t HostHal_Micros(void) {
+    clock_start();
+    return now_us();
+}
+
+void HostHal_SetUartPeer(USART_TypeDef* instance, const HostHalUartPeer_t* peer) {
+    g_peer[(instance == USART2) ? 1 : 0] = peer;
+}
+
+/* ----------------- 时钟 / GPIO / NVIC / 外设初始化（空操作） ----------------- */
+
+void SystemCoreClockUpdate(void) {
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct) {
+    (void)RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency) {
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+    return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init) {
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    (void)IRQn;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc) {
+    return (hadc != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim) {
+    return (htim != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* sMasterConfig) {
+    (void)sMasterConfig;
+    return (htim != NULL) ? HAL_OK : HAL_ERROR;
+}
@@ -0,0 +1,414 @@
+/**
+ ******************************************************************************
+ * @file           : stm32f4xx_hal.h
+ * @brief          : 主机端 HAL 垫片（Linux）
+ ******************************************************************************
+ * @description    : 在 PC 上编译固件模块时替代 STM32Cube HAL，只提供本项目
+ *                   实际用到的类型与函数子集：
+ *                   - HAL_GetTick / HAL_Delay：基于单调时钟的毫秒节拍；__WFI 短暂休眠
+ *                   - USART1：调试串口 → 标准输出
+ *                   - USART2：ESP8266 串口 → 伪终端/串口设备
+ *                     （路径取自环境变量 SPACENOSE_ESP_TTY，
+ *                      通常由 tools/esp8266_emu.py 创建）
+ *                   接收“中断”在 HAL_GetTick/HAL_Delay 内部同步派发，
+ *                   行为与 HAL_UART_Receive_IT + HAL_UART_RxCpltCallback 一致；
+ *                   HAL_UART_Transmit_DMA 立即写出，完成回调同样延后到
+ *                   下一次 HAL_GetTick/HAL_Delay 中派发。
+ *                   - ADC1 + TIM2：按 TIM2 周期（定时器时钟 84MHz）在
+ *                     HAL_GetTick/HAL_Delay 中补齐应完成的扫描帧，写入 DMA 缓冲并
+ *                     派发半满/全满回调；各通道读数由 HostHal_SetAdcValue 设置；
+ *                     模拟看门狗逐次比较被监视通道，越出窗口且已开中断时
+ *                     经 HAL_ADC_IRQHandler 派发 HAL_ADC_LevelOutOfWindowCallback。
+ ******************************************************************************
+ */
+
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_HAL 1
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+typedef enum {
+    DISABLE = 0U,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+/* 单线程模拟：“中断”只在 HAL 调用内同步派发，临界区与屏障均为空操作 */
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline void __DMB(void) {}
+
+/* 等待中断：休眠 0.2 ms 后派发期间到达的串口/ADC“中断”（与 HAL_Delay 的轮询粒度一致）；
+ * 虚拟时钟下推进到下一个 SysTick（1 ms 边界） */
+void __WFI(void);
+
+/* DWT 周期计数器：主机端不计数（读数恒为 0），耗时请用 host_bench 按墙钟测量 */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+#define DWT (&host_dwt)
+#define CoreDebug (&host_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+/* ----------------- DMA ----------------- */
+
+typedef struct {
+    void* Instance;               /* 主机端不使用 */
+} DMA_HandleTypeDef;
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma);
+
+/* ----------------- UART ----------------- */
+
+typedef struct {
+    int fd;                       /* 主机端文件描述符（-1 表示未打开） */
+} USART_TypeDef;
+
+extern USART_TypeDef host_usart1;
+extern USART_TypeDef host_usart2;
+
+#define USART1 (&host_usart1)
+#define USART2 (&host_usart2)
+
+#define UART_WORDLENGTH_8B     0x00000000U
+#define UART_STOPBITS_1        0x00000000U
+#define UART_PARITY_NONE       0x00000000U
+#define UART_MODE_TX_RX        0x0000000CU
+#define UART_HWCONTROL_NONE    0x00000000U
+#define UART_OVERSAMPLING_16   0x00000000U
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+    USART_TypeDef* Instance;
+    UART_InitTypeDef Init;
+    uint8_t* pRxBuffPtr;          /* HAL_UART_Receive_IT 登记的接收缓冲 */
+    uint16_t RxXferSize;
+    uint16_t RxXferCount;
+    DMA_HandleTypeDef* hdmatx;
+} UART_HandleTypeDef;
+
+/* ----------------- ADC / TIM（定时器触发扫描 + 循环 DMA） ----------------- */
+
+typedef struct {
+    int unused;
+} ADC_TypeDef;
+
+typedef struct {
+    int unused;
+} TIM_TypeDef;
+
+extern ADC_TypeDef host_adc1;
+extern TIM_TypeDef host_tim2;
+
+#define ADC1 (&host_adc1)
+#define TIM2 (&host_tim2)
+
+#define ADC_CHANNEL_0  0x00000000U
+#define ADC_CHANNEL_1  0x00000001U
+#define ADC_CHANNEL_2  0x00000002U
+#define ADC_CHANNEL_3  0x00000003U
+#define ADC_CHANNEL_4  0x00000004U
+#define ADC_CHANNEL_5  0x00000005U
+#define ADC_CHANNEL_6  0x00000006U
+#define ADC_CHANNEL_7  0x00000007U
+
+#define ADC_SAMPLETIME_84CYCLES 0x00000004U
+
+#define ADC_ANALOGWATCHDOG_NONE       0x00000000U
+#define ADC_ANALOGWATCHDOG_SINGLE_REG 0x00800200U
+#define ADC_IT_AWD   0x00000040U
+#define ADC_FLAG_AWD 0x00000001U
+
+#define HOST_ADC_MAX_RANKS 16
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct {
+    uint32_t WatchdogMode;
+    uint32_t HighThreshold;
+    uint32_t LowThreshold;
+    uint32_t Channel;
+    uint32_t ITMode;
+    uint32_t WatchdogNumber;
+} ADC_AnalogWDGConfTypeDef;
+
+#define ADC_CLOCK_SYNC_PCLK_DIV4         0x00010000U
+#define ADC_RESOLUTION_12B               0x00000000U
+#define ADC_EXTERNALTRIGCONVEDGE_RISING  0x10000000U
+#define ADC_EXTERNALTRIGCONV_T2_TRGO     0x06000000U
+#define ADC_DATAALIGN_RIGHT              0x00000000U
+#define ADC_EOC_SEQ_CONV                 0x00000000U
+
+typedef struct {
+    uint32_t ClockPrescaler;
+    uint32_t Resolution;
+    uint32_t DataAlign;
+    uint32_t ScanConvMode;
+    uint32_t EOCSelection;
+    FunctionalState ContinuousConvMode;
+    uint32_t NbrOfConversion;
+    FunctionalState DiscontinuousConvMode;
+    uint32_t ExternalTrigConv;
+    uint32_t ExternalTrigConvEdge;
+    FunctionalState DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct {
+    ADC_TypeDef* Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef* DMA_Handle;
+    uint32_t channels[HOST_ADC_MAX_RANKS];  /* 主机端：rank -> 通道 */
+    ADC_AnalogWDGConfTypeDef awd;           /* 主机端：模拟看门狗配置 */
+    uint32_t it_enabled;                    /* 主机端：ADC_IT_* */
+    uint32_t flags;                         /* 主机端：ADC_FLAG_* */
+} ADC_HandleTypeDef;
+
+#define __HAL_ADC_ENABLE_IT(h, it)   ((h)->it_enabled |= (it))
+#define __HAL_ADC_DISABLE_IT(h, it)  ((h)->it_enabled &= ~(uint32_t)(it))
+#define __HAL_ADC_CLEAR_FLAG(h, f)   ((h)->flags &= ~(uint32_t)(f))
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef* Instance;
+    TIM_Base_InitTypeDef Init;
+    uint32_t Counter;
+} TIM_HandleTypeDef;
+
+#define __HAL_TIM_SET_AUTORELOAD(h, v) ((h)->Init.Period = (v))
+#define __HAL_TIM_SET_COUNTER(h, v)    ((h)->Counter = (v))
+
+#define TIM_COUNTERMODE_UP              0x00000000U
+#define TIM_CLOCKDIVISION_DIV1          0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE  0x00000000U
+#define TIM_TRGO_UPDATE                 0x00000020U
+#define TIM_MASTERSLAVEMODE_DISABLE     0x00000000U
+
+typedef struct {
+    uint32_t MasterOutputTrigger;
+    uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* sMasterConfig);
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef* hadc, ADC_AnalogWDGConfTypeDef* AnalogWDGConfig);
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc);
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim);
+
+/* ----------------- 时钟 / GPIO / NVIC（主机端为空操作，供整机构建编译 main.c） ----------------- */
+
+extern uint32_t SystemCoreClock;   /* 固定 168 MHz，与固件时钟配置一致 */
+void SystemCoreClockUpdate(void);
+
+#define RCC_OSCILLATORTYPE_HSE   0x00000001U
+#define RCC_HSE_ON               0x00010000U
+#define RCC_PLL_ON               0x00000002U
+#define RCC_PLLSOURCE_HSE        0x00400000U
+#define RCC_PLLP_DIV2            0x00000002U
+#define RCC_CLOCKTYPE_SYSCLK     0x00000001U
+#define RCC_CLOCKTYPE_HCLK       0x00000002U
+#define RCC_CLOCKTYPE_PCLK1      0x00000004U
+#define RCC_CLOCKTYPE_PCLK2      0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK  0x00000002U
+#define RCC_SYSCLK_DIV1          0x00000000U
+#define RCC_HCLK_DIV2            0x00001000U
+#define RCC_HCLK_DIV4            0x00001400U
+#define FLASH_LATENCY_5          0x00000005U
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x0000C000U
+
+typedef struct {
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLM;
+    uint32_t PLLN;
+    uint32_t PLLP;
+    uint32_t PLLQ;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency);
+
+#define __HAL_RCC_PWR_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_USART1_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_USART2_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()    ((void)0)
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(v) ((void)(v))
+
+typedef struct {
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpiof;
+#define GPIOF (&host_gpiof)
+
+#define GPIO_PIN_9             ((uint16_t)0x0200)
+#define GPIO_PIN_10            ((uint16_t)0x0400)
+#define GPIO_MODE_OUTPUT_PP    0x00000001U
+#define GPIO_NOPULL            0x00000000U
+#define GPIO_SPEED_FREQ_LOW    0x00000000U
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+
+typedef enum {
+    DMA2_Stream0_IRQn = 56,
+    DMA2_Stream7_IRQn = 70
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+/* ----------------- 核心 ----------------- */
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* 96 位芯片 UID：主机端第 0 字取进程号（或 HostHal_SetUid），同机多个实例互不相同 */
+uint32_t HAL_GetUIDw0(void);
+uint32_t HAL_GetUIDw1(void);
+uint32_t HAL_GetUIDw2(void);
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+
+/* ----------------- 主机端扩展（固件代码不使用） ----------------- */
+
+/**
+ * @brief 派发已到达的串口接收字节与 DMA 发送完成（HAL_GetTick/HAL_Delay 会自动调用）
+ */
+void HostHal_ServiceIO(void);
+
+/**
+ * @brief 设置 ADC 通道的模拟读数（0~4095），之后的扫描帧都返回该值
+ */
+void HostHal_SetAdcValue(uint32_t channel, uint16_t value);
+
+/**
+ * @brief 固定 UID 第 0 字（虚拟时钟下取代进程号，重连退避的随机序列随之可复现）
+ */
+void HostHal_SetUid(uint32_t w0);
+
+/* 虚拟时钟的外部模型（host_sim）：时钟每前进一步先调用 advance，再派发串口/ADC“中断” */
+typedef struct {
+    uint64_t (*next_event_us)(void);   /* 模型下一个需要唤醒的时刻，无则 UINT64_MAX */
+    void (*advance)(uint64_t now_us);  /* 时钟已到达 now_us */
+} HostHalClock_t;
+
+/**
+ * @brief 切换到虚拟时钟（HAL_Init 之前调用）
+ * @note  HAL_Delay / __WFI / USART2 阻塞发送直接把时钟推进到下一个事件（TIM2 扫描帧、
+ *        DMA 发送完成、模型事件），不休眠；HAL_GetTick 每次读取计 1 µs（CPU 时间），
+ *        忙等节拍的循环同样能前进。结果只取决于输入，重复运行逐字节一致。
+ */
+void HostHal_UseVirtualClock(const HostHalClock_t* clock);
+
+/**
+ * @brief 当前时刻（µs，自 HAL_Init 起）
+ */
+uint64_t HostHal_Micros(void);
+
+/* 串口对端：取代伪终端（host_sim 的 ESP8266 模型） */
+typedef struct {
+    void (*write)(const uint8_t* data, uint16_t len);  /* MCU 发出的字节（发送时间已计入时钟） */
+    int (*read)(uint8_t* byte);                         /* 取一个已到达的字节；无则返回 0 */
+} HostHalUartPeer_t;
+
+void HostHal_SetUartPeer(USART_TypeDef* instance, const HostHalUartPeer_t* peer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4xx_HAL_H */
@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ * @file           : sim.h
+ * @brief          : 整机主机仿真（host_sim）公共定义
+ ******************************************************************************
+ * @description    : 完整固件（含 main.c 调度循环）在 Linux 上以虚拟时钟运行：
+ *                   - host/hal 切到虚拟时钟，HAL_Delay / __WFI 直接跳到下一个事件；
+ *                   - sim_esp8266.c：进程内的 ESP8266 AT 模型 + 地面站（收 TM、回 TM-ACK、
+ *                     发 TC），接在 USART2 上，时延/带宽/断线均按虚拟时间发生；
+ *                   - sim_scenario.c：场景脚本（ADC 信号、网络故障、地面 TC）；
+ *                   - sim_main.c：编入 main.c，按固定间隔输出时间线（队列深度、时延、丢弃）。
+ *                   同一输入的输出逐字节相同，可跨提交 diff。
+ ******************************************************************************
+ */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* ----------------- ESP8266 模型 + 地面站（sim_esp8266.c） ----------------- */
+
+typedef struct {
+    uint32_t latency_ms;      // 单程网络时延
+    uint32_t bandwidth_Bps;   // 空口带宽（字节/秒），0 表示不限
+    uint32_t join_ms;         // 连接热点耗时
+    uint8_t saved_ap;         // flash 中已保存热点：上电后自行连接
+} SimNetConfig_t;
+
+/* 地面站收到一个 TM（CRC 已校验）：user 为用户数据（HK/事件为 JSON） */
+typedef void (*SimTmSink_t)(uint8_t link_id, uint8_t service, uint8_t subtype,
+                            const uint8_t* user, uint16_t user_len, uint64_t now_us);
+
+void SimEsp_Init(const SimNetConfig_t* cfg, SimTmSink_t sink);
+void SimEsp_Attach(void);                 // 接到 USART2（HAL_UART_Init 之前）
+uint64_t SimEsp_NextEventUs(void);
+void SimEsp_Advance(uint64_t now_us);
+
+/* 故障注入与地面操作 */
+void SimEsp_WifiDrop(uint32_t down_ms);   // 热点消失 down_ms：上报 WIFI DISCONNECT，之后模块自行重连
+void SimEsp_CloseLink(int8_t link_id);    // 地面关闭连接（-1 表示全部），模块上报 <id>,CLOSED
+void SimEsp_ServerDown(uint32_t down_ms); // 地面服务停止 down_ms：现有连接关闭，CIPSTART 被拒
+void SimEsp_Reset(void);                  // 模块复位：连接丢失，重新启动并自动连接热点
+void SimEsp_SetLatency(uint32_t latency_ms);
+void SimEsp_SetBandwidth(uint32_t bandwidth_Bps);
+void SimEsp_SetAck(uint8_t enable);       // 地面是否回 TM-ACK（129/2）
+uint8_t SimEsp_SendTc(uint8_t subtype, const char* json);   // TC 129/<subtype>，经连接 0 下发
+
+typedef struct {
+    uint32_t tm_packets;      // 地面收到的 TM（含重复）
+    uint32_t crc_errors;
+    uint32_t acks_sent;
+    uint32_t tcs_sent;
+    uint32_t tcs_refused;     // 连接 0 不在线，TC 未能下发
+    uint32_t connects;
+    uint32_t connects_refused;
+    uint32_t cipsend;
+    uint64_t up_bytes;
+} SimNetStats_t;
+
+const SimNetStats_t* SimEsp_GetStats(void);
+
+/* ----------------- 场景脚本（sim_scenario.c） ----------------- */
+
+/**
+ * @brief 读入场景文件（path 为 NULL 时只用默认的清洁空气基线）
+ * @return 0 成功；-1 文件无法打开或有无法解析的行（已打印行号）
+ */
+int SimScenario_Load(const char* path, uint32_t seed);
+uint64_t SimScenario_NextEventUs(void);
+
+/**
+ * @brief 执行到期的动作并刷新 ADC 读数（每个虚拟时钟步调用）
+ * @param log 动作执行时写一行注释（"# t=... 动作原文"），NULL 不写
+ */
+void SimScenario_Advance(uint64_t now_us, FILE* log);
+
+/**
+ * @brief 场景中的 end 动作时刻（µs）；没有 end 时为 0
+ */
+uint64_t SimScenario_EndUs(void);
+
+/* ----------------- 命令行 ----------------- */
+
+const char* Sim_ArgStr(int argc, char** argv, const char* key, const char* def);
+long Sim_ArgInt(int argc, char** argv, const char* key, long def);
+uint8_t Sim_ArgFlag(int argc, char** argv, const char* key);
+
+#endif /* __SIM_H */
@@ -0,0 +1,824 @@
+/**
+ ******************************************************************************
+ * @file           : sim_esp8266.c
+ * @brief          : ESP8266 AT 模型 + 地面站（虚拟时钟，进程内）
+ ******************************************************************************
+ * @description    : 与 tools/esp8266_emu.py 相同的指令子集与应答格式（CIPMUX=1 多连接、
+ *                   _DEF/_CUR、CWAUTOCONN、CIPSTATUS、+IPD、<id>,CLOSED、WIFI DISCONNECT），
+ *                   但不经伪终端和真实 TCP：
+ *                   - 模块 → MCU 的字节按 115200 波特逐字节到达（HostHal_SetUartPeer）；
+ *                   - 上行数据按带宽与时延到达地面站，地面站分帧、校验 CRC，交给 SimTmSink_t，
+ *                     事件 TM 回 TM-ACK（129/2），TC 由场景脚本下发；
+ *                   - 所有定时都挂在本文件的事件堆上，由虚拟时钟推进。
+ *                   UDP 连接与透传模式不建模（CIPSTART "UDP" 回 ERROR）。
+ ******************************************************************************
+ */
+
+#include "sim.h"
+#include "stm32f4xx_hal.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_LINKS           5
+#define SIM_EVT_MAX         512
+#define SIM_EVT_DATA        320        // 一个 PUS 包（≤256）加 +IPD 头
+#define SIM_UART_OUT_SIZE   65536u     // 模块 → MCU 待发字节
+#define SIM_UART_BAUD       115200u
+#define SIM_CIPSEND_MAX     2048
+#define SIM_LINE_MAX        512
+#define SIM_GROUND_RX_SIZE  512
+#define SIM_BOOT_READY_MS   500        // AT+RST 到输出 ready
+#define SIM_APID_DEFAULT    0x001
+
+typedef enum {
+    SIM_EVT_EMIT = 0,         // 输出 data（模块应答/主动上报）
+    SIM_EVT_JOINED,           // 连上热点；arg = 1 表示由 CWJAP 发起（附 OK）
+    SIM_EVT_CONNECTED,        // TCP 握手完成
+    SIM_EVT_UPLINK,           // 上行数据到达地面站
+    SIM_EVT_DOWNLINK,         // 下行数据到达模块（+IPD）
+    SIM_EVT_AP_BACK,          // 热点恢复
+    SIM_EVT_SERVER_BACK,      // 地面服务恢复
+} SimEvtKind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t link;
+    uint8_t arg;
+    uint32_t gen;             // 连接代次：连接关闭后迟到的数据丢弃
+    uint16_t len;
+    uint8_t data[SIM_EVT_DATA];
+} SimEvt_t;
+
+typedef struct {
+    uint64_t at;
+    uint32_t seq;             // 同一时刻按入堆顺序
+    uint16_t idx;
+} SimHeapItem_t;
+
+typedef struct {
+    uint8_t open;
+    uint8_t connecting;
+    uint32_t gen;
+    char remote_ip[32];
+    uint16_t remote_port;
+    uint16_t local_port;
+    uint64_t up_busy_until;
+    uint64_t down_busy_until;
+    uint8_t rx[SIM_GROUND_RX_SIZE];   // 地面站分帧缓冲
+    uint16_t rx_len;
+} SimLink_t;
+
+static SimNetConfig_t g_cfg;
+static SimTmSink_t g_sink = NULL;
+static SimNetStats_t g_stats;
+
+static SimEvt_t g_pool[SIM_EVT_MAX];
+static uint16_t g_free[SIM_EVT_MAX];
+static uint16_t g_free_count = 0;
+static SimHeapItem_t g_heap[SIM_EVT_MAX];
+static uint16_t g_heap_count = 0;
+static uint32_t g_heap_seq = 0;
+
+/* 模块状态 */
+static uint8_t g_cipmux = 0;
+static uint8_t g_wifi_up = 0;
+static uint8_t g_autoconn = 1;        // 出厂默认开启
+static uint8_t g_saved_ap = 0;
+static uint64_t g_ap_down_until = 0;  // 热点消失期间连接失败
+static uint8_t g_server_up = 1;
+static uint8_t g_ack = 1;
+static uint16_t g_next_local_port = 50000;
+static SimLink_t g_links[SIM_LINKS];
+
+/* 串口：MCU → 模块的行缓冲 / CIPSEND 数据模式 */
+static char g_line[SIM_LINE_MAX];
+static uint16_t g_line_len = 0;
+static uint16_t g_send_expect = 0;
+static uint8_t g_send_link = 0;
+static uint8_t g_send_buf[SIM_CIPSEND_MAX];
+static uint16_t g_send_len = 0;
+
+/* 串口：模块 → MCU，逐字节按波特率到达 */
+static uint8_t g_out[SIM_UART_OUT_SIZE];
+static uint32_t g_out_head = 0;
+static uint32_t g_out_tail = 0;
+static uint64_t g_out_next_us = 0;
+static const uint64_t k_byte_us = 10000000ull / SIM_UART_BAUD;
+
+/* 地面站 */
+static uint16_t g_tc_seq = 0;
+static uint16_t g_apid = SIM_APID_DEFAULT;
+
+static const char* const k_gmr =
+    "AT version:1.7.4.0(May 11 2020 19:13:04)\r\n"
+    "SDK version:3.0.4(9532ceb)\r\n"
+    "compile time:May 27 2020 10:12:17\r\n"
+    "Bin version(Wroom 02):1.7.4\r\n"
+    "OK\r\n";
+
+static uint64_t now_us(void) {
+    return HostHal_Micros();
+}
+
+static uint64_t ms_us(uint32_t ms) {
+    return (uint64_t)ms * 1000u;
+}
+
+static inline uint16_t rd_u16(const uint8_t* p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static inline void wr_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)(v & 0xFF);
+}
+
+static uint16_t crc16_ccitt(const uint8_t* data, uint16_t len) {
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* ----------------- 事件堆 ----------------- */
+
+static int heap_less(const SimHeapItem_t* a, const SimHeapItem_t* b) {
+    return (a->at != b->at) ? (a->at < b->at) : ((int32_t)(a->seq - b->seq) < 0);
+}
+
+static SimEvt_t* evt_alloc(uint64_t at, SimEvtKind_t kind) {
+    if (g_free_count == 0) {
+        fprintf(stderr, "[sim] 事件堆已满（%u），丢弃事件\n", SIM_EVT_MAX);
+        return NULL;
+    }
+    uint16_t idx = g_free[--g_free_count];
+    SimEvt_t* e = &g_pool[idx];
+    memset(e, 0, offsetof(SimEvt_t, data));
+    e->kind = (uint8_t)kind;
+
+    uint16_t i = g_heap_count++;
+    g_heap[i] = (SimHeapItem_t){at, g_heap_seq++, idx};
+    while (i > 0) {
+        uint16_t parent = (uint16_t)((i - 1) / 2);
+        if (!heap_less(&g_heap[i], &g_heap[parent])) {
+            break;
+        }
+        SimHeapItem_t t = g_heap[i];
+        g_heap[i] = g_heap[parent];
+        g_heap[parent] = t;
+        i = parent;
+    }
+    return e;
+}
+
+static SimHeapItem_t heap_pop(void) {
+    SimHeapItem_t top = g_heap[0];
+    g_heap[0] = g_heap[--g_heap_count];
+    uint16_t i = 0;
+    for (;;) {
+        uint16_t l = (uint16_t)(2 * i + 1);
+        uint16_t r = (uint16_t)(l + 1);
+        uint16_t m = i;
+        if (l < g_heap_count && heap_less(&g_heap[l], &g_heap[m])) {
+            m = l;
+        }
+        if (r < g_heap_count && heap_less(&g_heap[r], &g_heap[m])) {
+            m = r;
+        }
+        if (m == i) {
+            break;
+        }
+        SimHeapItem_t t = g_heap[i];
+        g_heap[i] = g_heap[m];
+        g_heap[m] = t;
+        i = m;
+    }
+    return top;
+}
+
+/* ----------------- 模块 → MCU ----------------- */
+
+static void emit_bytes(const uint8_t* data, uint16_t len) {
+    uint64_t now = now_us();
+    if (g_out_head == g_out_tail && g_out_next_us < now + k_byte_us) {
+        g_out_next_us = now + k_byte_us;   // 线路空闲：第一个字节一个字节时间后到达
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        uint32_t next = (g_out_head + 1u) % SIM_UART_OUT_SIZE;
+        if (next == g_out_tail) {
+            fprintf(stderr, "[sim] 模块串口输出缓冲已满，丢弃 %u 字节\n", (unsigned)(len - i));
+            return;
+        }
+        g_out[g_out_head] = data[i];
+        g_out_head = next;
+    }
+}
+
+static void emit(const char* text) {
+    emit_bytes((const uint8_t*)text, (uint16_t)strlen(text));
+}
+
+static void emit_later(uint32_t delay_ms, const char* text) {
+    SimEvt_t* e = evt_alloc(now_us() + ms_us(delay_ms), SIM_EVT_EMIT);
+    if (e != NULL) {
+        e->len = (uint16_t)strlen(text);
+        memcpy(e->data, text, e->len);
+    }
+}
+
+static int peer_read(uint8_t* byte) {
+    if (g_out_head == g_out_tail || now_us() < g_out_next_us) {
+        return 0;
+    }
+    *byte = g_out[g_out_tail];
+    g_out_tail = (g_out_tail + 1u) % SIM_UART_OUT_SIZE;
+    g_out_next_us += k_byte_us;
+    return 1;
+}
+
+/* ----------------- 连接 ----------------- */
+
+static void close_link(uint8_t id, uint8_t notify) {
+    SimLink_t* l = &g_links[id];
+    if (!l->open && !l->connecting) {
+        return;
+    }
+    uint8_t was_open = l->open;
+    l->open = 0;
+    l->connecting = 0;
+    l->gen++;
+    l->rx_len = 0;
+    if (notify && was_open) {
+        char msg[16];
+        snprintf(msg, sizeof(msg), g_cipmux ? "%u,CLOSED\r\n" : "CLOSED\r\n", id);
+        emit(msg);
+    }
+}
+
+static void close_all_links(uint8_t notify) {
+    for (uint8_t i = 0; i < SIM_LINKS; i++) {
+        close_link(i, notify);
+    }
+}
+
+static uint8_t any_link_open(void) {
+    for (uint8_t i = 0; i < SIM_LINKS; i++) {
+        if (g_links[i].open) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t air_time_us(uint32_t bytes) {
+    return (g_cfg.bandwidth_Bps != 0) ? (uint64_t)bytes * 1000000ull / g_cfg.bandwidth_Bps : 0;
+}
+
+/**
+ * @brief 上行：按带宽排队、按时延到达地面站
+ * @return 空口发完的时刻（SEND OK）
+ */
+static uint64_t net_send(uint8_t id, const uint8_t* data, uint16_t len) {
+    SimLink_t* l = &g_links[id];
+    uint64_t now = now_us();
+    uint64_t start = (l->up_busy_until > now) ? l->up_busy_until : now;
+    l->up_busy_until = start + air_time_us(len);
+
+    for (uint16_t off = 0; off < len; off += SIM_EVT_DATA) {
+        uint16_t n = (uint16_t)((len - off < SIM_EVT_DATA) ? len - off : SIM_EVT_DATA);
+        SimEvt_t* e = evt_alloc(l->up_busy_until + ms_us(g_cfg.latency_ms), SIM_EVT_UPLINK);
+        if (e == NULL) {
+            break;
+        }
+        e->link = id;
+        e->gen = l->gen;
+        e->len = n;
+        memcpy(e->data, data + off, n);
+    }
+    return l->up_busy_until;
+}
+
+/**
+ * @brief 下行：地面站发出的数据按带宽与时延到达模块，再以 +IPD 交给 MCU
+ */
+static void net_downlink(uint8_t id, const uint8_t* data, uint16_t len) {
+    SimLink_t* l = &g_links[id];
+    uint64_t now = now_us();
+    uint64_t start = (l->down_busy_until > now) ? l->down_busy_until : now;
+    l->down_busy_until = start + air_time_us(len);
+
+    SimEvt_t* e = evt_alloc(l->down_busy_until + ms_us(g_cfg.latency_ms), SIM_EVT_DOWNLINK);
+    if (e != NULL && len <= SIM_EVT_DATA) {
+        e->link = id;
+        e->gen = l->gen;
+        e->len = len;
+        memcpy(e->data, data, len);
+    }
+}
+
+/* ----------------- 地面站 ----------------- */
+
+static void ground_send_tm_ack(uint8_t id, uint16_t tm_packet_id, uint16_t tm_seq_ctrl) {
+    uint8_t user[4];
+    wr_u16(&user[0], tm_packet_id);
+    wr_u16(&user[2], tm_seq_ctrl);
+
+    uint8_t pkt[6 + 5 + sizeof(user) + 2];
+    uint16_t data_field_len = (uint16_t)(5 + sizeof(user) + 2);
+    wr_u16(&pkt[0], (uint16_t)((1u << 12) | (1u << 11) | (g_apid & 0x07FF)));
+    wr_u16(&pkt[2], (uint16_t)((0x3u << 14) | (g_tc_seq++ & 0x3FFF)));
+    wr_u16(&pkt[4], (uint16_t)(data_field_len - 1));
+    pkt[6] = (uint8_t)(2u << 4);   // PUS-C，不请求 verification
+    pkt[7] = 129;
+    pkt[8] = 2;
+    wr_u16(&pkt[9], 0);
+    memcpy(&pkt[11], user, sizeof(user));
+    wr_u16(&pkt[sizeof(pkt) - 2], crc16_ccitt(pkt, (uint16_t)(sizeof(pkt) - 2)));
+    net_downlink(id, pkt, sizeof(pkt));
+    g_stats.acks_sent++;
+}
+
+static void ground_on_packet(uint8_t id, const uint8_t* pkt, uint16_t len) {
+    if (crc16_ccitt(pkt, (uint16_t)(len - 2)) != rd_u16(&pkt[len - 2])) {
+        g_stats.crc_errors++;
+        return;
+    }
+    uint16_t packet_id = rd_u16(&pkt[0]);
+    if (((packet_id >> 12) & 0x1) != 0 || len < 6 + 7 + 2) {
+        return;   // 不是 TM
+    }
+    g_apid = (uint16_t)(packet_id & 0x07FF);
+    g_stats.tm_packets++;
+
+    uint8_t service = pkt[7];
+    uint8_t subtype = pkt[8];
+    if (service == 5 && g_ack) {
+        ground_send_tm_ack(id, packet_id, rd_u16(&pkt[2]));
+    }
+    if (g_sink != NULL) {
+        g_sink(id, service, subtype, &pkt[13], (uint16_t)(len - 15), now_us());
+    }
+}
+
+/**
+ * @brief 地面站 TCP 流分帧：6 字节主头给出包长，凑齐即处理
+ */
+static void ground_on_bytes(uint8_t id, const uint8_t* data, uint16_t len) {
+    SimLink_t* l = &g_links[id];
+    g_stats.up_bytes += len;
+    while (len > 0) {
+        uint16_t want = 6;
+        if (l->rx_len >= 6) {
+            want = (uint16_t)(rd_u16(&l->rx[4]) + 7u);
+            if (want > SIM_GROUND_RX_SIZE || want < 6 + 7 + 2) {
+                l->rx_len = 0;   // 失步：丢弃缓冲（模型内不会发生）
+                continue;
+            }
+        }
+        uint16_t n = (uint16_t)(want - l->rx_len);
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&l->rx[l->rx_len], data, n);
+        l->rx_len = (uint16_t)(l->rx_len + n);
+        data += n;
+        len = (uint16_t)(len - n);
+        if (l->rx_len >= 6 && l->rx_len == (uint16_t)(rd_u16(&l->rx[4]) + 7u)) {
+            ground_on_packet(id, l->rx, l->rx_len);
+            l->rx_len = 0;
+        }
+    }
+}
+
+/* ----------------- AT 指令 ----------------- */
+
+static void join_ap(uint8_t from_cmd, uint8_t save) {
+    uint64_t at = now_us() + ms_us(g_cfg.join_ms);
+    if (at < g_ap_down_until) {
+        /* 热点不在：连接超时失败；自动重连由热点恢复事件完成 */
+        if (from_cmd) {
+            emit_later(g_cfg.join_ms, "+CWJAP:3\r\n\r\nFAIL\r\n");
+        }
+        return;
+    }
+    SimEvt_t* e = evt_alloc(at, SIM_EVT_JOINED);
+    if (e != NULL) {
+        e->arg = from_cmd;
+        e->len = save;   // CWJAP_DEF：写入 flash
+    }
+}
+
+static void cmd_cwjap(const char* line) {
+    const char* eq = strchr(line, '=');
+    if (eq == NULL || eq[1] != '"') {
+        emit(g_wifi_up ? "+CWJAP:\"sim\"\r\n\r\nOK\r\n" : "No AP\r\n\r\nOK\r\n");
+        return;
+    }
+    uint8_t was_up = g_wifi_up;
+    close_all_links(0);
+    g_wifi_up = 0;
+    if (was_up) {
+        emit("WIFI DISCONNECT\r\n");
+    }
+    join_ap(1, strncmp(line, "AT+CWJAP_DEF", 12) == 0);
+}
+
+static void cmd_cipstart(const char* line) {
+    unsigned id = 0;
+    char kind[8] = {0};
+    char ip[32] = {0};
+    unsigned port = 0;
+    int ok = g_cipmux
+           ? (sscanf(line, "AT+CIPSTART=%u,\"%7[^\"]\",\"%31[^\"]\",%u", &id, kind, ip, &port) == 4)
+           : (sscanf(line, "AT+CIPSTART=\"%7[^\"]\",\"%31[^\"]\",%u", kind, ip, &port) == 3);
+    if (!ok || id >= SIM_LINKS || !g_wifi_up || strcmp(kind, "TCP") != 0) {
+        emit("\r\nERROR\r\n");
+        return;
+    }
+    SimLink_t* l = &g_links[id];
+    if (l->open || l->connecting) {
+        emit("ALREADY CONNECTED\r\n\r\nERROR\r\n");
+        return;
+    }
+    char prefix[4] = "";
+    if (g_cipmux) {
+        snprintf(prefix, sizeof(prefix), "%u,", id);
+    }
+    if (!g_server_up) {
+        /* 对端拒绝：约一个往返后失败 */
+        char msg[32];
+        snprintf(msg, sizeof(msg), "\r\nERROR\r\n%sCLOSED\r\n", prefix);
+        emit_later(2 * g_cfg.latency_ms, msg);
+        g_stats.connects_refused++;
+        return;
+    }
+    l->connecting = 1;
+    l->gen++;
+    snprintf(l->remote_ip, sizeof(l->remote_ip), "%s", ip);
+    l->remote_port = (uint16_t)port;
+    SimEvt_t* e = evt_alloc(now_us() + ms_us(2 * g_cfg.latency_ms), SIM_EVT_CONNECTED);   // 三次握手 ≈ 1 RTT
+    if (e != NULL) {
+        e->link = (uint8_t)id;
+        e->gen = l->gen;
+    }
+}
+
+static void cmd_cipsend(const char* line) {
+    unsigned id = 0;
+    unsigned len = 0;
+    int ok = g_cipmux ? (sscanf(line, "AT+CIPSEND=%u,%u", &id, &len) == 2)
+                      : (sscanf(line, "AT+CIPSEND=%u", &len) == 1);
+    if (!ok || len == 0 || len > SIM_CIPSEND_MAX || id >= SIM_LINKS) {
+        emit("\r\nERROR\r\n");
+        return;
+    }
+    if (!g_links[id].open) {
+        emit("link is not valid\r\n\r\nERROR\r\n");
+        return;
+    }
+    g_send_link = (uint8_t)id;
+    g_send_expect = (uint16_t)len;
+    g_send_len = 0;
+    emit("\r\nOK\r\n> ");
+}
+
+static void finish_cipsend(void) {
+    char msg[32];
+    g_stats.cipsend++;
+    snprintf(msg, sizeof(msg), "\r\nRecv %u bytes\r\n", g_send_len);
+    emit(msg);
+    if (!g_links[g_send_link].open) {
+        emit("\r\nSEND FAIL\r\n");
+        return;
+    }
+    uint64_t done = net_send(g_send_link, g_send_buf, g_send_len);
+    SimEvt_t* e = evt_alloc(done, SIM_EVT_EMIT);
+    if (e != NULL) {
+        e->len = (uint16_t)strlen("\r\nSEND OK\r\n");
+        memcpy(e->data, "\r\nSEND OK\r\n", e->len);
+    }
+}
+
+static void cmd_cipclose(const char* line) {
+    unsigned id = 0;
+    if (sscanf(line, "AT+CIPCLOSE=%u", &id) != 1) {
+        id = 0;
+    }
+    if (g_cipmux && id == 5) {
+        for (uint8_t i = 0; i < SIM_LINKS; i++) {
+            if (g_links[i].open) {
+                char msg[16];
+                close_link(i, 0);
+                snprintf(msg, sizeof(msg), "%u,CLOSED\r\n", i);
+                emit(msg);
+            }
+        }
+        emit_later(g_cfg.latency_ms, "\r\nOK\r\n");
+    } else if (id < SIM_LINKS && g_links[id].open) {
+        char msg[32];
+        close_link((uint8_t)id, 0);
+        snprintf(msg, sizeof(msg), g_cipmux ? "%u,CLOSED\r\n\r\nOK\r\n" : "CLOSED\r\n\r\nOK\r\n", id);
+        emit_later(g_cfg.latency_ms, msg);
+    } else {
+        emit("\r\nERROR\r\n");
+    }
+}
+
+static void cmd_cipstatus(void) {
+    char out[512];
+    int n;
+    uint8_t status = !g_wifi_up ? 5 : any_link_open() ? 3 : (g_stats.connects > 0) ? 4 : 2;
+    n = snprintf(out, sizeof(out), "STATUS:%u\r\n", status);
+    for (uint8_t i = 0; i < SIM_LINKS && n < (int)sizeof(out); i++) {
+        const SimLink_t* l = &g_links[i];
+        if (l->open) {
+            n += snprintf(out + n, sizeof(out) - (size_t)n, "+CIPSTATUS:%u,\"TCP\",\"%s\",%u,%u,0\r\n",
+                          i, l->remote_ip, l->remote_port, l->local_port);
+        }
+    }
+    if (n < (int)sizeof(out)) {
+        snprintf(out + n, sizeof(out) - (size_t)n, "\r\nOK\r\n");
+    }
+    emit(out);
+}
+
+static void boot_autojoin(void) {
+    if (g_autoconn && g_saved_ap) {
+        join_ap(0, 0);
+    }
+}
+
+static void handle_command(const char* line) {
+    if (strcmp(line, "AT") == 0 || strcmp(line, "ATE0") == 0 || strcmp(line, "ATE1") == 0) {
+        emit("\r\nOK\r\n");
+    } else if (strcmp(line, "AT+GMR") == 0) {
+        emit(k_gmr);
+    } else if (strcmp(line, "AT+RST") == 0) {
+        emit("\r\nOK\r\n");
+        SimEsp_Reset();
+    } else if (strncmp(line, "AT+CWMODE", 9) == 0) {
+        emit(strchr(line, '=') ? "\r\nOK\r\n" : "+CWMODE:1\r\n\r\nOK\r\n");
+    } else if (strncmp(line, "AT+CWJAP", 8) == 0) {
+        cmd_cwjap(line);
+    } else if (strcmp(line, "AT+CWQAP") == 0) {
+        uint8_t was_up = g_wifi_up;
+        close_all_links(1);
+        g_wifi_up = 0;
+        emit(was_up ? "\r\nOK\r\nWIFI DISCONNECT\r\n" : "\r\nOK\r\n");
+    } else if (strcmp(line, "AT+CIFSR") == 0) {
+        emit("+CIFSR:STAIP,\"192.168.137.2\"\r\n+CIFSR:STAMAC,\"5c:cf:7f:00:00:01\"\r\n\r\nOK\r\n");
+    } else if (strncmp(line, "AT+CWAUTOCONN=", 14) == 0) {
+        g_autoconn = (line[14] == '1') ? 1 : 0;
+        emit("\r\nOK\r\n");
+    } else if (strcmp(line, "AT+CIPMUX?") == 0) {
+        emit(g_cipmux ? "+CIPMUX:1\r\n\r\nOK\r\n" : "+CIPMUX:0\r\n\r\nOK\r\n");
+    } else if (strncmp(line, "AT+CIPMUX=", 10) == 0) {
+        if (any_link_open()) {
+            emit("link is builded\r\n\r\nERROR\r\n");   // 有连接时不允许切换
+        } else {
+            g_cipmux = (line[10] == '1') ? 1 : 0;
+            emit("\r\nOK\r\n");
+        }
+    } else if (strncmp(line, "AT+CIPMODE=", 11) == 0) {
+        emit((line[11] == '0') ? "\r\nOK\r\n" : "\r\nERROR\r\n");   // 透传不建模
+    } else if (strncmp(line, "AT+CIPSTART=", 12) == 0) {
+        cmd_cipstart(line);
+    } else if (strncmp(line, "AT+CIPSEND=", 11) == 0) {
+        cmd_cipsend(line);
+    } else if (strncmp(line, "AT+CIPCLOSE", 11) == 0) {
+        cmd_cipclose(line);
+    } else if (strcmp(line, "AT+CIPSTATUS") == 0) {
+        cmd_cipstatus();
+    } else {
+        emit("\r\nERROR\r\n");
+    }
+}
+
+static void peer_write(const uint8_t* data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t b = data[i];
+        if (g_send_expect > 0) {
+            g_send_buf[g_send_len++] = b;
+            if (--g_send_expect == 0) {
+                finish_cipsend();
+            }
+            continue;
+        }
+        if (g_line_len < SIM_LINE_MAX - 1) {
+            g_line[g_line_len++] = (char)b;
+        } else {
+            g_line_len = 0;
+        }
+        if (g_line_len >= 2 && g_line[g_line_len - 2] == '\r' && g_line[g_line_len - 1] == '\n') {
+            g_line[g_line_len - 2] = '\0';
+            g_line_len = 0;
+            char echo[SIM_LINE_MAX + 4];
+            snprintf(echo, sizeof(echo), "%s\r\r\n", g_line);   // ATE1：回显
+            emit(echo);
+            if (g_line[0] != '\0') {
+                handle_command(g_line);
+            }
+        }
+    }
+}
+
+static const HostHalUartPeer_t k_peer = {
+    .write = peer_write,
+    .read = peer_read,
+};
+
+/* ----------------- 事件处理 ----------------- */
+
+static void on_event(SimEvt_t* e) {
+    SimLink_t* l = &g_links[e->link];
+    char msg[40];
+
+    switch ((SimEvtKind_t)e->kind) {
+    case SIM_EVT_EMIT:
+        emit_bytes(e->data, e->len);
+        break;
+
+    case SIM_EVT_JOINED:
+        if (now_us() < g_ap_down_until) {
+            if (e->arg) {
+                emit("+CWJAP:3\r\n\r\nFAIL\r\n");
+            }
+            break;
+        }
+        if (e->len) {
+            g_saved_ap = 1;
+        }
+        if (!g_wifi_up || e->arg) {
+            g_wifi_up = 1;
+            emit(e->arg ? "WIFI CONNECTED\r\nWIFI GOT IP\r\n\r\nOK\r\n" : "WIFI CONNECTED\r\nWIFI GOT IP\r\n");
+        }
+        break;
+
+    case SIM_EVT_CONNECTED:
+        if (e->gen != l->gen || !l->connecting) {
+            break;
+        }
+        l->connecting = 0;
+        if (!g_wifi_up || !g_server_up) {
+            snprintf(msg, sizeof(msg), g_cipmux ? "\r\nERROR\r\n%u,CLOSED\r\n" : "\r\nERROR\r\nCLOSED\r\n", e->link);
+            emit(msg);
+            g_stats.connects_refused++;
+            break;
+        }
+        l->open = 1;
+        l->rx_len = 0;
+        l->local_port = g_next_local_port++;
+        g_stats.connects++;
+        snprintf(msg, sizeof(msg), g_cipmux ? "%u,CONNECT\r\n\r\nOK\r\n" : "CONNECT\r\n\r\nOK\r\n", e->link);
+        emit(msg);
+        break;
+
+    case SIM_EVT_UPLINK:
+        if (e->gen == l->gen && l->open) {
+            ground_on_bytes(e->link, e->data, e->len);
+        }
+        break;
+
+    case SIM_EVT_DOWNLINK:
+        if (e->gen == l->gen && l->open) {
+            if (g_cipmux) {
+                snprintf(msg, sizeof(msg), "\r\n+IPD,%u,%u:", e->link, e->len);
+            } else {
+                snprintf(msg, sizeof(msg), "\r\n+IPD,%u:", e->len);
+            }
+            emit(msg);
+            emit_bytes(e->data, e->len);
+        }
+        break;
+
+    case SIM_EVT_AP_BACK:
+        if (!g_wifi_up && now_us() >= g_ap_down_until) {
+            g_wifi_up = 1;
+            emit("WIFI CONNECTED\r\nWIFI GOT IP\r\n");
+        }
+        break;
+
+    case SIM_EVT_SERVER_BACK:
+        g_server_up = 1;
+        break;
+    }
+}
+
+/* ----------------- 接口 ----------------- */
+
+void SimEsp_Init(const SimNetConfig_t* cfg, SimTmSink_t sink) {
+    g_cfg = *cfg;
+    g_sink = sink;
+    memset(&g_stats, 0, sizeof(g_stats));
+    memset(g_links, 0, sizeof(g_links));
+    g_free_count = 0;
+    for (uint16_t i = 0; i < SIM_EVT_MAX; i++) {
+        g_free[g_free_count++] = (uint16_t)(SIM_EVT_MAX - 1 - i);
+    }
+    g_heap_count = 0;
+    g_saved_ap = cfg->saved_ap;
+    boot_autojoin();
+}
+
+void SimEsp_Attach(void) {
+    HostHal_SetUartPeer(USART2, &k_peer);
+}
+
+uint64_t SimEsp_NextEventUs(void) {
+    uint64_t next = (g_heap_count > 0) ? g_heap[0].at : UINT64_MAX;
+    if (g_out_head != g_out_tail && g_out_next_us < next) {
+        next = g_out_next_us;
+    }
+    return next;
+}
+
+void SimEsp_Advance(uint64_t now_us_) {
+    while (g_heap_count > 0 && g_heap[0].at <= now_us_) {
+        SimHeapItem_t it = heap_pop();
+        on_event(&g_pool[it.idx]);
+        g_free[g_free_count++] = it.idx;
+    }
+}
+
+void SimEsp_WifiDrop(uint32_t down_ms) {
+    g_ap_down_until = now_us() + ms_us(down_ms);
+    if (g_wifi_up) {
+        close_all_links(1);
+        g_wifi_up = 0;
+        emit("WIFI DISCONNECT\r\n");
+    }
+    evt_alloc(g_ap_down_until, SIM_EVT_AP_BACK);   // 模块持续重试，热点恢复即连上
+}
+
+void SimEsp_CloseLink(int8_t link_id) {
+    for (uint8_t i = 0; i < SIM_LINKS; i++) {
+        if (link_id < 0 || link_id == (int8_t)i) {
+            close_link(i, 1);
+        }
+    }
+}
+
+void SimEsp_ServerDown(uint32_t down_ms) {
+    g_server_up = 0;
+    close_all_links(1);
+    evt_alloc(now_us() + ms_us(down_ms), SIM_EVT_SERVER_BACK);
+}
+
+void SimEsp_Reset(void) {
+    close_all_links(0);
+    g_wifi_up = 0;
+    g_cipmux = 0;
+    g_send_expect = 0;
+    g_line_len = 0;
+    emit_later(SIM_BOOT_READY_MS, "\r\n ets Jan  8 2013,rst cause:2, boot mode:(3,7)\r\n\r\nready\r\n");
+    if (g_autoconn && g_saved_ap) {
+        SimEvt_t* e = evt_alloc(now_us() + ms_us(SIM_BOOT_READY_MS + g_cfg.join_ms), SIM_EVT_JOINED);
+        (void)e;
+    }
+}
+
+void SimEsp_SetLatency(uint32_t latency_ms) {
+    g_cfg.latency_ms = latency_ms;
+}
+
+void SimEsp_SetBandwidth(uint32_t bandwidth_Bps) {
+    g_cfg.bandwidth_Bps = bandwidth_Bps;
+}
+
+void SimEsp_SetAck(uint8_t enable) {
+    g_ack = enable ? 1 : 0;
+}
+
+uint8_t SimEsp_SendTc(uint8_t subtype, const char* json) {
+    uint16_t user_len = (uint16_t)strlen(json);
+    uint8_t pkt[256];
+    uint16_t data_field_len = (uint16_t)(5 + user_len + 2);
+    uint16_t total = (uint16_t)(6 + data_field_len);
+
+    if (!g_links[0].open || total > sizeof(pkt)) {
+        g_stats.tcs_refused++;
+        return 0;
+    }
+    wr_u16(&pkt[0], (uint16_t)((1u << 12) | (1u << 11) | (g_apid & 0x07FF)));
+    wr_u16(&pkt[2], (uint16_t)((0x3u << 14) | (g_tc_seq++ & 0x3FFF)));
+    wr_u16(&pkt[4], (uint16_t)(data_field_len - 1));
+    pkt[6] = (uint8_t)((2u << 4) | 0x9);   // 请求接受 + 完成确认
+    pkt[7] = 129;
+    pkt[8] = subtype;
+    wr_u16(&pkt[9], 0);
+    memcpy(&pkt[11], json, user_len);
+    wr_u16(&pkt[total - 2], crc16_ccitt(pkt, (uint16_t)(total - 2)));
+    net_downlink(0, pkt, total);
+    g_stats.tcs_sent++;
+    return 1;
+}
+
+const SimNetStats_t* SimEsp_GetStats(void) {
+    return &g_stats;
+}
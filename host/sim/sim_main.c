@@ -0,0 +1,441 @@
+/**
+ ******************************************************************************
+ * @file           : sim_main.c
+ * @brief          : host_sim 入口：完整固件在虚拟时钟上运行，输出可 diff 的时间线
+ ******************************************************************************
+ * @description    : 直接编入 src/main.c（main 改名为 Firmware_Main），HK/事件入队经本文件
+ *                   记下入队时刻，地面站收到同一报文时得出端到端时延。
+ *
+ *                   时间线为 CSV，每 --step-s 秒一行（窗口内的增量 / 峰值）：
+ *                     t_s      窗口结束时刻（虚拟时间，秒）
+ *                     net      联网状态机状态（main.c NetState_t）
+ *                     up       在线地面站数
+ *                     rate_ms  当前采样间隔
+ *                     q, q_max 各站 PUS 队列深度之和：窗口结束时 / 窗口内逐毫秒峰值
+ *                     queued   入队的 HK + 事件
+ *                     drop     队列溢出丢弃的 TM（pus_link dropped）
+ *                     hk, ev   地面首次收到的 HK / 事件
+ *                     dup      地面再次收到的报文（丢 ACK 后的重传等）
+ *                     lat_*    入队 → 地面首次收到的时延（毫秒，窗口内）
+ *                     outages  恢复的链路中断次数
+ *                     miss     调度截止时间错过次数
+ *                   场景动作以 "# t=..." 注释行插入，结束时以 "#" 行给出全程汇总。
+ *                   输出只取决于参数与场景文件，逐字节可复现；墙钟耗时打印到 stderr。
+ ******************************************************************************
+ */
+
+#include "ground_link.h"
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+uint8_t SimFw_QueueHousekeeping(const char* payload_json);
+uint8_t SimFw_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required);
+
+#define main Firmware_Main
+#define GroundLink_QueueHousekeeping SimFw_QueueHousekeeping
+#define GroundLink_QueueEvent SimFw_QueueEvent
+/* main.c 按 ARM 的 uint32_t（unsigned long）写 %lu，且 main 以不返回的 Sched_Run 结尾 */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"
+#pragma GCC diagnostic ignored "-Wreturn-type"
+#include "main.c"
+#pragma GCC diagnostic pop
+#undef main
+#undef GroundLink_QueueHousekeeping
+#undef GroundLink_QueueEvent
+
+#define SIM_STAMP_MAX       1024       // 在途报文（各站队列之和远小于此）
+#define SIM_WINDOW_LAT_MAX  8192
+
+typedef struct {
+    uint32_t hash;            // 报文 JSON 的 FNV-1a
+    uint32_t queued_ms;
+    uint8_t links_seen;       // 已在哪些连接上收到（事件每站一份）
+    uint8_t delivered;
+    uint8_t live;
+} SimStamp_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t hk;
+    uint32_t ev;
+    uint32_t dup;
+    uint32_t q_max;
+    uint32_t lat_count;
+    uint32_t lat[SIM_WINDOW_LAT_MAX];
+} SimWindow_t;
+
+static const char* const k_net_names[] = {
+    "boot", "probe", "status", "autojoin", "mode", "join", "link", "up", "retry",
+};
+
+static SimStamp_t g_stamps[SIM_STAMP_MAX];
+static uint32_t g_stamp_next = 0;
+static SimWindow_t g_win;
+static SimWindow_t g_total_counts;        // 全程计数（lat 不用）
+static uint32_t* g_all_lat = NULL;        // 全程时延
+static uint32_t g_all_lat_count = 0;
+static uint32_t g_all_lat_cap = 0;
+
+static FILE* g_out = NULL;
+static uint64_t g_step_us = 60000000ull;
+static uint64_t g_next_row_us = 0;
+static uint64_t g_end_us = 0;
+static uint64_t g_last_ms = UINT64_MAX;
+static uint32_t g_last_drop = 0;
+static uint32_t g_last_outages = 0;
+static uint32_t g_last_miss = 0;
+static uint32_t g_overall_q_max = 0;
+static struct timespec g_wall_start;
+
+static uint32_t fnv1a(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s != '\0') {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t fnv1a_n(const uint8_t* s, uint16_t len) {
+    uint32_t h = 2166136261u;
+    for (uint16_t i = 0; i < len; i++) {
+        h = (h ^ s[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void stamp_add(const char* payload) {
+    g_stamps[g_stamp_next] = (SimStamp_t){fnv1a(payload), HAL_GetTick(), 0, 0, 1};
+    g_stamp_next = (g_stamp_next + 1u) % SIM_STAMP_MAX;
+    g_win.queued++;
+}
+
+uint8_t SimFw_QueueHousekeeping(const char* payload_json) {
+    uint8_t ok = GroundLink_QueueHousekeeping(payload_json);
+    if (ok) {
+        stamp_add(payload_json);
+    }
+    return ok;
+}
+
+uint8_t SimFw_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
+    uint8_t ok = GroundLink_QueueEvent(event_subtype, payload_json, ack_required);
+    if (ok) {
+        stamp_add(payload_json);
+    }
+    return ok;
+}
+
+static void lat_add(uint32_t ms) {
+    if (g_win.lat_count < SIM_WINDOW_LAT_MAX) {
+        g_win.lat[g_win.lat_count++] = ms;
+    }
+    if (g_all_lat_count == g_all_lat_cap) {
+        g_all_lat_cap = g_all_lat_cap ? g_all_lat_cap * 2 : 4096;
+        g_all_lat = realloc(g_all_lat, g_all_lat_cap * sizeof(uint32_t));
+        if (g_all_lat == NULL) {
+            fprintf(stderr, "[sim] 内存不足\n");
+            exit(1);
+        }
+    }
+    g_all_lat[g_all_lat_count++] = ms;
+}
+
+/**
+ * @brief 地面站收到 TM：HK（3/25）与事件（5/x）按报文查入队时刻
+ */
+static void OnGroundTm(uint8_t link_id, uint8_t service, uint8_t subtype,
+                       const uint8_t* user, uint16_t user_len, uint64_t now_us) {
+    (void)subtype;
+    if (service != 3 && service != 5) {
+        return;
+    }
+    uint32_t h = fnv1a_n(user, user_len);
+    uint8_t bit = (uint8_t)(1u << link_id);
+    for (uint32_t k = 0; k < SIM_STAMP_MAX; k++) {
+        /* 从最新的往回找：同一报文内容重复入队时取最近一次 */
+        SimStamp_t* s = &g_stamps[(g_stamp_next + SIM_STAMP_MAX - 1u - k) % SIM_STAMP_MAX];
+        if (!s->live || s->hash != h || (s->links_seen & bit)) {
+            continue;
+        }
+        s->links_seen |= bit;
+        if (!s->delivered) {
+            s->delivered = 1;
+            if (service == 3) {
+                g_win.hk++;
+            } else {
+                g_win.ev++;
+            }
+            uint32_t now_ms = (uint32_t)(now_us / 1000u);
+            lat_add(now_ms - s->queued_ms);
+        }
+        return;
+    }
+    g_win.dup++;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t pct(const uint32_t* sorted, uint32_t n, uint32_t p) {
+    if (n == 0) {
+        return 0;
+    }
+    uint32_t i = (n * p) / 100u;
+    return sorted[(i < n) ? i : n - 1];
+}
+
+static uint32_t queue_depth(void) {
+    uint32_t q = 0;
+    for (uint8_t i = 0; i < GroundLink_StationCount(); i++) {
+        q += GroundLink_QueueDepth(i);
+    }
+    return q;
+}
+
+static void link_totals(uint32_t* drop, uint32_t* outages) {
+    *drop = 0;
+    *outages = 0;
+    for (uint8_t i = 0; i < GroundLink_StationCount(); i++) {
+        const GroundLinkStats_t* st = GroundLink_GetStats(i);
+        if (st != NULL) {
+            *drop += st->tm_dropped;
+            *outages += st->outages;
+        }
+    }
+}
+
+static uint32_t sched_misses(void) {
+    uint32_t misses = 0;
+    SchedStats_t st;
+    for (int8_t id = 0; id < (int8_t)Sched_TaskCount(); id++) {
+        if (Sched_GetStats(id, &st)) {
+            misses += st.misses;
+        }
+    }
+    return misses;
+}
+
+static void write_row(uint64_t t_us) {
+    uint32_t drop;
+    uint32_t outages;
+    uint32_t miss = sched_misses();
+    link_totals(&drop, &outages);
+
+    qsort(g_win.lat, g_win.lat_count, sizeof(uint32_t), cmp_u32);
+    fprintf(g_out, "%lu,%s,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+            (unsigned long)(t_us / 1000000u),
+            k_net_names[g_net_state],
+            GroundLink_UpCount(),
+            (unsigned long)g_sampling_interval_ms,
+            (unsigned long)queue_depth(),
+            (unsigned long)g_win.q_max,
+            (unsigned long)g_win.queued,
+            (unsigned long)(drop - g_last_drop),
+            (unsigned long)g_win.hk,
+            (unsigned long)g_win.ev,
+            (unsigned long)g_win.dup,
+            (unsigned long)pct(g_win.lat, g_win.lat_count, 50),
+            (unsigned long)pct(g_win.lat, g_win.lat_count, 95),
+            (unsigned long)(g_win.lat_count ? g_win.lat[g_win.lat_count - 1] : 0),
+            (unsigned long)(outages - g_last_outages),
+            /* 统计可被 TC 清零：清零后以当前值为增量 */
+            (unsigned long)((miss >= g_last_miss) ? miss - g_last_miss : miss));
+
+    g_total_counts.queued += g_win.queued;
+    g_total_counts.hk += g_win.hk;
+    g_total_counts.ev += g_win.ev;
+    g_total_counts.dup += g_win.dup;
+    if (g_win.q_max > g_overall_q_max) {
+        g_overall_q_max = g_win.q_max;
+    }
+    g_last_drop = drop;
+    g_last_outages = outages;
+    g_last_miss = miss;
+    memset(&g_win, 0, offsetof(SimWindow_t, lat));
+}
+
+static void write_summary(void) {
+    uint32_t drop;
+    uint32_t outages;
+    uint32_t pending = 0;
+    link_totals(&drop, &outages);
+    for (uint32_t i = 0; i < SIM_STAMP_MAX; i++) {
+        if (g_stamps[i].live && !g_stamps[i].delivered) {
+            pending++;
+        }
+    }
+    qsort(g_all_lat, g_all_lat_count, sizeof(uint32_t), cmp_u32);
+
+    const SimNetStats_t* net = SimEsp_GetStats();
+    fprintf(g_out, "# summary queued=%lu delivered_hk=%lu delivered_ev=%lu undelivered=%lu drop=%lu dup=%lu q_max=%lu\n",
+            (unsigned long)g_total_counts.queued, (unsigned long)g_total_counts.hk,
+            (unsigned long)g_total_counts.ev, (unsigned long)pending, (unsigned long)drop,
+            (unsigned long)g_total_counts.dup, (unsigned long)g_overall_q_max);
+    fprintf(g_out, "# latency_ms n=%lu p50=%lu p95=%lu p99=%lu max=%lu\n",
+            (unsigned long)g_all_lat_count,
+            (unsigned long)pct(g_all_lat, g_all_lat_count, 50),
+            (unsigned long)pct(g_all_lat, g_all_lat_count, 95),
+            (unsigned long)pct(g_all_lat, g_all_lat_count, 99),
+            (unsigned long)(g_all_lat_count ? g_all_lat[g_all_lat_count - 1] : 0));
+    fprintf(g_out, "# ground tm=%lu crc_err=%lu acks=%lu tcs=%lu tcs_refused=%lu connects=%lu refused=%lu cipsend=%lu up_bytes=%llu outages=%lu\n",
+            (unsigned long)net->tm_packets, (unsigned long)net->crc_errors, (unsigned long)net->acks_sent,
+            (unsigned long)net->tcs_sent, (unsigned long)net->tcs_refused, (unsigned long)net->connects,
+            (unsigned long)net->connects_refused, (unsigned long)net->cipsend,
+            (unsigned long long)net->up_bytes, (unsigned long)outages);
+
+    SchedStats_t st;
+    for (int8_t id = 0; id < (int8_t)Sched_TaskCount(); id++) {
+        if (Sched_GetStats(id, &st)) {
+            fprintf(g_out, "# task %s runs=%lu misses=%lu late_max_ms=%lu\n", st.name,
+                    (unsigned long)st.runs, (unsigned long)st.misses, (unsigned long)st.late_max_ms);
+        }
+    }
+}
+
+/* ----------------- 虚拟时钟 ----------------- */
+
+static uint64_t SimNextEventUs(void) {
+    uint64_t next = SimEsp_NextEventUs();
+    uint64_t s = SimScenario_NextEventUs();
+    if (s < next) {
+        next = s;
+    }
+    if (g_next_row_us < next) {
+        next = g_next_row_us;
+    }
+    return next;
+}
+
+static void SimAdvance(uint64_t now_us) {
+    SimScenario_Advance(now_us, g_out);
+    SimEsp_Advance(now_us);
+
+    uint64_t ms = now_us / 1000u;
+    if (ms != g_last_ms) {
+        g_last_ms = ms;
+        uint32_t q = queue_depth();
+        if (q > g_win.q_max) {
+            g_win.q_max = q;
+        }
+    }
+
+    while (now_us >= g_next_row_us && g_next_row_us <= g_end_us) {
+        write_row(g_next_row_us);
+        g_next_row_us += g_step_us;
+    }
+    if (now_us >= g_end_us) {
+        struct timespec wall_end;
+        clock_gettime(CLOCK_MONOTONIC, &wall_end);
+        double wall_s = (double)(wall_end.tv_sec - g_wall_start.tv_sec)
+                      + (double)(wall_end.tv_nsec - g_wall_start.tv_nsec) / 1e9;
+        write_summary();
+        fflush(g_out);
+        fflush(stdout);
+        fprintf(stderr, "[sim] 虚拟 %.0f s，墙钟 %.2f s（%.0f 倍速）\n",
+                (double)g_end_us / 1e6, wall_s, (wall_s > 0) ? (double)g_end_us / 1e6 / wall_s : 0.0);
+        exit(0);
+    }
+}
+
+static const HostHalClock_t k_sim_clock = {
+    .next_event_us = SimNextEventUs,
+    .advance = SimAdvance,
+};
+
+/* ----------------- 命令行 ----------------- */
+
+const char* Sim_ArgStr(int argc, char** argv, const char* key, const char* def) {
+    for (int i = 0; i + 1 < argc; i++) {
+        if (strcmp(argv[i], key) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return def;
+}
+
+long Sim_ArgInt(int argc, char** argv, const char* key, long def) {
+    const char* v = Sim_ArgStr(argc, argv, key, NULL);
+    return (v != NULL) ? strtol(v, NULL, 0) : def;
+}
+
+uint8_t Sim_ArgFlag(int argc, char** argv, const char* key) {
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], key) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [options]\n"
+            "  --scenario FILE       场景脚本（见 host/sim/scenarios）\n"
+            "  --duration-s N        仿真时长（默认 86400；场景中的 end 优先）\n"
+            "  --step-s N            时间线间隔（默认 60）\n"
+            "  --out FILE            时间线输出（默认 stdout）\n"
+            "  --log FILE            固件串口日志（默认丢弃）\n"
+            "  --seed N              芯片 UID 与噪声种子（默认 1）\n"
+            "  --latency-ms N        单程网络时延（默认 20）\n"
+            "  --bandwidth-Bps N     空口带宽，字节/秒（默认 20000，0 为不限）\n"
+            "  --join-ms N           连接热点耗时（默认 3000）\n"
+            "  --saved-ap            模块 flash 中已保存热点（上电自动连接）\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    if (Sim_ArgFlag(argc, argv, "--help") || Sim_ArgFlag(argc, argv, "-h")) {
+        usage(argv[0]);
+        return 2;
+    }
+    uint32_t seed = (uint32_t)Sim_ArgInt(argc, argv, "--seed", 1);
+    const char* out_path = Sim_ArgStr(argc, argv, "--out", NULL);
+    const char* log_path = Sim_ArgStr(argc, argv, "--log", "/dev/null");
+    long step_s = Sim_ArgInt(argc, argv, "--step-s", 60);
+
+    /* 固件 printf 与 USART1 日志都写 stdout：时间线先占住原 stdout，再把 stdout 转到日志 */
+    g_out = (out_path != NULL) ? fopen(out_path, "w") : fdopen(dup(STDOUT_FILENO), "w");
+    if (g_out == NULL || freopen(log_path, "w", stdout) == NULL) {
+        fprintf(stderr, "[sim] 无法打开输出 %s / 日志 %s\n", out_path ? out_path : "stdout", log_path);
+        return 1;
+    }
+
+    SimNetConfig_t cfg = {
+        .latency_ms = (uint32_t)Sim_ArgInt(argc, argv, "--latency-ms", 20),
+        .bandwidth_Bps = (uint32_t)Sim_ArgInt(argc, argv, "--bandwidth-Bps", 20000),
+        .join_ms = (uint32_t)Sim_ArgInt(argc, argv, "--join-ms", 3000),
+        .saved_ap = Sim_ArgFlag(argc, argv, "--saved-ap"),
+    };
+    if (SimScenario_Load(Sim_ArgStr(argc, argv, "--scenario", NULL), seed) != 0) {
+        return 1;
+    }
+    g_end_us = SimScenario_EndUs();
+    if (g_end_us == 0) {
+        g_end_us = (uint64_t)Sim_ArgInt(argc, argv, "--duration-s", 86400) * 1000000ull;
+    }
+    g_step_us = (uint64_t)((step_s > 0) ? step_s : 60) * 1000000ull;
+    g_next_row_us = g_step_us;
+
+    HostHal_SetUid(0x53494D00u ^ seed);
+    HostHal_UseVirtualClock(&k_sim_clock);
+    SimEsp_Init(&cfg, OnGroundTm);
+    SimEsp_Attach();
+
+    fprintf(g_out, "# host_sim seed=%lu latency_ms=%lu bandwidth_Bps=%lu join_ms=%lu saved_ap=%u duration_s=%lu step_s=%lu\n",
+            (unsigned long)seed, (unsigned long)cfg.latency_ms, (unsigned long)cfg.bandwidth_Bps,
+            (unsigned long)cfg.join_ms, cfg.saved_ap, (unsigned long)(g_end_us / 1000000u),
+            (unsigned long)(g_step_us / 1000000u));
+    fprintf(g_out, "t_s,net,up,rate_ms,q,q_max,queued,drop,hk,ev,dup,lat_p50,lat_p95,lat_max,outages,miss\n");
+    clock_gettime(CLOCK_MONOTONIC, &g_wall_start);
+
+    Firmware_Main();   // 调度循环不返回：到结束时刻由 SimAdvance 退出
+    return 0;
+}
@@ -0,0 +1,344 @@
+/**
+ ******************************************************************************
+ * @file           : sim_scenario.c
+ * @brief          : host_sim 场景脚本：ADC 信号与网络事件按虚拟时间发生
+ ******************************************************************************
+ * @description    : 每行 "<时刻> <动作> [参数...]"，# 之后为注释；时刻为数字加单位
+ *                   h / m / s / ms（省略为秒，可连写如 2h10m），行可乱序，
+ *                   按时刻排序后执行（同一时刻按行序）。
+ *
+ *                   adc    CH CODE            通道 CH 的读数（12 位码值）
+ *                   ramp   CH CODE SECONDS    从当前值线性变化到 CODE
+ *                   noise  CH AMP             叠加 ±AMP 的均匀噪声（固定种子，逐毫秒刷新）
+ *                   ppm    KEY PPM [SECONDS]  传感器 KEY（HK 前缀，如 mq3）到 PPM 浓度
+ *                                             （按当时的 R0 换算码值；PPM ≤ 0 回到基线）
+ *                   wifi   SECONDS            热点消失 SECONDS 秒
+ *                   close  [ID]               地面关闭连接 ID（省略为全部）
+ *                   server SECONDS            地面服务停止 SECONDS 秒
+ *                   latency MS / bandwidth BPS / ack on|off
+ *                   tc     SUB JSON           地面下发 TC 129/SUB
+ *                   reset                     ESP8266 复位
+ *                   end                       仿真结束（覆盖 --duration-s）
+ *
+ *                   未指定的通道为清洁空气基线：码值 SIM_BASELINE_CODE，噪声 ±SIM_BASELINE_NOISE。
+ ******************************************************************************
+ */
+
+#include "sim.h"
+#include "sensor_manager.h"
+#include "stm32f4xx_hal.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_ADC_CHANNELS    19
+#define SIM_BASELINE_CODE   800
+#define SIM_BASELINE_NOISE  3
+#define SIM_ACTION_MAX      4096
+#define SIM_TEXT_MAX        200
+
+typedef enum {
+    ACT_ADC = 0,
+    ACT_RAMP,
+    ACT_NOISE,
+    ACT_PPM,
+    ACT_WIFI,
+    ACT_CLOSE,
+    ACT_SERVER,
+    ACT_LATENCY,
+    ACT_BANDWIDTH,
+    ACT_ACK,
+    ACT_TC,
+    ACT_RESET,
+    ACT_END,
+} SimActKind_t;
+
+typedef struct {
+    uint64_t at_us;
+    uint16_t line_no;         // 同一时刻按行序
+    uint8_t kind;
+    int32_t a;                // 通道 / 秒数 / 连接号 / 子类型 ...
+    double b;                 // 码值 / ppm
+    double c;                 // 变化时长（秒）
+    char text[SIM_TEXT_MAX];  // 原文（写时间线）；tc 的 JSON 另存于 arg
+    char arg[SIM_TEXT_MAX];
+} SimAction_t;
+
+typedef struct {
+    double from;
+    double to;
+    uint64_t start_us;
+    uint64_t dur_us;
+    uint16_t noise;
+} SimChannel_t;
+
+static SimAction_t g_actions[SIM_ACTION_MAX];
+static uint16_t g_action_count = 0;
+static uint16_t g_next_action = 0;
+static uint64_t g_end_us = 0;
+static SimChannel_t g_ch[SIM_ADC_CHANNELS];
+static uint32_t g_rng = 1;
+static uint64_t g_last_ms = UINT64_MAX;
+
+static uint32_t xorshift32(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+/* "90"、"1.5m"、"2h10m"、"250ms"：数字加单位（h / m / s / ms，省略为秒），可连写 */
+static int parse_time(const char* tok, uint64_t* out_us) {
+    double total = 0;
+    const char* p = tok;
+    while (*p != '\0') {
+        char* end = NULL;
+        double v = strtod(p, &end);
+        if (end == p || v < 0) {
+            return -1;
+        }
+        double scale = 1.0;
+        if (end[0] == 'm' && end[1] == 's') {
+            scale = 0.001;
+            end += 2;
+        } else if (*end == 's') {
+            end++;
+        } else if (*end == 'm') {
+            scale = 60.0;
+            end++;
+        } else if (*end == 'h') {
+            scale = 3600.0;
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        total += v * scale;
+        p = end;
+    }
+    *out_us = (uint64_t)(total * 1e6 + 0.5);
+    return 0;
+}
+
+static int parse_line(SimAction_t* act, char* line) {
+    char cmd[16] = {0};
+    char t[32] = {0};
+    int used = 0;
+    if (sscanf(line, "%31s %15s %n", t, cmd, &used) < 2 || parse_time(t, &act->at_us) != 0) {
+        return -1;
+    }
+    const char* rest = line + used;
+    char word[32] = {0};
+    int n = 0;
+
+    if (strcmp(cmd, "adc") == 0) {
+        act->kind = ACT_ADC;
+        n = (sscanf(rest, "%d %lf", &act->a, &act->b) == 2);
+    } else if (strcmp(cmd, "ramp") == 0) {
+        act->kind = ACT_RAMP;
+        n = (sscanf(rest, "%d %lf %lf", &act->a, &act->b, &act->c) == 3);
+    } else if (strcmp(cmd, "noise") == 0) {
+        act->kind = ACT_NOISE;
+        n = (sscanf(rest, "%d %lf", &act->a, &act->b) == 2);
+    } else if (strcmp(cmd, "ppm") == 0) {
+        act->kind = ACT_PPM;
+        act->c = 0;
+        n = (sscanf(rest, "%31s %lf %lf", act->arg, &act->b, &act->c) >= 2);
+        n = n && (SensorManager_FindByKey(act->arg) < SENSOR_TYPE_MAX);
+    } else if (strcmp(cmd, "wifi") == 0 || strcmp(cmd, "server") == 0) {
+        act->kind = (cmd[0] == 'w') ? ACT_WIFI : ACT_SERVER;
+        n = (sscanf(rest, "%d", &act->a) == 1);
+    } else if (strcmp(cmd, "close") == 0) {
+        act->kind = ACT_CLOSE;
+        act->a = -1;
+        n = (sscanf(rest, "%d", &act->a) <= 1);
+    } else if (strcmp(cmd, "latency") == 0 || strcmp(cmd, "bandwidth") == 0) {
+        act->kind = (cmd[0] == 'l') ? ACT_LATENCY : ACT_BANDWIDTH;
+        n = (sscanf(rest, "%d", &act->a) == 1);
+    } else if (strcmp(cmd, "ack") == 0) {
+        act->kind = ACT_ACK;
+        n = (sscanf(rest, "%31s", word) == 1);
+        act->a = (strcmp(word, "on") == 0);
+        n = n && (act->a || strcmp(word, "off") == 0);
+    } else if (strcmp(cmd, "tc") == 0) {
+        act->kind = ACT_TC;
+        int off = 0;
+        n = (sscanf(rest, "%d %n", &act->a, &off) == 1 && rest[off] == '{');
+        snprintf(act->arg, sizeof(act->arg), "%s", rest + off);
+    } else if (strcmp(cmd, "reset") == 0 || strcmp(cmd, "end") == 0) {
+        act->kind = (cmd[0] == 'r') ? ACT_RESET : ACT_END;
+        n = 1;
+    }
+    if ((act->kind == ACT_ADC || act->kind == ACT_RAMP || act->kind == ACT_NOISE)
+        && (act->a < 0 || act->a >= SIM_ADC_CHANNELS)) {
+        n = 0;
+    }
+    return n ? 0 : -1;
+}
+
+static int action_cmp(const void* pa, const void* pb) {
+    const SimAction_t* a = pa;
+    const SimAction_t* b = pb;
+    if (a->at_us != b->at_us) {
+        return (a->at_us < b->at_us) ? -1 : 1;
+    }
+    return (int)a->line_no - (int)b->line_no;
+}
+
+static double channel_value(const SimChannel_t* ch, uint64_t now_us) {
+    if (ch->dur_us == 0 || now_us >= ch->start_us + ch->dur_us) {
+        return ch->to;
+    }
+    double f = (double)(now_us - ch->start_us) / (double)ch->dur_us;
+    return ch->from + (ch->to - ch->from) * f;
+}
+
+static void channel_move(uint32_t ch, double to, double seconds, uint64_t now_us) {
+    SimChannel_t* c = &g_ch[ch];
+    c->from = channel_value(c, now_us);
+    c->to = to;
+    c->start_us = now_us;
+    c->dur_us = (seconds > 0) ? (uint64_t)(seconds * 1e6) : 0;
+}
+
+static void run_action(const SimAction_t* act, uint64_t now_us) {
+    switch ((SimActKind_t)act->kind) {
+    case ACT_ADC:
+        channel_move((uint32_t)act->a, act->b, 0, now_us);
+        break;
+    case ACT_RAMP:
+        channel_move((uint32_t)act->a, act->b, act->c, now_us);
+        break;
+    case ACT_NOISE:
+        g_ch[act->a].noise = (uint16_t)act->b;
+        break;
+    case ACT_PPM: {
+        SensorType_t id = SensorManager_FindByKey(act->arg);
+        uint32_t ch = SensorManager_GetDesc(id)->adc_channel;
+        double code = (act->b > 0) ? (double)SensorManager_CodeForPpm(id, (float)act->b) : SIM_BASELINE_CODE;
+        channel_move(ch, code, act->c, now_us);
+        break;
+    }
+    case ACT_WIFI:
+        SimEsp_WifiDrop((uint32_t)act->a * 1000u);
+        break;
+    case ACT_CLOSE:
+        SimEsp_CloseLink((int8_t)act->a);
+        break;
+    case ACT_SERVER:
+        SimEsp_ServerDown((uint32_t)act->a * 1000u);
+        break;
+    case ACT_LATENCY:
+        SimEsp_SetLatency((uint32_t)act->a);
+        break;
+    case ACT_BANDWIDTH:
+        SimEsp_SetBandwidth((uint32_t)act->a);
+        break;
+    case ACT_ACK:
+        SimEsp_SetAck((uint8_t)act->a);
+        break;
+    case ACT_TC:
+        SimEsp_SendTc((uint8_t)act->a, act->arg);
+        break;
+    case ACT_RESET:
+        SimEsp_Reset();
+        break;
+    case ACT_END:
+        break;
+    }
+}
+
+int SimScenario_Load(const char* path, uint32_t seed) {
+    g_rng = (seed != 0) ? seed : 1;
+    for (uint32_t i = 0; i < SIM_ADC_CHANNELS; i++) {
+        g_ch[i] = (SimChannel_t){SIM_BASELINE_CODE, SIM_BASELINE_CODE, 0, 0, SIM_BASELINE_NOISE};
+    }
+    g_action_count = 0;
+    g_next_action = 0;
+    g_end_us = 0;
+    if (path == NULL) {
+        return 0;
+    }
+
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "[sim] 无法打开场景 %s\n", path);
+        return -1;
+    }
+    char line[512];
+    uint16_t line_no = 0;
+    int rc = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+        char* hash = strchr(line, '#');
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        size_t len = strlen(line);
+        while (len > 0 && isspace((unsigned char)line[len - 1])) {
+            line[--len] = '\0';
+        }
+        char* s = line;
+        while (isspace((unsigned char)*s)) {
+            s++;
+        }
+        if (*s == '\0') {
+            continue;
+        }
+        if (g_action_count >= SIM_ACTION_MAX) {
+            fprintf(stderr, "[sim] %s:%u 动作超过 %u 条\n", path, line_no, SIM_ACTION_MAX);
+            rc = -1;
+            break;
+        }
+        SimAction_t* act = &g_actions[g_action_count];
+        memset(act, 0, sizeof(*act));
+        act->line_no = line_no;
+        snprintf(act->text, sizeof(act->text), "%s", s);
+        if (parse_line(act, s) != 0) {
+            fprintf(stderr, "[sim] %s:%u 无法解析：%s\n", path, line_no, act->text);
+            rc = -1;
+            continue;
+        }
+        if (act->kind == ACT_END && (g_end_us == 0 || act->at_us < g_end_us)) {
+            g_end_us = act->at_us;
+        }
+        g_action_count++;
+    }
+    fclose(f);
+    qsort(g_actions, g_action_count, sizeof(g_actions[0]), action_cmp);
+    return rc;
+}
+
+uint64_t SimScenario_NextEventUs(void) {
+    return (g_next_action < g_action_count) ? g_actions[g_next_action].at_us : UINT64_MAX;
+}
+
+void SimScenario_Advance(uint64_t now_us, FILE* log) {
+    while (g_next_action < g_action_count && g_actions[g_next_action].at_us <= now_us) {
+        const SimAction_t* act = &g_actions[g_next_action++];
+        run_action(act, now_us);
+        if (log != NULL) {
+            fprintf(log, "# t=%.3f %s\n", (double)now_us / 1e6, act->text);
+        }
+    }
+
+    /* 读数与噪声逐毫秒刷新（ADC 以 1 kHz 扫描，同一毫秒内不变） */
+    uint64_t ms = now_us / 1000u;
+    if (ms == g_last_ms) {
+        return;
+    }
+    g_last_ms = ms;
+    for (uint32_t i = 0; i < SIM_ADC_CHANNELS; i++) {
+        const SimChannel_t* c = &g_ch[i];
+        double v = channel_value(c, now_us);
+        if (c->noise != 0) {
+            v += (double)(int32_t)(xorshift32() % (2u * c->noise + 1u)) - (double)c->noise;
+        }
+        v = (v < 0) ? 0 : (v > 4095) ? 4095 : v;
+        HostHal_SetAdcValue(i, (uint16_t)(v + 0.5));
+    }
+}
+
+uint64_t SimScenario_EndUs(void) {
+    return g_end_us;
+}
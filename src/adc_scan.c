@@ -0,0 +1,216 @@
+/**
+ ******************************************************************************
+ * @file           : adc_scan.c
+ * @brief          : 定时器触发的多通道 ADC 扫描实现
+ ******************************************************************************
+ */
+
+#include "adc_scan.h"
+
+#include <stdio.h>
+
+static const uint32_t k_channels[ADC_SCAN_NUM_CHANNELS] = ADC_SCAN_CHANNELS;
+
+static ADC_HandleTypeDef* g_hadc = NULL;
+static TIM_HandleTypeDef* g_htim = NULL;
+
+/* DMA 循环写入的两帧：半满中断 = 第 0 帧完成，全满中断 = 第 1 帧完成 */
+static volatile uint16_t g_dma_buf[2][ADC_SCAN_NUM_CHANNELS];
+
+static volatile uint8_t g_latest_half = 0;   // 最近完成的是哪一帧
+static volatile uint32_t g_latest_tick = 0;
+static volatile uint32_t g_seq = 0;          // 已完成帧数（最后更新）
+static volatile uint32_t g_errors = 0;
+static volatile AdcScanFrameHook_t g_frame_hook = NULL;
+
+/* 模拟看门狗 */
+static volatile AdcScanWatchdogHook_t g_awd_hook = NULL;
+static uint32_t g_awd_channel = 0;
+static volatile uint8_t g_awd_configured = 0;
+static volatile uint8_t g_awd_armed = 0;
+static volatile uint32_t g_awd_count = 0;
+
+void AdcScan_Init(ADC_HandleTypeDef* hadc, TIM_HandleTypeDef* htim) {
+    ADC_ChannelConfTypeDef sConfig = {0};
+
+    g_hadc = hadc;
+    g_htim = htim;
+    g_seq = 0;
+
+    for (uint8_t i = 0; i < ADC_SCAN_NUM_CHANNELS; i++) {
+        sConfig.Channel = k_channels[i];
+        sConfig.Rank = i + 1;
+        sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;  // 传感器输出阻抗较高，加长采样时间
+        if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK) {
+            printf("[ADC扫描] 通道 rank%u 配置失败\r\n", i + 1);
+        }
+    }
+}
+
+uint8_t AdcScan_Start(uint32_t rate_hz) {
+    if (g_hadc == NULL || g_htim == NULL || rate_hz == 0 || rate_hz > ADC_SCAN_TIM_CLOCK_HZ) {
+        return 0;
+    }
+
+    HAL_TIM_Base_Stop(g_htim);
+    __HAL_TIM_SET_AUTORELOAD(g_htim, ADC_SCAN_TIM_CLOCK_HZ / rate_hz - 1);
+    __HAL_TIM_SET_COUNTER(g_htim, 0);
+
+    if (HAL_ADC_Start_DMA(g_hadc, (uint32_t*)g_dma_buf, 2 * ADC_SCAN_NUM_CHANNELS) != HAL_OK) {
+        printf("[ADC扫描] DMA 启动失败\r\n");
+        return 0;
+    }
+    if (HAL_TIM_Base_Start(g_htim) != HAL_OK) {
+        HAL_ADC_Stop_DMA(g_hadc);
+        printf("[ADC扫描] TIM 启动失败\r\n");
+        return 0;
+    }
+    printf("[ADC扫描] 已启动：%u 通道，%lu 帧/秒\r\n",
+           ADC_SCAN_NUM_CHANNELS, (unsigned long)rate_hz);
+    return 1;
+}
+
+void AdcScan_Stop(void) {
+    if (g_htim != NULL) {
+        HAL_TIM_Base_Stop(g_htim);
+    }
+    if (g_hadc != NULL) {
+        HAL_ADC_Stop_DMA(g_hadc);
+    }
+}
+
+void AdcScan_SetFrameHook(AdcScanFrameHook_t hook) {
+    g_frame_hook = hook;
+}
+
+uint8_t AdcScan_ConfigWatchdog(uint32_t adc_channel, uint16_t low, uint16_t high) {
+    ADC_AnalogWDGConfTypeDef awd = {0};
+
+    if (g_hadc == NULL || AdcScan_ChannelIndex(adc_channel) < 0 || low > high) {
+        return 0;
+    }
+    AdcScan_DisarmWatchdog();
+
+    awd.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;   // 只比较这一个通道（规则组）
+    awd.Channel = adc_channel;
+    awd.HighThreshold = high;
+    awd.LowThreshold = low;
+    awd.ITMode = DISABLE;                                // 由 AdcScan_ArmWatchdog 开中断
+    if (HAL_ADC_AnalogWDGConfig(g_hadc, &awd) != HAL_OK) {
+        printf("[ADC扫描] 模拟看门狗配置失败\r\n");
+        return 0;
+    }
+    g_awd_channel = adc_channel;
+    g_awd_configured = 1;
+    return 1;
+}
+
+void AdcScan_ArmWatchdog(void) {
+    if (g_hadc == NULL || !g_awd_configured) {
+        return;
+    }
+    __HAL_ADC_CLEAR_FLAG(g_hadc, ADC_FLAG_AWD);
+    g_awd_armed = 1;
+    __HAL_ADC_ENABLE_IT(g_hadc, ADC_IT_AWD);
+}
+
+void AdcScan_DisarmWatchdog(void) {
+    if (g_hadc != NULL) {
+        __HAL_ADC_DISABLE_IT(g_hadc, ADC_IT_AWD);
+    }
+    g_awd_armed = 0;
+}
+
+uint8_t AdcScan_WatchdogArmed(void) {
+    return g_awd_armed;
+}
+
+void AdcScan_SetWatchdogHook(AdcScanWatchdogHook_t hook) {
+    g_awd_hook = hook;
+}
+
+uint32_t AdcScan_GetWatchdogCount(void) {
+    return g_awd_count;
+}
+
+uint8_t AdcScan_GetLatest(AdcScanFrame_t* out) {
+    /*
+     * 帧完成后 DMA 先写另一半，再回来覆盖这一半，拷贝窗口为一整帧周期；
+     * 拷贝前后帧序号不变即说明期间没有新帧完成，数据未被覆盖。
+     */
+    for (uint8_t attempt = 0; attempt < 3; attempt++) {
+        uint32_t seq = g_seq;
+        if (seq == 0) {
+            return 0;
+        }
+        __DMB();
+        uint8_t half = g_latest_half;
+        uint32_t tick = g_latest_tick;
+        for (uint8_t i = 0; i < ADC_SCAN_NUM_CHANNELS; i++) {
+            out->raw[i] = g_dma_buf[half][i];
+        }
+        __DMB();
+        if (g_seq == seq) {
+            out->seq = seq;
+            out->tick = tick;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int8_t AdcScan_ChannelIndex(uint32_t adc_channel) {
+    for (uint8_t i = 0; i < ADC_SCAN_NUM_CHANNELS; i++) {
+        if (k_channels[i] == adc_channel) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+uint32_t AdcScan_GetErrorCount(void) {
+    return g_errors;
+}
+
+static void frame_done(uint8_t half) {
+    AdcScanFrameHook_t hook = g_frame_hook;
+    if (hook != NULL) {
+        hook(g_dma_buf[half]);
+    }
+    g_latest_half = half;
+    g_latest_tick = HAL_GetTick();
+    __DMB();
+    g_seq = g_seq + 1;   // 最后更新，读取方以此判断帧是否完整
+}
+
+void AdcScan_OnHalfComplete(void) {
+    frame_done(0);
+}
+
+void AdcScan_OnComplete(void) {
+    frame_done(1);
+}
+
+/**
+ * @brief ADC 溢出或 DMA 错误：HAL 已停止 DMA，重新从缓冲区起点开始
+ */
+void AdcScan_OnError(void) {
+    g_errors = g_errors + 1;
+    if (g_hadc != NULL) {
+        HAL_ADC_Stop_DMA(g_hadc);
+        HAL_ADC_Start_DMA(g_hadc, (uint32_t*)g_dma_buf, 2 * ADC_SCAN_NUM_CHANNELS);
+    }
+}
+
+/**
+ * @brief 模拟看门狗触发：持续越限时每次转换都会置位，先撤防避免中断风暴
+ */
+void AdcScan_OnWatchdog(void) {
+    AdcScan_DisarmWatchdog();
+    g_awd_count = g_awd_count + 1;
+
+    AdcScanWatchdogHook_t hook = g_awd_hook;
+    if (hook != NULL) {
+        hook(g_awd_channel);
+    }
+}
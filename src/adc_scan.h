@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file           : adc_scan.h
+ * @brief          : 定时器触发的多通道 ADC 扫描（循环 DMA 双缓冲）
+ ******************************************************************************
+ * @description    : 替代“配置通道 → 启动 → 轮询 → 停止”的逐次软件读数：
+ *                   - TIM2 更新事件（TRGO）按固定频率触发 ADC1 扫描一遍全部通道，
+ *                     采样时刻由硬件决定，不受主循环抖动影响；
+ *                   - DMA2 Stream0 以循环模式把结果写入两帧长的缓冲区，
+ *                     半满/全满中断各标记一帧完成；
+ *                   - 读取方用 AdcScan_GetLatest 拷出最近一帧（同一次扫描的
+ *                     全部通道），由帧序号检测拷贝期间是否被 DMA 覆盖；
+ *                   - 需要逐帧处理原始转换流（如过采样滤波）时注册帧钩子，
+ *                     钩子在 DMA 中断里对每一帧调用一次，不会漏帧；
+ *                   - 模拟看门狗（AWD）：硬件逐次比较某一通道的转换结果，
+ *                     越出窗口立即进中断，不等主循环读数。一次性触发：
+ *                     触发后自动撤防，处理完毕再调用 AdcScan_ArmWatchdog。
+ *
+ *                   新增传感器：在 ADC_SCAN_CHANNELS 末尾追加通道，
+ *                   并在 HAL_ADC_MspInit 中把对应引脚配置为模拟输入。
+ ******************************************************************************
+ */
+
+#ifndef __ADC_SCAN_H
+#define __ADC_SCAN_H
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+
+/* 扫描序列（按 rank 顺序） */
+#define ADC_SCAN_CHANNELS                                          \
+    {                                                              \
+        ADC_CHANNEL_1,   /* PA1 -> ADC1_IN1 */                     \
+        ADC_CHANNEL_5,   /* PA5 -> ADC1_IN5（MQ-3 酒精传感器） */  \
+    }
+#define ADC_SCAN_NUM_CHANNELS 2
+
+#define ADC_SCAN_TIM_CLOCK_HZ 10000u     // TIM2 计数频率（预分频后），决定可设置的扫描频率粒度
+#define ADC_SCAN_DEFAULT_RATE_HZ 1000u   // 默认扫描频率（帧/秒），供过采样滤波抽取到上报速率
+
+/* 一帧：同一次扫描得到的全部通道 */
+typedef struct {
+    uint16_t raw[ADC_SCAN_NUM_CHANNELS];   // 按 ADC_SCAN_CHANNELS 顺序
+    uint32_t seq;                          // 帧序号（启动后第 1 帧为 1）
+    uint32_t tick;                         // 该帧完成时的 HAL_GetTick()
+} AdcScanFrame_t;
+
+/**
+ * @brief 帧钩子：DMA 中断上下文中调用，raw 按 ADC_SCAN_CHANNELS 顺序，
+ *        仅在调用期间有效（需尽快返回，不可阻塞）
+ */
+typedef void (*AdcScanFrameHook_t)(const volatile uint16_t* raw);
+
+/**
+ * @brief 看门狗钩子：ADC 中断上下文中调用（需尽快返回，不可阻塞）
+ */
+typedef void (*AdcScanWatchdogHook_t)(uint32_t adc_channel);
+
+/**
+ * @brief 配置扫描序列（ADC 需已按扫描模式 + TIM2 TRGO 触发初始化）
+ */
+void AdcScan_Init(ADC_HandleTypeDef* hadc, TIM_HandleTypeDef* htim);
+
+/**
+ * @brief 按指定频率启动扫描
+ * @param rate_hz 每秒扫描帧数（1 ~ ADC_SCAN_TIM_CLOCK_HZ）
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t AdcScan_Start(uint32_t rate_hz);
+
+void AdcScan_Stop(void);
+
+/**
+ * @brief 注册帧钩子（NULL 取消）
+ */
+void AdcScan_SetFrameHook(AdcScanFrameHook_t hook);
+
+/**
+ * @brief 配置模拟看门狗：监视一个通道，原始码值越出 [low, high] 即触发
+ * @note  配置后处于撤防状态，需 AdcScan_ArmWatchdog
+ * @return 1: 成功; 0: 通道不在扫描序列中或配置失败
+ */
+uint8_t AdcScan_ConfigWatchdog(uint32_t adc_channel, uint16_t low, uint16_t high);
+
+/**
+ * @brief 布防 / 撤防（布防前清除残留标志）
+ */
+void AdcScan_ArmWatchdog(void);
+void AdcScan_DisarmWatchdog(void);
+uint8_t AdcScan_WatchdogArmed(void);
+
+/**
+ * @brief 注册看门狗钩子（NULL 取消）
+ */
+void AdcScan_SetWatchdogHook(AdcScanWatchdogHook_t hook);
+
+/**
+ * @brief 看门狗触发次数
+ */
+uint32_t AdcScan_GetWatchdogCount(void);
+
+/**
+ * @brief 取最近完成的一帧
+ * @return 1: 成功; 0: 尚无数据
+ */
+uint8_t AdcScan_GetLatest(AdcScanFrame_t* out);
+
+/**
+ * @brief 通道在帧中的下标
+ * @return 下标；-1 表示该通道不在扫描序列中
+ */
+int8_t AdcScan_ChannelIndex(uint32_t adc_channel);
+
+/**
+ * @brief ADC 溢出/DMA 错误次数（每次错误后自动重启扫描）
+ */
+uint32_t AdcScan_GetErrorCount(void);
+
+/* 由 stm32f4xx_it.c 中的 HAL 回调调用 */
+void AdcScan_OnHalfComplete(void);
+void AdcScan_OnComplete(void);
+void AdcScan_OnError(void);
+void AdcScan_OnWatchdog(void);
+
+#endif /* __ADC_SCAN_H */
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file           : anomaly.c
+ * @brief          : 流式异常检测实现
+ ******************************************************************************
+ */
+
+#include "anomaly.h"
+
+#include <math.h>
+
+#define Z2_Q8_MAX 0xFFFFFFFFu
+
+void Anomaly_Init(Anomaly_t* a, uint8_t shift, uint16_t warmup, uint16_t min_sigma, float z) {
+    a->shift = (shift < 1) ? 1 : (shift > 15) ? 15 : shift;
+    a->warmup = (warmup < 1) ? 1 : warmup;
+    a->var_floor_q16 = ((int64_t)min_sigma * min_sigma) << 16;
+    if (a->var_floor_q16 == 0) {
+        a->var_floor_q16 = 1;
+    }
+    a->hits = 0;
+    a->hit_tick = 0;
+    Anomaly_SetThreshold(a, z);
+    Anomaly_Reset(a);
+}
+
+void Anomaly_Reset(Anomaly_t* a) {
+    a->mean_q8 = 0;
+    a->var_q16 = a->var_floor_q16;
+    a->z2_q8 = 0;
+    a->z2_peak_q8 = 0;
+    a->seen = 0;
+}
+
+void Anomaly_SetThreshold(Anomaly_t* a, float z) {
+    float z2 = z * z * 256.0f;
+    a->z2_thresh_q8 = (z2 >= 4294967040.0f) ? Z2_Q8_MAX : (uint32_t)z2;
+}
+
+uint8_t Anomaly_Push(Anomaly_t* a, uint16_t code, uint32_t tick) {
+    int32_t x_q8 = (int32_t)code << 8;
+
+    if (a->seen == 0) {
+        a->mean_q8 = x_q8;
+        a->var_q16 = a->var_floor_q16;
+        a->seen = 1;
+        return 0;
+    }
+
+    int32_t diff_q8 = x_q8 - a->mean_q8;
+    int64_t d2_q16 = (int64_t)diff_q8 * diff_q8;
+
+    /* 先用旧统计量打分：新样本不会稀释自己的偏差 */
+    uint8_t hit = 0;
+    if (a->seen >= a->warmup) {
+        int64_t var = (a->var_q16 > a->var_floor_q16) ? a->var_q16 : a->var_floor_q16;
+        uint64_t z2 = (uint64_t)(d2_q16 << 8) / (uint64_t)var;   // |diff| < 2^24，d2 << 8 < 2^56
+        a->z2_q8 = (z2 > Z2_Q8_MAX) ? Z2_Q8_MAX : (uint32_t)z2;
+        if (a->z2_q8 > a->z2_peak_q8) {
+            a->z2_peak_q8 = a->z2_q8;
+        }
+        if (a->z2_q8 >= a->z2_thresh_q8) {
+            a->hits++;
+            a->hit_tick = tick;
+            hit = 1;
+        }
+    } else {
+        a->seen++;
+    }
+
+    /* μ += α·d；σ² = (1 - α)·(σ² + α·d²)（West 的增量 EWMA 方差） */
+    a->mean_q8 += diff_q8 >> a->shift;
+    int64_t v = a->var_q16 + (d2_q16 >> a->shift);
+    a->var_q16 = v - (v >> a->shift);
+    return hit;
+}
+
+uint32_t Anomaly_TakePeak(Anomaly_t* a) {
+    uint32_t peak = a->z2_peak_q8;
+    a->z2_peak_q8 = 0;
+    return peak;
+}
+
+float Anomaly_Z(uint32_t z2_q8) {
+    return sqrtf((float)z2_q8 / 256.0f);
+}
@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file           : anomaly.h
+ * @brief          : 流式异常检测（EWMA 均值/方差 z 分数，定点，固定状态）
+ ******************************************************************************
+ * @description    : 每个样本更新一次指数加权的均值与方差（α = 2^-shift），
+ *                   并以更新前的统计量计算 z² = (x - μ)² / σ²：
+ *                   - 全部为整数运算（均值 Q8、方差 Q16，码值平方单位），
+ *                     每样本一次 64 位除法，可在采样中断中调用；
+ *                   - σ 有下限 min_sigma（码值），避免长时间平稳后 1 个 LSB 的抖动
+ *                     被放大成高分；
+ *                   - 前 warmup 个样本只学习不打分。
+ *
+ *                   状态大小固定，与运行时长无关。阈值比较使用 z² 避免开方，
+ *                   需要上报时由 Anomaly_Z 换算。
+ ******************************************************************************
+ */
+
+#ifndef __ANOMALY_H
+#define __ANOMALY_H
+
+#include <stdint.h>
+
+typedef struct {
+    int32_t mean_q8;              // 均值（码值 × 256）
+    int64_t var_q16;              // 方差（码值² × 65536）
+    int64_t var_floor_q16;        // 方差下限 min_sigma²
+    uint32_t z2_thresh_q8;        // 越限阈值 z²（× 256）
+    uint32_t z2_q8;               // 最近一个样本的 z²
+    uint32_t z2_peak_q8;          // 自上次 Anomaly_TakePeak 以来的最大 z²
+    uint32_t hit_tick;            // 最近一次越限的时刻
+    uint32_t hits;                // 越限样本累计数
+    uint16_t seen;                // 已学习样本数（饱和于 warmup）
+    uint16_t warmup;
+    uint8_t shift;
+} Anomaly_t;
+
+/**
+ * @param shift      EWMA 系数 α = 2^-shift（1~15）；时间常数约 2^shift 个样本
+ * @param warmup     前多少个样本只学习不打分（至少 1）
+ * @param min_sigma  σ 下限（码值）
+ * @param z          越限阈值
+ */
+void Anomaly_Init(Anomaly_t* a, uint8_t shift, uint16_t warmup, uint16_t min_sigma, float z);
+
+/**
+ * @brief 丢弃已学习的统计量（阈值与参数保留），从下一个样本重新预热
+ */
+void Anomaly_Reset(Anomaly_t* a);
+
+void Anomaly_SetThreshold(Anomaly_t* a, float z);
+
+/**
+ * @brief 推入一个样本
+ * @return 1: 该样本越限; 0: 正常或仍在预热
+ */
+uint8_t Anomaly_Push(Anomaly_t* a, uint16_t code, uint32_t tick);
+
+/**
+ * @brief 取走并清零峰值 z²
+ */
+uint32_t Anomaly_TakePeak(Anomaly_t* a);
+
+/**
+ * @brief z²（Q8）→ z
+ */
+float Anomaly_Z(uint32_t z2_q8);
+
+#endif /* __ANOMALY_H */
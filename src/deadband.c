@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file           : deadband.c
+ * @brief          : 遥测参数死区判定实现
+ ******************************************************************************
+ */
+
+#include "deadband.h"
+
+#include <math.h>
+
+void Deadband_Init(Deadband_t* d, float abs, float rel) {
+    Deadband_SetThreshold(d, abs, rel);
+    d->ref = 0.0f;
+    d->has_ref = false;
+}
+
+void Deadband_SetThreshold(Deadband_t* d, float abs, float rel) {
+    d->abs = (abs > 0.0f) ? abs : 0.0f;
+    d->rel = (rel > 0.0f) ? rel : 0.0f;
+}
+
+bool Deadband_Exceeded(const Deadband_t* d, float value) {
+    if (!d->has_ref) {
+        return true;
+    }
+    float band = d->rel * fabsf(d->ref);
+    if (d->abs > band) {
+        band = d->abs;
+    }
+    return fabsf(value - d->ref) > band;
+}
+
+void Deadband_Commit(Deadband_t* d, float value) {
+    d->ref = value;
+    d->has_ref = true;
+}
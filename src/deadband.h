@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file           : deadband.h
+ * @brief          : 单个遥测参数的死区判定（绝对/相对变化量）
+ ******************************************************************************
+ * @description    : 记住上次下传的值，新值与之相差超过死区宽度
+ *                   max(abs, rel·|上次值|) 即视为“有变化”：
+ *                   - 数值较小时由绝对死区把关（避免 0 附近的噪声被相对死区放大），
+ *                     数值较大时由相对死区把关；
+ *                   - abs / rel 为 0 表示不启用该项；两项都为 0 时任何变化都算；
+ *                   - 尚未下传过（无参考值）时总是视为有变化。
+ *                   参考值只在真正下传后由 Deadband_Commit 更新，
+ *                   因此缓慢漂移会累积到超出死区为止，不会被逐轮吞掉。
+ ******************************************************************************
+ */
+
+#ifndef __DEADBAND_H
+#define __DEADBAND_H
+
+#include <stdbool.h>
+
+typedef struct {
+    float abs;                    // 绝对死区（参数单位），0 表示不启用
+    float rel;                    // 相对死区（比例，0.05 = 5%），0 表示不启用
+    float ref;                    // 上次下传的值
+    bool has_ref;
+} Deadband_t;
+
+void Deadband_Init(Deadband_t* d, float abs, float rel);
+
+/**
+ * @brief 只改阈值，保留参考值
+ */
+void Deadband_SetThreshold(Deadband_t* d, float abs, float rel);
+
+bool Deadband_Exceeded(const Deadband_t* d, float value);
+
+/**
+ * @brief 记录已下传的值，作为下一次判定的参考
+ */
+void Deadband_Commit(Deadband_t* d, float value);
+
+#endif /* __DEADBAND_H */
@@ -0,0 +1,355 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.c
+ * @brief          : 延迟（异步）日志实现
+ ******************************************************************************
+ */
+
+#include "dlog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* 单生产者（主循环）/单消费者（DMA 完成中断）环形缓冲区 */
+static uint8_t g_ring[DLOG_RING_SIZE];
+static volatile uint16_t g_head = 0;      // 写入指针（仅主循环修改）
+static volatile uint16_t g_tail = 0;      // 读取指针（仅 DMA 完成中断修改）
+static volatile uint16_t g_inflight = 0;  // 当前 DMA 正在发送的字节数
+static volatile uint8_t g_busy = 0;
+
+static UART_HandleTypeDef* g_huart = NULL;
+static uint32_t g_dropped = 0;        // 累计丢弃字节
+static uint32_t g_dropped_pending = 0; // 尚未上报的丢弃字节
+
+#if !DLOG_BINARY
+/* 文本模式需要格式串；二进制模式下格式串不进固件 */
+static const char* const k_fmt[DLOG_ID_COUNT] = {
+#define DLOG_MSG(name, fmt) fmt,
+#include "dlog_catalog.h"
+#undef DLOG_MSG
+};
+#endif
+
+static uint16_t ring_free(void) {
+    uint16_t head = g_head;
+    uint16_t tail = g_tail;
+    return (uint16_t)((tail + DLOG_RING_SIZE - head - 1) % DLOG_RING_SIZE);
+}
+
+/**
+ * @brief 在 head 之后 offset 处写入数据（尚未提交，消费者不可见）
+ */
+static void ring_put(uint16_t offset, const void* data, uint16_t len) {
+    uint16_t head = (uint16_t)((g_head + offset) % DLOG_RING_SIZE);
+    uint16_t first = (uint16_t)(DLOG_RING_SIZE - head);
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&g_ring[head], data, first);
+    if (len > first) {
+        memcpy(&g_ring[0], (const uint8_t*)data + first, (size_t)(len - first));
+    }
+}
+
+static void ring_commit(uint16_t len) {
+    __DMB();
+    g_head = (uint16_t)((g_head + len) % DLOG_RING_SIZE);
+}
+
+/**
+ * @brief 若 DMA 空闲，则发送 tail 起的一段连续数据
+ * @note  主循环与 DMA 完成中断都会调用，用关中断保护 busy 标志
+ */
+static void dlog_kick(void) {
+    if (g_huart == NULL) {
+        return;
+    }
+
+    __disable_irq();
+    if (g_busy || g_head == g_tail) {
+        __enable_irq();
+        return;
+    }
+    uint16_t tail = g_tail;
+    uint16_t head = g_head;
+    uint16_t n = (head > tail) ? (uint16_t)(head - tail) : (uint16_t)(DLOG_RING_SIZE - tail);
+    g_busy = 1;
+    g_inflight = n;
+    __enable_irq();
+
+    if (HAL_UART_Transmit_DMA(g_huart, &g_ring[tail], n) != HAL_OK) {
+        g_inflight = 0;
+        g_busy = 0;
+    }
+}
+
+void DLog_OnTxComplete(void) {
+    g_tail = (uint16_t)((g_tail + g_inflight) % DLOG_RING_SIZE);
+    g_inflight = 0;
+    g_busy = 0;
+    dlog_kick();
+}
+
+void DLog_Init(UART_HandleTypeDef* huart) {
+    g_huart = huart;
+    g_head = 0;
+    g_tail = 0;
+    g_inflight = 0;
+    g_busy = 0;
+    g_dropped = 0;
+    g_dropped_pending = 0;
+}
+
+uint32_t DLog_GetDroppedBytes(void) {
+    return g_dropped;
+}
+
+void DLog_Flush(uint32_t timeout_ms) {
+    uint32_t start = HAL_GetTick();
+    dlog_kick();
+    while ((g_busy || g_head != g_tail) && (HAL_GetTick() - start) < timeout_ms) {
+        dlog_kick();
+    }
+}
+
+static void note_dropped(uint16_t len) {
+    g_dropped += len;
+    g_dropped_pending += len;
+}
+
+#if DLOG_BINARY
+
+/* ----------------- 二进制记录 ----------------- */
+
+#define DLOG_HDR_LEN 8   /* sync + len + id(2) + tick(4) */
+#define DLOG_MAX_BODY 255
+
+/**
+ * @brief 组装并写入一条记录：body = id(2) + tick(4) + payload
+ */
+static uint8_t put_record(uint16_t id, const uint8_t* payload, uint16_t payload_len) {
+    uint16_t body_len = (uint16_t)(6 + payload_len);
+    uint16_t total = (uint16_t)(2 + body_len + 1);
+    if (body_len > DLOG_MAX_BODY || total > ring_free()) {
+        note_dropped(total);
+        return 0;
+    }
+
+    uint8_t hdr[DLOG_HDR_LEN];
+    uint32_t tick = HAL_GetTick();
+    hdr[0] = DLOG_SYNC;
+    hdr[1] = (uint8_t)body_len;
+    hdr[2] = (uint8_t)(id & 0xFF);
+    hdr[3] = (uint8_t)(id >> 8);
+    hdr[4] = (uint8_t)(tick & 0xFF);
+    hdr[5] = (uint8_t)(tick >> 8);
+    hdr[6] = (uint8_t)(tick >> 16);
+    hdr[7] = (uint8_t)(tick >> 24);
+
+    uint8_t x = 0;
+    for (uint16_t i = 1; i < DLOG_HDR_LEN; i++) {
+        x ^= hdr[i];
+    }
+    for (uint16_t i = 0; i < payload_len; i++) {
+        x ^= payload[i];
+    }
+
+    ring_put(0, hdr, DLOG_HDR_LEN);
+    ring_put(DLOG_HDR_LEN, payload, payload_len);
+    ring_put((uint16_t)(DLOG_HDR_LEN + payload_len), &x, 1);
+    ring_commit(total);
+    return 1;
+}
+
+static void flush_dropped_note(void) {
+    if (g_dropped_pending == 0) {
+        return;
+    }
+    uint32_t n = g_dropped_pending;
+    uint8_t payload[4] = {(uint8_t)n, (uint8_t)(n >> 8), (uint8_t)(n >> 16), (uint8_t)(n >> 24)};
+    if (put_record(DLOG_ID_DROPPED, payload, sizeof(payload))) {
+        g_dropped_pending = 0;
+    }
+}
+
+void DLog_Write(dlog_id_t id, const dlog_arg_t* args, uint8_t nargs) {
+    uint8_t payload[DLOG_MAX_BODY];
+    uint16_t n = 0;
+    const uint16_t cap = DLOG_MAX_BODY - 6;
+
+    flush_dropped_note();
+
+    for (uint8_t i = 0; i < nargs; i++) {
+        if (args[i].kind == DLOG_ARG_STR) {
+            const char* s = (args[i].v.s != NULL) ? args[i].v.s : "";
+            size_t len = strlen(s);
+            uint16_t room = (n + 1 < cap) ? (uint16_t)(cap - n - 1) : 0;
+            if (len > DLOG_STR_MAX) {
+                len = DLOG_STR_MAX;
+            }
+            if (len > room) {
+                len = room;
+            }
+            if (n + 1 > cap) {
+                break;
+            }
+            payload[n++] = (uint8_t)len;
+            memcpy(&payload[n], s, len);
+            n = (uint16_t)(n + len);
+        } else {
+            if (n + 4 > cap) {
+                break;
+            }
+            uint32_t v = args[i].v.u;   /* F32 与 U32 共用同一 32 位表示 */
+            payload[n++] = (uint8_t)v;
+            payload[n++] = (uint8_t)(v >> 8);
+            payload[n++] = (uint8_t)(v >> 16);
+            payload[n++] = (uint8_t)(v >> 24);
+        }
+    }
+
+    put_record((uint16_t)id, payload, n);
+    dlog_kick();
+}
+
+void DLog_WriteText(const char* text, int len) {
+    if (text == NULL || len <= 0) {
+        return;
+    }
+    flush_dropped_note();
+
+    /* TEXT 记录的参数是一个 %s：长度前缀 + 文本；长文本拆成多条 */
+    uint8_t payload[DLOG_MAX_BODY];
+    const uint16_t chunk_max = DLOG_MAX_BODY - 6 - 1;
+    while (len > 0) {
+        uint16_t n = (len > chunk_max) ? chunk_max : (uint16_t)len;
+        payload[0] = (uint8_t)n;
+        memcpy(&payload[1], text, n);
+        put_record(DLOG_ID_TEXT, payload, (uint16_t)(n + 1));
+        text += n;
+        len -= n;
+    }
+    dlog_kick();
+}
+
+#else /* !DLOG_BINARY */
+
+/* ----------------- 文本模式 ----------------- */
+
+static void put_text(const char* text, uint16_t len) {
+    if (g_dropped_pending > 0) {
+        char note[64];
+        int n = snprintf(note, sizeof(note), k_fmt[DLOG_ID_DROPPED], (unsigned long)g_dropped_pending);
+        if (n > 0 && (uint16_t)n < ring_free()) {
+            ring_put(0, note, (uint16_t)n);
+            ring_commit((uint16_t)n);
+            g_dropped_pending = 0;
+        }
+    }
+    if (len > ring_free()) {
+        note_dropped(len);
+        return;
+    }
+    ring_put(0, text, len);
+    ring_commit(len);
+}
+
+/**
+ * @brief 按目录格式串逐个转换说明符格式化参数
+ */
+static uint16_t format_args(char* out, uint16_t out_size, const char* fmt, const dlog_arg_t* args, uint8_t nargs) {
+    uint16_t n = 0;
+    uint8_t ai = 0;
+
+    while (*fmt != '\0' && n + 1 < out_size) {
+        if (*fmt != '%') {
+            out[n++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[n++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        /* 截取一个转换说明符，如 %.3f / %lu / %5s */
+        char spec[16];
+        uint8_t sl = 0;
+        spec[sl++] = *fmt++;
+        while (*fmt != '\0' && sl < sizeof(spec) - 2 && strchr("diuxXcfeEgGs", *fmt) == NULL) {
+            spec[sl++] = *fmt++;
+        }
+        char conv = *fmt;
+        if (conv == '\0') {
+            break;
+        }
+        spec[sl++] = *fmt++;
+        spec[sl] = '\0';
+
+        int w = 0;
+        if (ai < nargs) {
+            const dlog_arg_t* a = &args[ai++];
+            if (conv == 's') {
+                w = snprintf(&out[n], out_size - n, spec, (a->kind == DLOG_ARG_STR && a->v.s) ? a->v.s : "");
+            } else if (strchr("feEgG", conv) != NULL) {
+                w = snprintf(&out[n], out_size - n, spec, (double)((a->kind == DLOG_ARG_F32) ? a->v.f : (float)a->v.u));
+            } else {
+                /* 去掉 l/h 修饰后按 32 位整数输出 */
+                char ispec[16];
+                uint8_t k = 0;
+                for (uint8_t j = 0; spec[j] != '\0'; j++) {
+                    if (spec[j] != 'l' && spec[j] != 'h' && spec[j] != 'z') {
+                        ispec[k++] = spec[j];
+                    }
+                }
+                ispec[k] = '\0';
+                if (conv == 'd' || conv == 'i') {
+                    w = snprintf(&out[n], out_size - n, ispec, (int)(int32_t)a->v.u);
+                } else {
+                    w = snprintf(&out[n], out_size - n, ispec, (unsigned int)a->v.u);
+                }
+            }
+        }
+        if (w > 0) {
+            n = (uint16_t)(n + (((uint16_t)w < out_size - n) ? (uint16_t)w : (uint16_t)(out_size - n - 1)));
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+void DLog_Write(dlog_id_t id, const dlog_arg_t* args, uint8_t nargs) {
+    if ((unsigned)id >= DLOG_ID_COUNT) {
+        return;
+    }
+    char line[256];
+    uint16_t n = format_args(line, sizeof(line), k_fmt[id], args, nargs);
+    put_text(line, n);
+    dlog_kick();
+}
+
+void DLog_WriteText(const char* text, int len) {
+    if (text == NULL || len <= 0) {
+        return;
+    }
+    while (len > 0) {
+        uint16_t n = (len > 0xFFFF) ? 0xFFFF : (uint16_t)len;
+        put_text(text, n);
+        text += n;
+        len -= n;
+    }
+    dlog_kick();
+}
+
+#endif /* DLOG_BINARY */
+
+void DLog_Poll(void) {
+#if DLOG_BINARY
+    flush_dropped_note();
+#else
+    if (g_dropped_pending > 0) {
+        put_text("", 0);
+    }
+#endif
+    dlog_kick();
+}
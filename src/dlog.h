@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ * @file           : dlog.h
+ * @brief          : 延迟（异步）日志：RAM 环形缓冲 + USART1 DMA 后台发送
+ ******************************************************************************
+ * @description    : 替代阻塞式 printf → HAL_UART_Transmit(HAL_MAX_DELAY)：
+ *                   - DLOG(名称, 参数...)：只写入“消息ID + 原始参数”的二进制记录，
+ *                     格式串留在 dlog_catalog.h，由主机端 tools/dlog_decode.py 还原；
+ *                   - printf（经 _write）：整段文本作为 TEXT 记录写入同一缓冲；
+ *                   - 缓冲区由 USART1 DMA 在后台发送，调用方从不等待串口。
+ *                   缓冲区满时丢弃新日志并计数，之后补发一条 DROPPED 记录。
+ *
+ *                   记录格式（小端）：
+ *                     [0xA5][len][id:2][tick_ms:4][args...][xor]
+ *                   len = id 到 args 末尾的字节数；xor = len..args 的异或校验。
+ *
+ *                   编译选项 DLOG_BINARY=0：DLOG 在本地按格式串格式化为文本，
+ *                   输出纯文本流（串口监视器可直接阅读；主机端构建默认如此）。
+ ******************************************************************************
+ */
+
+#ifndef __DLOG_H
+#define __DLOG_H
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+
+#ifndef DLOG_BINARY
+#ifdef HOST_BUILD
+#define DLOG_BINARY 0
+#else
+#define DLOG_BINARY 1
+#endif
+#endif
+
+#ifndef DLOG_RING_SIZE
+#define DLOG_RING_SIZE 4096   // 环形缓冲区大小（字节）
+#endif
+
+#define DLOG_SYNC 0xA5
+#define DLOG_STR_MAX 200      // 单个 %s 参数最多记录的字节数
+
+/* 消息ID（由 dlog_catalog.h 生成） */
+typedef enum {
+#define DLOG_MSG(name, fmt) DLOG_ID_##name,
+#include "dlog_catalog.h"
+#undef DLOG_MSG
+    DLOG_ID_COUNT
+} dlog_id_t;
+
+/* 参数：由 DLOG 宏按实参类型自动打包 */
+typedef enum {
+    DLOG_ARG_U32 = 0,
+    DLOG_ARG_F32,
+    DLOG_ARG_STR,
+} dlog_arg_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    union {
+        uint32_t u;
+        float f;
+        const char* s;
+    } v;
+} dlog_arg_t;
+
+static inline dlog_arg_t dlog_arg_u(uint32_t x) { dlog_arg_t a; a.kind = DLOG_ARG_U32; a.v.u = x; return a; }
+static inline dlog_arg_t dlog_arg_f(double x) { dlog_arg_t a; a.kind = DLOG_ARG_F32; a.v.f = (float)x; return a; }
+static inline dlog_arg_t dlog_arg_s(const char* x) { dlog_arg_t a; a.kind = DLOG_ARG_STR; a.v.s = x; return a; }
+
+#define DLOG_ARG(x) _Generic((x),           \
+        float: dlog_arg_f,                  \
+        double: dlog_arg_f,                 \
+        char*: dlog_arg_s,                  \
+        const char*: dlog_arg_s,            \
+        default: dlog_arg_u)(x)
+
+/* 参数个数（0~8）与逐个打包；列表以 {0} 占位开头，避免空初始化列表 */
+#define DLOG_NARG(...) DLOG_NARG_(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a) , DLOG_ARG(a)
+#define DLOG_ARGS_2(a, ...) , DLOG_ARG(a) DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...) , DLOG_ARG(a) DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...) , DLOG_ARG(a) DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...) , DLOG_ARG(a) DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...) , DLOG_ARG(a) DLOG_ARGS_5(__VA_ARGS__)
+#define DLOG_ARGS_7(a, ...) , DLOG_ARG(a) DLOG_ARGS_6(__VA_ARGS__)
+#define DLOG_ARGS_8(a, ...) , DLOG_ARG(a) DLOG_ARGS_7(__VA_ARGS__)
+
+/**
+ * @brief 记录一条目录消息（非阻塞，耗时为微秒级）
+ * @note  用法：DLOG(MAIN_SAMPLE, counter, status, adc, voltage, ppm);
+ *        实参个数与类型必须与 dlog_catalog.h 中的格式串一致。
+ */
+#define DLOG(name, ...)                                                         \
+    DLog_Write(DLOG_ID_##name,                                                  \
+               (const dlog_arg_t[]){ {0} DLOG_CAT(DLOG_ARGS_, DLOG_NARG(__VA_ARGS__))(__VA_ARGS__) } + 1, \
+               DLOG_NARG(__VA_ARGS__))
+
+/**
+ * @brief 初始化延迟日志
+ * @param huart 输出串口（USART1，需已关联 TX DMA）
+ */
+void DLog_Init(UART_HandleTypeDef* huart);
+
+/**
+ * @brief 写入一条消息记录（一般通过 DLOG 宏调用）
+ */
+void DLog_Write(dlog_id_t id, const dlog_arg_t* args, uint8_t nargs);
+
+/**
+ * @brief 写入一段文本（printf 重定向入口）
+ */
+void DLog_WriteText(const char* text, int len);
+
+/**
+ * @brief 阻塞等待缓冲区发完（仅用于断言/故障等致命路径）
+ */
+void DLog_Flush(uint32_t timeout_ms);
+
+/**
+ * @brief 周期调用（调度器日志任务）：补记丢弃统计，DMA 空闲且有待发数据时启动发送
+ * @note  启动 DMA 失败或缓冲区满时，数据/丢弃记录原本要等下一次写入才会发出
+ */
+void DLog_Poll(void);
+
+/**
+ * @brief DMA 发送完成回调（在 HAL_UART_TxCpltCallback 中调用）
+ */
+void DLog_OnTxComplete(void);
+
+/**
+ * @brief 累计丢弃的字节数（缓冲区满）
+ */
+uint32_t DLog_GetDroppedBytes(void);
+
+#endif /* __DLOG_H */
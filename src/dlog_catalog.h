@@ -0,0 +1,42 @@
+/**
+ ******************************************************************************
+ * @file           : dlog_catalog.h
+ * @brief          : 延迟日志消息目录（格式串 ↔ 消息ID）
+ ******************************************************************************
+ * @description    : 每行 DLOG_MSG(名称, "格式串") 定义一条消息，ID 即行序号（从 0 开始）。
+ *                   固件只记录 ID + 原始参数；主机端 tools/dlog_decode.py 读取本文件
+ *                   还原文本。参数类型由格式串决定：
+ *                   - %d %i %u %x %X %c（可带 l/h 修饰）：32 位整数
+ *                   - %f %e %g：32 位浮点
+ *                   - %s：字符串（长度前缀，超长截断）
+ *
+ *                   注意：只在末尾追加新消息，不要插入/删除/重排已有行，
+ *                   否则旧日志将无法正确解码。
+ ******************************************************************************
+ */
+
+/* 保留：0 = printf 文本透传，1 = 丢弃统计 */
+DLOG_MSG(TEXT,            "%s")
+DLOG_MSG(DROPPED,         "[dlog] 日志缓冲区满，丢弃 %lu 字节\r\n")
+
+/* ESP8266 驱动 */
+DLOG_MSG(ESP_TX,          "[发送] %s")
+DLOG_MSG(ESP_RX,          "[响应] %s\r\n")
+DLOG_MSG(ESP_RX_TIMEOUT,  "[超时响应] %s\r\n")
+DLOG_MSG(ESP_NO_RESPONSE, "[超时] 未收到任何响应\r\n")
+DLOG_MSG(ESP_STATUS_WIFI, "[CIPSTATUS][WiFi] %s\r\n")
+DLOG_MSG(ESP_STATUS_TCP,  "[CIPSTATUS] %s\r\n")
+
+/* 主循环 */
+DLOG_MSG(MAIN_SAMPLE,     "[%lu] MQ-3 状态=%u(0就绪/1预热/2错误/3未就绪) ADC=%u 电压=%.3f V 酒精=%.2f ppm\r\n")
+DLOG_MSG(MAIN_PUS_FAIL,   "   [警告] PUS发送失败，触发重连\r\n")
+
+/* 调度器 */
+DLOG_MSG(SCHED_MISS,      "[调度] 任务 %s 超过截止时间，延迟 %lu ms\r\n")
+
+/* 带浮点参数的提示（固件不链接浮点 printf，由主机端解码器格式化） */
+DLOG_MSG(MAIN_DEADBAND,   "[指令] HK 死区 %s：abs %.3f rel %.3f%s\r\n")
+DLOG_MSG(MAIN_AWD_LEVEL,  "[模拟看门狗] 告警阈值 %.0f ppm → ADC %u\r\n")
+DLOG_MSG(MQ_CAL_OK,       "[%s] 校准完成！R0 = %.2f kΩ（%u 样本，剔除 %u，RSD %.2f%%）\r\n")
+DLOG_MSG(MQ_CAL_FAIL,     "[%s] 校准失败（%u 样本，剔除 %u，RSD %.2f%%），沿用 R0 = %.2f kΩ\r\n")
+DLOG_MSG(MAIN_AWD_NOISE,  "[模拟看门狗] 越界后滤波浓度未达告警阈值（%.2f ppm），视为噪声，恢复正常采样率\r\n")
@@ -0,0 +1,367 @@
+/**
+ ******************************************************************************
+ * @file           : dsp.c
+ * @brief          : 定点 DSP 小核实现（可移植 C / Cortex-M4 DSP / SSE2 / AVX2）
+ ******************************************************************************
+ */
+
+#include "dsp.h"
+
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && !defined(HOST_BUILD)
+#include "stm32f4xx_hal.h"   // CMSIS 内建：__SMLAD / __SMLALD / __SXTB16 / __USUB16 / __SEL
+#define DSP_HAVE_M4 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DSP_HAVE_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DSP_HAVE_AVX2 1
+#endif
+
+#if defined(DSP_HAVE_M4)
+#define DSP_BEST(fn) fn##_m4
+#elif defined(DSP_HAVE_AVX2)
+#define DSP_BEST(fn) fn##_avx2
+#elif defined(DSP_HAVE_SSE2)
+#define DSP_BEST(fn) fn##_sse2
+#else
+#define DSP_BEST(fn) fn##_c
+#endif
+
+/* ========================= 可移植 C（参考） ========================= */
+
+static int32_t dot_q7_c(const int8_t* a, const int8_t* b, uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint32_t)((int32_t)a[i] * b[i]);
+    }
+    return (int32_t)acc;
+}
+
+static int64_t dot_q15_c(const int16_t* a, const int16_t* b, uint32_t n) {
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (int32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+static void stats_u16_c(const uint16_t* x, uint32_t n, DspStatsU16_t* out) {
+    uint32_t sum = 0;
+    uint16_t lo = 0xFFFF;
+    uint16_t hi = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum += x[i];
+        lo = (x[i] < lo) ? x[i] : lo;
+        hi = (x[i] > hi) ? x[i] : hi;
+    }
+    out->sum = sum;
+    out->min = lo;
+    out->max = hi;
+}
+
+/* ========================= Cortex-M4 DSP ========================= */
+
+#if defined(DSP_HAVE_M4)
+static inline uint32_t rd32(const void* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));   // M4 允许非对齐 LDR，编译为单条加载
+    return v;
+}
+
+static int32_t dot_q7_m4(const int8_t* a, const int8_t* b, uint32_t n) {
+    uint32_t acc = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t wa = rd32(a + i);
+        uint32_t wb = rd32(b + i);
+        /* SXTB16：字节 0/2 符号扩展为两个半字；循环右移 8 位后取字节 1/3 */
+        acc = __SMLAD(__SXTB16(wa), __SXTB16(wb), acc);
+        acc = __SMLAD(__SXTB16(__ROR(wa, 8)), __SXTB16(__ROR(wb, 8)), acc);
+    }
+    for (; i < n; i++) {
+        acc += (uint32_t)((int32_t)a[i] * b[i]);
+    }
+    return (int32_t)acc;
+}
+
+static int64_t dot_q15_m4(const int16_t* a, const int16_t* b, uint32_t n) {
+    uint64_t acc = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = __SMLALD(rd32(a + i), rd32(b + i), acc);
+        acc = __SMLALD(rd32(a + i + 2), rd32(b + i + 2), acc);
+    }
+    for (; i < n; i++) {
+        acc += (uint64_t)(int64_t)((int32_t)a[i] * b[i]);
+    }
+    return (int64_t)acc;
+}
+
+static void stats_u16_m4(const uint16_t* x, uint32_t n, DspStatsU16_t* out) {
+    uint32_t sum = 0;
+    uint32_t lo = 0xFFFFFFFFu;
+    uint32_t hi = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint32_t w = rd32(x + i);
+        sum += (w & 0xFFFFu) + (w >> 16);
+        (void)__USUB16(w, lo);   // GE 位：w ≥ lo 的半字
+        lo = __SEL(lo, w);
+        (void)__USUB16(w, hi);
+        hi = __SEL(w, hi);
+    }
+    uint16_t lo16 = ((lo & 0xFFFFu) < (lo >> 16)) ? (uint16_t)lo : (uint16_t)(lo >> 16);
+    uint16_t hi16 = ((hi & 0xFFFFu) > (hi >> 16)) ? (uint16_t)hi : (uint16_t)(hi >> 16);
+    if (i < n) {
+        sum += x[i];
+        lo16 = (x[i] < lo16) ? x[i] : lo16;
+        hi16 = (x[i] > hi16) ? x[i] : hi16;
+    }
+    out->sum = sum;
+    out->min = lo16;
+    out->max = hi16;
+}
+#endif /* DSP_HAVE_M4 */
+
+/* ========================= x86 SSE2 ========================= */
+
+#if defined(DSP_HAVE_SSE2)
+static uint32_t hsum_epi32_sse2(__m128i v) {
+    uint32_t lane[4];
+    _mm_storeu_si128((__m128i*)lane, v);
+    return lane[0] + lane[1] + lane[2] + lane[3];
+}
+
+static int32_t dot_q7_sse2(const int8_t* a, const int8_t* b, uint32_t n) {
+    __m128i acc = _mm_setzero_si128();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        /* 字节与自身交织后算术右移 8 位 = 符号扩展为 16 位 */
+        __m128i alo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i ahi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i blo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i bhi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(alo, blo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(ahi, bhi));
+    }
+    uint32_t sum = hsum_epi32_sse2(acc);
+    for (; i < n; i++) {
+        sum += (uint32_t)((int32_t)a[i] * b[i]);
+    }
+    return (int32_t)sum;
+}
+
+/* pmaddwd 的两两和只有 (-32768)·(-32768) × 2 = 2^31 会回绕成 INT32_MIN（真值下限为 -2^31 + 2^16），
+ * 扩展为 int64 时把这种通道当作无符号处理 */
+static __m128i madd_widen_sse2(__m128i acc, __m128i m) {
+    __m128i wrapped = _mm_cmpeq_epi32(m, _mm_set1_epi32((int32_t)0x80000000u));
+    __m128i sign = _mm_andnot_si128(wrapped, _mm_srai_epi32(m, 31));
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(m, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(m, sign));
+}
+
+static int64_t dot_q15_sse2(const int16_t* a, const int16_t* b, uint32_t n) {
+    __m128i acc = _mm_setzero_si128();
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        acc = madd_widen_sse2(acc, _mm_madd_epi16(va, vb));
+    }
+    int64_t lane[2];
+    _mm_storeu_si128((__m128i*)lane, acc);
+    int64_t sum = lane[0] + lane[1];
+    for (; i < n; i++) {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+static void stats_u16_sse2(const uint16_t* x, uint32_t n, DspStatsU16_t* out) {
+    /* SSE2 只有有符号 16 位 min/max：异或 0x8000 后比较，结果再异或回来 */
+    const __m128i bias = _mm_set1_epi16((int16_t)0x8000);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vlo = _mm_set1_epi16(0x7FFF);
+    __m128i vhi = _mm_set1_epi16((int16_t)0x8000);
+    __m128i acc = zero;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(x + i));
+        __m128i s = _mm_xor_si128(v, bias);
+        vlo = _mm_min_epi16(vlo, s);
+        vhi = _mm_max_epi16(vhi, s);
+        acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+        acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+    }
+    uint16_t lo_lane[8];
+    uint16_t hi_lane[8];
+    _mm_storeu_si128((__m128i*)lo_lane, _mm_xor_si128(vlo, bias));
+    _mm_storeu_si128((__m128i*)hi_lane, _mm_xor_si128(vhi, bias));
+    uint16_t lo = 0xFFFF;
+    uint16_t hi = 0;
+    for (uint8_t k = 0; k < 8; k++) {
+        lo = (lo_lane[k] < lo) ? lo_lane[k] : lo;
+        hi = (hi_lane[k] > hi) ? hi_lane[k] : hi;
+    }
+    uint32_t sum = hsum_epi32_sse2(acc);
+    for (; i < n; i++) {
+        sum += x[i];
+        lo = (x[i] < lo) ? x[i] : lo;
+        hi = (x[i] > hi) ? x[i] : hi;
+    }
+    out->sum = sum;
+    out->min = lo;
+    out->max = hi;
+}
+#endif /* DSP_HAVE_SSE2 */
+
+/* ========================= x86 AVX2 ========================= */
+
+#if defined(DSP_HAVE_AVX2)
+static int32_t dot_q7_avx2(const int8_t* a, const int8_t* b, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    uint32_t sum = hsum_epi32_sse2(_mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+    for (; i < n; i++) {
+        sum += (uint32_t)((int32_t)a[i] * b[i]);
+    }
+    return (int32_t)sum;
+}
+
+static int64_t dot_q15_avx2(const int16_t* a, const int16_t* b, uint32_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i m = _mm256_madd_epi16(va, vb);
+        __m256i wrapped = _mm256_cmpeq_epi32(m, _mm256_set1_epi32((int32_t)0x80000000u));
+        __m256i sign = _mm256_andnot_si256(wrapped, _mm256_srai_epi32(m, 31));
+        acc = _mm256_add_epi64(acc, _mm256_unpacklo_epi32(m, sign));
+        acc = _mm256_add_epi64(acc, _mm256_unpackhi_epi32(m, sign));
+    }
+    int64_t lane[4];
+    _mm256_storeu_si256((__m256i*)lane, acc);
+    int64_t sum = lane[0] + lane[1] + lane[2] + lane[3];
+    for (; i < n; i++) {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+static void stats_u16_avx2(const uint16_t* x, uint32_t n, DspStatsU16_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vlo = _mm256_set1_epi16((int16_t)0xFFFF);
+    __m256i vhi = zero;
+    __m256i acc = zero;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(x + i));
+        vlo = _mm256_min_epu16(vlo, v);
+        vhi = _mm256_max_epu16(vhi, v);
+        acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+        acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+    }
+    uint16_t lo_lane[16];
+    uint16_t hi_lane[16];
+    _mm256_storeu_si256((__m256i*)lo_lane, vlo);
+    _mm256_storeu_si256((__m256i*)hi_lane, vhi);
+    uint16_t lo = 0xFFFF;
+    uint16_t hi = 0;
+    for (uint8_t k = 0; k < 16; k++) {
+        lo = (lo_lane[k] < lo) ? lo_lane[k] : lo;
+        hi = (hi_lane[k] > hi) ? hi_lane[k] : hi;
+    }
+    uint32_t sum = hsum_epi32_sse2(_mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+    for (; i < n; i++) {
+        sum += x[i];
+        lo = (x[i] < lo) ? x[i] : lo;
+        hi = (x[i] > hi) ? x[i] : hi;
+    }
+    out->sum = sum;
+    out->min = lo;
+    out->max = hi;
+}
+#endif /* DSP_HAVE_AVX2 */
+
+/* ========================= 公共接口 ========================= */
+
+static const DspImpl_t k_impls[] = {
+    {"c", dot_q7_c, dot_q15_c, stats_u16_c},
+#if defined(DSP_HAVE_M4)
+    {"cortex-m4", dot_q7_m4, dot_q15_m4, stats_u16_m4},
+#endif
+#if defined(DSP_HAVE_SSE2)
+    {"sse2", dot_q7_sse2, dot_q15_sse2, stats_u16_sse2},
+#endif
+#if defined(DSP_HAVE_AVX2)
+    {"avx2", dot_q7_avx2, dot_q15_avx2, stats_u16_avx2},
+#endif
+};
+
+const DspImpl_t* Dsp_Implementations(uint8_t* count) {
+    *count = (uint8_t)(sizeof(k_impls) / sizeof(k_impls[0]));
+    return k_impls;
+}
+
+int32_t Dsp_DotQ7(const int8_t* a, const int8_t* b, uint32_t n) {
+    return DSP_BEST(dot_q7)(a, b, n);
+}
+
+int64_t Dsp_DotQ15(const int16_t* a, const int16_t* b, uint32_t n) {
+    return DSP_BEST(dot_q15)(a, b, n);
+}
+
+void Dsp_StatsU16(const uint16_t* x, uint32_t n, DspStatsU16_t* out) {
+    DSP_BEST(stats_u16)(x, n, out);
+}
+
+static inline int16_t sat16(int64_t v) {
+    return (int16_t)((v < -32768) ? -32768 : (v > 32767) ? 32767 : v);
+}
+
+/* 右移 shift 位，四舍五入（.5 向上） */
+static inline int64_t round_shift(int64_t v, uint8_t shift) {
+    return (shift == 0) ? v : (v + ((int64_t)1 << (shift - 1))) >> shift;
+}
+
+void Dsp_FirQ15(const int16_t* coeff, uint16_t taps, uint8_t shift, const int16_t* x, int16_t* y, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        y[i] = sat16(round_shift(Dsp_DotQ15(coeff, x + i, taps), shift));
+    }
+}
+
+void Dsp_BiquadQ14(DspBiquadQ14_t* f, const int16_t* in, int16_t* out, uint32_t n) {
+    int32_t x1 = f->x1;
+    int32_t x2 = f->x2;
+    int32_t y1 = f->y1;
+    int32_t y2 = f->y2;
+
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t x0 = in[i];
+        int64_t acc = (int64_t)f->b0 * x0 + (int64_t)f->b1 * x1 + (int64_t)f->b2 * x2
+                    - (int64_t)f->a1 * y1 - (int64_t)f->a2 * y2;
+        int16_t y0 = sat16(round_shift(acc, 14));
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+        out[i] = y0;
+    }
+    f->x1 = (int16_t)x1;
+    f->x2 = (int16_t)x2;
+    f->y1 = (int16_t)y1;
+    f->y2 = (int16_t)y2;
+}
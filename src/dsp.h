@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file           : dsp.h
+ * @brief          : 定点 DSP 小核：q7/q15 点积、FIR、双二阶滤波、块求和/最小/最大
+ ******************************************************************************
+ * @description    : 全部为整数运算，各实现逐位一致：
+ *                   - 目标板（Cortex-M4，__ARM_FEATURE_DSP）：SMLAD / SMLALD / SXTB16 /
+ *                     USUB16 + SEL 等 SIMD 指令，每条指令处理两个 16 位量；
+ *                   - 主机（HOST_BUILD）：x86-64 上默认 SSE2，编译时加 -mavx2 则用 AVX2；
+ *                   - 其他平台：可移植 C（同时作为逐位校验的参考）。
+ *                   Dsp_* 在编译期选定最快的实现；Dsp_Implementations 列出本次编译
+ *                   可用的全部实现，供 host_bench dsp 逐一校验与测速。
+ *
+ *                   双二阶滤波是逐样本递推，无法跨样本并行，各平台共用 C 实现。
+ ******************************************************************************
+ */
+
+#ifndef __DSP_H
+#define __DSP_H
+
+#include <stdint.h>
+
+/* 块统计结果；n = 0 时 sum = 0、min = 0xFFFF、max = 0 */
+typedef struct {
+    uint32_t sum;                 // 模 2^32 累加
+    uint16_t min;
+    uint16_t max;
+} DspStatsU16_t;
+
+/* 直接 I 型双二阶（Q14 系数，|a1| < 2），y = b0·x + b1·x1 + b2·x2 - a1·y1 - a2·y2 */
+typedef struct {
+    int16_t b0, b1, b2;
+    int16_t a1, a2;
+    int16_t x1, x2;               // 状态：上两个输入/输出，初始化为 0
+    int16_t y1, y2;
+} DspBiquadQ14_t;
+
+/* 一种实现（host_bench dsp 用） */
+typedef struct {
+    const char* name;
+    int32_t (*dot_q7)(const int8_t* a, const int8_t* b, uint32_t n);
+    int64_t (*dot_q15)(const int16_t* a, const int16_t* b, uint32_t n);
+    void (*stats_u16)(const uint16_t* x, uint32_t n, DspStatsU16_t* out);
+} DspImpl_t;
+
+/**
+ * @brief q7 点积 Σ a[i]·b[i]
+ * @note  按 int32 累加（模 2^32）；n ≤ 131072 时不会溢出
+ */
+int32_t Dsp_DotQ7(const int8_t* a, const int8_t* b, uint32_t n);
+
+/**
+ * @brief q15 点积 Σ a[i]·b[i]，int64 累加（不溢出）
+ */
+int64_t Dsp_DotQ15(const int16_t* a, const int16_t* b, uint32_t n);
+
+void Dsp_StatsU16(const uint16_t* x, uint32_t n, DspStatsU16_t* out);
+
+/**
+ * @brief FIR：y[i] = sat16(round(Σ_k coeff[k]·x[i + k] / 2^shift))，i = 0 .. n-1
+ * @param x 需有 n + taps - 1 个样本（前 taps - 1 个为上一块的尾部）；
+ *          系数按 x 的时间顺序排列（非对称滤波器需调用方反转）
+ */
+void Dsp_FirQ15(const int16_t* coeff, uint16_t taps, uint8_t shift, const int16_t* x, int16_t* y, uint32_t n);
+
+/**
+ * @brief 双二阶滤波一个块（状态保存在 f 中，可分块连续调用；in 与 out 可相同）
+ */
+void Dsp_BiquadQ14(DspBiquadQ14_t* f, const int16_t* in, int16_t* out, uint32_t n);
+
+/**
+ * @brief 本次编译可用的实现：[0] 为可移植 C 参考，最后一项即 Dsp_* 使用的实现
+ */
+const DspImpl_t* Dsp_Implementations(uint8_t* count);
+
+#endif /* __DSP_H */
@@ -1,4 +1,5 @@
 #include "esp8266_driver.h"
+#include "dlog.h"
 
 // ----------------- 环形缓冲区实现 -----------------
 
@@ -17,6 +18,16 @@ static RingBuffer_t rx_buffer = {{0}, 0, 0};
 // 声明一个单字节的接收缓冲区, 用于中断接收
 static uint8_t uart_rx_byte; 
 
+// +IPD 解析器复位 / 逐字节消费（实现见下文）
+static void ipd_reset(void);
+static uint8_t ipd_consume_byte(uint8_t b);
+static void evt_reset(void);
+
+static uint8_t wait_for_string(const char* target, const char* fail, uint32_t timeout);
+
+/* 正在执行 +IPD / 主动上报回调：回调中不得再读缓冲区或发指令（见 ESP8266_PollIPD） */
+static uint8_t in_sink = 0;
+
 // ----------------- 驱动核心函数 -----------------
 
 /**
@@ -55,9 +66,15 @@ void ESP8266_RxCallback(void) {
  * @brief 清空环形缓冲区
  */
 void ESP8266_ClearBuffer(void) {
+    if (in_sink) {
+        return;   // 回调期间清空会抹掉调用方正在读的片段
+    }
     // 通过将头尾指针设为相同来清空缓冲区
     rx_buffer.head = 0;
     rx_buffer.tail = 0;
+    // 丢弃了半帧数据, +IPD 解析器与主动上报的行缓冲也要重新同步
+    ipd_reset();
+    evt_reset();
     // 可选: 清零物理内存
     memset((void*)rx_buffer.buffer, 0, ESP8266_RX_BUFFER_SIZE);
 }
@@ -66,20 +83,35 @@ void ESP8266_ClearBuffer(void) {
  * @brief 向ESP8266发送命令
  */
 void ESP8266_SendCommand(const char* cmd) {
+    if (in_sink) {
+        return;
+    }
     // 通过调试串口打印发送的命令
-    printf("[发送] %s", cmd);
+    DLOG(ESP_TX, cmd);
     // 通过UART2将命令发送给ESP8266
     HAL_UART_Transmit(&huart2, (uint8_t*)cmd, strlen(cmd), 1000);
 }
 
 /**
  * @brief 从环形缓冲区读取数据, 直到找到目标字符串或超时
+ * @note  等待期间到达的 +IPD payload（多连接时其他链路的下行数据）照常投递给接收回调,
+ *        不参与匹配, 也不会被丢弃
  */
 uint8_t ESP8266_WaitForString(const char* target, uint32_t timeout) {
+    return wait_for_string(target, NULL, timeout);
+}
+
+/**
+ * @brief WaitForString 的实现；fail 非空时, 收到 fail 字符串立即返回失败（不必等到超时）
+ */
+static uint8_t wait_for_string(const char* target, const char* fail, uint32_t timeout) {
     char temp_buf[ESP8266_RX_BUFFER_SIZE] = {0};
     uint16_t current_len = 0;
     uint32_t start_tick = HAL_GetTick();
 
+    if (in_sink) {
+        return 0;
+    }
     while ((HAL_GetTick() - start_tick) < timeout) {
         // 检查环形缓冲区是否有新数据
         while (rx_buffer.tail != rx_buffer.head) {
@@ -87,6 +119,11 @@ uint8_t ESP8266_WaitForString(const char* target, uint32_t timeout) {
             char c = rx_buffer.buffer[rx_buffer.tail];
             rx_buffer.tail = (rx_buffer.tail + 1) % ESP8266_RX_BUFFER_SIZE;
 
+            // +IPD payload 字节：已投递给接收回调
+            if (ipd_consume_byte((uint8_t)c)) {
+                continue;
+            }
+
             // 将取出的字节存入临时缓冲区
             if (current_len < sizeof(temp_buf) - 1) {
                 temp_buf[current_len++] = c;
@@ -95,9 +132,13 @@ uint8_t ESP8266_WaitForString(const char* target, uint32_t timeout) {
             // 检查临时缓冲区中是否包含目标字符串
             if (strstr(temp_buf, target)) {
                 // 为了调试, 打印收到的完整响应
-                printf("[响应] %s\r\n", temp_buf);
+                DLOG(ESP_RX, temp_buf);
                 return 1; // 找到了
             }
+            if (fail != NULL && strstr(temp_buf, fail)) {
+                DLOG(ESP_RX, temp_buf);
+                return 0;
+            }
         }
         // 短暂延时, 避免CPU空转
         HAL_Delay(1);
@@ -105,9 +146,9 @@ uint8_t ESP8266_WaitForString(const char* target, uint32_t timeout) {
     
     // 超时, 打印已收到的数据以供调试
     if(current_len > 0) {
-        printf("[超时响应] %s\r\n", temp_buf);
+        DLOG(ESP_RX_TIMEOUT, temp_buf);
     } else {
-        printf("[超时] 未收到任何响应\r\n");
+        DLOG(ESP_NO_RESPONSE);
     }
 
     return 0; // 超时未找到
@@ -128,7 +169,7 @@ uint8_t ESP8266_SendAndWaitOK(const char* cmd, uint32_t timeout) {
 uint16_t ESP8266_GetBuffer(char* buffer, uint16_t buffer_size) {
     uint16_t len = 0;
     // 确保传入的buffer足够大
-    if (buffer == NULL || buffer_size == 0) {
+    if (buffer == NULL || buffer_size == 0 || in_sink) {
         return 0;
     }
 
@@ -144,22 +185,49 @@ uint16_t ESP8266_GetBuffer(char* buffer, uint16_t buffer_size) {
 
 // ----------------- 状态查询 -----------------
 
+/**
+ * @brief 发送 AT+CIPSTATUS 并收集完整响应（直到 OK / ERROR，最多 1 s）
+ * @note  逐字节经 +IPD 解析器：其间到达的下行 payload 照常投递, 不混进响应
+ */
+static uint16_t cipstatus_query(char* resp, uint16_t size) {
+    uint16_t len = 0;
+    uint32_t start_tick = HAL_GetTick();
+
+    resp[0] = '\0';
+    if (in_sink) {
+        return 0;
+    }
+    ESP8266_PollIPD();
+    ESP8266_SendCommand("AT+CIPSTATUS\r\n");
+
+    while ((HAL_GetTick() - start_tick) < 1000) {
+        while (rx_buffer.tail != rx_buffer.head && len < size - 1) {
+            uint8_t c = rx_buffer.buffer[rx_buffer.tail];
+            rx_buffer.tail = (rx_buffer.tail + 1) % ESP8266_RX_BUFFER_SIZE;
+            if (!ipd_consume_byte(c)) {
+                resp[len++] = (char)c;
+            }
+        }
+        resp[len] = '\0';
+        if (strstr(resp, "\r\nOK\r\n") != NULL || strstr(resp, "ERROR") != NULL) {
+            break;
+        }
+        HAL_Delay(1);
+    }
+    return len;
+}
+
 /**
  * @brief 判断是否已经连接到热点
  */
 uint8_t ESP8266_IsAPConnected(void) {
     char resp[ESP8266_RX_BUFFER_SIZE] = {0};
 
-    ESP8266_ClearBuffer();
-    ESP8266_SendCommand("AT+CIPSTATUS\r\n");
-
-    /* 等待状态返回并取出完整响应 */
-    ESP8266_WaitForString("OK", 1000);
-    ESP8266_GetBuffer(resp, sizeof(resp));
-    printf("[CIPSTATUS][WiFi] %s\r\n", resp);
+    cipstatus_query(resp, sizeof(resp));
+    DLOG(ESP_STATUS_WIFI, resp);
 
-    /* STATUS:2/3 表示已拿到IP（热点连接正常） */
-    if (strstr(resp, "STATUS:2") || strstr(resp, "STATUS:3")) {
+    /* STATUS:2/3/4 表示已拿到IP（热点连接正常，4 只是 TCP 已断开） */
+    if (strstr(resp, "STATUS:2") || strstr(resp, "STATUS:3") || strstr(resp, "STATUS:4")) {
         return 1;
     }
     return 0;
@@ -171,13 +239,8 @@ uint8_t ESP8266_IsAPConnected(void) {
 uint8_t ESP8266_IsTCPConnected(void) {
     char resp[ESP8266_RX_BUFFER_SIZE] = {0};
 
-    ESP8266_ClearBuffer();
-    ESP8266_SendCommand("AT+CIPSTATUS\r\n");
-
-    /* 等待状态返回 */
-    HAL_Delay(300);
-    ESP8266_GetBuffer(resp, sizeof(resp));
-    printf("[CIPSTATUS] %s\r\n", resp);
+    cipstatus_query(resp, sizeof(resp));
+    DLOG(ESP_STATUS_TCP, resp);
 
     /* STATUS:3 表示 TCP 已建立连接 */
     if (strstr(resp, "STATUS:3")) {
@@ -186,6 +249,274 @@ uint8_t ESP8266_IsTCPConnected(void) {
     return 0;
 }
 
+// ----------------- 联网流程 -----------------
+
+/**
+ * @brief  测试ESP8266连接 (重构后)
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_Test(void) {
+    printf("\r\n=== ESP8266 连接诊断 ===\r\n");
+    
+    if (ESP8266_SendAndWaitOK("AT\r\n", 2000)) {
+        printf("✓ ESP8266响应正常！\r\n");
+        printf("=========================\r\n\r\n");
+        
+        // 获取版本信息
+        printf("正在获取ESP8266版本信息...\r\n");
+        ESP8266_ClearBuffer();
+        ESP8266_SendCommand("AT+GMR\r\n");
+        if(ESP8266_WaitForString("OK", 2000)) {
+            // 响应已在 WaitForString 内部打印
+        }
+        return 1;
+    } else {
+        printf("\r\n✗ ESP8266无响应！\r\n");
+        printf("\r\n请检查以下问题：\r\n");
+        printf("  1. ESP8266是否正确供电（3.3V，需要200-300mA电流）\r\n");
+        printf("  2. TX/RX连接是否交叉（STM32 TX→ESP8266 RX, STM32 RX→ESP8266 TX）\r\n");
+        printf("  3. 是否共地（GND连接）\r\n");
+        printf("  4. ESP8266的CH_PD（使能）引脚是否接3.3V\r\n");
+        printf("  5. 尝试按下ESP8266的复位按钮后重新测试\r\n");
+        printf("=========================\r\n\r\n");
+        return 0;
+    }
+}
+
+/**
+ * @brief  查询ESP8266的IP地址 (重构后)
+ */
+void ESP8266_GetIPAddress(void) {
+    printf("\r\n正在查询IP地址...\r\n");
+    ESP8266_ClearBuffer();
+    ESP8266_SendCommand("AT+CIFSR\r\n");
+    if(ESP8266_WaitForString("OK", 5000)) {
+        // 响应已在 WaitForString 内部打印
+    }
+}
+
+/**
+ * @brief  连接到WiFi热点 (重构后)
+ * @return 1=成功, 0=失败
+ */
+uint8_t ESP8266_ConnectWiFi(const char* ssid, const char* password) {
+    char cmd[128] = {0};
+    
+    printf("\r\n--- WiFi连接流程 ---\r\n\r\n");
+    
+    // 步骤1：设置为Station模式
+    printf("1. 设置为Station模式...\r\n");
+    if (!ESP8266_SendAndWaitOK("AT+CWMODE=1\r\n", 5000)) {
+        printf("   ⚠ 模式设置失败，但继续尝试...\r\n\r\n");
+    } else {
+        printf("   ✓ 模式设置成功\r\n\r\n");
+    }
+    HAL_Delay(1000);
+
+    // 步骤2：断开之前的连接 (可选但推荐)
+    printf("2. 断开之前的连接...\r\n");
+    ESP8266_SendAndWaitOK("AT+CWQAP\r\n", 3000);
+    printf("   ✓ 已断开（或未连接）\r\n\r\n");
+    HAL_Delay(1000);
+
+    // 步骤3：连接到指定WiFi
+    printf("3. 连接到WiFi: %s\r\n", ssid);
+    printf("   密码: %s\r\n", password);
+    printf("   正在连接（最多25秒）...\r\n");
+    
+    sprintf(cmd, "AT+CWJAP=\"%s\",\"%s\"\r\n", ssid, password);
+    
+    ESP8266_ClearBuffer();
+    ESP8266_SendCommand(cmd);
+    
+    // 等待 "WIFI GOT IP" 或 "OK"
+    if (ESP8266_WaitForString("WIFI GOT IP", 25000) || ESP8266_WaitForString("OK", 1000)) {
+        printf("   ✓ WiFi连接成功！\r\n");
+        return 1;
+    } else {
+        printf("\r\n   ✗ WiFi连接失败！\r\n");
+        printf("   请检查：\r\n");
+        printf("   - WiFi名称和密码是否正确\r\n");
+        printf("   - 热点是否已开启\r\n");
+        printf("   - 热点频段是否为2.4GHz\r\n");
+        printf("   - ESP8266与热点的距离\r\n");
+        return 0;
+    }
+}
+
+// ----------------- 非阻塞指令（后台联网） -----------------
+
+/* 非阻塞指令的响应窗口：放满时丢弃较早的一半，目标字符串总在最近的字节里；
+ * 需容纳 ESP8266_MAX_LINKS 条连接都在时的完整 CIPSTATUS 响应（ESP8266_StatusLinks） */
+#define ESP8266_ASYNC_RESP_SIZE 512
+static char async_resp[ESP8266_ASYNC_RESP_SIZE];
+static uint16_t async_len = 0;
+
+/**
+ * @brief 发出指令后立即返回
+ * @note  不清空接收缓冲区：已到达的 +IPD 先投递出去
+ */
+void ESP8266_CommandStart(const char* cmd) {
+    ESP8266_PollIPD();
+    async_len = 0;
+    async_resp[0] = '\0';
+    ESP8266_SendCommand(cmd);
+}
+
+/**
+ * @brief 取出已到达的字节并检查响应
+ */
+int8_t ESP8266_CommandPoll(const char* target, const char* fail) {
+    if (in_sink) {
+        return 0;
+    }
+    while (rx_buffer.tail != rx_buffer.head) {
+        uint8_t c = rx_buffer.buffer[rx_buffer.tail];
+        rx_buffer.tail = (rx_buffer.tail + 1) % ESP8266_RX_BUFFER_SIZE;
+        if (ipd_consume_byte(c)) {
+            continue;
+        }
+        if (async_len >= sizeof(async_resp) - 1) {
+            uint16_t keep = (uint16_t)(sizeof(async_resp) / 2);
+            memmove(async_resp, async_resp + async_len - keep, keep);
+            async_len = keep;
+        }
+        async_resp[async_len++] = (char)c;
+        async_resp[async_len] = '\0';
+    }
+
+    if (strstr(async_resp, target) != NULL) {
+        DLOG(ESP_RX, async_resp);
+        return 1;
+    }
+    if (fail != NULL && strstr(async_resp, fail) != NULL) {
+        DLOG(ESP_RX, async_resp);
+        return -1;
+    }
+    return 0;
+}
+
+/* 模块支持 _DEF 指令（AT 固件 1.3 起）；收到 ERROR 后改用旧指令，此后不再尝试 */
+static uint8_t def_cmds = 1;
+/* 本次上电已把热点与自动连接写入模块 flash，之后的重连改用 _CUR，不再重复写 flash */
+static uint8_t profile_saved = 0;
+static uint8_t profile_pending = 0;   // ESP8266_AutoConnectStart 的参数，成功后写入 profile_saved
+
+/**
+ * @brief 设置 Station 模式（不等待），优先 CWMODE_DEF 写入模块 flash
+ */
+void ESP8266_StationModeStart(void) {
+    ESP8266_CommandStart(def_cmds ? "AT+CWMODE_DEF=1\r\n" : "AT+CWMODE=1\r\n");
+}
+
+/**
+ * @brief 检查模式设置结果；_DEF 指令不被支持时改发 AT+CWMODE=1 并继续等待
+ */
+int8_t ESP8266_StationModePoll(void) {
+    int8_t r = ESP8266_CommandPoll("OK", "ERROR");
+
+    if (r < 0 && def_cmds) {
+        def_cmds = 0;
+        printf("[ESP8266] 固件不支持 _DEF 指令，热点配置不写入模块 flash\r\n");
+        ESP8266_StationModeStart();
+        return 0;
+    }
+    return r;
+}
+
+/**
+ * @brief 发起热点连接（不等待）；CWJAP 会先断开旧的热点，无需 CWQAP
+ * @note  CWJAP_DEF 把热点保存到模块 flash，模块复位后自行重连
+ */
+void ESP8266_JoinStart(const char* ssid, const char* password) {
+    char cmd[128] = {0};
+    const char* suffix = "";
+
+    if (def_cmds) {
+        suffix = profile_saved ? "_CUR" : "_DEF";
+    }
+    snprintf(cmd, sizeof(cmd), "AT+CWJAP%s=\"%s\",\"%s\"\r\n", suffix, ssid, password);
+    ESP8266_CommandStart(cmd);
+}
+
+/**
+ * @brief 上电自动连接已保存的热点（AT+CWAUTOCONN，设置本身即保存在 flash）
+ */
+uint8_t ESP8266_SetAutoConnect(uint8_t enable) {
+    ESP8266_PollIPD();
+    ESP8266_SendCommand(enable ? "AT+CWAUTOCONN=1\r\n" : "AT+CWAUTOCONN=0\r\n");
+    if (!wait_for_string("OK", "ERROR", 1000)) {
+        return 0;
+    }
+    profile_saved = enable;
+    return 1;
+}
+
+/**
+ * @brief 设置上电自动连接（不等待）
+ */
+void ESP8266_AutoConnectStart(uint8_t enable) {
+    ESP8266_CommandStart(enable ? "AT+CWAUTOCONN=1\r\n" : "AT+CWAUTOCONN=0\r\n");
+    profile_pending = enable;
+}
+
+/**
+ * @brief 检查 CWAUTOCONN 结果；成功后 JoinStart 改用 _CUR
+ */
+int8_t ESP8266_AutoConnectPoll(void) {
+    int8_t r = ESP8266_CommandPoll("OK", "ERROR");
+
+    if (r > 0) {
+        profile_saved = profile_pending;
+    }
+    return r;
+}
+
+/**
+ * @brief 查询连接状态（不等待），结果由 ESP8266_StatusPoll 取出
+ */
+void ESP8266_StatusStart(void) {
+    ESP8266_CommandStart("AT+CIPSTATUS\r\n");
+}
+
+/**
+ * @brief 检查 CIPSTATUS 响应并取出 STATUS:<n>
+ */
+int8_t ESP8266_StatusPoll(uint8_t* status) {
+    int8_t r = ESP8266_CommandPoll("\r\nOK\r\n", "ERROR");
+    const char* p;
+
+    if (r <= 0) {
+        return r;
+    }
+    // 跳过 "+CIPSTATUS:" 行里的同名子串
+    p = async_resp;
+    while ((p = strstr(p, "STATUS:")) != NULL && p > async_resp && p[-1] == 'P') {
+        p += 7;
+    }
+    if (p == NULL || p[7] < '0' || p[7] > '9') {
+        return -1;
+    }
+    *status = (uint8_t)(p[7] - '0');
+    return 1;
+}
+
+/**
+ * @brief 从最近一次 CIPSTATUS 响应中逐行找 +CIPSTATUS:<id>,
+ */
+uint8_t ESP8266_StatusLinks(void) {
+    uint8_t mask = 0;
+    const char* p = async_resp;
+
+    while ((p = strstr(p, "+CIPSTATUS:")) != NULL) {
+        p += 11;
+        if (*p >= '0' && *p < (char)('0' + ESP8266_MAX_LINKS)) {
+            mask |= (uint8_t)(1u << (*p - '0'));
+        }
+    }
+    return mask;
+}
+
 // ----------------- TCP通信功能 -----------------
 
 /**
@@ -228,28 +559,28 @@ uint8_t ESP8266_StartConnection(const char* type, const char* remote_ip, uint16_
 }
 
 /**
- * @brief 通过TCP发送数据（使用普通传输模式）
+ * @brief AT+CIPSEND 发送流程：命令 → ">" → 数据 → "SEND OK"
+ * @note  不清空接收缓冲区：先把已到达的 +IPD 投递出去,
+ *        等待过程中新到的 +IPD 也由 WaitForString 照常投递
  */
-uint8_t ESP8266_SendTCP(const uint8_t* data, uint16_t len) {
-    char cmd[32] = {0};
-    
-    // 发送 AT+CIPSEND 命令，指定数据长度
-    sprintf(cmd, "AT+CIPSEND=%u\r\n", len);
-    
-    ESP8266_ClearBuffer();
+static uint8_t cipsend(const char* cmd, const uint8_t* data, uint16_t len) {
+    if (in_sink) {
+        return 0;   // 回调里发起的发送：调用方保留消息，回调返回后再发
+    }
+    ESP8266_PollIPD();
     ESP8266_SendCommand(cmd);
-    
-    // 等待 ">" 提示符
-    if (!ESP8266_WaitForString(">", 2000)) {
+
+    // 等待 ">" 提示符；连接已断开时模块回 "link is not valid ... ERROR", 立即返回
+    if (!wait_for_string(">", "ERROR", 2000)) {
         printf("[错误] 未收到发送提示符\r\n");
         return 0;
     }
-    
+
     // 发送实际数据
     HAL_UART_Transmit(&huart2, (uint8_t*)data, len, 1000);
-    
-    // 等待 SEND OK
-    if (ESP8266_WaitForString("SEND OK", 3000)) {
+
+    // 等待 SEND OK（发送途中断开时模块回 SEND FAIL）
+    if (wait_for_string("SEND OK", "SEND FAIL", 3000)) {
         return 1;
     } else {
         printf("[错误] 数据发送失败\r\n");
@@ -257,6 +588,191 @@ uint8_t ESP8266_SendTCP(const uint8_t* data, uint16_t len) {
     }
 }
 
+/**
+ * @brief 通过TCP发送数据（使用普通传输模式）
+ */
+uint8_t ESP8266_SendTCP(const uint8_t* data, uint16_t len) {
+    char cmd[32] = {0};
+
+    // 发送 AT+CIPSEND 命令，指定数据长度
+    sprintf(cmd, "AT+CIPSEND=%u\r\n", len);
+    return cipsend(cmd, data, len);
+}
+
+// ----------------- 多连接（CIPMUX=1） -----------------
+
+/**
+ * @brief 切换单/多连接模式
+ * @note  ESP8266 要求切换前关闭所有连接, 这里先统一关闭
+ */
+uint8_t ESP8266_SetMultiConnection(uint8_t enable) {
+    // 两种模式的"关闭全部"写法不同, 都发一遍（不适用的那条会回 ERROR, 不必等满超时）
+    ESP8266_PollIPD();
+    ESP8266_SendCommand("AT+CIPCLOSE=5\r\n");
+    wait_for_string("OK", "ERROR", 1000);
+    ESP8266_SendCommand("AT+CIPCLOSE\r\n");
+    wait_for_string("OK", "ERROR", 1000);
+    return ESP8266_SendAndWaitOK(enable ? "AT+CIPMUX=1\r\n" : "AT+CIPMUX=0\r\n", 3000);
+}
+
+/**
+ * @brief 查询是否已处于多连接模式（MCU 复位后模块仍保持原来的 CIPMUX 与连接）
+ */
+uint8_t ESP8266_IsMultiConnection(void) {
+    ESP8266_PollIPD();
+    ESP8266_SendCommand("AT+CIPMUX?\r\n");
+    if (!wait_for_string("+CIPMUX:1", "OK", 1000)) {
+        return 0;
+    }
+    // 取走结尾的 OK, 以免被后续指令当作自己的响应
+    ESP8266_WaitForString("OK", 200);
+    return 1;
+}
+
+/**
+ * @brief 在指定连接号上建立连接（需先 ESP8266_SetMultiConnection(1)）
+ */
+uint8_t ESP8266_StartLink(uint8_t link_id, const char* type, const char* remote_ip, uint16_t remote_port) {
+    char cmd[128] = {0};
+
+    if (link_id >= ESP8266_MAX_LINKS) {
+        return 0;
+    }
+    printf("[连接%u] 建立%s连接到 %s:%u ...\r\n", link_id, type, remote_ip, remote_port);
+    sprintf(cmd, "AT+CIPSTART=%u,\"%s\",\"%s\",%u\r\n", link_id, type, remote_ip, remote_port);
+
+    ESP8266_PollIPD();
+    ESP8266_SendCommand(cmd);
+    // 连接被拒绝时模块很快回 ERROR, 不必等满超时
+    if (wait_for_string("CONNECT", "ERROR", 10000)) {
+        printf("   ✓ 连接%u建立成功\r\n", link_id);
+        return 1;
+    }
+    printf("   ✗ 连接%u建立失败\r\n", link_id);
+    return 0;
+}
+
+/**
+ * @brief 关闭指定连接号
+ */
+uint8_t ESP8266_CloseLink(uint8_t link_id) {
+    char cmd[24] = {0};
+
+    sprintf(cmd, "AT+CIPCLOSE=%u\r\n", link_id);
+    ESP8266_PollIPD();
+    ESP8266_SendCommand(cmd);
+    return ESP8266_WaitForString("OK", 2000);
+}
+
+/**
+ * @brief 通过指定连接号发送数据
+ */
+uint8_t ESP8266_SendLink(uint8_t link_id, const uint8_t* data, uint16_t len) {
+    char cmd[32] = {0};
+
+    if (link_id >= ESP8266_MAX_LINKS) {
+        return 0;
+    }
+    sprintf(cmd, "AT+CIPSEND=%u,%u\r\n", link_id, len);
+    return cipsend(cmd, data, len);
+}
+
+/**
+ * @brief 查询当前已建立的连接
+ */
+uint8_t ESP8266_QueryLinks(void) {
+    char resp[ESP8266_RX_BUFFER_SIZE] = {0};
+    uint8_t mask = 0;
+
+    /* 逐行找 +CIPSTATUS:<id>, */
+    cipstatus_query(resp, sizeof(resp));
+    const char* p = resp;
+    while ((p = strstr(p, "+CIPSTATUS:")) != NULL) {
+        p += 11;
+        if (*p >= '0' && *p < (char)('0' + ESP8266_MAX_LINKS)) {
+            mask |= (uint8_t)(1u << (*p - '0'));
+        }
+    }
+    DLOG(ESP_STATUS_TCP, resp);
+    return mask;
+}
+
+/* 非阻塞切换多连接的进度：0 CIPCLOSE=5，1 CIPCLOSE，2 CIPMUX=1 */
+static uint8_t mux_step = 0;
+/* 非阻塞 CIPSTART 的连接号（打印结果用） */
+static uint8_t open_link_id = 0;
+
+/**
+ * @brief 查询多连接模式（不等待），结果由 ESP8266_MultiQueryPoll 取出
+ */
+void ESP8266_MultiQueryStart(void) {
+    ESP8266_CommandStart("AT+CIPMUX?\r\n");
+}
+
+/**
+ * @brief 检查 CIPMUX? 响应
+ */
+int8_t ESP8266_MultiQueryPoll(uint8_t* enabled) {
+    int8_t r = ESP8266_CommandPoll("\r\nOK\r\n", "ERROR");
+
+    if (r > 0) {
+        *enabled = (strstr(async_resp, "+CIPMUX:1") != NULL) ? 1 : 0;
+    }
+    return r;
+}
+
+/**
+ * @brief 切换到多连接模式（不等待）：与 ESP8266_SetMultiConnection 相同，先关闭全部连接
+ */
+void ESP8266_MultiEnableStart(void) {
+    mux_step = 0;
+    ESP8266_CommandStart("AT+CIPCLOSE=5\r\n");
+}
+
+/**
+ * @brief 推进 CIPCLOSE=5 → CIPCLOSE → CIPMUX=1；两条关闭指令回 OK 或 ERROR 都继续
+ */
+int8_t ESP8266_MultiEnablePoll(void) {
+    int8_t r = ESP8266_CommandPoll("OK", "ERROR");
+
+    if (r == 0 || mux_step >= 2) {
+        return r;
+    }
+    mux_step++;
+    ESP8266_CommandStart((mux_step == 1) ? "AT+CIPCLOSE\r\n" : "AT+CIPMUX=1\r\n");
+    return 0;
+}
+
+/**
+ * @brief 在指定连接号上发起连接（不等待），结果由 ESP8266_OpenLinkPoll 取出
+ */
+uint8_t ESP8266_OpenLinkStart(uint8_t link_id, const char* type, const char* remote_ip, uint16_t remote_port) {
+    char cmd[128] = {0};
+
+    if (link_id >= ESP8266_MAX_LINKS) {
+        return 0;
+    }
+    printf("[连接%u] 建立%s连接到 %s:%u ...\r\n", link_id, type, remote_ip, remote_port);
+    sprintf(cmd, "AT+CIPSTART=%u,\"%s\",\"%s\",%u\r\n", link_id, type, remote_ip, remote_port);
+    open_link_id = link_id;
+    ESP8266_CommandStart(cmd);
+    return 1;
+}
+
+/**
+ * @brief 检查 CIPSTART 结果（连接被拒时模块很快回 ERROR）
+ */
+int8_t ESP8266_OpenLinkPoll(void) {
+    int8_t r = ESP8266_CommandPoll("CONNECT", "ERROR");
+
+    if (r > 0) {
+        printf("   ✓ 连接%u建立成功\r\n", open_link_id);
+    } else if (r < 0) {
+        printf("   ✗ 连接%u建立失败\r\n", open_link_id);
+    }
+    return r;
+}
+
 /**
  * @brief 设置透传模式
  */
@@ -331,183 +847,251 @@ uint16_t ESP8266_ReceiveTCP(char* buffer, uint16_t buffer_size) {
     return len;
 }
 
+/* ----------------- +IPD 解析（零拷贝投递） ----------------- */
+
+/* +IPD 解析状态机 */
+typedef enum {
+    IPD_SYNC = 0,
+    IPD_MATCH,      /* 匹配 "+IPD," */
+    IPD_READ_NUM,   /* 读取 <len> 或 <id> */
+    IPD_READ_LEN,   /* 读取真正的 <len>（用于多连接格式） */
+    IPD_READ_DATA,
+} ipd_state_t;
+
+typedef struct {
+    ipd_state_t state;
+    uint8_t match_idx;
+    uint8_t link_id;
+    uint32_t num;
+    uint16_t data_left;   /* 当前帧尚未投递的 payload 字节数 */
+} ipd_parser_t;
+
+static ipd_parser_t ipd = {IPD_SYNC, 0, 0, 0, 0};
+static esp8266_ipd_sink_t ipd_sink = NULL;
+
+static void ipd_reset(void) {
+    ipd.state = IPD_SYNC;
+    ipd.match_idx = 0;
+    ipd.link_id = 0;
+    ipd.num = 0;
+    ipd.data_left = 0;
+}
+
 /**
- * @brief 从TCP连接接收数据（非阻塞，二进制安全）
- *
- * 解析普通模式下 ESP8266 的 +IPD 前缀：
- * - 单连接：+IPD,<len>:<data>
- * - 多连接：+IPD,<id>,<len>:<data>
- *
- * 本函数会在内部缓存一个完整的 <data>，缓存完成后一次性返回给调用者。
+ * @brief 读到 ':' 时结束帧头解析，进入 payload 投递
  */
-uint16_t ESP8266_ReceiveTCPBytes(uint8_t* buffer, uint16_t buffer_size) {
-    if (buffer == NULL || buffer_size == 0) {
-        return 0;
+static void ipd_begin_data(void) {
+    if (ipd.num == 0 || ipd.num > 0xFFFF) {
+        /* 空帧或长度异常：直接重新同步 */
+        ipd_reset();
+        return;
     }
+    ipd.data_left = (uint16_t)ipd.num;
+    ipd.state = IPD_READ_DATA;
+    evt_reset();   // payload 之后的上报不一定另起一行
+}
+
+/* ----------------- 主动上报（WIFI DISCONNECT / <id>,CLOSED 等） ----------------- */
+
+#define EVT_LINE_SIZE 24   // 关心的上报都很短, 更长的行直接跳过
 
-    /* 解析状态机 */
-    typedef enum {
-        IPD_SYNC = 0,
-        IPD_MATCH,      /* 匹配 "+IPD," */
-        IPD_READ_NUM,   /* 读取 <len> 或 <id> */
-        IPD_READ_LEN,   /* 读取真正的 <len>（用于多连接格式） */
-        IPD_READ_DATA,
-        IPD_DISCARD,
-    } ipd_state_t;
-
-    static ipd_state_t state = IPD_SYNC;
-    static uint8_t match_idx = 0;
-    static uint16_t num = 0;
-    static uint16_t ipd_len = 0;
-    static uint16_t data_pos = 0;
-    static uint16_t discard_left = 0;
-    static uint8_t payload[512];
-
-    const uint8_t pattern[] = {'+', 'I', 'P', 'D', ','};
-
-    /* 若已有完整payload，则直接输出 */
-    if (state == IPD_READ_DATA && ipd_len > 0 && data_pos == ipd_len) {
-        uint16_t out_len = (ipd_len <= buffer_size) ? ipd_len : buffer_size;
-        memcpy(buffer, payload, out_len);
-        /* 重置以继续解析后续帧 */
-        state = IPD_SYNC;
-        match_idx = 0;
-        num = 0;
-        ipd_len = 0;
-        data_pos = 0;
-        discard_left = 0;
-        return out_len;
+static char evt_line[EVT_LINE_SIZE];
+static uint8_t evt_len = 0;
+static uint8_t evt_skip = 0;   // 当前行过长, 丢弃到行尾
+static esp8266_event_sink_t evt_sink = NULL;
+
+static void evt_reset(void) {
+    evt_len = 0;
+    evt_skip = 0;
+}
+
+/**
+ * @brief 一行结束：识别主动上报并交给事件回调
+ */
+static void evt_dispatch(void) {
+    const char* line = evt_line;
+
+    if (strcmp(line, "WIFI DISCONNECT") == 0) {
+        evt_sink(ESP8266_EVT_WIFI_DOWN, 0);
+    } else if (strcmp(line, "WIFI GOT IP") == 0) {
+        evt_sink(ESP8266_EVT_WIFI_UP, 0);
+    } else if (strcmp(line, "CLOSED") == 0) {
+        evt_sink(ESP8266_EVT_LINK_CLOSED, 0);
+    } else if (line[0] >= '0' && line[0] < (char)('0' + ESP8266_MAX_LINKS) && strcmp(line + 1, ",CLOSED") == 0) {
+        evt_sink(ESP8266_EVT_LINK_CLOSED, (uint8_t)(line[0] - '0'));
     }
+}
 
-    while (rx_buffer.tail != rx_buffer.head) {
-        uint8_t b = rx_buffer.buffer[rx_buffer.tail];
-        rx_buffer.tail = (rx_buffer.tail + 1) % ESP8266_RX_BUFFER_SIZE;
+/**
+ * @brief 按行拼接 payload 之外的字节
+ */
+static void evt_feed_byte(uint8_t b) {
+    if (b == '\n') {
+        if (!evt_skip && evt_len > 0 && evt_sink != NULL) {
+            evt_line[evt_len] = '\0';
+            in_sink = 1;
+            evt_dispatch();
+            in_sink = 0;
+        }
+        evt_reset();
+    } else if (b != '\r' && !evt_skip) {
+        if (evt_len < EVT_LINE_SIZE - 1) {
+            evt_line[evt_len++] = (char)b;
+        } else {
+            evt_skip = 1;
+        }
+    }
+}
 
-        if (state == IPD_SYNC) {
-            if (b == '+') {
-                state = IPD_MATCH;
-                match_idx = 1;
-            }
-            continue;
+void ESP8266_SetEventSink(esp8266_event_sink_t sink) {
+    evt_sink = sink;
+}
+
+/**
+ * @brief 处理一个帧头字节（payload 之外的所有字节）
+ */
+static void ipd_feed_header_byte(uint8_t b) {
+    static const uint8_t pattern[] = {'+', 'I', 'P', 'D', ','};
+
+    evt_feed_byte(b);
+    switch (ipd.state) {
+    case IPD_SYNC:
+        if (b == '+') {
+            ipd.state = IPD_MATCH;
+            ipd.match_idx = 1;
         }
+        break;
 
-        if (state == IPD_MATCH) {
-            if (b == pattern[match_idx]) {
-                match_idx++;
-                if (match_idx >= sizeof(pattern)) {
-                    state = IPD_READ_NUM;
-                    num = 0;
-                }
-            } else {
-                /* 失配：若当前字节又是 '+'，则从头重新匹配 */
-                if (b == '+') {
-                    match_idx = 1;
-                } else {
-                    state = IPD_SYNC;
-                    match_idx = 0;
-                }
+    case IPD_MATCH:
+        if (b == pattern[ipd.match_idx]) {
+            ipd.match_idx++;
+            if (ipd.match_idx >= sizeof(pattern)) {
+                ipd.state = IPD_READ_NUM;
+                ipd.num = 0;
+                ipd.link_id = 0;
             }
-            continue;
+        } else if (b == '+') {
+            /* 失配：若当前字节又是 '+'，则从头重新匹配 */
+            ipd.match_idx = 1;
+        } else {
+            ipd_reset();
         }
+        break;
 
-        if (state == IPD_READ_NUM) {
-            if (b >= '0' && b <= '9') {
-                num = (uint16_t)(num * 10 + (uint16_t)(b - '0'));
-                continue;
-            }
-            if (b == ':') {
-                /* 单连接格式：num 即 len */
-                ipd_len = num;
-                data_pos = 0;
-                if (ipd_len == 0) {
-                    /* 空帧：直接重置并继续同步 */
-                    state = IPD_SYNC;
-                    match_idx = 0;
-                    num = 0;
-                    continue;
-                }
-                if (ipd_len > sizeof(payload)) {
-                    discard_left = ipd_len;
-                    state = IPD_DISCARD;
-                } else {
-                    state = IPD_READ_DATA;
-                }
-                continue;
-            }
-            if (b == ',') {
-                /* 多连接格式：刚读到的是 link id，接下来再读 len */
-                num = 0;
-                state = IPD_READ_LEN;
-                continue;
+    case IPD_READ_NUM:
+    case IPD_READ_LEN:
+        if (b >= '0' && b <= '9') {
+            ipd.num = ipd.num * 10 + (uint32_t)(b - '0');
+            if (ipd.num > 0xFFFF) {
+                ipd_reset();
             }
+        } else if (b == ':') {
+            /* 单连接格式：num 即 len；多连接格式：已在 ',' 处记下 link id */
+            ipd_begin_data();
+        } else if (b == ',' && ipd.state == IPD_READ_NUM) {
+            /* 多连接格式：刚读到的是 link id，接下来再读 len */
+            ipd.link_id = (uint8_t)ipd.num;
+            ipd.num = 0;
+            ipd.state = IPD_READ_LEN;
+        } else {
             /* 其他字符：重置 */
-            state = IPD_SYNC;
-            match_idx = 0;
-            num = 0;
-            continue;
+            ipd_reset();
         }
+        break;
 
-        if (state == IPD_READ_LEN) {
-            if (b >= '0' && b <= '9') {
-                num = (uint16_t)(num * 10 + (uint16_t)(b - '0'));
-                continue;
-            }
-            if (b == ':') {
-                ipd_len = num;
-                data_pos = 0;
-                if (ipd_len == 0) {
-                    state = IPD_SYNC;
-                    match_idx = 0;
-                    num = 0;
-                    continue;
-                }
-                if (ipd_len > sizeof(payload)) {
-                    discard_left = ipd_len;
-                    state = IPD_DISCARD;
-                } else {
-                    state = IPD_READ_DATA;
-                }
-                continue;
-            }
-            state = IPD_SYNC;
-            match_idx = 0;
-            num = 0;
+    default:
+        ipd_reset();
+        break;
+    }
+}
+
+/**
+ * @brief 逐字节消费：payload 字节直接投递给接收回调, 其余字节交给帧头解析
+ * @return 1: 该字节属于 +IPD payload; 0: 普通响应字节
+ */
+static uint8_t ipd_consume_byte(uint8_t b) {
+    if (ipd.state != IPD_READ_DATA) {
+        ipd_feed_header_byte(b);
+        return 0;
+    }
+    if (ipd_sink != NULL) {
+        in_sink = 1;
+        ipd_sink(ipd.link_id, &b, 1);
+        in_sink = 0;
+    }
+    ipd.data_left--;
+    if (ipd.data_left == 0) {
+        ipd_reset();
+    }
+    return 1;
+}
+
+/**
+ * @brief 注册 +IPD payload 接收回调
+ */
+void ESP8266_SetIPDSink(esp8266_ipd_sink_t sink) {
+    ipd_sink = sink;
+}
+
+/**
+ * @brief 投递片段之后才扣减 data_left，回调期间它仍包含本次片段
+ */
+uint16_t ESP8266_IPDFrameLeft(void) {
+    return (ipd.state == IPD_READ_DATA) ? ipd.data_left : 0;
+}
+
+/**
+ * @brief 消费环形缓冲区，把 +IPD payload 直接投递给接收回调（非阻塞，二进制安全）
+ *
+ * 解析普通模式下 ESP8266 的 +IPD 前缀：
+ * - 单连接：+IPD,<len>:<data>
+ * - 多连接：+IPD,<id>,<len>:<data>
+ *
+ * payload 不再经过中间缓冲：回调拿到的是环形缓冲区内部的连续片段，
+ * 回调返回后才推进读指针，因此回调期间中断不会覆盖这段数据。
+ * 帧长度不受限制（只受 <len> 字段本身约束）。
+ *
+ * 回调期间驱动不可重入：读缓冲区、清缓冲区与发指令（含 CIPSEND）一律立即返回失败，
+ * 回调里要发的数据应先入队（如 pus_link 的 TC 验收回报），由主循环在回调之外发出。
+ */
+uint16_t ESP8266_PollIPD(void) {
+    uint16_t delivered = 0;
+
+    if (in_sink) {
+        return 0;
+    }
+    while (rx_buffer.tail != rx_buffer.head) {
+        uint16_t tail = rx_buffer.tail;
+
+        if (ipd.state != IPD_READ_DATA) {
+            uint8_t b = rx_buffer.buffer[tail];
+            rx_buffer.tail = (uint16_t)((tail + 1) % ESP8266_RX_BUFFER_SIZE);
+            ipd_feed_header_byte(b);
             continue;
         }
 
-        if (state == IPD_READ_DATA) {
-            if (data_pos < sizeof(payload)) {
-                payload[data_pos++] = b;
-            }
-            if (data_pos >= ipd_len) {
-                /* 一帧 data 完整到齐：立即输出（一次只返回一帧） */
-                uint16_t out_len = (ipd_len <= buffer_size) ? ipd_len : buffer_size;
-                memcpy(buffer, payload, out_len);
-                state = IPD_SYNC;
-                match_idx = 0;
-                num = 0;
-                ipd_len = 0;
-                data_pos = 0;
-                discard_left = 0;
-                return out_len;
-            }
-            continue;
+        /* 计算可一次性投递的连续片段：不跨越回绕点，不超过本帧剩余长度 */
+        uint16_t head = rx_buffer.head;
+        uint16_t span = (head > tail) ? (uint16_t)(head - tail)
+                                      : (uint16_t)(ESP8266_RX_BUFFER_SIZE - tail);
+        if (span > ipd.data_left) {
+            span = ipd.data_left;
         }
 
-        if (state == IPD_DISCARD) {
-            if (discard_left > 0) {
-                discard_left--;
-            }
-            if (discard_left == 0) {
-                state = IPD_SYNC;
-                match_idx = 0;
-                num = 0;
-                ipd_len = 0;
-                data_pos = 0;
-            }
-            continue;
+        if (ipd_sink != NULL) {
+            in_sink = 1;
+            ipd_sink(ipd.link_id, &rx_buffer.buffer[tail], span);
+            in_sink = 0;
+        }
+        /* 回调期间驱动拒绝重入，tail 与解析器只有这里推进 */
+        rx_buffer.tail = (uint16_t)((rx_buffer.tail + span) % ESP8266_RX_BUFFER_SIZE);
+        ipd.data_left = (uint16_t)(ipd.data_left - span);
+        delivered = (uint16_t)(delivered + span);
+
+        if (ipd.data_left == 0) {
+            ipd_reset();
         }
     }
 
-    return 0;
+    return delivered;
 }
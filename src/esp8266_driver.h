@@ -8,6 +8,7 @@
 
 // 宏定义
 #define ESP8266_RX_BUFFER_SIZE 1024 // 环形缓冲区大小, 1KB
+#define ESP8266_MAX_LINKS 5         // 多连接模式下的连接号 0~4（CIPCLOSE=5 表示全部）
 
 // 外部变量声明
 extern UART_HandleTypeDef huart2;
@@ -73,6 +74,93 @@ uint8_t ESP8266_IsTCPConnected(void);
  */
 void ESP8266_RxCallback(void);
 
+/**
+ * @brief 测试ESP8266是否响应AT指令，并打印固件版本
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_Test(void);
+
+/**
+ * @brief 以Station模式连接到WiFi热点
+ * @param ssid 热点名称
+ * @param password 热点密码
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_ConnectWiFi(const char* ssid, const char* password);
+
+/**
+ * @brief 发出 AT 指令后立即返回（不等待响应），响应由 ESP8266_CommandPoll 收集
+ * @note  供后台联网状态机使用：每次只检查一下已到达的字节，等待期间采样与排队照常进行。
+ *        等待期间不要再调用其他阻塞式 AT 函数，否则响应会被它们取走。
+ */
+void ESP8266_CommandStart(const char* cmd);
+
+/**
+ * @brief 非阻塞检查 ESP8266_CommandStart 的响应（+IPD payload 照常投递给接收回调）
+ * @param target 成功标志，例如 "OK"、"WIFI GOT IP"
+ * @param fail   失败标志，可为 NULL
+ * @return 1: 收到 target; -1: 收到 fail; 0: 尚未收到（超时由调用方判断）
+ */
+int8_t ESP8266_CommandPoll(const char* target, const char* fail);
+
+/**
+ * @brief 非阻塞地设置 Station 模式（AT+CWMODE_DEF=1，模块不支持 _DEF 时自动改用 AT+CWMODE=1）
+ */
+void ESP8266_StationModeStart(void);
+
+/**
+ * @brief 非阻塞检查 ESP8266_StationModeStart 的结果
+ * @return 1: 成功; -1: 失败; 0: 尚未收到
+ */
+int8_t ESP8266_StationModePoll(void);
+
+/**
+ * @brief 非阻塞地发起热点连接（AT+CWJAP_DEF，热点保存到模块 flash），
+ *        之后用 ESP8266_CommandPoll("WIFI GOT IP", "FAIL") 检查
+ * @note  ESP8266_SetAutoConnect(1) 成功后改用 AT+CWJAP_CUR，每次上电最多写一次 flash
+ */
+void ESP8266_JoinStart(const char* ssid, const char* password);
+
+/**
+ * @brief 设置上电自动连接已保存的热点（AT+CWAUTOCONN，阻塞，最多约 1 s）
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_SetAutoConnect(uint8_t enable);
+
+/**
+ * @brief 非阻塞地设置上电自动连接（AT+CWAUTOCONN），之后用 ESP8266_AutoConnectPoll 检查
+ */
+void ESP8266_AutoConnectStart(uint8_t enable);
+
+/**
+ * @brief 非阻塞检查 ESP8266_AutoConnectStart 的结果
+ * @return 1: 成功; -1: 失败; 0: 尚未收到
+ */
+int8_t ESP8266_AutoConnectPoll(void);
+
+/**
+ * @brief 非阻塞地查询连接状态（AT+CIPSTATUS）
+ */
+void ESP8266_StatusStart(void);
+
+/**
+ * @brief 非阻塞检查 ESP8266_StatusStart 的响应
+ * @param status 收到响应时写入 STATUS:<n>（2: 已获得 IP; 3: 有连接; 4: 连接已断开; 5: 未连接热点）
+ * @return 1: 已取得状态; -1: 出错; 0: 尚未收到
+ */
+int8_t ESP8266_StatusPoll(uint8_t* status);
+
+/**
+ * @brief ESP8266_StatusPoll 返回 1 之后取同一响应中已建立的连接
+ * @return 位掩码, bit n 表示连接号 n 已连接
+ */
+uint8_t ESP8266_StatusLinks(void);
+
+/**
+ * @brief 查询并打印ESP8266的IP地址
+ */
+void ESP8266_GetIPAddress(void);
+
 /**
  * @brief 建立TCP连接
  * @param type "TCP"
@@ -90,6 +178,82 @@ uint8_t ESP8266_StartConnection(const char* type, const char* remote_ip, uint16_
  */
 uint8_t ESP8266_SendTCP(const uint8_t* data, uint16_t len);
 
+/**
+ * @brief 切换单/多连接模式（AT+CIPMUX），切换前会关闭所有连接
+ * @param enable 1: 多连接; 0: 单连接
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_SetMultiConnection(uint8_t enable);
+
+/**
+ * @brief 查询是否处于多连接模式（AT+CIPMUX?）
+ * @return 1: 多连接; 0: 单连接或无响应
+ */
+uint8_t ESP8266_IsMultiConnection(void);
+
+/**
+ * @brief 多连接模式下在指定连接号上建立连接
+ * @param link_id 连接号 (0 ~ ESP8266_MAX_LINKS-1)
+ * @param type "TCP" 或 "UDP"
+ * @param remote_ip 远程服务器IP地址
+ * @param remote_port 远程服务器端口
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_StartLink(uint8_t link_id, const char* type, const char* remote_ip, uint16_t remote_port);
+
+/**
+ * @brief 多连接模式下关闭指定连接
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_CloseLink(uint8_t link_id);
+
+/**
+ * @brief 多连接模式下通过指定连接发送数据（AT+CIPSEND=<id>,<len>）
+ * @return 1: 成功; 0: 失败
+ */
+uint8_t ESP8266_SendLink(uint8_t link_id, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 查询多连接模式下已建立的连接
+ * @return 位掩码, bit n 表示连接号 n 已连接
+ */
+uint8_t ESP8266_QueryLinks(void);
+
+/**
+ * @brief 非阻塞地查询多连接模式（AT+CIPMUX?）
+ */
+void ESP8266_MultiQueryStart(void);
+
+/**
+ * @brief 非阻塞检查 ESP8266_MultiQueryStart 的响应
+ * @param enabled 收到响应时写入 1: 多连接; 0: 单连接
+ * @return 1: 已取得结果; -1: 出错; 0: 尚未收到
+ */
+int8_t ESP8266_MultiQueryPoll(uint8_t* enabled);
+
+/**
+ * @brief 非阻塞地切换到多连接模式（先关闭全部连接，再 AT+CIPMUX=1）
+ */
+void ESP8266_MultiEnableStart(void);
+
+/**
+ * @brief 非阻塞推进 ESP8266_MultiEnableStart（每次调用最多发出下一条指令）
+ * @return 1: 已切换; -1: CIPMUX=1 失败; 0: 尚未完成（超时由调用方判断）
+ */
+int8_t ESP8266_MultiEnablePoll(void);
+
+/**
+ * @brief 多连接模式下非阻塞地在指定连接号上发起连接（AT+CIPSTART=<id>,...）
+ * @return 1: 已发出; 0: 连接号无效
+ */
+uint8_t ESP8266_OpenLinkStart(uint8_t link_id, const char* type, const char* remote_ip, uint16_t remote_port);
+
+/**
+ * @brief 非阻塞检查 ESP8266_OpenLinkStart 的结果
+ * @return 1: 已连接; -1: 失败; 0: 尚未收到（超时由调用方判断）
+ */
+int8_t ESP8266_OpenLinkPoll(void);
+
 /**
  * @brief 设置透传模式
  * @param enable 1: 启用透传; 0: 退出透传
@@ -112,12 +276,54 @@ uint8_t ESP8266_HasPendingData(void);
 uint16_t ESP8266_ReceiveTCP(char* buffer, uint16_t buffer_size);
 
 /**
- * @brief 从TCP连接接收数据（非阻塞，二进制安全）
- * @param buffer 用于存放实际 TCP payload 的缓冲区（不做\\0结尾）
- * @param buffer_size 缓冲区大小
- * @return 读取到的 payload 字节数（若未凑齐一个 +IPD 帧则返回 0）
+ * @brief +IPD payload 接收回调
+ * @param link_id 连接号（单连接格式固定为 0；多连接格式为 +IPD,<id> 中的 id）
+ * @param data    指向环形缓冲区内部的连续 payload 片段，仅在回调期间有效
+ * @param len     片段长度
+ * @note  一帧 +IPD 可能分多次回调（分批到达或跨越环形缓冲区回绕点），
+ *        接收方应按字节流处理，例如直接交给 PusLink_FeedBytes 分帧。
+ */
+typedef void (*esp8266_ipd_sink_t)(uint8_t link_id, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 注册 +IPD payload 接收回调
+ * @param sink 回调函数；为 NULL 时 payload 被解析后直接丢弃
+ */
+void ESP8266_SetIPDSink(esp8266_ipd_sink_t sink);
+
+/**
+ * @brief 当前 +IPD 帧中尚未投递的字节数（含正在回调的片段），仅在 +IPD 回调中有效
+ * @note  等于本次回调的 len 时，本次片段即帧尾；UDP 连接据此切分数据报。
+ */
+uint16_t ESP8266_IPDFrameLeft(void);
+
+/**
+ * @brief 模块主动上报的链路事件
+ */
+typedef enum {
+    ESP8266_EVT_WIFI_DOWN = 0,    // WIFI DISCONNECT
+    ESP8266_EVT_WIFI_UP,          // WIFI GOT IP
+    ESP8266_EVT_LINK_CLOSED,      // <id>,CLOSED（单连接格式为 CLOSED，id 记为 0）
+} esp8266_event_t;
+
+/**
+ * @brief 链路事件回调
+ * @note  在消费接收缓冲区的任何函数中调用（包括阻塞等待响应期间），回调应只更新状态、尽快返回。
+ *        ESP8266_ClearBuffer 丢弃的字节不会产生事件。
+ */
+typedef void (*esp8266_event_sink_t)(esp8266_event_t evt, uint8_t link_id);
+
+/**
+ * @brief 注册链路事件回调；为 NULL 时不上报
+ */
+void ESP8266_SetEventSink(esp8266_event_sink_t sink);
+
+/**
+ * @brief 消费接收缓冲区并把 +IPD payload 零拷贝投递给接收回调（非阻塞，二进制安全）
+ * @return 本次投递的 payload 字节数
  * @note  解析 ESP8266 普通模式的 +IPD 前缀：+IPD,<len>:<data>（兼容 +IPD,<id>,<len>:<data>）。
+ *        帧长度不受本地缓冲区限制。
  */
-uint16_t ESP8266_ReceiveTCPBytes(uint8_t* buffer, uint16_t buffer_size);
+uint16_t ESP8266_PollIPD(void);
 
 #endif /* __ESP8266_DRIVER_H */
@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file           : exposure.c
+ * @brief          : 暴露事件响应特征提取实现
+ ******************************************************************************
+ */
+
+#include "exposure.h"
+
+#include <string.h>
+
+#define EXPOSURE_BASE_SHIFT   6   // 基线 EWMA α = 1/64
+#define EXPOSURE_SMOOTH_SHIFT 2   // 平滑 EWMA α = 1/4
+
+void Exposure_Init(Exposure_t* e, uint16_t on_codes, uint32_t max_ms) {
+    memset(e, 0, sizeof(*e));
+    e->on_codes = (on_codes < 2) ? 2 : on_codes;
+    e->max_ms = max_ms;
+}
+
+void Exposure_Reset(Exposure_t* e) {
+    e->started = false;
+    e->active = false;
+}
+
+static void exposure_finish(Exposure_t* e, uint32_t tick, uint8_t reason) {
+    ExposureEvent_t* ev = &e->cur;
+    int32_t delta = (int32_t)ev->peak - ev->base;
+    int32_t resid = (e->smooth_q8 >> 8) - ev->base;
+    uint32_t rise_ms = ev->t_peak - ev->t_start;
+
+    ev->t_end = tick;
+    ev->end = (uint16_t)(e->smooth_q8 >> 8);
+    ev->reason = reason;
+    ev->tau_rise_ms = 0;
+    ev->tau_rec_ms = 0;
+    if (delta > 0) {
+        int64_t t = (int64_t)rise_ms - e->area_at_peak / delta;
+        ev->tau_rise_ms = (t > 0) ? (uint32_t)t : 0;
+        if (resid < 0) {
+            resid = 0;
+        }
+        if (reason == EXPOSURE_END_RECOVERED && resid < delta) {
+            int64_t a = ev->area - e->area_at_peak;
+            ev->tau_rec_ms = (a > 0) ? (uint32_t)(a / (delta - resid)) : 0;
+        }
+    }
+    e->result = *ev;
+    e->ready = true;
+    e->events++;
+    e->active = false;
+    e->base_q8 = e->smooth_q8;   // 以结束时的水平重新起算基线
+}
+
+uint8_t Exposure_Push(Exposure_t* e, uint16_t code, uint32_t tick) {
+    int32_t x_q8 = (int32_t)code << 8;
+
+    if (!e->started) {
+        e->base_q8 = x_q8;
+        e->smooth_q8 = x_q8;
+        e->last_tick = tick;
+        e->started = true;
+        e->active = false;
+        return 0;
+    }
+
+    uint32_t dt = tick - e->last_tick;
+    int32_t prev_q8 = e->smooth_q8;
+    e->last_tick = tick;
+    e->smooth_q8 += (x_q8 - e->smooth_q8) >> EXPOSURE_SMOOTH_SHIFT;
+    int32_t dev = (e->smooth_q8 - e->base_q8) >> 8;
+
+    if (!e->active) {
+        if (dev <= e->on_codes) {
+            e->base_q8 += (e->smooth_q8 - e->base_q8) >> EXPOSURE_BASE_SHIFT;
+            return 0;
+        }
+        /* 暴露开始：基线冻结，从本样本起累计 */
+        memset(&e->cur, 0, sizeof(e->cur));
+        e->cur.t_start = tick;
+        e->cur.t_peak = tick;
+        e->cur.base = (uint16_t)(e->base_q8 >> 8);
+        e->cur.peak = code;
+        e->area_at_peak = 0;
+        e->active = true;
+    }
+
+    ExposureEvent_t* ev = &e->cur;
+    ev->area += (int64_t)((int32_t)code - ev->base) * dt;
+    if (dt > 0) {
+        int32_t slope = (int32_t)(((int64_t)(e->smooth_q8 - prev_q8) * 1000) / dt / 256);
+        if (slope > ev->slope_max) {
+            ev->slope_max = slope;
+        }
+    }
+    if (code > ev->peak) {
+        ev->peak = code;
+        ev->t_peak = tick;
+        e->area_at_peak = ev->area;
+    }
+
+    int32_t delta = (int32_t)ev->peak - ev->base;
+    int32_t off = (delta >> 3 > e->on_codes / 2) ? (delta >> 3) : e->on_codes / 2;
+    if (tick != ev->t_peak && dev <= off) {
+        exposure_finish(e, tick, EXPOSURE_END_RECOVERED);
+        return 1;
+    }
+    if (tick - ev->t_start >= e->max_ms) {
+        exposure_finish(e, tick, EXPOSURE_END_TIMEOUT);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ * @file           : exposure.h
+ * @brief          : 暴露事件的流式响应特征（基线、峰值、最大斜率、上升/恢复时间常数、积分响应）
+ ******************************************************************************
+ * @description    : 每个样本 O(1)、整数运算，可在采样中断中调用：
+ *                   - 空闲时以慢 EWMA（1/64）跟踪基线；快 EWMA（1/4）平滑后的信号
+ *                     高出基线 on_codes 即判定暴露开始，基线冻结；
+ *                   - 暴露期间累计 (x - 基线)·dt（积分响应），记录峰值、峰值时刻与
+ *                     峰值时刻的累计面积，以及平滑信号的最大斜率；
+ *                   - 峰值之后平滑信号回落到基线 + max(on_codes / 2, Δ / 8) 以内即恢复结束，
+ *                     超过 max_ms 仍未恢复则以 timeout 结束，并以当前水平作为新基线。
+ *
+ *                   时间常数按一阶响应由面积反推，无需保存波形：
+ *                   - 上升：x = b + Δ(1 - e^(-t/τ))，峰值前面积 A_r = Δ·T - Δ·τ（T ≫ τ），
+ *                     τ_rise = T - A_r / Δ；
+ *                   - 恢复：x = b + Δ·e^(-t/τ)，峰值后面积 A_d = τ·(Δ - r)，r 为结束时的残余，
+ *                     τ_rec = A_d / (Δ - r)。
+ *                   再次升高超过峰值时峰值前移，恢复段重新累计。
+ ******************************************************************************
+ */
+
+#ifndef __EXPOSURE_H
+#define __EXPOSURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    EXPOSURE_END_RECOVERED = 0,   // 回落到基线附近
+    EXPOSURE_END_TIMEOUT          // 超过 max_ms 未恢复
+} ExposureEnd_t;
+
+/* 一次暴露事件的特征（码值与 tick 单位，换算由调用方完成） */
+typedef struct {
+    uint32_t t_start;             // 暴露开始时刻
+    uint32_t t_peak;              // 峰值时刻
+    uint32_t t_end;               // 结束时刻
+    uint16_t base;                // 基线码值
+    uint16_t peak;                // 峰值码值
+    uint16_t end;                 // 结束时的平滑码值
+    int32_t slope_max;            // 平滑信号最大上升斜率（码值/s）
+    uint32_t tau_rise_ms;
+    uint32_t tau_rec_ms;          // timeout 结束时为 0（未恢复，无法估计）
+    int64_t area;                 // 积分响应（码值·ms）
+    uint8_t reason;               // ExposureEnd_t
+} ExposureEvent_t;
+
+typedef struct {
+    int32_t base_q8;              // 基线（码值 × 256）
+    int32_t smooth_q8;            // 平滑信号（码值 × 256）
+    uint32_t last_tick;
+    uint16_t on_codes;            // 暴露判定阈值（高出基线的码值）
+    uint32_t max_ms;              // 单次暴露最长时间
+    bool started;
+    bool active;                  // 暴露进行中
+    ExposureEvent_t cur;          // 进行中的事件
+    int64_t area_at_peak;
+    ExposureEvent_t result;       // 最近结束的事件
+    bool ready;                   // result 尚未取走
+    uint32_t events;              // 结束的事件累计数
+} Exposure_t;
+
+void Exposure_Init(Exposure_t* e, uint16_t on_codes, uint32_t max_ms);
+
+/**
+ * @brief 丢弃基线与进行中的事件（传感器离开正常状态时调用），已结束的结果保留
+ */
+void Exposure_Reset(Exposure_t* e);
+
+/**
+ * @brief 推入一个样本（时刻需单调不减）
+ * @return 1: 本样本结束了一次暴露事件（结果见 result）
+ */
+uint8_t Exposure_Push(Exposure_t* e, uint16_t code, uint32_t tick);
+
+#endif /* __EXPOSURE_H */
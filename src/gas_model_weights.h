@@ -0,0 +1,259 @@
+/**
+ ******************************************************************************
+ * @file           : gas_model_weights.h
+ * @brief          : 板上气体分类器（int8）层表与权重 —— 由 tools/tinyml_export.py 生成，勿手改
+ ******************************************************************************
+ * @description    : 来源：占位模型（GasClassifier1DCNN 结构，随机初始化 seed=0，未训练）
+ *                   int8 与浮点模型 top-1 一致率：256/256（折叠后浮点参考，校准窗口）
+ *                   只由一个源文件包含（sensor_manager.c；主机端另有 bench_tinyml.c）。
+ ******************************************************************************
+ */
+
+#ifndef __GAS_MODEL_WEIGHTS_H
+#define __GAS_MODEL_WEIGHTS_H
+
+#include "tinyml.h"
+
+#define GAS_MODEL_PLACEHOLDER 1     // 1 = 未训练的占位模型，不上报类别
+#define GAS_MODEL_IN_FEATURES 1
+#define GAS_MODEL_SEQ_LEN 16
+#define GAS_MODEL_N_CLASSES 7
+#define GAS_MODEL_ARENA_BYTES 512   // 工作区（两块交替）
+#define GAS_MODEL_WEIGHT_BYTES 2847 // 权重 + 偏置 + 倍率（Flash）
+#define GAS_MODEL_MACS 13680        // 每次推理的乘加次数
+
+static const int8_t k_gas_l0_w[48] = {
+    127, 95, -29, -127, 6, -50, 127, -88, -10, 26, 127, 1, -108, 127, 59, -66,
+    108, 127, 98, 127, -60, 73, 127, 59, -9, -127, -21, 30, 112, 127, -8, 127,
+    -83, 80, 13, -127, 86, -40, 127, 43, -127, -2, 127, -88, -60, 127, -106, 23,
+};
+
+static const int32_t k_gas_l0_b[16] = {
+    -1470, 3755, 2069, -247, -3176, -722, 38, 2101,
+    -1896, 213, 1095, 189, 1874, 156, 2443, 539,
+};
+
+static const int32_t k_gas_l0_mult[16] = {
+    1137572575, 1592522030, 1874686465, 1347934295, 1689764142, 1594566415,
+    1328292481, 1317301722, 1318822696, 1541129301, 1206562689, 1605045766,
+    2145826320, 1647648792, 1214135613, 1223609686,
+};
+
+static const int8_t k_gas_l0_shift[16] = {
+    7, 8, 8, 7, 8, 7, 7, 7, 7, 7, 7, 7, 8, 7, 7, 7,
+};
+
+static const int8_t k_gas_l2_w[1536] = {
+    22, -14, 25, -29, 19, -54, -79, -80, 29, 40, -6, -105, 66, 96, 108, 88,
+    102, 108, 10, -28, 53, -57, 80, 89, 101, 23, 115, 20, -13, 41, 127, 107,
+    75, -107, 29, -3, 33, 88, -66, 59, -98, -72, 75, -43, 81, -102, -91, 51,
+    -118, 19, 107, 9, 47, -123, 35, 28, 20, -28, -34, 125, -121, -124, 120, -82,
+    -98, -75, 78, 114, -124, -19, -104, -62, -73, 38, -39, -83, 1, -120, -104, 127,
+    -78, -37, 60, 88, 109, -86, 45, 121, -115, 46, 90, -41, -65, 25, -15, -85,
+    -7, -23, 18, 2, -48, -36, 86, -63, 15, -124, 62, -42, -116, -56, -66, 115,
+    -38, -54, -36, 114, 34, 31, 55, -29, -22, 38, -127, -78, -42, -66, 35, -31,
+    96, 17, -22, -25, 51, -21, 41, -115, -14, -61, -87, 7, -3, 16, 65, 98,
+    -1, -48, -8, 79, 95, 79, -79, 127, 34, -106, 57, 124, -25, 45, -47, -73,
+    55, -127, 82, 7, -102, -97, 38, 95, -56, 122, -102, 90, -26, -106, -57, -12,
+    74, 92, -93, 5, 38, -39, 95, -56, -122, -117, 46, 15, 114, 111, 104, -116,
+    64, 52, 40, 55, 104, 36, -33, 10, -76, 23, -127, -90, -43, 75, 57, -42,
+    31, -119, -87, 125, -54, -27, 13, -53, -6, -67, -117, -83, 6, -111, -25, -44,
+    -22, -104, 106, -7, 88, 123, -40, -5, 52, -19, -51, 61, 102, 109, 33, -32,
+    122, 36, -112, -107, 64, -113, -127, -27, 5, -13, -3, 22, 46, -20, -34, 126,
+    -62, 72, -18, -37, -113, 94, 52, 104, -12, 46, -98, -26, -76, -118, 116, -73,
+    -91, -78, -31, 12, -90, 126, 125, -91, -24, 46, 97, -1, 108, -46, 0, 0,
+    44, -77, 28, -73, -41, 120, 103, 82, -120, -91, -63, 74, 89, 21, 56, 79,
+    -112, -108, 96, -119, -71, -119, -125, 89, -44, -88, -91, 40, 121, 1, 104, 1,
+    19, 46, 79, 67, 127, 64, 105, -76, 9, 26, 84, -5, 75, -29, 22, 91,
+    76, 40, -127, -81, 2, -62, -110, 91, 113, -50, -23, 79, -111, 36, -95, -54,
+    84, -113, -118, -21, -2, 92, 55, 44, -89, 124, -23, 28, -29, -115, -7, -89,
+    -119, 30, 33, -100, 12, -39, -30, 70, -2, 97, 28, -8, 34, -41, -95, 46,
+    33, 78, -101, 111, 81, 113, 101, 49, 84, 5, 77, -84, 76, -15, 69, -12,
+    78, -115, -123, 117, -4, 108, 120, 45, 19, -77, -110, 86, 105, 76, 54, -22,
+    -53, -104, -20, 18, 114, 118, -23, -108, 74, 63, -127, -14, 50, -127, 113, 125,
+    57, -109, -111, -36, -121, -39, -126, 122, 82, -111, 101, -75, -76, 45, 113, -97,
+    -127, -34, -122, 27, 93, -81, -100, -40, 118, -95, 120, -35, -7, -53, 113, 118,
+    35, -81, 127, -102, 21, -89, 102, 115, 78, -47, -66, 66, -54, -21, -117, -95,
+    -122, -108, -109, -20, 13, 61, -91, -20, 35, -106, -14, -33, 114, -113, -23, -21,
+    58, -46, -75, -53, -7, 115, 76, -57, 15, 48, 75, -14, -26, 68, -17, -64,
+    -12, 111, -91, -10, 35, -4, -76, -127, 51, 30, -125, -51, 68, 33, 12, -88,
+    54, -7, 47, 68, -70, 69, -58, 127, -99, 101, -121, -64, 7, 21, -27, -104,
+    -65, -57, 67, 107, 25, -122, 77, -51, -42, 8, -66, 110, -88, -22, -55, 5,
+    19, 33, 8, -23, 35, -25, 73, 76, -55, -34, 34, -90, 52, -31, 24, -95,
+    43, -37, -7, -22, -6, 49, -46, 39, -112, -51, 62, -114, 31, -121, -7, 99,
+    -125, 7, -110, 93, 47, 61, 43, -125, -117, 31, 127, 95, 51, 58, -69, 64,
+    -54, -100, -10, -43, -84, -20, 101, -16, -13, 53, 6, -94, 104, -14, 74, -28,
+    79, -28, -72, -78, 113, 22, -115, -29, -68, -106, -80, -113, 35, -84, 28, 29,
+    52, 3, -55, 97, -38, -11, 34, 4, 117, 116, 110, 111, 21, -3, 52, -73,
+    -60, -117, -86, -127, 40, -92, 73, 46, 120, -26, 108, -12, -41, -102, 98, 75,
+    -47, -12, -46, -125, -121, -35, -77, 7, -83, -79, 46, 62, -50, 95, -65, -41,
+    56, -121, 115, -113, -10, 60, -120, 82, 127, -10, -101, -111, -106, 70, -23, 111,
+    -16, -112, -19, 68, 87, -122, -85, -3, -99, 98, 115, -48, -17, 15, -57, 11,
+    -80, -54, -16, 28, 10, -64, -72, -102, 76, -107, 62, -67, -58, 63, 43, 65,
+    4, 96, -101, 39, -102, 63, -38, 47, 54, 43, -74, 89, -69, 5, 47, -71,
+    34, -57, -88, 83, 14, -46, 23, -127, -99, -28, 127, 3, -113, 71, 75, 73,
+    18, 51, -75, 61, 82, 68, -38, 24, 34, 104, -102, 87, 7, -37, -12, -127,
+    -73, 40, 42, -1, 118, -5, -48, 91, -63, 27, 53, 84, 74, -30, -115, -120,
+    59, 120, -41, -15, 59, 41, -63, 45, -51, -37, 10, 61, -91, -125, 33, -124,
+    -116, -70, 39, -111, -112, 121, -20, 100, -72, -17, -36, -83, -44, 124, 63, -30,
+    -23, -60, 8, 60, 48, -10, -117, 108, -23, -28, -127, -92, 94, 4, 59, -90,
+    -43, 87, 82, -65, -122, 78, -85, 74, 47, -85, -108, 109, 25, 31, -11, -89,
+    27, -66, 81, 62, -125, 115, -123, -109, -55, -93, -70, -38, 62, -25, -61, -2,
+    -28, -50, 106, 13, 126, 72, 19, -63, 50, -12, 59, -25, -1, -127, 64, -123,
+    48, 22, 73, -56, 49, -78, 8, -42, 127, 125, -77, 17, -45, 124, 112, 23,
+    56, 46, -37, 106, 102, -43, 63, -125, 81, 17, 115, -35, 32, -45, 72, 26,
+    124, -127, -91, -116, -95, 109, 114, -5, 114, 81, 71, 63, -79, 12, -19, 114,
+    -83, -84, 40, -87, -99, 1, 76, 27, 65, -60, -55, -18, 125, 55, 114, 10,
+    14, 127, -80, 73, 76, 89, 65, -89, 42, 110, 16, -36, 116, 16, -23, 30,
+    79, -70, -126, 8, 114, 47, 34, 33, -1, 60, -65, 102, -58, 115, 111, -109,
+    -13, 63, -13, 2, 80, 53, 119, -87, 110, 111, 35, 114, -64, 99, 71, 28,
+    -105, -120, -125, -64, 67, -29, 71, 32, -28, 97, -118, -9, 85, -96, 54, -44,
+    -122, -7, 6, -117, 17, -39, -127, -79, -100, 10, -117, 110, 88, 114, -47, 104,
+    124, 68, -58, 44, 25, -25, -50, -113, -96, -94, -5, 36, 68, -116, 83, -117,
+    14, 62, 33, 115, -40, 22, -106, 15, 80, -76, -61, 51, -63, -61, 111, 127,
+    -88, 102, 13, -118, 22, 36, -119, 66, 81, -109, 38, -11, -67, -11, -87, -42,
+    40, -6, 14, 11, 82, -40, 80, -107, -18, -38, -12, 85, 3, 124, 92, -97,
+    -48, -125, 61, -126, 101, -80, -22, -114, -49, -29, -117, 70, 55, -37, 88, -110,
+    -116, -38, 105, 67, 45, 16, 79, -23, -123, 79, -81, -29, -37, -98, -39, -84,
+    30, 40, -127, -11, 14, 97, -1, -110, -117, 95, 76, 94, -62, 39, -106, 85,
+    -42, 116, -7, -119, 104, 32, -54, -118, -31, -87, 12, -90, -83, 107, 36, -65,
+    96, 32, 113, -4, 99, 45, -116, -66, -55, -84, -67, -70, 96, -9, 96, -92,
+    16, -124, 109, -126, -28, 77, 127, -122, 82, 3, -117, 70, -99, 28, 71, 44,
+    -31, -121, -16, 106, -43, -64, -92, 3, 9, -109, -24, 40, 119, -17, -16, -7,
+    -70, -27, 37, -26, 21, 86, 127, 98, -33, -122, 28, -6, -67, -117, -46, 76,
+    118, -100, 96, -115, 54, -121, -20, 94, -27, 108, 54, 27, -86, -41, -23, 23,
+    127, -55, 1, 111, -40, 33, 68, 33, 65, -78, 117, -83, 21, -52, 34, -53,
+    -18, 47, -59, 58, -39, -94, 29, -86, -18, -26, -109, 54, 46, 71, 11, 14,
+    -85, -75, -70, 6, 82, -37, 98, 60, 55, -42, -98, 118, 91, -23, 93, 102,
+    -40, 0, -43, 50, 106, 124, 62, -50, 97, 126, -39, 115, 3, 119, 127, 80,
+    47, -89, -127, 24, 52, 112, 4, 50, 38, -76, 37, 123, -100, 48, 29, -32,
+    75, -125, 101, 81, -5, -100, -12, 22, -63, -3, 71, 108, 16, 84, -108, 91,
+    112, -88, 87, 93, 100, 5, 29, -77, 55, -25, -127, -97, -30, 102, 17, 110,
+    114, -110, 23, -44, 2, -12, -5, -106, 88, -3, 38, -7, -85, 11, -90, 93,
+    88, -95, -114, -114, -28, 120, 15, -62, -72, -103, -95, 83, -96, 97, 86, -96,
+    15, -127, 93, 15, 66, -2, 49, 111, 15, 96, -40, -103, -127, -70, 87, -48,
+    -71, -1, 115, 2, -41, -108, 19, -70, -34, -30, 66, -69, 112, 62, -5, 98,
+    -36, -30, -95, 71, -25, 0, -7, 40, -32, 107, -17, -36, -25, 68, 127, 94,
+    -5, -53, -14, -40, -65, -80, 116, 0, -99, -30, -28, 3, 122, 121, 17, 30,
+    45, 1, -3, -47, 47, -104, -47, 100, -69, 119, 123, 19, -117, -104, -76, -44,
+    -99, 76, -35, -68, -116, -30, -126, -98, 27, 111, -77, 61, -77, -127, 101, 88,
+    -116, -86, -71, 114, -31, 82, -17, -32, 71, 31, -62, 22, 54, 87, 47, 38,
+    26, -109, 119, 57, -61, 51, 32, 42, -32, 20, 43, -80, 2, -101, -105, 110,
+    -100, 105, -8, -12, -43, -22, -33, 17, -44, 86, -71, -67, -5, 116, -127, 60,
+};
+
+static const int32_t k_gas_l2_b[32] = {
+    -1040, -204, 554, -113, -150, -524, -53, -568,
+    -481, 325, 209, 927, 980, 47, -900, -439,
+    38, 364, 973, -722, -988, 780, 639, 571,
+    -66, 373, -186, -649, -238, 606, 633, 1012,
+};
+
+static const int32_t k_gas_l2_mult[32] = {
+    1589060183, 1563370839, 1596162213, 1599186843, 1572553682, 1575903309,
+    1570727356, 1600272171, 1504550497, 1578473924, 1595140944, 1549858000,
+    1600034647, 1588636261, 1533457576, 1523413389, 1560582950, 1591084049,
+    1534811704, 1597799852, 1569311306, 1586655267, 1596377562, 1557345469,
+    1600663645, 1594534897, 1588356751, 1587773427, 1533257673, 1584569315,
+    1596255163, 1524462861,
+};
+
+static const int8_t k_gas_l2_shift[32] = {
+    9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+    9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+};
+
+static const int8_t k_gas_l5_w[512] = {
+    101, 47, 5, 58, -82, 110, 55, 25, -17, 35, 31, 104, 18, -75, -15, -67,
+    105, 89, 15, -79, -119, -95, -15, 45, -72, 48, 94, 67, -19, 38, 127, 100,
+    -41, 47, -86, 15, -37, -16, -16, 42, 89, -8, -90, 65, 64, 116, -27, -9,
+    10, 100, 52, -123, -75, 91, 22, 96, -23, -74, -127, 127, -93, 37, -3, -31,
+    10, -109, 121, -2, -125, -21, 66, -48, 63, 69, -67, 121, -122, 94, 3, -89,
+    -62, 24, -57, 87, -72, -30, 2, -41, 83, -61, -106, -89, 33, 16, -112, 127,
+    -5, -46, 59, -122, -17, 42, 119, 67, 99, -98, -18, -120, -58, -30, -40, -32,
+    78, -80, 83, 11, -41, 13, -87, -1, -123, 93, -43, -40, 127, 29, -21, 75,
+    -110, 18, 5, 92, 22, -4, 5, 72, -39, 15, 53, 126, 49, 117, -26, 28,
+    62, -39, -59, 120, -38, 127, 89, -72, 83, 123, -57, 42, 68, -106, 81, -49,
+    53, 115, -119, 29, -53, -99, 54, 122, 3, -39, -13, -22, 8, -23, -107, 123,
+    127, -83, -66, -16, 51, -120, 86, 35, -59, 95, 41, -47, 12, 123, -115, 53,
+    92, 50, -94, 25, 75, -21, 22, -65, -49, 81, -3, -13, -99, -33, 5, -70,
+    81, -30, -69, -50, 85, 106, 121, -127, 67, 7, -98, -66, -57, -25, -8, 114,
+    -115, 54, 92, -37, -65, -73, -52, -92, 13, -65, -123, -70, 84, -22, 100, 116,
+    -67, 16, 99, 21, -86, -66, 127, -52, 96, 77, 63, 58, 76, 90, -114, -87,
+    1, -75, 9, -2, -97, -108, -127, 85, -109, 120, 126, 64, -13, -58, -23, -40,
+    -27, 59, 102, -89, -67, -75, -118, 92, 3, -113, -14, -13, 72, 68, -95, 33,
+    3, -127, -92, 44, -35, 121, 0, 49, -96, -5, 61, 87, -78, -27, -7, -16,
+    -6, -53, 81, 108, -39, 36, -31, 21, 51, 0, 46, 67, 90, -81, -74, 4,
+    2, 78, 4, 102, 71, 2, 83, -6, -40, -17, -11, 38, -114, 58, 119, -10,
+    -110, -76, -101, -62, 75, -127, 95, 112, -80, -83, 119, -36, 79, -125, 125, -123,
+    28, 112, 87, -50, 84, -28, 0, -36, -38, 21, 74, 52, 70, -127, 8, -38,
+    -76, 110, -79, -82, -84, 41, 29, 1, 23, 115, 94, 106, -117, 104, -123, 39,
+    114, 1, -21, -45, 110, 113, 32, 57, -43, -96, 127, 42, -60, 126, 29, -45,
+    105, -112, 81, -90, -104, -64, 57, 29, -21, -90, 112, 71, 49, 83, 73, -103,
+    71, 88, 64, -5, 49, -104, 69, -62, 74, 35, 2, 9, -111, -120, -127, 72,
+    -94, -99, -30, 125, 101, -49, 84, -108, -28, 21, 127, -118, -23, 110, -123, 26,
+    -26, 16, 53, -24, 101, 118, 125, -115, 87, 98, -92, 114, -96, -76, 118, 86,
+    20, -55, -64, -25, -127, 35, -116, 71, -111, -127, -56, 71, 86, 2, 113, -100,
+    -49, 70, -51, -103, 23, -127, -37, -71, -49, -4, 10, -121, -54, -34, -28, -6,
+    -22, -124, -81, 42, 95, 3, -102, -125, -100, -34, 19, 48, 7, 19, -43, 48,
+};
+
+static const int32_t k_gas_l5_b[16] = {
+    254, -108, 349, 269, 442, -37, -174, 311,
+    -517, -130, 523, -177, 14, -281, -471, -486,
+};
+
+static const int32_t k_gas_l5_mult[16] = {
+    1667961573, 1694203753, 1683951474, 1691133455, 1707358844, 1696445333,
+    1655797644, 1665425299, 1667892481, 1661611661, 1704107016, 1658942570,
+    1635971547, 1660719194, 1676975003, 1493977122,
+};
+
+static const int8_t k_gas_l5_shift[16] = {
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+};
+
+static const int8_t k_gas_l6_w[112] = {
+    -16, 30, 12, 5, -99, -117, -36, 113, -82, -59, -4, 105, 114, -127, 38, -67,
+    39, 62, 99, 47, 89, 73, -87, -116, 61, 7, 127, -85, -29, -54, 97, -4,
+    105, 53, 127, 25, 121, -83, -15, 20, 122, 17, 93, 33, 3, -28, -33, -52,
+    -79, 127, 10, 100, 106, 121, -72, -45, 37, -49, -98, 71, 14, 10, 58, -106,
+    117, -6, 53, 28, 29, 58, -114, -1, -81, -31, 3, -41, -26, 64, -127, 127,
+    27, -88, 15, -110, 0, 50, -21, -49, 46, 114, 98, -30, 96, -101, -116, 127,
+    67, 29, 15, -49, 102, 90, -5, -72, 45, 58, 127, 74, -105, 126, 91, 21,
+};
+
+static const int32_t k_gas_l6_b[7] = {
+    -338, 466, 193, -870, 138, -989, 580,
+};
+
+static const int32_t k_gas_l6_mult[7] = {
+    1452443653, 1450023613, 1452763277, 1347246599, 1330050468, 1407272662,
+    1443152370,
+};
+
+static const int8_t k_gas_l6_shift[7] = {
+    7, 7, 7, 7, 7, 7, 7,
+};
+
+static const TinyMlLayer_t k_gas_layers[7] = {
+    {TINYML_OP_CONV1D, 1, 3, 1, 16, k_gas_l0_w, k_gas_l0_b, k_gas_l0_mult, k_gas_l0_shift},
+    {TINYML_OP_MAXPOOL2, 0, 0, 16, 16, NULL, NULL, NULL, NULL},
+    {TINYML_OP_CONV1D, 1, 3, 16, 32, k_gas_l2_w, k_gas_l2_b, k_gas_l2_mult, k_gas_l2_shift},
+    {TINYML_OP_MAXPOOL2, 0, 0, 32, 32, NULL, NULL, NULL, NULL},
+    {TINYML_OP_GAP, 0, 0, 32, 32, NULL, NULL, NULL, NULL},
+    {TINYML_OP_DENSE, 1, 0, 32, 16, k_gas_l5_w, k_gas_l5_b, k_gas_l5_mult, k_gas_l5_shift},
+    {TINYML_OP_DENSE, 0, 0, 16, 7, k_gas_l6_w, k_gas_l6_b, k_gas_l6_mult, k_gas_l6_shift},
+};
+
+static const float k_gas_in_offset[1] = {10.0f};
+static const float k_gas_in_gain[1] = {1.24489596f};
+static const char* const k_gas_classes[7] = {"mars", "venus", "comet", "europa", "titan", "earth_life", "background"};
+static const char* const k_gas_features[1] = {"mq3"};
+
+static const TinyMlModel_t k_gas_model = {
+    k_gas_layers, 7, GAS_MODEL_IN_FEATURES, GAS_MODEL_SEQ_LEN, GAS_MODEL_N_CLASSES, 256,
+    k_gas_in_offset, k_gas_in_gain, 0.047395011f, k_gas_classes, k_gas_features,
+};
+
+#endif /* __GAS_MODEL_WEIGHTS_H */
@@ -0,0 +1,519 @@
+/**
+ ******************************************************************************
+ * @file           : ground_link.c
+ * @brief          : 多地面站链路管理实现
+ ******************************************************************************
+ */
+
+#include "ground_link.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char* type;
+    const char* ip;
+    uint16_t port;
+    uint8_t roles;
+    uint8_t link_id;
+    uint8_t up;
+    uint16_t udp_port;        // 0 = 不使用 UDP
+    uint8_t udp_link_id;
+    uint8_t udp_up;
+    uint16_t udp_rx_len;      // 正在拼接的下行数据报（一帧 +IPD 可能分多次回调）
+    uint8_t udp_rx_over;      // 本数据报超长，到帧尾整个丢弃
+    uint8_t udp_rx[PUS_MAX_PACKET_LEN];
+    uint8_t ever_up;          // 曾经在线过（开机后尚未连上不算中断）
+    uint32_t down_since;      // 本次中断起点
+    GroundLinkStats_t stats;
+    PusLink_t pus;
+} ground_station_t;
+
+static ground_station_t g_stations[GROUND_LINK_MAX];
+static uint8_t g_station_count = 0;
+static uint8_t g_link_count = 0;                      // 已分配的连接号
+static uint8_t g_link_owner[ESP8266_MAX_LINKS];       // 连接号 -> 站点下标
+
+static uint16_t g_apid = 0x001;
+static uint16_t g_source_id = 0x01;
+static uint16_t g_dest_id = 0x00;
+static GroundHkPolicy_t g_hk_policy = GROUND_HK_FAILOVER;
+static uint8_t g_hk_next = 0;   // 轮询分担的下一个起点
+static pus_link_cmd_handler_t g_cmd_handler = NULL;
+static uint8_t g_mux_ready = 0;  // 已切换到 CIPMUX=1
+static uint16_t g_tm_seq = 0;    // 各站链路共用的 TM 序号计数器
+
+/* 非阻塞恢复（GroundLink_ResumeStart / GroundLink_ResumePoll）：每步最多发出一条 AT 指令 */
+#define GROUND_MUX_QUERY_TIMEOUT_MS   1000
+#define GROUND_MUX_ENABLE_TIMEOUT_MS  5000    // CIPCLOSE=5 + CIPCLOSE + CIPMUX=1
+#define GROUND_STATUS_TIMEOUT_MS      2000
+#define GROUND_OPEN_TIMEOUT_MS        10000   // 连接被拒时模块很快回 ERROR，不必等满
+
+typedef enum {
+    RESUME_IDLE = 0,
+    RESUME_MUX_QUERY,         // AT+CIPMUX?
+    RESUME_MUX_ENABLE,        // 模块处于单连接模式：关闭全部连接后 CIPMUX=1
+    RESUME_STATUS,            // AT+CIPSTATUS：沿用模块上仍在的连接
+    RESUME_OPEN,              // 逐个连接号 CIPSTART
+} ground_resume_t;
+
+static ground_resume_t g_resume = RESUME_IDLE;
+static uint32_t g_resume_since = 0;
+static uint8_t g_resume_mask = 0;     // 模块上已建立的连接
+static uint8_t g_resume_link = 0;     // 下一个待检查的连接号
+static uint8_t g_resume_fresh = 0;    // 刚切换到多连接：建立不计入重连次数
+
+static uint8_t station_send(void* user, const uint8_t* data, uint16_t len) {
+    ground_station_t* st = (ground_station_t*)user;
+    if (!ESP8266_SendLink(st->link_id, data, len)) {
+        return 0;
+    }
+    st->stats.tx_packets++;
+    return 1;
+}
+
+static uint8_t station_send_udp(void* user, const uint8_t* data, uint16_t len) {
+    ground_station_t* st = (ground_station_t*)user;
+    if (!ESP8266_SendLink(st->udp_link_id, data, len)) {
+        st->stats.udp_failures++;
+        st->udp_up = 0;
+        return 0;
+    }
+    st->stats.udp_packets++;
+    return 1;
+}
+
+static void station_set_up(ground_station_t* st, uint8_t up) {
+    up = up ? 1 : 0;
+    if (st->up && !up) {
+        st->down_since = HAL_GetTick();
+    } else if (!st->up && up && st->ever_up) {
+        uint32_t ms = HAL_GetTick() - st->down_since;
+        st->stats.outages++;
+        st->stats.outage_ms_last = ms;
+        st->stats.outage_ms_total += ms;
+        if (ms > st->stats.outage_ms_max) {
+            st->stats.outage_ms_max = ms;
+        }
+    }
+    if (up) {
+        st->ever_up = 1;
+    }
+    st->up = up;
+    PusLinkCtx_SetConnected(&st->pus, st->up);
+}
+
+static void station_set_udp_up(ground_station_t* st, uint8_t up) {
+    st->udp_up = (st->udp_port != 0 && up) ? 1 : 0;
+    if (!st->udp_up) {
+        st->udp_rx_len = 0;   // 驱动清缓冲区时可能留下半个数据报
+        st->udp_rx_over = 0;
+    }
+    PusLinkCtx_SetDatagramReady(&st->pus, st->udp_up);
+}
+
+/* HK 可以发往该站：TCP 在线，或 UDP 可用 */
+static uint8_t station_hk_usable(const ground_station_t* st) {
+    return (st->up || st->udp_up) ? 1 : 0;
+}
+
+static int8_t alloc_link(uint8_t station) {
+    if (g_link_count >= ESP8266_MAX_LINKS) {
+        return -1;
+    }
+    g_link_owner[g_link_count] = station;
+    return (int8_t)g_link_count++;
+}
+
+void GroundLink_Init(uint16_t apid, uint16_t source_id, uint16_t dest_id, GroundHkPolicy_t hk_policy) {
+    memset(g_stations, 0, sizeof(g_stations));
+    g_station_count = 0;
+    g_link_count = 0;
+    g_apid = apid;
+    g_source_id = source_id;
+    g_dest_id = dest_id;
+    g_hk_policy = hk_policy;
+    g_hk_next = 0;
+    g_cmd_handler = NULL;
+    g_mux_ready = 0;
+    g_tm_seq = 0;
+    g_resume = RESUME_IDLE;
+}
+
+int8_t GroundLink_AddStation(const char* type, const char* ip, uint16_t port, uint8_t roles) {
+    if (g_station_count >= GROUND_LINK_MAX || ip == NULL || ip[0] == '\0') {
+        return -1;
+    }
+    int8_t link_id = alloc_link(g_station_count);
+    if (link_id < 0) {
+        return -1;
+    }
+    ground_station_t* st = &g_stations[g_station_count];
+    st->type = type;
+    st->ip = ip;
+    st->port = port;
+    st->roles = roles;
+    st->link_id = (uint8_t)link_id;
+    st->up = 0;
+    PusLinkCtx_Init(&st->pus, station_send, st, g_apid, g_source_id, g_dest_id);
+    PusLinkCtx_ShareSeqCounter(&st->pus, &g_tm_seq);
+    PusLinkCtx_SetCommandHandler(&st->pus, g_cmd_handler);
+    return (int8_t)g_station_count++;
+}
+
+int8_t GroundLink_AddDatagram(int8_t station, uint16_t udp_port) {
+    if (station < 0 || station >= g_station_count || udp_port == 0) {
+        return -1;
+    }
+    ground_station_t* st = &g_stations[station];
+    if (st->udp_port != 0) {
+        return (int8_t)st->udp_link_id;
+    }
+    int8_t link_id = alloc_link((uint8_t)station);
+    if (link_id < 0) {
+        return -1;
+    }
+    st->udp_port = udp_port;
+    st->udp_link_id = (uint8_t)link_id;
+    st->udp_up = 0;
+    PusLinkCtx_SetDatagramTransport(&st->pus, station_send_udp, st);
+    PusLinkCtx_RouteService(&st->pus, 3, PUS_ROUTE_DATAGRAM);   // Service 3：HK
+    return link_id;
+}
+
+void GroundLink_SetCommandHandler(pus_link_cmd_handler_t handler) {
+    g_cmd_handler = handler;
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        PusLinkCtx_SetCommandHandler(&g_stations[i].pus, handler);
+    }
+}
+
+uint8_t GroundLink_Connect(void) {
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        station_set_up(&g_stations[i], 0);
+        station_set_udp_up(&g_stations[i], 0);
+    }
+    g_mux_ready = ESP8266_SetMultiConnection(1);
+    if (!g_mux_ready) {
+        printf("[地面站] 多连接模式设置失败\r\n");
+        return 0;
+    }
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        ground_station_t* st = &g_stations[i];
+        station_set_up(st, ESP8266_StartLink(st->link_id, st->type, st->ip, st->port));
+        if (st->udp_port != 0) {
+            station_set_udp_up(st, ESP8266_StartLink(st->udp_link_id, "UDP", st->ip, st->udp_port));
+        }
+    }
+    return GroundLink_UpCount();
+}
+
+uint8_t GroundLink_Reconnect(void) {
+    if (!g_mux_ready) {
+        return GroundLink_Connect();
+    }
+    uint8_t mask = ESP8266_QueryLinks();
+
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        ground_station_t* st = &g_stations[i];
+        if (mask & (1u << st->link_id)) {
+            station_set_up(st, 1);
+        } else if (ESP8266_StartLink(st->link_id, st->type, st->ip, st->port)) {
+            st->stats.reconnects++;
+            station_set_up(st, 1);
+        } else {
+            station_set_up(st, 0);
+        }
+
+        if (st->udp_port == 0) {
+            continue;
+        }
+        if (mask & (1u << st->udp_link_id)) {
+            station_set_udp_up(st, 1);
+        } else {
+            station_set_udp_up(st, ESP8266_StartLink(st->udp_link_id, "UDP", st->ip, st->udp_port));
+        }
+    }
+    return GroundLink_UpCount();
+}
+
+static void resume_enter(ground_resume_t step) {
+    g_resume = step;
+    g_resume_since = HAL_GetTick();
+}
+
+/* 连接号 link_id 的结果：TCP 连接对应站点在线，UDP 连接对应数据报可用 */
+static void resume_link_result(uint8_t link_id, uint8_t up, uint8_t opened) {
+    ground_station_t* st = &g_stations[g_link_owner[link_id]];
+    if (st->udp_port != 0 && link_id == st->udp_link_id) {
+        station_set_udp_up(st, up);
+        return;
+    }
+    if (up && opened && !g_resume_fresh) {
+        st->stats.reconnects++;
+    }
+    station_set_up(st, up);
+}
+
+/* 从 g_resume_link 起找下一个需要 CIPSTART 的连接号并发出；全部处理完返回 0 */
+static uint8_t resume_open_next(void) {
+    while (g_resume_link < g_link_count) {
+        uint8_t id = g_resume_link;
+        if (!(g_resume_mask & (1u << id))) {
+            ground_station_t* st = &g_stations[g_link_owner[id]];
+            uint8_t udp = (st->udp_port != 0 && id == st->udp_link_id);
+            if (ESP8266_OpenLinkStart(id, udp ? "UDP" : st->type, st->ip, udp ? st->udp_port : st->port)) {
+                resume_enter(RESUME_OPEN);
+                return 1;
+            }
+        }
+        resume_link_result(id, (g_resume_mask >> id) & 1u, 0);
+        g_resume_link++;
+    }
+    g_resume = RESUME_IDLE;
+    return 0;
+}
+
+void GroundLink_ResumeStart(void) {
+    /* 每次都向模块查询：模块复位后 CIPMUX 回到 0，本地记录的状态已过时，
+     * 继续发 CIPSTART=<id>,... 只会得到 ERROR */
+    g_resume_mask = 0;
+    g_resume_link = 0;
+    g_resume_fresh = 0;
+    ESP8266_MultiQueryStart();
+    resume_enter(RESUME_MUX_QUERY);
+}
+
+int8_t GroundLink_ResumePoll(void) {
+    uint32_t elapsed = HAL_GetTick() - g_resume_since;
+    uint8_t mux = 0;
+    int8_t r;
+
+    switch (g_resume) {
+    case RESUME_MUX_QUERY:
+        r = ESP8266_MultiQueryPoll(&mux);
+        if (r > 0 && mux) {
+            g_mux_ready = 1;
+            ESP8266_StatusStart();
+            resume_enter(RESUME_STATUS);
+        } else if (r != 0 || elapsed > GROUND_MUX_QUERY_TIMEOUT_MS) {
+            /* 单连接模式（或无响应）：同 GroundLink_Connect，全部重建 */
+            g_mux_ready = 0;
+            g_resume_fresh = 1;
+            for (uint8_t i = 0; i < g_station_count; i++) {
+                station_set_up(&g_stations[i], 0);
+                station_set_udp_up(&g_stations[i], 0);
+            }
+            ESP8266_MultiEnableStart();
+            resume_enter(RESUME_MUX_ENABLE);
+        }
+        return 0;
+
+    case RESUME_MUX_ENABLE:
+        r = ESP8266_MultiEnablePoll();
+        if (r > 0) {
+            g_mux_ready = 1;
+            return (int8_t)!resume_open_next();
+        }
+        if (r < 0 || elapsed > GROUND_MUX_ENABLE_TIMEOUT_MS) {
+            printf("[地面站] 多连接模式设置失败\r\n");
+            g_resume = RESUME_IDLE;
+            return 1;
+        }
+        return 0;
+
+    case RESUME_STATUS:
+        r = ESP8266_StatusPoll(&mux);
+        if (r == 0 && elapsed <= GROUND_STATUS_TIMEOUT_MS) {
+            return 0;
+        }
+        /* 查询失败时全部 CIPSTART：仍在的连接回 ALREADY CONNECTED，同样视为在线 */
+        g_resume_mask = (r > 0) ? ESP8266_StatusLinks() : 0;
+        return (int8_t)!resume_open_next();
+
+    case RESUME_OPEN:
+        r = ESP8266_OpenLinkPoll();
+        if (r == 0 && elapsed <= GROUND_OPEN_TIMEOUT_MS) {
+            return 0;
+        }
+        if (r == 0) {
+            printf("   ✗ 连接%u建立超时\r\n", g_resume_link);
+        }
+        resume_link_result(g_resume_link, r > 0, 1);
+        g_resume_link++;
+        return (int8_t)!resume_open_next();
+
+    case RESUME_IDLE:
+    default:
+        return 1;
+    }
+}
+
+void GroundLink_OnEvent(esp8266_event_t evt, uint8_t link_id) {
+    if (evt == ESP8266_EVT_WIFI_DOWN) {
+        for (uint8_t i = 0; i < g_station_count; i++) {
+            station_set_up(&g_stations[i], 0);
+            station_set_udp_up(&g_stations[i], 0);
+        }
+        g_mux_ready = 0;   // 可能是模块复位，之后由 Resume / Reconnect 重新确认多连接模式
+        return;
+    }
+    if (evt != ESP8266_EVT_LINK_CLOSED || link_id >= g_link_count) {
+        return;
+    }
+    ground_station_t* st = &g_stations[g_link_owner[link_id]];
+    if (st->udp_port != 0 && link_id == st->udp_link_id) {
+        station_set_udp_up(st, 0);
+    } else if (st->up) {
+        st->stats.closed++;
+        station_set_up(st, 0);
+    }
+}
+
+/**
+ * @brief UDP 连接：一帧 +IPD 即一个数据报，拼齐后整包交给 pus_link，不进 TCP 的流式分帧器
+ */
+static void station_udp_rx(ground_station_t* st, const uint8_t* data, uint16_t len) {
+    uint8_t last = (ESP8266_IPDFrameLeft() <= len);
+
+    if (!st->udp_rx_over && (uint32_t)st->udp_rx_len + len <= sizeof(st->udp_rx)) {
+        memcpy(&st->udp_rx[st->udp_rx_len], data, len);
+        st->udp_rx_len = (uint16_t)(st->udp_rx_len + len);
+    } else {
+        st->udp_rx_over = 1;
+    }
+    if (last) {
+        if (!st->udp_rx_over) {
+            PusLinkCtx_FeedDatagram(&st->pus, st->udp_rx, st->udp_rx_len);
+        }
+        st->udp_rx_len = 0;
+        st->udp_rx_over = 0;
+    }
+}
+
+void GroundLink_OnIPD(uint8_t link_id, const uint8_t* data, uint16_t len) {
+    if (link_id >= g_link_count) {
+        return;
+    }
+    ground_station_t* st = &g_stations[g_link_owner[link_id]];
+    if (st->udp_port != 0 && link_id == st->udp_link_id) {
+        station_udp_rx(st, data, len);
+        return;
+    }
+    PusLinkCtx_FeedBytes(&st->pus, data, len);
+}
+
+/**
+ * @brief 选出本条 HK 的目标站点；全部离线时放入第一个 HK 站点的队列，待重连后补发
+ */
+static ground_station_t* pick_hk_station(void) {
+    ground_station_t* fallback = NULL;
+
+    for (uint8_t k = 0; k < g_station_count; k++) {
+        uint8_t i = (g_hk_policy == GROUND_HK_BALANCE)
+                        ? (uint8_t)((g_hk_next + k) % g_station_count)
+                        : k;
+        ground_station_t* st = &g_stations[i];
+        if (!(st->roles & GROUND_ROLE_HK)) {
+            continue;
+        }
+        if (station_hk_usable(st)) {
+            g_hk_next = (uint8_t)((i + 1) % g_station_count);
+            return st;
+        }
+        if (fallback == NULL || st->link_id < fallback->link_id) {
+            fallback = st;
+        }
+    }
+    return fallback;
+}
+
+uint8_t GroundLink_QueueHousekeeping(const char* payload_json) {
+    ground_station_t* st = pick_hk_station();
+    if (st == NULL) {
+        return 0;
+    }
+    st->stats.hk_queued++;
+    return PusLinkCtx_QueueHousekeeping(&st->pus, payload_json);
+}
+
+uint8_t GroundLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
+    PusLink_t* links[GROUND_LINK_MAX];
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        if (g_stations[i].roles & GROUND_ROLE_EVENTS) {
+            links[n++] = &g_stations[i].pus;
+        }
+    }
+    return PusLinkCtx_QueueEventMulti(links, n, event_subtype, payload_json, ack_required);
+}
+
+uint8_t GroundLink_EventQueueDepth(void) {
+    uint8_t depth = 0;
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        const ground_station_t* st = &g_stations[i];
+        if ((st->roles & GROUND_ROLE_EVENTS) && st->up) {
+            uint8_t d = PusLinkCtx_QueueDepth(&st->pus);
+            if (d > depth) {
+                depth = d;
+            }
+        }
+    }
+    return depth;
+}
+
+uint8_t GroundLink_QueueDepth(uint8_t station) {
+    return (station < g_station_count) ? PusLinkCtx_QueueDepth(&g_stations[station].pus) : 0;
+}
+
+uint8_t GroundLink_Poll(void) {
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        ground_station_t* st = &g_stations[i];
+        if (!station_hk_usable(st)) {
+            continue;
+        }
+        if (!PusLinkCtx_Poll(&st->pus) && st->up) {
+            st->stats.tx_failures++;
+            station_set_up(st, 0);
+            printf("[地面站] 连接%u（%s:%u）发送失败，已切换到其余站点\r\n",
+                   st->link_id, st->ip, st->port);
+        }
+    }
+    return GroundLink_UpCount();
+}
+
+uint8_t GroundLink_StationCount(void) {
+    return g_station_count;
+}
+
+uint8_t GroundLink_UpCount(void) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        n = (uint8_t)(n + g_stations[i].up);
+    }
+    return n;
+}
+
+uint8_t GroundLink_AllUp(void) {
+    for (uint8_t i = 0; i < g_station_count; i++) {
+        const ground_station_t* st = &g_stations[i];
+        if (!st->up || (st->udp_port != 0 && !st->udp_up)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+uint8_t GroundLink_IsUp(uint8_t station) {
+    return (station < g_station_count) ? g_stations[station].up : 0;
+}
+
+const GroundLinkStats_t* GroundLink_GetStats(uint8_t station) {
+    if (station >= g_station_count) {
+        return NULL;
+    }
+    ground_station_t* st = &g_stations[station];
+    st->stats.tm_dropped = st->pus.dropped;
+    return &st->stats;
+}
@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file           : ground_link.h
+ * @brief          : 多地面站链路管理（ESP8266 多连接 + 每站一条 PUS 链路）
+ ******************************************************************************
+ * @description    : ESP8266 工作在 CIPMUX=1，每个地面站占用一个连接号，
+ *                   各自拥有独立的 PusLink_t（队列、分帧、TM-ACK），TM 序号由各站共用
+ *                   一个计数器，任一地面站看到的序号都不重复、不倒退。
+ *                   下行 +IPD,<id> 按连接号分发到对应链路。
+ *
+ *                   上行策略：
+ *                   - 事件：复制到所有带 GROUND_ROLE_EVENTS 的站点（同一份字节，
+ *                     地面按 (APID, 序号, 用户数据) 去重），每站各自等待 TM-ACK、各自重传；
+ *                   - HK：只发一份，按 GroundHkPolicy_t 选择在线站点；
+ *                     站点配置了 UDP 端口时 HK 走 UDP（一包一个数据报，尽力而为），
+ *                     不再排在 TCP 流里阻塞事件；UDP 不可用时回落到 TCP；
+ *                   某站发送失败或模块上报断开即标记离线，后续流量立即改走其余在线站点。
+ ******************************************************************************
+ */
+
+#ifndef __GROUND_LINK_H
+#define __GROUND_LINK_H
+
+#include <stdint.h>
+#include "esp8266_driver.h"
+#include "pus_link.h"
+
+#define GROUND_LINK_MAX ESP8266_MAX_LINKS
+
+/* 站点角色（可组合） */
+#define GROUND_ROLE_EVENTS 0x01   // 接收事件副本
+#define GROUND_ROLE_HK     0x02   // 参与 HK 下传
+#define GROUND_ROLE_ALL    (GROUND_ROLE_EVENTS | GROUND_ROLE_HK)
+
+/* HK 分发策略 */
+typedef enum {
+    GROUND_HK_FAILOVER = 0,   // 发往第一个在线站点（主站优先，主站离线即切到备站）
+    GROUND_HK_BALANCE,        // 在线站点之间轮流分担
+} GroundHkPolicy_t;
+
+/* 单站统计 */
+typedef struct {
+    uint32_t tx_packets;      // 经 TCP 发送成功的 PUS 包
+    uint32_t tx_failures;     // TCP 发送失败（每次失败都会使该站离线）
+    uint32_t reconnects;      // 重连成功次数
+    uint32_t hk_queued;       // 分到本站的 HK
+    uint32_t udp_packets;     // 经 UDP 发出的包
+    uint32_t udp_failures;    // UDP 发送失败（之后回落到 TCP，直到重连）
+    uint32_t closed;          // 模块上报 <id>,CLOSED（对端或网络断开）
+    uint32_t outages;         // 已恢复的中断次数（TCP 离线 → 重新在线）
+    uint32_t outage_ms_total; // 已恢复中断的累计时长
+    uint32_t outage_ms_max;
+    uint32_t outage_ms_last;
+    uint32_t tm_dropped;      // 本站队列溢出丢弃的 TM（淘汰旧 HK 或放不下）
+} GroundLinkStats_t;
+
+/**
+ * @brief 初始化（清空站点表）
+ */
+void GroundLink_Init(uint16_t apid, uint16_t source_id, uint16_t dest_id, GroundHkPolicy_t hk_policy);
+
+/**
+ * @brief 添加地面站（按添加顺序分配连接号，第一个为主站）
+ * @param type "TCP"
+ * @param ip/port 地面站地址（字符串需在整个运行期间有效）
+ * @param roles GROUND_ROLE_* 组合
+ * @return 站点号；-1 表示站点或连接号已满
+ */
+int8_t GroundLink_AddStation(const char* type, const char* ip, uint16_t port, uint8_t roles);
+
+/**
+ * @brief 为站点增加一条 UDP 连接，HK（Service 3）改走该连接
+ * @param station GroundLink_AddStation 的返回值（-1 时忽略）
+ * @param udp_port 地面站 UDP 端口，0 表示不启用
+ * @return 分配的连接号；-1 表示未启用
+ */
+int8_t GroundLink_AddDatagram(int8_t station, uint16_t udp_port);
+
+/**
+ * @brief 设置 TC 指令回调（所有站点共用）
+ */
+void GroundLink_SetCommandHandler(pus_link_cmd_handler_t handler);
+
+/**
+ * @brief 切换到多连接模式并连接所有站点
+ * @return 在线站点数
+ */
+uint8_t GroundLink_Connect(void);
+
+/**
+ * @brief 查询连接状态，重连离线的 TCP/UDP 连接
+ * @return 在线站点数
+ */
+uint8_t GroundLink_Reconnect(void);
+
+/**
+ * @brief 非阻塞地沿用模块上已有的连接：已处于多连接模式时只补建缺少的连接（MCU 复位后
+ *        模块仍保持原来的连接，不必全部关闭重建），否则同 GroundLink_Connect
+ * @note  每次都查询模块的 CIPMUX（模块复位后回到单连接模式）；之后反复调用
+ *        GroundLink_ResumePoll，期间不要调用其他 AT 函数（含发送）
+ */
+void GroundLink_ResumeStart(void);
+
+/**
+ * @brief 推进 GroundLink_ResumeStart：每次调用最多发出一条 AT 指令
+ *        （CIPMUX? / CIPCLOSE / CIPMUX=1 / CIPSTATUS / 一个连接号的 CIPSTART），各步自带超时
+ * @return 1: 已完成（在线站点数见 GroundLink_UpCount）; 0: 尚未完成
+ */
+int8_t GroundLink_ResumePoll(void);
+
+/**
+ * @brief 链路事件回调（ESP8266_SetEventSink）：<id>,CLOSED 使对应连接立即离线，
+ *        WIFI DISCONNECT 使全部连接离线；PUS 链路随之停止发送，消息留在队列中
+ */
+void GroundLink_OnEvent(esp8266_event_t evt, uint8_t link_id);
+
+/**
+ * @brief +IPD 接收回调：按连接号交给对应站点的 PUS 分帧器（UDP 连接按数据报整包处理）
+ */
+void GroundLink_OnIPD(uint8_t link_id, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief HK 入队（按策略选一个站点）
+ */
+uint8_t GroundLink_QueueHousekeeping(const char* payload_json);
+
+/**
+ * @brief 事件入队（复制到所有事件站点）
+ * @return 入队的站点数
+ */
+uint8_t GroundLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required);
+
+/**
+ * @brief 在线事件站点中最深的发送队列（含等待 TM-ACK 的消息），用于批量下传限流
+ */
+uint8_t GroundLink_EventQueueDepth(void);
+
+/**
+ * @brief 某站的发送队列深度（含等待 TM-ACK 的消息；离线时即断链缓存的消息数）
+ */
+uint8_t GroundLink_QueueDepth(uint8_t station);
+
+/**
+ * @brief 每个在线站点发送一条待发消息；TCP 发送失败的站点标记离线
+ * @return TCP 在线站点数
+ */
+uint8_t GroundLink_Poll(void);
+
+uint8_t GroundLink_StationCount(void);
+uint8_t GroundLink_UpCount(void);
+
+/**
+ * @brief 所有站点的 TCP（及已配置的 UDP）连接均在线
+ */
+uint8_t GroundLink_AllUp(void);
+
+uint8_t GroundLink_IsUp(uint8_t station);
+const GroundLinkStats_t* GroundLink_GetStats(uint8_t station);
+
+#endif /* __GROUND_LINK_H */
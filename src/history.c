@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file           : history.c
+ * @brief          : 板上多分辨率历史实现
+ ******************************************************************************
+ */
+
+#include "history.h"
+
+#include <string.h>
+
+static const struct {
+    uint32_t period_ms;
+    uint16_t offset;                    // 在 bucket[] 中的起点
+    uint16_t len;
+} k_levels[HISTORY_LEVELS] = {
+    {1000, 0, HISTORY_1S_LEN},
+    {10000, HISTORY_1S_LEN, HISTORY_10S_LEN},
+    {60000, HISTORY_1S_LEN + HISTORY_10S_LEN, HISTORY_60S_LEN},
+};
+
+/* 环形缓冲：返回新项的物理下标，满则覆盖最旧项 */
+static uint16_t ring_append(HistoryRing_t* r, uint16_t cap) {
+    uint16_t idx = (uint16_t)((r->head + r->len) % cap);
+    if (r->len < cap) {
+        r->len++;
+    } else {
+        r->head = (uint16_t)((r->head + 1) % cap);
+    }
+    return idx;
+}
+
+/* 时刻比较（按差值判断先后，tick 回绕时仍正确） */
+static int tick_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static void close_bucket(History_t* h, uint8_t level) {
+    HistoryOpen_t* o = &h->open[level];
+    uint16_t idx = ring_append(&h->ring[level], k_levels[level].len);
+    HistoryBucket_t* b = &h->bucket[k_levels[level].offset + idx];
+
+    b->tick = o->tick;
+    b->min = o->min;
+    b->max = o->max;
+    b->mean = (uint16_t)((o->sum + o->count / 2u) / o->count);
+    b->count = o->count;
+    o->count = 0;
+}
+
+void History_Init(History_t* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void History_Push(History_t* h, uint16_t value, uint32_t tick) {
+    uint16_t idx = ring_append(&h->raw_ring, HISTORY_RAW_LEN);
+    h->raw[idx].tick = tick;
+    h->raw[idx].value = value;
+
+    for (uint8_t level = 0; level < HISTORY_LEVELS; level++) {
+        HistoryOpen_t* o = &h->open[level];
+        uint32_t start = tick - (tick % k_levels[level].period_ms);
+
+        if (o->count > 0 && o->tick != start) {
+            close_bucket(h, level);
+        }
+        if (o->count == 0) {
+            o->tick = start;
+            o->sum = 0;
+            o->min = value;
+            o->max = value;
+        }
+        o->sum += value;
+        if (value < o->min) {
+            o->min = value;
+        }
+        if (value > o->max) {
+            o->max = value;
+        }
+        if (o->count < UINT16_MAX) {
+            o->count++;
+        }
+    }
+}
+
+int8_t History_LevelForResolution(uint16_t res_s) {
+    if (res_s == 0) {
+        return HISTORY_LEVEL_RAW;
+    }
+    for (uint8_t level = 0; level < HISTORY_LEVELS; level++) {
+        if (k_levels[level].period_ms == (uint32_t)res_s * 1000u) {
+            return (int8_t)(level + 1);
+        }
+    }
+    return -1;
+}
+
+uint32_t History_LevelPeriod(uint8_t level) {
+    if (level == HISTORY_LEVEL_RAW || level > HISTORY_LEVELS) {
+        return 0;
+    }
+    return k_levels[level - 1].period_ms;
+}
+
+/* 第 i 个（逻辑序，0 为最旧）记录的 tick */
+static uint32_t entry_tick(const History_t* h, uint8_t level, uint16_t i) {
+    if (level == HISTORY_LEVEL_RAW) {
+        return h->raw[(h->raw_ring.head + i) % HISTORY_RAW_LEN].tick;
+    }
+    const HistoryRing_t* r = &h->ring[level - 1];
+    uint16_t cap = k_levels[level - 1].len;
+    return h->bucket[k_levels[level - 1].offset + (r->head + i) % cap].tick;
+}
+
+uint16_t History_Read(const History_t* h, uint8_t level, uint32_t from_tick, uint32_t to_tick,
+                      HistoryRecord_t* out, uint16_t max) {
+    if (level > HISTORY_LEVELS || out == NULL) {
+        return 0;
+    }
+    uint16_t len = (level == HISTORY_LEVEL_RAW) ? h->raw_ring.len : h->ring[level - 1].len;
+
+    /* 二分查找第一个 tick >= from_tick 的记录 */
+    uint16_t lo = 0;
+    uint16_t hi = len;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (tick_before(entry_tick(h, level, mid), from_tick)) {
+            lo = (uint16_t)(mid + 1);
+        } else {
+            hi = mid;
+        }
+    }
+
+    uint16_t n = 0;
+    for (uint16_t i = lo; i < len && n < max; i++) {
+        HistoryRecord_t* rec = &out[n];
+        if (level == HISTORY_LEVEL_RAW) {
+            const HistorySample_t* s = &h->raw[(h->raw_ring.head + i) % HISTORY_RAW_LEN];
+            rec->tick = s->tick;
+            rec->min = rec->max = rec->mean = s->value;
+            rec->count = 1;
+        } else {
+            const HistoryRing_t* r = &h->ring[level - 1];
+            *rec = h->bucket[k_levels[level - 1].offset + (r->head + i) % k_levels[level - 1].len];
+        }
+        if (tick_before(to_tick, rec->tick)) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+uint16_t History_Latest(const History_t* h, HistorySample_t* out, uint16_t n) {
+    uint16_t len = h->raw_ring.len;
+    if (n > len) {
+        n = len;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        out[i] = h->raw[(h->raw_ring.head + len - n + i) % HISTORY_RAW_LEN];
+    }
+    return n;
+}
@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file           : history.h
+ * @brief          : 板上多分辨率历史（原始样本环 + 1s/10s/60s 聚合金字塔）
+ ******************************************************************************
+ * @description    : 每路传感器一个 History_t，固定 RAM：
+ *                   - 原始层：最近 HISTORY_RAW_LEN 个过采样输出（值 + 时刻）；
+ *                   - 聚合层：按 1 s / 10 s / 60 s 对齐的桶，记录 min/max/mean/样本数，
+ *                     每层一个环形缓冲，写满后覆盖最旧的桶。
+ *                   每个样本同时累加进三层的“当前桶”，跨入下一周期时当前桶关闭
+ *                   入环（均值按原始样本精确计算，不做逐层近似）。
+ *
+ *                   默认容量：原始 256 个（每 256 ms 一个输出时约 65 s）、
+ *                   1 s × 240（4 min）、10 s × 360（1 h）、60 s × 720（12 h），
+ *                   约 18 KB/传感器。
+ *
+ *                   在中断中推入时，读取方（History_Read）需关中断调用。
+ ******************************************************************************
+ */
+
+#ifndef __HISTORY_H
+#define __HISTORY_H
+
+#include <stdint.h>
+
+#ifndef HISTORY_RAW_LEN
+#define HISTORY_RAW_LEN 256
+#endif
+#ifndef HISTORY_1S_LEN
+#define HISTORY_1S_LEN 240
+#endif
+#ifndef HISTORY_10S_LEN
+#define HISTORY_10S_LEN 360
+#endif
+#ifndef HISTORY_60S_LEN
+#define HISTORY_60S_LEN 720
+#endif
+
+#define HISTORY_LEVELS 3                // 聚合层数（1 s / 10 s / 60 s）
+#define HISTORY_LEVEL_RAW 0             // History_Read 的 level：0 为原始层，1~3 为聚合层
+#define HISTORY_BUCKET_TOTAL (HISTORY_1S_LEN + HISTORY_10S_LEN + HISTORY_60S_LEN)
+
+typedef struct {
+    uint32_t tick;
+    uint16_t value;
+} HistorySample_t;
+
+typedef struct {
+    uint32_t tick;                      // 桶起点（按周期对齐）
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint16_t count;
+} HistoryBucket_t;
+
+typedef struct {
+    uint16_t head;                      // 最旧一项
+    uint16_t len;
+} HistoryRing_t;
+
+typedef struct {
+    uint32_t tick;
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+    uint16_t count;                     // 0 表示尚未开桶
+} HistoryOpen_t;
+
+typedef struct {
+    HistorySample_t raw[HISTORY_RAW_LEN];
+    HistoryBucket_t bucket[HISTORY_BUCKET_TOTAL];   // 三层依次存放
+    HistoryRing_t raw_ring;
+    HistoryRing_t ring[HISTORY_LEVELS];
+    HistoryOpen_t open[HISTORY_LEVELS];
+} History_t;
+
+/* 读出的一条记录（原始层 min = max = mean = 样本值，count = 1） */
+typedef HistoryBucket_t HistoryRecord_t;
+
+void History_Init(History_t* h);
+
+/**
+ * @brief 推入一个样本（时刻需单调不减）
+ */
+void History_Push(History_t* h, uint16_t value, uint32_t tick);
+
+/**
+ * @brief 分辨率（秒）→ level
+ * @param res_s 0 = 原始样本；1 / 10 / 60
+ * @return level；-1 表示不支持的分辨率
+ */
+int8_t History_LevelForResolution(uint16_t res_s);
+
+/**
+ * @brief level 的周期（ms），原始层返回 0
+ */
+uint32_t History_LevelPeriod(uint8_t level);
+
+/**
+ * @brief 按时间顺序读出 tick ∈ [from_tick, to_tick] 的记录（只含已关闭的桶）
+ * @param max out 容量；分页时以最后一条的 tick + 1 作为下一页的 from_tick
+ * @return 读出条数
+ */
+uint16_t History_Read(const History_t* h, uint8_t level, uint32_t from_tick, uint32_t to_tick,
+                      HistoryRecord_t* out, uint16_t max);
+
+/**
+ * @brief 最近 n 个原始样本，按时间顺序（最旧在前）
+ * @return 读出个数（样本不足 n 时少于 n）
+ */
+uint16_t History_Latest(const History_t* h, HistorySample_t* out, uint16_t n);
+
+#endif /* __HISTORY_H */
@@ -10,16 +10,29 @@
 
 #include "stm32f4xx_hal.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "esp8266_driver.h"   // 引入新的ESP8266驱动
 #include "sensor_manager.h"   // 引入传感器管理模块
 #include "pus_link.h"         // ECSS PUS（最小子集）
+#include "ground_link.h"      // 多地面站（ESP8266 多连接）
+#include "dlog.h"             // 延迟日志（USART1 DMA 后台发送）
+#include "adc_scan.h"         // TIM2 触发的多通道 ADC 扫描（循环 DMA）
+#include "sched.h"            // 协作式调度器（周期任务）
+#include "tm_writer.h"        // 遥测序列化（不用浮点 printf）
 
 /* WiFi/服务器配置 - 请根据实际环境修改 */
 static const char* WIFI_SSID = "MCVC05LC";       // 笔记本热点名称
 static const char* WIFI_PASSWORD = "N46065rj";   // 笔记本热点密码
 static const char* SERVER_IP = "192.168.137.1";  // 电脑热点的IP地址
 static const uint16_t SERVER_PORT = 8888;        // TCP服务器端口
+static const uint16_t SERVER_HK_UDP_PORT = 0;    // HK 走 UDP 的端口（后端默认 8888），0 表示 HK 仍走 TCP
+
+/* 备用地面站（留空表示不启用）：事件双发，HK 在主站离线时立即改走备站 */
+static const char* BACKUP_SERVER_IP = "";
+static const uint16_t BACKUP_SERVER_PORT = 8888;
+static const uint16_t BACKUP_SERVER_HK_UDP_PORT = 0;
+#define GROUND_HK_POLICY            GROUND_HK_FAILOVER   // 或 GROUND_HK_BALANCE（HK 轮流分担）
 
 /* 自适应采样配置 */
 static volatile uint32_t g_sampling_interval_ms = 5000;  // 动态采样间隔（毫秒）
@@ -31,43 +44,161 @@ static volatile uint32_t g_sampling_interval_ms = 5000;  // 动态采样间隔
 #define NORMAL_SAMPLE_RATE_MS       5000
 #define ALCOHOL_ALERT_PPM           150.0f
 #define ALCOHOL_CLEAR_PPM           120.0f
+#define GAS_AWD_CONFIRM_MS          10000    // 模拟看门狗越界后，等待滤波浓度确认告警的时长
+
+#define GAS_CLASS_EVENT_CONF        0.6f     // 板上分类类别变化且置信度达到此值时下传事件
+
+/* 模拟看门狗：ADC 硬件逐次比较 MQ-3 原始码值，越过告警阈值立即中断（不等采样间隔） */
+static volatile uint8_t g_gas_awd_tripped = 0;
+
+/* HK 下传粒度（TC 129/5）：告警/异常期间逐轮全量下传；平静期只在某个字段越出死区
+ * （sensor_manager.c 中按字段设置）或到达最长静默时间时下传 */
+#define HK_HEARTBEAT_MS             60000    // 平静期最长静默（心跳）间隔（5 s 采样时约 1/12 的 HK）
+#define HK_ANOMALY_HOLD_MS          30000    // 最后一次越限后继续逐轮下传的时长
+#define HK_ANOMALY_Z_MAX            50u      // TC 可设的异常阈值上限
+static uint8_t g_hk_gated = 1;               // 0: 每轮都下传
+static uint32_t g_hk_heartbeat_ms = HK_HEARTBEAT_MS;
+static uint32_t g_hk_sent_total = 0;         // 已下传 / 省略的 HK 累计数
+static uint32_t g_hk_suppressed_total = 0;
+static uint8_t g_telemetry_report = 0;       // 收到 TC 129/5，采样任务回报一次 telemetry 事件
+static char g_telemetry_db[24];              // 该 TC 修改的死区字段（空表示未修改）
+static uint8_t g_telemetry_db_ok = 0;
+
+/* 历史下传（TC 129/4）：每轮最多入队几页，事件队列深度达到上限时暂停，不挤占实时遥测 */
+#define HISTORY_PAGES_PER_LOOP      4
+#define HISTORY_QUEUE_LIMIT         (PUS_QUEUE_SIZE / 2)
+static SensorHistoryCursor_t g_history_cursor = { .done = true };
+
+/* 调度任务（sched.h）：各自按周期释放，TC 处理与重传不再等待采样间隔；截止时间 0 表示等于周期 */
+#define TASK_RX_PERIOD_MS           5        // TC 接收：+IPD 投递到 PUS 分帧器
+#define TASK_PUS_PERIOD_MS          20       // PUS 队列发送、TM-ACK 重传、历史分页
+#define TASK_SAMPLE_DEADLINE_MS     100      // 采样：周期 = g_sampling_interval_ms
+#define TASK_NET_PERIOD_MS          1000     // 网络监护（在线或等待重试时）
+#define TASK_NET_STEP_MS            20       // 联网过程中检查 AT 响应的间隔
+#define TASK_LOG_PERIOD_MS          100      // 延迟日志补发
+static int8_t g_task_sample = -1;
+static int8_t g_task_net = -1;
+static uint8_t g_tcp_enabled = 0;            // 至少一个地面站在线
+static uint8_t g_wifi_connected = 0;
+static uint8_t g_sched_report = 0;           // 收到 TC 129/6：1 = 回报调度统计，2 = 回报后清零
+
+/* 后台联网（NetTask 推进）：每步只发一条 AT 指令或检查一次已到达的响应，采样与 PUS 排队不必等待 */
+#define ESP_BOOT_MS                 1000     // ESP8266 上电后到能响应 AT 的时间
+#define NET_PROBE_TIMEOUT_MS        2000
+#define NET_STATUS_TIMEOUT_MS       2000
+#define NET_AUTOJOIN_TIMEOUT_MS     6000     // 模块自行连接已保存热点的等待上限
+#define NET_MODE_TIMEOUT_MS         2000
+#define NET_JOIN_TIMEOUT_MS         25000
+#define NET_AUTOCONN_TIMEOUT_MS     1000
+#define NET_ADDR_TIMEOUT_MS         5000
+typedef enum {
+    NET_BOOT = 0,                            // 等待 ESP8266 启动
+    NET_PROBE,                               // AT
+    NET_STATUS,                              // AT+CIPSTATUS：热点已在线则跳过连接流程
+    NET_AUTOJOIN,                            // 等待模块自动连接 flash 中保存的热点
+    NET_MODE,                                // AT+CWMODE_DEF=1（完整流程）
+    NET_JOIN,                                // AT+CWJAP_DEF，等待 WIFI GOT IP
+    NET_AUTOCONN,                            // AT+CWAUTOCONN=1（仅完整流程之后，写模块 flash）
+    NET_ADDR,                                // AT+CIFSR（离线时打印本机 IP）
+    NET_LINK,                                // 沿用或建立多连接，逐个补建各地面站 CIPSTART
+    NET_UP,                                  // 热点在线：按退避重连离线的地面站
+    NET_RETRY,                               // 失败后按退避等待，再从 NET_PROBE 开始
+} NetState_t;
+static NetState_t g_net_state = NET_BOOT;
+
+/* 网络监护：ESP8266 主动上报（CLOSED / WIFI DISCONNECT）与发送失败立即唤醒 NetTask，
+ * 重连间隔按指数退避（每次失败上限翻倍），实际等待在 [上限/2, 上限] 内随机（种子取芯片 UID，
+ * 地面站重启后各节点不会同时重连） */
+#define NET_BACKOFF_MIN_MS          1000
+#define NET_BACKOFF_MAX_MS          60000
+#define NET_EVT_WIFI_DOWN           0x01
+#define NET_EVT_WIFI_UP             0x02
+#define NET_EVT_LINK_LOST           0x04
+typedef struct {
+    volatile uint8_t events;                 // NET_EVT_*：OnNetEvent 置位，NetTask 处理
+    uint8_t retry_armed;
+    uint32_t retry_at;                       // 下次重连时刻
+    uint32_t backoff_ms;                     // 下次等待的上限
+    uint32_t rng;
+    uint32_t offline_since;                  // 全部地面站离线的起点
+    uint32_t outages;                        // 全部离线 → 恢复（开机首次上线不计）
+    uint32_t outage_ms_total;
+    uint32_t outage_ms_max;
+    uint32_t outage_ms_last;
+    uint32_t wifi_drops;                     // 在线时收到 WIFI DISCONNECT
+} NetSupervisor_t;
+static NetSupervisor_t g_net = { .backoff_ms = NET_BACKOFF_MIN_MS };
+
+/* 启动耗时（开机毫秒数），首包下传后以 boot 事件回报一次 */
+#define BOOT_SAMPLE                 0x01
+#define BOOT_LINK                   0x02
+#define BOOT_TX                     0x04
+typedef struct {
+    uint8_t done;                            // BOOT_* 已发生的里程碑
+    uint32_t first_sample_ms;                // 首轮采样完成（HK 已入队）
+    uint32_t link_ms;                        // 首次有地面站在线
+    uint32_t first_tx_ms;                    // 首个 PUS 包发出
+    uint8_t backlog;                         // 上线时已排队待发的消息数
+} BootTiming_t;
+static BootTiming_t g_boot;
 
 /* Private variables */
 UART_HandleTypeDef huart1;  // 调试串口
+DMA_HandleTypeDef hdma_usart1_tx;  // 调试串口 TX DMA（DMA2 Stream7 Ch4）
 UART_HandleTypeDef huart2;  // ESP8266串口
 ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;       // ADC1 扫描结果 DMA（DMA2 Stream0 Ch0，循环）
+TIM_HandleTypeDef htim2;           // ADC 扫描触发（TRGO = 更新事件）
 
 /* Private function prototypes */
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART1_UART_Init(void);
 static void MX_USART2_UART_Init(void);
 static void MX_ADC1_Init(void);
+static void MX_TIM2_Init(void);
 void Error_Handler(void);
-static uint8_t EnsureWiFiConnected(const char* ssid, const char* password);
-static uint8_t EnsureTCPConnected(const char* ip, uint16_t port);
-
-/* 新的ESP8266相关函数 */
-uint8_t ESP8266_Test(void);
-uint8_t ESP8266_ConnectWiFi(const char* ssid, const char* password);
-void ESP8266_GetIPAddress(void);
+static void BootTimingStep(void);
 
 /* 后端指令解析函数 */
 static void ParseBackendCommand(const char* json_str);
+static uint8_t JsonFindUint(const char* json, const char* key, uint32_t* out);
+static uint8_t JsonFindString(const char* json, const char* key, char* out, size_t size);
+static uint8_t JsonFindFloat(const char* json, const char* key, float* out);
+static uint8_t HistoryTransferStep(void);
+static void OnGasWatchdog(uint32_t adc_channel);
+static void UpdateGasWatchdog(uint8_t arm);
+static void ReportSchedStats(void);
+static void ReportLinkStats(void);
+static void OnNetEvent(esp8266_event_t evt, uint8_t link_id);
+static void NetSetOnline(uint8_t online);
+static uint32_t NetRetryArm(uint32_t now);
+static NetState_t NetLinkStart(uint8_t joined);
+static NetState_t NetAddrStart(void);
+static void QueueEventTm(TmWriter_t* w, uint8_t event_subtype);
+
+/* 调度任务 */
+static void RxTask(void);
+static void PusTask(void);
+static void SampleTask(void);
+static void NetTask(void);
+static void LogTask(void);
 
 /**
- * @brief  重定向printf到UART1
+ * @brief  重定向printf到UART1（写入延迟日志缓冲，由DMA后台发送，不阻塞）
  */
 int _write(int file, char *ptr, int len)
 {
-    HAL_UART_Transmit(&huart1, (uint8_t*)ptr, len, HAL_MAX_DELAY);
+    (void)file;
+    DLog_WriteText(ptr, len);
     return len;
 }
 
 /**
  * @brief  读取ADC值
  */
-// 兼容旧接口：如需手动读取，请使用传感器管理器接口（MQ3_ReadADC/MQ3_ReadVoltage）
+// 兼容旧接口：如需手动读取，请使用传感器管理器接口（SensorManager_GetData，由注册表中的驱动更新）
 
 /**
  * @brief  主程序
@@ -83,27 +214,42 @@ int main(void)
     /* 步骤3：初始化GPIO */
     MX_GPIO_Init();
     
-    /* 步骤4：初始化UART */
+    /* 步骤4：初始化DMA与UART（USART1 日志经 DMA 后台发送） */
+    MX_DMA_Init();
     MX_USART1_UART_Init();
     MX_USART2_UART_Init();
+    DLog_Init(&huart1);
     
-    /* 步骤5：初始化ADC */
+    /* 步骤5：初始化ADC（TIM2 定时触发扫描，结果经 DMA 循环写入） */
     MX_ADC1_Init();
+    MX_TIM2_Init();
+    AdcScan_Init(&hadc1, &htim2);
+    if (!AdcScan_Start(ADC_SCAN_DEFAULT_RATE_HZ))
+    {
+        Error_Handler();
+    }
 
-    /* 步骤6：初始化传感器管理器 (集成MQ-3) */
-    SensorManager_Init(&hadc1);
+    /* 步骤6：初始化传感器管理器 (集成MQ-3，读取扫描帧) */
+    SensorManager_Init();
+    AdcScan_SetWatchdogHook(OnGasWatchdog);   // MQ-3 就绪后按告警阈值布防
 
     /* 步骤7: 初始化ESP8266驱动 (关键改动) */
     ESP8266_Init();
 
-    /* 步骤8: 初始化 ECSS PUS（传输层使用 TCP；后续可替换为 LoRa） */
-    PusLink_Init(ESP8266_SendTCP, 0x001, 0x01, 0x00);
-    PusLink_SetConnected(0);
-    PusLink_SetCommandHandler(ParseBackendCommand);
+    /* 步骤8: 初始化 ECSS PUS（每个地面站一条 PUS 链路，经 ESP8266 多连接 TCP，HK 可选走 UDP） */
+    GroundLink_Init(0x001, 0x01, 0x00, GROUND_HK_POLICY);
+    GroundLink_AddDatagram(GroundLink_AddStation("TCP", SERVER_IP, SERVER_PORT, GROUND_ROLE_ALL),
+                           SERVER_HK_UDP_PORT);
+    GroundLink_AddDatagram(GroundLink_AddStation("TCP", BACKUP_SERVER_IP, BACKUP_SERVER_PORT, GROUND_ROLE_ALL),
+                           BACKUP_SERVER_HK_UDP_PORT);
+    GroundLink_SetCommandHandler(ParseBackendCommand);
+    ESP8266_SetIPDSink(GroundLink_OnIPD);
+    ESP8266_SetEventSink(OnNetEvent);
+    g_net.rng = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2() ^ HAL_GetTick();
+    if (g_net.rng == 0) {
+        g_net.rng = 1;   // xorshift 不能从 0 开始
+    }
 
-    /* 等待串口稳定 */
-    HAL_Delay(1000);
-    
     /* 打印启动信息 */
     printf("\r\n========================================\r\n");
     printf("  星际嗅探者 - 传感器系统启动 (v3.0)\r\n");
@@ -112,236 +258,680 @@ int main(void)
     printf("  传感器: MQ-3 酒精传感器\r\n");
     printf("========================================\r\n\r\n");
 
-    /* 测试ESP8266连接 */
-    uint8_t tcp_enabled = 0;       // TCP连接状态标志
-    uint8_t wifi_connected = 0;    // WiFi连接状态标志
-    uint32_t last_network_check = 0;
-    const uint32_t network_check_interval = 60000; // 轮询间隔(ms) 改为1分钟
-    printf("正在测试ESP8266连接...\r\n");
-    if (ESP8266_Test())
-    {
-        /* 连接WiFi热点 */
-        printf("\r\n正在连接WiFi热点...\r\n");
-        
-        if (ESP8266_ConnectWiFi(WIFI_SSID, WIFI_PASSWORD))
-        {
-            printf("\r\n✓ WiFi连接成功！\r\n");
-            wifi_connected = 1;
-            ESP8266_GetIPAddress();
-            
-            /* 建立TCP连接到电脑服务器 */
-            printf("\r\n正在建立TCP连接...\r\n");
-            
-            if (ESP8266_StartConnection("TCP", SERVER_IP, SERVER_PORT))
-            {
-                printf("\r\n✓ TCP连接建立成功！\r\n");
-                tcp_enabled = 1;
-            }
-            else
-            {
-                printf("\r\n✗ TCP连接失败，将只本地显示数据\r\n");
-            }
-        }
-        else
-        {
-            printf("\r\n✗ WiFi连接失败，将继续运行但无网络功能\r\n");
-            wifi_connected = 0;
-        }
-    }
+    /* 联网不再阻塞启动：由 NetTask 在后台完成（热点、地面站），其间 HK/事件在 PUS 队列中缓存 */
+    /* 步骤9：调度任务（运行到完成，按截止时间先后运行到期任务，空闲时 WFI） */
+    Sched_Init(SystemCoreClock / 1000000u);
+    Sched_Add("rx", RxTask, TASK_RX_PERIOD_MS, 0);
+    Sched_Add("pus", PusTask, TASK_PUS_PERIOD_MS, 0);
+    g_task_sample = Sched_Add("sample", SampleTask, g_sampling_interval_ms, TASK_SAMPLE_DEADLINE_MS);
+    g_task_net = Sched_Add("net", NetTask, TASK_NET_STEP_MS, 0);
+    Sched_Add("log", LogTask, TASK_LOG_PERIOD_MS, 0);
     
     printf("\r\n========================================\r\n");
-    printf("系统初始化完成，进入主循环\r\n");
+    printf("系统初始化完成，进入调度循环（%u 个任务，%lu ms），后台联网\r\n", Sched_TaskCount(),
+           (unsigned long)HAL_GetTick());
     printf("========================================\r\n\r\n");
 
-    uint32_t counter = 0;
-    uint8_t last_tcp_enabled = 0;
-    SensorStatus_t last_mq3_status = SENSOR_STATUS_NOT_READY;
-    uint8_t gas_alert_active = 0;
+    Sched_Run();
+}
 
-    /* 主循环 */
-    while (1)
-    {
-        /* 检查后端下发的指令（非阻塞，PUS Telecommand） */
-        if (tcp_enabled && ESP8266_HasPendingData()) {
-            uint8_t rx[512] = {0};
-            uint16_t rx_len = ESP8266_ReceiveTCPBytes(rx, sizeof(rx));
-            if (rx_len > 0) {
-                PusLink_FeedBytes(rx, rx_len);
-            }
+/**
+ * @brief  NetTask 发出的 AT 指令尚在等待响应：期间不发送、不取接收缓冲区，以免取走它的响应
+ */
+static uint8_t NetCommandPending(void)
+{
+    return (g_net_state != NET_BOOT && g_net_state != NET_AUTOJOIN &&
+            g_net_state != NET_UP && g_net_state != NET_RETRY) ? 1 : 0;
+}
+
+/**
+ * @brief  TC 接收任务：+IPD payload 直接从接收环形缓冲区投递到 PUS 分帧器，指令随即执行
+ * @note   离线时也照常消费，CLOSED / WIFI DISCONNECT 等主动上报随即经 OnNetEvent 生效
+ */
+static void RxTask(void)
+{
+    if (!NetCommandPending() && ESP8266_HasPendingData()) {
+        ESP8266_PollIPD();
+    }
+    if (g_sched_report) {
+        ReportSchedStats();
+        ReportLinkStats();
+        if (g_sched_report == 2) {
+            Sched_ResetStats();
         }
+        g_sched_report = 0;
+    }
+}
 
-        /* 周期检查热点与服务器状态 */
-        uint32_t now = HAL_GetTick();
-        if (!wifi_connected || !tcp_enabled)
-        {
-            if (now - last_network_check > network_check_interval)
-            {
-                wifi_connected = EnsureWiFiConnected(WIFI_SSID, WIFI_PASSWORD);
-                if (wifi_connected)
-                {
-                    tcp_enabled = EnsureTCPConnected(SERVER_IP, SERVER_PORT);
-                }
-                else
-                {
-                    tcp_enabled = 0;
-                }
-                last_network_check = now;
-            }
+/**
+ * @brief  PUS 发送任务：历史分页入队，队列发送与 TM-ACK 重传（每次发送一条）
+ */
+static void PusTask(void)
+{
+    /* 历史下传：本轮入队几页，就多发送几次 */
+    uint8_t polls = 1;
+    if (g_tcp_enabled) {
+        polls += HistoryTransferStep();
+    }
+
+    /* 队列发送：失败的站点自动离线，流量改走其余站点，并立即唤醒网络监护安排重连 */
+    while (polls-- > 0 && g_tcp_enabled && !NetCommandPending()) {
+        uint8_t before = GroundLink_UpCount();
+        uint8_t up = GroundLink_Poll();
+        if (up < before) {
+            Sched_Trigger(g_task_net);
+        }
+        if (up == 0) {
+            DLOG(MAIN_PUS_FAIL);
+            NetSetOnline(0);
+        }
+    }
+    if ((g_boot.done & BOOT_LINK) && !(g_boot.done & BOOT_TX)) {
+        BootTimingStep();
+    }
+}
+
+/**
+ * @brief  网络任务：后台联网状态机（见 NetState_t）与链路监护
+ * @note   联网过程中按 TASK_NET_STEP_MS 运行以便及时推进，在线或等待重试时回到 TASK_NET_PERIOD_MS；
+ *         链路事件（OnNetEvent）与发送失败经 Sched_Trigger 立即唤醒本任务。
+ *         热点与自动连接保存在模块 flash 中：先查 CIPSTATUS，模块已在线（MCU 复位）或自行连上
+ *         （模块复位、热点恢复）时直接沿用，只有查询失败或等不到时才走 CWMODE → CWJAP 完整流程。
+ */
+static void NetTask(void)
+{
+    static uint32_t state_since = 0;
+    uint32_t now = HAL_GetTick();
+    NetState_t next = g_net_state;
+    uint8_t status = 0;
+    int8_t r;
+
+    switch (g_net_state) {
+    case NET_BOOT:
+        if (now >= ESP_BOOT_MS) {
+            ESP8266_CommandStart("AT\r\n");
+            next = NET_PROBE;
+        }
+        break;
+
+    case NET_PROBE:
+        if (ESP8266_CommandPoll("OK", NULL) > 0) {
+            ESP8266_StatusStart();
+            next = NET_STATUS;
+        } else if (now - state_since > NET_PROBE_TIMEOUT_MS) {
+            printf("[网络] ESP8266 无响应（检查供电、TX/RX 交叉、共地、CH_PD），%lu ms 后重试\r\n",
+                   (unsigned long)NetRetryArm(now));
+            next = NET_RETRY;
         }
-        else
-        {
-            /* 已连通时刷新时间戳，避免累积突发检查 */
-            last_network_check = now;
+        break;
+
+    case NET_STATUS:
+        r = ESP8266_StatusPoll(&status);
+        if (r > 0 && status >= 2 && status <= 4) {
+            if (!g_wifi_connected) {
+                printf("[网络] ✓ 模块已在热点上（STATUS:%u，%lu ms），沿用现有连接\r\n", status, (unsigned long)now);
+            }
+            g_wifi_connected = 1;
+            next = NetLinkStart(0);
+        } else if (r > 0 && status == 5) {
+            printf("[网络] 热点未连接，等待模块自动连接已保存的热点 ...\r\n");
+            g_wifi_connected = 0;
+            NetSetOnline(0);
+            g_net.events &= (uint8_t)~NET_EVT_WIFI_UP;
+            next = NET_AUTOJOIN;
+        } else if (r != 0 || now - state_since > NET_STATUS_TIMEOUT_MS) {
+            ESP8266_StationModeStart();
+            next = NET_MODE;
         }
+        break;
 
-        /* TCP连通状态变化：用于触发队列重发 */
-        if (tcp_enabled != last_tcp_enabled) {
-            PusLink_SetConnected(tcp_enabled);
-            last_tcp_enabled = tcp_enabled;
+    case NET_AUTOJOIN:
+        /* WIFI GOT IP 由接收任务（或下面的 PollIPD）识别，经 OnNetEvent 置位 */
+        ESP8266_PollIPD();
+        if (g_net.events & NET_EVT_WIFI_UP) {
+            printf("[网络] ✓ 模块已自动连接热点（%lu ms）\r\n", (unsigned long)now);
+            g_wifi_connected = 1;
+            next = NetLinkStart(0);
+        } else if (now - state_since > NET_AUTOJOIN_TIMEOUT_MS) {
+            ESP8266_StationModeStart();
+            next = NET_MODE;
         }
+        break;
 
-        /* LED闪烁 */
-        HAL_GPIO_TogglePin(GPIOF, GPIO_PIN_9);
-        HAL_GPIO_TogglePin(GPIOF, GPIO_PIN_10);
+    case NET_MODE:
+        /* 模式设置失败也继续尝试连接热点（与原先的阻塞流程一致） */
+        if (ESP8266_StationModePoll() != 0 || now - state_since > NET_MODE_TIMEOUT_MS) {
+            printf("[网络] 正在连接热点 %s ...\r\n", WIFI_SSID);
+            ESP8266_JoinStart(WIFI_SSID, WIFI_PASSWORD);
+            next = NET_JOIN;
+        }
+        break;
 
-        /* 更新所有传感器数据 */
-        SensorManager_Update();
+    case NET_JOIN:
+        r = ESP8266_CommandPoll("WIFI GOT IP", "FAIL");
+        if (r > 0) {
+            printf("[网络] ✓ 热点已连接（%lu ms）\r\n", (unsigned long)now);
+            g_wifi_connected = 1;
+            next = NetLinkStart(1);
+        } else if (r < 0 || now - state_since > NET_JOIN_TIMEOUT_MS) {
+            printf("[网络] ✗ 热点连接失败（检查名称/密码、2.4 GHz、距离），%lu ms 后重试\r\n",
+                   (unsigned long)NetRetryArm(now));
+            next = NET_RETRY;
+        }
+        break;
 
-        /* 获取MQ-3传感器数据 */
-        SensorData_t* mq3_data = SensorManager_GetData(SENSOR_TYPE_MQ3_ALCOHOL);
+    case NET_AUTOCONN:
+        if (ESP8266_AutoConnectPoll() != 0 || now - state_since > NET_AUTOCONN_TIMEOUT_MS) {
+            next = NetAddrStart();
+        }
+        break;
 
-        /* 打印数据 */
-        printf("[%lu] ===== 传感器数据 =====\r\n", counter++);
+    case NET_ADDR:
+        /* 响应里的 IP 由 ESP8266_CommandPoll 记入日志 */
+        if (ESP8266_CommandPoll("OK", "ERROR") != 0 || now - state_since > NET_ADDR_TIMEOUT_MS) {
+            GroundLink_ResumeStart();
+            next = NET_LINK;
+        }
+        break;
 
-        if (mq3_data != NULL) {
-            printf("  MQ-3 状态: ");
-            switch(mq3_data->status) {
-                case SENSOR_STATUS_OK:
-                    printf("就绪\r\n");
-                    break;
-                case SENSOR_STATUS_PREHEATING:
-                    printf("预热中...\r\n");
-                    break;
-                default:
-                    printf("错误\r\n");
-                    break;
-            }
-            printf("  MQ-3 ADC: %u\r\n", mq3_data->adc_raw);
-            printf("  MQ-3 电压: %.3f V\r\n", mq3_data->voltage);
-            printf("  酒精浓度: %.2f ppm\r\n", mq3_data->concentration);
-        }
-        printf("============================\r\n\r\n");
-
-        /* 发送数据到地面：使用 ECSS PUS 协议（支持断链缓存+优先级） */
-        if (mq3_data != NULL)
-        {
-            /* ========== 事件下传：状态变化/阈值触发（示例） ========== */
-            if (mq3_data->status != last_mq3_status) {
-                char evt_payload[128] = {0};
-                snprintf(evt_payload, sizeof(evt_payload),
-                         "{\"kind\":\"status\",\"sensor\":\"mq3\",\"status\":%d}",
-                         (int)mq3_data->status);
-                PusLink_QueueEvent(PUS5_EVENT_LOW, evt_payload, 1);
-                last_mq3_status = mq3_data->status;
-            }
+    case NET_LINK:
+        /* 每步最多一条 AT 指令（CIPMUX? / CIPMUX=1 / CIPSTATUS / 一个连接号的 CIPSTART），
+         * 连接未被拒绝而迟迟不回时要等到超时，期间采样与接收照常运行 */
+        if (GroundLink_ResumePoll() == 0) {
+            break;
+        }
+        NetSetOnline(GroundLink_UpCount() > 0);
+        if (GroundLink_AllUp()) {
+            g_net.backoff_ms = NET_BACKOFF_MIN_MS;
+            g_net.retry_armed = 0;
+            printf("[网络] 地面站 %u/%u 在线\r\n", GroundLink_UpCount(), GroundLink_StationCount());
+        } else {
+            printf("[网络] 地面站 %u/%u 在线，%lu ms 后重连其余站点\r\n", GroundLink_UpCount(),
+                   GroundLink_StationCount(), (unsigned long)NetRetryArm(now));
+        }
+        if (g_tcp_enabled && !(g_boot.done & BOOT_LINK)) {
+            g_boot.done |= BOOT_LINK;
+            g_boot.link_ms = HAL_GetTick();
+            g_boot.backlog = GroundLink_EventQueueDepth();
+        }
+        next = NET_UP;
+        break;
 
-            if (mq3_data->status == SENSOR_STATUS_OK) {
-                if (!gas_alert_active && mq3_data->concentration >= ALCOHOL_ALERT_PPM) {
-                    gas_alert_active = 1;
-                    g_sampling_interval_ms = HIGH_SAMPLE_RATE_MS;
-                    char evt_payload[160] = {0};
-                    snprintf(evt_payload, sizeof(evt_payload),
-                             "{\"kind\":\"gas_alert\",\"metric\":\"alcohol_ppm\",\"value\":%.2f,"
-                             "\"action\":\"high_sample\",\"rate_ms\":%lu}",
-                             mq3_data->concentration,
-                             (unsigned long)g_sampling_interval_ms);
-                    PusLink_QueueEvent(PUS5_EVENT_HIGH, evt_payload, 1);
-                } else if (gas_alert_active && mq3_data->concentration <= ALCOHOL_CLEAR_PPM) {
-                    gas_alert_active = 0;
-                    g_sampling_interval_ms = NORMAL_SAMPLE_RATE_MS;
-                    char evt_payload[160] = {0};
-                    snprintf(evt_payload, sizeof(evt_payload),
-                             "{\"kind\":\"gas_clear\",\"metric\":\"alcohol_ppm\",\"value\":%.2f,"
-                             "\"action\":\"normal\",\"rate_ms\":%lu}",
-                             mq3_data->concentration,
-                             (unsigned long)g_sampling_interval_ms);
-                    PusLink_QueueEvent(PUS5_EVENT_MEDIUM, evt_payload, 1);
-                }
-            } else {
-                gas_alert_active = 0;
-            }
+    case NET_UP:
+        if (g_net.events & NET_EVT_WIFI_DOWN) {
+            /* 模块会自行重连热点：先等 WIFI GOT IP，等不到再走完整流程 */
+            g_net.events &= (uint8_t)~(NET_EVT_WIFI_DOWN | NET_EVT_LINK_LOST);
+            g_net.wifi_drops++;
+            g_wifi_connected = 0;
+            NetSetOnline(0);
+            printf("[网络] 热点断开，等待模块自动重连 ...\r\n");
+            next = NET_AUTOJOIN;
+            break;
+        }
+        g_net.events &= (uint8_t)~NET_EVT_LINK_LOST;
+        if (g_tcp_enabled && GroundLink_UpCount() == 0) {
+            NetSetOnline(0);
+        }
+        if (GroundLink_AllUp()) {
+            g_net.retry_armed = 0;
+        } else if (!g_net.retry_armed) {
+            printf("[网络] 地面站 %u/%u 在线，%lu ms 后重连\r\n", GroundLink_UpCount(),
+                   GroundLink_StationCount(), (unsigned long)NetRetryArm(now));
+        } else if ((int32_t)(now - g_net.retry_at) >= 0) {
+            /* 同样先查状态：热点在线时 NET_LINK 只补建离线的地面站 */
+            g_net.retry_armed = 0;
+            ESP8266_StatusStart();
+            next = NET_STATUS;
+        }
+        break;
 
-            char payload[192] = {0};
-            snprintf(payload,
-                     sizeof(payload),
-                     "{\"counter\":%lu,"
-                     "\"adc\":%u,"
-                     "\"voltage\":%.3f,"
-                     "\"mq3_adc\":%u,"
-                     "\"mq3_voltage\":%.3f,"
-                     "\"alcohol_ppm\":%.2f,"
-                     "\"sensor_status\":%d}",
-                     counter - 1,
-                     mq3_data->adc_raw,
-                     mq3_data->voltage,
-                     mq3_data->adc_raw,        // mq3_adc
-                     mq3_data->voltage,        // mq3_voltage
-                     mq3_data->concentration,  // alcohol_ppm
-                     mq3_data->status);        // sensor_status
-
-            /* 遥测：Housekeeping（不要求 ACK）；断链期间会在队列内缓存，连通后补发 */
-            PusLink_QueueHousekeeping(payload);
-
-            /* 队列发送：若发送失败，触发上层重连 */
-            if (!PusLink_Poll()) {
-                printf("   [警告] PUS发送失败，触发重连\r\n");
-                tcp_enabled = 0;
-                PusLink_SetConnected(0);
-            }
+    case NET_RETRY:
+    default:
+        /* 模块自行连上热点时不必等满退避 */
+        if ((g_net.events & NET_EVT_WIFI_UP) || (int32_t)(now - g_net.retry_at) >= 0) {
+            g_net.retry_armed = 0;
+            ESP8266_CommandStart("AT\r\n");
+            next = NET_PROBE;
         }
+        break;
+    }
+
+    if (next != g_net_state) {
+        g_net_state = next;
+        state_since = now;
+        Sched_SetPeriod(g_task_net, (next == NET_UP || next == NET_RETRY) ? TASK_NET_PERIOD_MS : TASK_NET_STEP_MS);
+    }
+    if (g_net.retry_armed && (next == NET_UP || next == NET_RETRY)) {
+        /* 退避不足一个监护周期时按剩余时间唤醒 */
+        int32_t left = (int32_t)(g_net.retry_at - now);
+        Sched_SetPeriod(g_task_net, (left > 0 && left < TASK_NET_PERIOD_MS) ? (uint32_t)left : TASK_NET_PERIOD_MS);
+    }
+}
+
+/**
+ * @brief  安排下次重连：等待时间在 [上限/2, 上限] 内随机，上限随之翻倍（至 NET_BACKOFF_MAX_MS）
+ * @return 等待时间（ms）
+ */
+static uint32_t NetRetryArm(uint32_t now)
+{
+    uint32_t cap = g_net.backoff_ms;
+
+    g_net.rng ^= g_net.rng << 13;
+    g_net.rng ^= g_net.rng >> 17;
+    g_net.rng ^= g_net.rng << 5;
+    uint32_t delay = cap / 2u + g_net.rng % (cap / 2u + 1u);
+
+    g_net.backoff_ms = (cap < NET_BACKOFF_MAX_MS / 2u) ? cap * 2u : NET_BACKOFF_MAX_MS;
+    g_net.retry_at = now + delay;
+    g_net.retry_armed = 1;
+    return delay;
+}
+
+/**
+ * @brief  热点已在线，开始建立地面站连接：此前的事件由本次连接处理，期间新到的事件留给 NET_UP
+ * @param  joined 本轮经完整流程（CWJAP_DEF）连上热点：先写自动连接，沿用时不重复写 flash
+ * @return 下一状态
+ */
+static NetState_t NetLinkStart(uint8_t joined)
+{
+    g_net.events = 0;
+    if (joined) {
+        ESP8266_AutoConnectStart(1);
+        return NET_AUTOCONN;
+    }
+    return NetAddrStart();
+}
+
+/**
+ * @brief  离线时先查询本机 IP（便于现场排查），否则直接开始恢复地面站连接
+ * @return 下一状态
+ */
+static NetState_t NetAddrStart(void)
+{
+    if (!g_tcp_enabled) {
+        ESP8266_CommandStart("AT+CIFSR\r\n");
+        return NET_ADDR;
+    }
+    GroundLink_ResumeStart();
+    return NET_LINK;
+}
 
-        /* 使用动态采样间隔 */
-        HAL_Delay(g_sampling_interval_ms);
+/**
+ * @brief  更新“至少一个地面站在线”，记录全部离线的中断时长（开机首次上线前不计）
+ */
+static void NetSetOnline(uint8_t online)
+{
+    online = online ? 1 : 0;
+    if (g_tcp_enabled && !online) {
+        g_net.offline_since = HAL_GetTick();
+    } else if (!g_tcp_enabled && online && (g_boot.done & BOOT_LINK)) {
+        uint32_t ms = HAL_GetTick() - g_net.offline_since;
+        g_net.outages++;
+        g_net.outage_ms_last = ms;
+        g_net.outage_ms_total += ms;
+        if (ms > g_net.outage_ms_max) {
+            g_net.outage_ms_max = ms;
+        }
+        printf("[网络] 地面链路恢复，中断 %lu ms\r\n", (unsigned long)ms);
     }
+    g_tcp_enabled = online;
 }
 
 /**
- * @brief  确保连接到热点，不在线则自动重连
+ * @brief  ESP8266 主动上报：地面站链路立即离线（PUS 停止发送、消息留在队列），唤醒 NetTask
+ * @note   可能在任意消费接收缓冲区的调用中执行（包括阻塞等待期间），只更新状态
  */
-static uint8_t EnsureWiFiConnected(const char* ssid, const char* password)
+static void OnNetEvent(esp8266_event_t evt, uint8_t link_id)
 {
-    if (ESP8266_IsAPConnected()) {
-        printf("[网络监听] 热点已连接\r\n");
-        return 1;
+    GroundLink_OnEvent(evt, link_id);
+    if (evt == ESP8266_EVT_WIFI_DOWN) {
+        g_net.events = (uint8_t)((g_net.events | NET_EVT_WIFI_DOWN) & ~NET_EVT_WIFI_UP);
+    } else if (evt == ESP8266_EVT_WIFI_UP) {
+        g_net.events |= NET_EVT_WIFI_UP;
+    } else {
+        g_net.events |= NET_EVT_LINK_LOST;
     }
+    Sched_Trigger(g_task_net);
+}
+
+/**
+ * @brief  首个 PUS 包发出后打印启动耗时，并以 boot 事件回报
+ */
+static void BootTimingStep(void)
+{
+    uint32_t sent = 0;
 
-    printf("\r\n[网络监听] 热点未连接，开始重连...\r\n");
-    if (ESP8266_ConnectWiFi(ssid, password)) {
-        printf("   ✓ 热点重连成功\r\n");
-        ESP8266_GetIPAddress();
-        return 1;
+    for (uint8_t i = 0; i < GroundLink_StationCount(); i++) {
+        const GroundLinkStats_t* st = GroundLink_GetStats(i);
+        sent += st->tx_packets + st->udp_packets;
     }
-    printf("   ✗ 热点重连失败，本轮不再重试\r\n");
-    return 0;
+    if (sent == 0) {
+        return;
+    }
+    g_boot.done |= BOOT_TX;
+    g_boot.first_tx_ms = HAL_GetTick();
+    printf("[启动] 首次采样 %lu ms，地面站上线 %lu ms，首包下传 %lu ms（上线时积压 %u 条）\r\n",
+           (unsigned long)g_boot.first_sample_ms, (unsigned long)g_boot.link_ms,
+           (unsigned long)g_boot.first_tx_ms, g_boot.backlog);
+
+    char evt_payload[96];
+    TmWriter_t w;
+    TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "boot");
+    TmWriter_Uint(&w, "sample_ms", g_boot.first_sample_ms);
+    TmWriter_Uint(&w, "link_ms", g_boot.link_ms);
+    TmWriter_Uint(&w, "tx_ms", g_boot.first_tx_ms);
+    TmWriter_Uint(&w, "backlog", g_boot.backlog);
+    TmWriter_EndObject(&w);
+    QueueEventTm(&w, PUS5_EVENT_INFO);
+}
+
+/**
+ * @brief  日志任务：补发滞留的延迟日志与丢弃统计
+ */
+static void LogTask(void)
+{
+    DLog_Poll();
 }
 
 /**
- * @brief  确保TCP与服务器保持连接
+ * @brief  采样任务：按 g_sampling_interval_ms 释放，模拟看门狗越限时立即触发一次
  */
-static uint8_t EnsureTCPConnected(const char* ip, uint16_t port)
+static void SampleTask(void)
 {
-    if (ESP8266_IsTCPConnected()) {
-        printf("[网络监听] TCP已连接\r\n");
-        return 1;
+    static uint32_t counter = 0;
+    static SensorStatus_t last_status[SENSOR_TYPE_MAX];
+    static uint8_t last_status_valid = 0;
+    static uint8_t gas_alert_active = 0;
+    static uint8_t awd_pending = 0;          // 模拟看门狗已越界，等待滤波浓度确认
+    static uint32_t awd_pending_since = 0;
+    static const char* last_class = "none";  // 上次通过事件下传的板上分类类别
+    static uint8_t anomaly_active = 0;
+    static uint8_t hk_sent = 0;              // 是否已下传过 HK（第一轮总是下传）
+    static uint32_t hk_last_tx = 0;          // 上次下传 HK 的时刻
+    static uint32_t hk_suppressed = 0;       // 上次下传以来被省略的轮数
+    static float hk_z_peak = 0.0f;           // 上次下传以来的最大异常分数
+    uint32_t now = HAL_GetTick();
+
+    if (!last_status_valid) {
+        for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+            last_status[id] = SENSOR_STATUS_NOT_READY;
+        }
+        last_status_valid = 1;
+    }
+
+    /* LED闪烁 */
+    HAL_GPIO_TogglePin(GPIOF, GPIO_PIN_9);
+    HAL_GPIO_TogglePin(GPIOF, GPIO_PIN_10);
+
+    /* 更新所有传感器数据 */
+    SensorManager_Update();
+
+    /* 校准结果事件（预热后自动校准，或 TC 129/3 触发） */
+    SensorCalResult_t cal_result;
+    while (SensorManager_TakeCalibrationResult(&cal_result)) {
+        char evt_payload[192];
+        TmWriter_t w;
+        TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+        TmWriter_BeginObject(&w, NULL);
+        TmWriter_Str(&w, "kind", "calibration");
+        TmWriter_Str(&w, "sensor", SensorManager_GetDesc(cal_result.sensor)->hk_key);
+        TmWriter_Str(&w, "result", cal_result.ok ? "ok" : "failed");
+        TmWriter_Str(&w, "trigger", cal_result.from_preheat ? "preheat" : "tc");
+        TmWriter_Fixed(&w, "r0", cal_result.r0, 2);
+        TmWriter_Uint(&w, "samples", cal_result.samples);
+        TmWriter_Uint(&w, "rejected", cal_result.rejected);
+        TmWriter_Fixed(&w, "rsd", cal_result.rsd, 4);
+        TmWriter_EndObject(&w);
+        QueueEventTm(&w, cal_result.ok ? PUS5_EVENT_INFO : PUS5_EVENT_MEDIUM);
     }
 
-    printf("\r\n[网络监听] TCP未连接，开始重连...\r\n");
-    if (ESP8266_StartConnection("TCP", ip, port)) {
-        printf("   ✓ TCP重连成功\r\n");
-        return 1;
+    /* 暴露事件特征（响应升起又回落后提取一次）：地面可直接据此分类，无需原始波形 */
+    SensorExposure_t exposure;
+    while (SensorManager_TakeExposure(&exposure)) {
+        char evt_payload[PUS_MAX_TM_JSON_LEN + 1];
+        TmWriter_t w;
+        TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+        TmWriter_BeginObject(&w, NULL);
+        TmWriter_Str(&w, "kind", "exposure");
+        TmWriter_Str(&w, "sensor", SensorManager_GetDesc(exposure.sensor)->hk_key);
+        TmWriter_Str(&w, "end", exposure.recovered ? "recovered" : "timeout");
+        TmWriter_Fixed(&w, "ago", (float)(HAL_GetTick() - exposure.t_start) / 1000.0f, 1);
+        TmWriter_Fixed(&w, "base", exposure.base_ppm, 2);
+        TmWriter_Fixed(&w, "peak", exposure.peak_ppm, 2);
+        TmWriter_Fixed(&w, "dv", exposure.dv, 3);
+        TmWriter_Fixed(&w, "slope", exposure.slope, 4);
+        TmWriter_Fixed(&w, "t_rise", exposure.t_rise_s, 1);
+        TmWriter_Fixed(&w, "tau_rise", exposure.tau_rise_s, 1);
+        TmWriter_Fixed(&w, "tau_rec", exposure.tau_rec_s, 1);
+        TmWriter_Fixed(&w, "area", exposure.area, 2);
+        TmWriter_Fixed(&w, "dur", exposure.duration_s, 1);
+        TmWriter_EndObject(&w);
+        QueueEventTm(&w, PUS5_EVENT_INFO);
+    }
+
+    /* 获取MQ-3传感器数据 */
+    SensorData_t* mq3_data = SensorManager_GetData(SENSOR_TYPE_MQ3_ALCOHOL);
+
+    /* 打印数据（二进制日志记录，主机端解码） */
+    counter++;
+    if (mq3_data != NULL) {
+        DLOG(MAIN_SAMPLE, counter - 1, mq3_data->status, mq3_data->adc_raw,
+             mq3_data->voltage, mq3_data->concentration);
+    }
+
+    /* 发送数据到地面：使用 ECSS PUS 协议（支持断链缓存+优先级） */
+    if (mq3_data != NULL)
+    {
+        /* ========== 事件下传：状态变化/阈值触发（示例） ========== */
+        for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+            SensorStatus_t status = SensorManager_GetData((SensorType_t)id)->status;
+            if (status != last_status[id]) {
+                char evt_payload[128];
+                TmWriter_t w;
+                TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+                TmWriter_BeginObject(&w, NULL);
+                TmWriter_Str(&w, "kind", "status");
+                TmWriter_Str(&w, "sensor", SensorManager_GetDesc((SensorType_t)id)->hk_key);
+                TmWriter_Int(&w, "status", (int32_t)status);
+                TmWriter_EndObject(&w);
+                QueueEventTm(&w, PUS5_EVENT_LOW);
+                last_status[id] = status;
+            }
+        }
+
+        /* 板上分类（占位模型或传感器未就绪时无效）：附在告警事件上，类别变化时单独下传 */
+        const SensorClassification_t* cls = SensorManager_GetClassification();
+        if (cls->valid && cls->class_name != last_class && cls->confidence >= GAS_CLASS_EVENT_CONF) {
+            char evt_payload[160];
+            TmWriter_t w;
+            TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+            TmWriter_BeginObject(&w, NULL);
+            TmWriter_Str(&w, "kind", "gas_class");
+            TmWriter_Str(&w, "class", cls->class_name);
+            TmWriter_Fixed(&w, "conf", cls->confidence, 2);
+            TmWriter_Str(&w, "prev", last_class);
+            TmWriter_Uint(&w, "cycles", cls->cycles);
+            TmWriter_EndObject(&w);
+            QueueEventTm(&w, PUS5_EVENT_LOW);
+            last_class = cls->class_name;
+        }
+
+        /* 模拟看门狗只比较单次转换：越界仅用于提前唤醒并切到高采样率（看门狗随之撤防），
+         * 告警以过采样滤波后的浓度确认；确认窗口内未达阈值视为噪声，恢复正常采样率 */
+        if (g_gas_awd_tripped) {
+            g_gas_awd_tripped = 0;
+            if (!gas_alert_active && !awd_pending) {
+                awd_pending = 1;
+                awd_pending_since = now;
+            }
+        }
+
+        if (mq3_data->status == SENSOR_STATUS_OK) {
+            if (!gas_alert_active && mq3_data->concentration >= ALCOHOL_ALERT_PPM) {
+                gas_alert_active = 1;
+                g_sampling_interval_ms = HIGH_SAMPLE_RATE_MS;
+                char evt_payload[192];
+                TmWriter_t w;
+                TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+                TmWriter_BeginObject(&w, NULL);
+                TmWriter_Str(&w, "kind", "gas_alert");
+                TmWriter_Str(&w, "metric", "alcohol_ppm");
+                TmWriter_Fixed(&w, "value", mq3_data->concentration, 2);
+                TmWriter_Str(&w, "action", "high_sample");
+                TmWriter_Uint(&w, "rate_ms", g_sampling_interval_ms);
+                TmWriter_Str(&w, "trigger", awd_pending ? "awd" : "poll");
+                if (cls->valid) {
+                    TmWriter_Str(&w, "cls", cls->class_name);
+                    TmWriter_Fixed(&w, "cls_conf", cls->confidence, 2);
+                }
+                TmWriter_EndObject(&w);
+                QueueEventTm(&w, PUS5_EVENT_HIGH);
+                awd_pending = 0;
+            } else if (gas_alert_active && mq3_data->concentration <= ALCOHOL_CLEAR_PPM) {
+                gas_alert_active = 0;
+                g_sampling_interval_ms = NORMAL_SAMPLE_RATE_MS;
+                char evt_payload[160];
+                TmWriter_t w;
+                TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+                TmWriter_BeginObject(&w, NULL);
+                TmWriter_Str(&w, "kind", "gas_clear");
+                TmWriter_Str(&w, "metric", "alcohol_ppm");
+                TmWriter_Fixed(&w, "value", mq3_data->concentration, 2);
+                TmWriter_Str(&w, "action", "normal");
+                TmWriter_Uint(&w, "rate_ms", g_sampling_interval_ms);
+                TmWriter_EndObject(&w);
+                QueueEventTm(&w, PUS5_EVENT_MEDIUM);
+            } else if (awd_pending && now - awd_pending_since >= GAS_AWD_CONFIRM_MS) {
+                awd_pending = 0;
+                g_sampling_interval_ms = NORMAL_SAMPLE_RATE_MS;
+                DLOG(MAIN_AWD_NOISE, mq3_data->concentration);
+            }
+        } else {
+            if (awd_pending) {
+                g_sampling_interval_ms = NORMAL_SAMPLE_RATE_MS;   // 布防后传感器恰好失效，撤销高采样率
+                awd_pending = 0;
+            }
+            gas_alert_active = 0;
+        }
+        UpdateGasWatchdog(mq3_data->status == SENSOR_STATUS_OK && !gas_alert_active && !awd_pending);
+
+        /* 异常检测（采样中断中逐样本打分）：进入异常时下传事件 */
+        SensorAnomaly_t anomaly;
+        SensorManager_TakeAnomaly(&anomaly, HK_ANOMALY_HOLD_MS);
+        if (anomaly.z_peak > hk_z_peak) {
+            hk_z_peak = anomaly.z_peak;
+        }
+        if (anomaly.active && !anomaly_active) {
+            char evt_payload[128];
+            TmWriter_t w;
+            TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+            TmWriter_BeginObject(&w, NULL);
+            TmWriter_Str(&w, "kind", "anomaly");
+            TmWriter_Str(&w, "sensor", SensorManager_GetDesc(anomaly.sensor)->hk_key);
+            TmWriter_Fixed(&w, "z", anomaly.z_peak, 1);
+            TmWriter_Uint(&w, "hits", anomaly.hits);
+            TmWriter_EndObject(&w);
+            QueueEventTm(&w, PUS5_EVENT_LOW);
+        }
+        anomaly_active = anomaly.active;
+
+        /* HK 下传粒度：决定原因写入 tx 字段，地面可据此审计省略了哪些轮次 */
+        const char* hk_tx = NULL;
+        char db_field[24] = "";
+        if (!g_hk_gated) {
+            hk_tx = "full";
+        } else if (gas_alert_active) {
+            hk_tx = "alert";
+        } else if (anomaly.active) {
+            hk_tx = "anomaly";
+        } else if (SensorManager_DeadbandExceeded(db_field, sizeof(db_field))) {
+            hk_tx = "deadband";
+        } else if (!hk_sent || now - hk_last_tx >= g_hk_heartbeat_ms) {
+            hk_tx = "heartbeat";
+        }
+
+        if (hk_tx == NULL) {
+            hk_suppressed++;
+            g_hk_suppressed_total++;
+        } else {
+            /* HK 字段由传感器注册表逐行生成（sensor_table.h） */
+            char payload[PUS_MAX_TM_JSON_LEN + 1];
+            TmWriter_t w;
+            TmWriter_Init(&w, payload, sizeof(payload), TM_ENC_JSON);
+            SensorManager_WriteHousekeeping(&w, counter - 1);
+            TmWriter_Str(&w, "tx", hk_tx);
+            TmWriter_Fixed(&w, "z", hk_z_peak, 1);
+            TmWriter_Uint(&w, "supp", hk_suppressed);
+            if (db_field[0] != '\0') {
+                TmWriter_Str(&w, "db", db_field);
+            }
+
+            /* 心跳另附期间每个传感器的浓度摘要 [min, max, mean] 与累计计数；放不下时只发必需字段 */
+            TmWriterMark_t essential = TmWriter_Mark(&w);
+            if (strcmp(hk_tx, "heartbeat") == 0) {
+                for (uint8_t id = 0; hk_sent && hk_suppressed > 0 && id < SENSOR_TYPE_MAX; id++) {
+                    float lo, hi, mean;
+                    if (SensorManager_Summarize((SensorType_t)id, hk_last_tx, &lo, &hi, &mean)) {
+                        TmWriter_Key(&w, SensorManager_GetDesc((SensorType_t)id)->ppm_key, "_rng");
+                        TmWriter_BeginArray(&w, NULL);
+                        TmWriter_Fixed(&w, NULL, lo, 1);
+                        TmWriter_Fixed(&w, NULL, hi, 1);
+                        TmWriter_Fixed(&w, NULL, mean, 1);
+                        TmWriter_EndArray(&w);
+                    }
+                }
+                TmWriter_Uint(&w, "n_tx", g_hk_sent_total);
+                TmWriter_Uint(&w, "n_supp", g_hk_suppressed_total);
+            }
+            SensorManager_WriteHousekeepingEnd(&w);
+            if (!TmWriter_Ok(&w)) {
+                TmWriter_Rollback(&w, essential);
+                SensorManager_WriteHousekeepingEnd(&w);
+            }
+            size_t len = TmWriter_Finish(&w);
+            if (len == 0) {
+                printf("[HK] 传感器字段超出缓冲区，本次不下传\r\n");
+            } else {
+                /* 遥测：Housekeeping（不要求 ACK）；断链期间会在队列内缓存，连通后补发 */
+                GroundLink_QueueHousekeeping(payload);
+                g_hk_sent_total++;
+                if (!(g_boot.done & BOOT_SAMPLE)) {
+                    g_boot.done |= BOOT_SAMPLE;
+                    g_boot.first_sample_ms = HAL_GetTick();
+                }
+            }
+            SensorManager_DeadbandCommit();
+            hk_sent = 1;
+            hk_last_tx = now;
+            hk_suppressed = 0;
+            hk_z_peak = 0.0f;
+        }
+
+        /* TC 129/5 的回执：当前下传粒度与累计计数 */
+        if (g_telemetry_report) {
+            char evt_payload[160];
+            TmWriter_t w;
+            TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+            TmWriter_BeginObject(&w, NULL);
+            TmWriter_Str(&w, "kind", "telemetry");
+            TmWriter_Str(&w, "mode", g_hk_gated ? "gated" : "full");
+            TmWriter_Uint(&w, "heartbeat_s", g_hk_heartbeat_ms / 1000u);
+            TmWriter_Uint(&w, "n_tx", g_hk_sent_total);
+            TmWriter_Uint(&w, "n_supp", g_hk_suppressed_total);
+            if (g_telemetry_db[0] != '\0') {
+                TmWriter_Str(&w, "db", g_telemetry_db);
+                TmWriter_Uint(&w, "db_ok", g_telemetry_db_ok);
+            }
+            TmWriter_EndObject(&w);
+            QueueEventTm(&w, PUS5_EVENT_INFO);
+            g_telemetry_report = 0;
+        }
     }
-    printf("   ✗ TCP重连失败，本轮不再重试\r\n");
-    return 0;
+
+    /* 告警/TC 可能改了采样间隔：下次释放 = 本次释放 + 新间隔 */
+    Sched_SetPeriod(g_task_sample, g_sampling_interval_ms);
 }
 
 /**
@@ -410,6 +1000,22 @@ static void MX_GPIO_Init(void)
     HAL_GPIO_WritePin(GPIOF, GPIO_PIN_9 | GPIO_PIN_10, GPIO_PIN_SET);
 }
 
+/**
+ * @brief  DMA初始化：DMA2 Stream7 用于 USART1 TX（延迟日志），Stream0 用于 ADC1 扫描
+ */
+static void MX_DMA_Init(void)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    /* 日志优先级低于 ESP8266 接收中断，避免挤占 USART2 */
+    HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+
+    /* ADC 帧完成中断只记录帧序号，采样时刻由 TIM2 决定，优先级可以最低 */
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+}
+
 /**
  * @brief  USART1初始化 (PA9-TX, PA10-RX) - 调试串口
  */
@@ -455,7 +1061,7 @@ static void MX_USART2_UART_Init(void)
 }
 
 /**
- * @brief  ADC1初始化
+ * @brief  ADC1初始化：扫描模式，每个 TIM2 TRGO 上升沿转换一遍全部通道
  */
 static void MX_ADC1_Init(void)
 {
@@ -464,15 +1070,15 @@ static void MX_ADC1_Init(void)
     hadc1.Instance = ADC1;
     hadc1.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
     hadc1.Init.Resolution = ADC_RESOLUTION_12B;
-    hadc1.Init.ScanConvMode = DISABLE;
-    hadc1.Init.ContinuousConvMode = ENABLE;
+    hadc1.Init.ScanConvMode = ENABLE;
+    hadc1.Init.ContinuousConvMode = DISABLE;
     hadc1.Init.DiscontinuousConvMode = DISABLE;
-    hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-    hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    hadc1.Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T2_TRGO;
     hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
-    hadc1.Init.NbrOfConversion = 1;
-    hadc1.Init.DMAContinuousRequests = DISABLE;
-    hadc1.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+    hadc1.Init.NbrOfConversion = ADC_SCAN_NUM_CHANNELS;
+    hadc1.Init.DMAContinuousRequests = ENABLE;
+    hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
     
     if (HAL_ADC_Init(&hadc1) != HAL_OK)
     {
@@ -481,104 +1087,29 @@ static void MX_ADC1_Init(void)
 }
 
 /**
- * @brief  测试ESP8266连接 (重构后)
- * @return 1: 成功; 0: 失败
- */
-uint8_t ESP8266_Test(void)
-{
-    printf("\r\n=== ESP8266 连接诊断 ===\r\n");
-    
-    if (ESP8266_SendAndWaitOK("AT\r\n", 2000))
-    {
-        printf("✓ ESP8266响应正常！\r\n");
-        printf("=========================\r\n\r\n");
-        
-        // 获取版本信息
-        printf("正在获取ESP8266版本信息...\r\n");
-        ESP8266_ClearBuffer();
-        ESP8266_SendCommand("AT+GMR\r\n");
-        if(ESP8266_WaitForString("OK", 2000)) {
-            // 响应已在 WaitForString 内部打印
-        }
-        return 1;
-    }
-    else
-    {
-        printf("\r\n✗ ESP8266无响应！\r\n");
-        printf("\r\n请检查以下问题：\r\n");
-        printf("  1. ESP8266是否正确供电（3.3V，需要200-300mA电流）\r\n");
-        printf("  2. TX/RX连接是否交叉（STM32 TX→ESP8266 RX, STM32 RX→ESP8266 TX）\r\n");
-        printf("  3. 是否共地（GND连接）\r\n");
-        printf("  4. ESP8266的CH_PD（使能）引脚是否接3.3V\r\n");
-        printf("  5. 尝试按下ESP8266的复位按钮后重新测试\r\n");
-        printf("=========================\r\n\r\n");
-        return 0;
-    }
-}
-
-/**
- * @brief  查询ESP8266的IP地址 (重构后)
+ * @brief  TIM2初始化：计数频率 ADC_SCAN_TIM_CLOCK_HZ，更新事件作为 ADC 触发（TRGO）
+ * @note   APB1 = 42MHz，分频系数≠1 时定时器时钟 ×2 = 84MHz；周期由 AdcScan_Start 设置
  */
-void ESP8266_GetIPAddress(void)
+static void MX_TIM2_Init(void)
 {
-    printf("\r\n正在查询IP地址...\r\n");
-    ESP8266_ClearBuffer();
-    ESP8266_SendCommand("AT+CIFSR\r\n");
-    if(ESP8266_WaitForString("OK", 5000)) {
-        // 响应已在 WaitForString 内部打印
-    }
-}
-
-/**
- * @brief  连接到WiFi热点 (重构后)
- * @return 1=成功, 0=失败
- */
-uint8_t ESP8266_ConnectWiFi(const char* ssid, const char* password)
-{
-    char cmd[128] = {0};
-    
-    printf("\r\n--- WiFi连接流程 ---\r\n\r\n");
-    
-    // 步骤1：设置为Station模式
-    printf("1. 设置为Station模式...\r\n");
-    if (!ESP8266_SendAndWaitOK("AT+CWMODE=1\r\n", 5000)) {
-        printf("   ⚠ 模式设置失败，但继续尝试...\r\n\r\n");
-    } else {
-        printf("   ✓ 模式设置成功\r\n\r\n");
-    }
-    HAL_Delay(1000);
-
-    // 步骤2：断开之前的连接 (可选但推荐)
-    printf("2. 断开之前的连接...\r\n");
-    ESP8266_SendAndWaitOK("AT+CWQAP\r\n", 3000);
-    printf("   ✓ 已断开（或未连接）\r\n\r\n");
-    HAL_Delay(1000);
+    TIM_MasterConfigTypeDef sMasterConfig = {0};
 
-    // 步骤3：连接到指定WiFi
-    printf("3. 连接到WiFi: %s\r\n", ssid);
-    printf("   密码: %s\r\n", password);
-    printf("   正在连接（最多25秒）...\r\n");
-    
-    sprintf(cmd, "AT+CWJAP=\"%s\",\"%s\"\r\n", ssid, password);
-    
-    ESP8266_ClearBuffer();
-    ESP8266_SendCommand(cmd);
-    
-    // 等待 "WIFI GOT IP" 或 "OK"
-    if (ESP8266_WaitForString("WIFI GOT IP", 25000) || ESP8266_WaitForString("OK", 1000))
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = (84000000u / ADC_SCAN_TIM_CLOCK_HZ) - 1;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = (ADC_SCAN_TIM_CLOCK_HZ / ADC_SCAN_DEFAULT_RATE_HZ) - 1;
+    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
     {
-        printf("   ✓ WiFi连接成功！\r\n");
-        return 1;
+        Error_Handler();
     }
-    else
+
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
     {
-        printf("\r\n   ✗ WiFi连接失败！\r\n");
-        printf("   请检查：\r\n");
-        printf("   - WiFi名称和密码是否正确\r\n");
-        printf("   - 热点是否已开启\r\n");
-        printf("   - 热点频段是否为2.4GHz\r\n");
-        printf("   - ESP8266与热点的距离\r\n");
-        return 0;
+        Error_Handler();
     }
 }
 
@@ -610,6 +1141,7 @@ void Error_Handler(void)
  * @brief  解析后端下发的JSON指令
  * @param  json_str 收到的JSON字符串
  * @note   支持的指令格式: {"cmd":"set_rate","rate_ms":1000}
+ *                        {"cmd":"calibrate"}（后台校准全部传感器的 R0，结果以事件上报）
  */
 static void ParseBackendCommand(const char* json_str)
 {
@@ -640,6 +1172,7 @@ static void ParseBackendCommand(const char* json_str)
             /* 验证范围并更新采样率 */
             if (rate_ms >= MIN_SAMPLING_INTERVAL_MS && rate_ms <= MAX_SAMPLING_INTERVAL_MS) {
                 g_sampling_interval_ms = (uint32_t)rate_ms;
+                Sched_SetPeriod(g_task_sample, g_sampling_interval_ms);   // 立即生效，不等旧间隔走完
                 printf("[自适应采样] 采样率已更新: %d ms\r\n", rate_ms);
             } else {
                 printf("[自适应采样] 无效的采样率: %d ms (范围: %d-%d)\r\n",
@@ -647,6 +1180,85 @@ static void ParseBackendCommand(const char* json_str)
             }
         }
     }
+    /* R0 校准：只启动，不阻塞；完成后采样任务上报 calibration 事件 */
+    else if (strstr(json_str, "calibrate") != NULL) {
+        if (SensorManager_StartCalibration(SENSOR_ALL) > 0) {
+            printf("[指令] R0 校准已启动\r\n");
+        } else {
+            printf("[指令] R0 校准已在进行中，忽略\r\n");
+        }
+    }
+    /* 历史回传：{"cmd":"history","sensor":"mq3","res":10,"from_s":3600,"to_s":0} */
+    else if (strstr(json_str, "\"history\"") != NULL) {
+        char key[16] = {0};
+        uint32_t res_s = 10;
+        uint32_t from_s = 600;
+        uint32_t to_s = 0;
+        SensorType_t type = (SensorType_t)0;
+
+        if (JsonFindString(json_str, "sensor", key, sizeof(key))) {
+            type = SensorManager_FindByKey(key);
+        }
+        (void)JsonFindUint(json_str, "res", &res_s);
+        (void)JsonFindUint(json_str, "from_s", &from_s);
+        (void)JsonFindUint(json_str, "to_s", &to_s);
+
+        if (res_s <= 0xFFFF && SensorManager_StartHistory(&g_history_cursor, type, (uint16_t)res_s, from_s, to_s)) {
+            printf("[指令] 历史回传: %s 分辨率 %lu s，%lu ~ %lu 秒前\r\n",
+                   SensorManager_GetDesc(type)->hk_key, (unsigned long)res_s,
+                   (unsigned long)from_s, (unsigned long)to_s);
+        } else {
+            printf("[指令] 历史回传参数无效: %s\r\n", json_str);
+        }
+    }
+    /* HK 下传粒度：{"cmd":"telemetry","mode":"gated"|"full","heartbeat_s":60,"z":4,
+     *              "db":"alcohol_ppm","abs":1.0,"rel":0.05}，字段均可省略；处理后回报 telemetry 事件 */
+    else if (strstr(json_str, "\"telemetry\"") != NULL) {
+        char mode[8] = {0};
+        uint32_t heartbeat_s = 0;
+        uint32_t z = 0;
+        const char* z_note = "";                 // 异常阈值是否真正生效（越界的 z 被拒绝）
+
+        if (JsonFindString(json_str, "mode", mode, sizeof(mode))) {
+            if (strcmp(mode, "full") == 0) {
+                g_hk_gated = 0;
+            } else if (strcmp(mode, "gated") == 0) {
+                g_hk_gated = 1;
+            }
+        }
+        if (JsonFindUint(json_str, "heartbeat_s", &heartbeat_s) && heartbeat_s >= 1u && heartbeat_s <= 3600u) {
+            g_hk_heartbeat_ms = heartbeat_s * 1000u;
+        }
+        if (JsonFindUint(json_str, "z", &z)) {
+            if (z >= 1u && z <= HK_ANOMALY_Z_MAX) {
+                SensorManager_SetAnomalyThreshold((float)z);
+                z_note = "，异常阈值已更新";
+            } else {
+                z_note = "，异常阈值超出范围，未修改";
+            }
+        }
+
+        /* 死区：只给 abs 或 rel 时另一项置 0（不启用） */
+        g_telemetry_db[0] = '\0';
+        if (JsonFindString(json_str, "db", g_telemetry_db, sizeof(g_telemetry_db))) {
+            float db_abs = 0.0f;
+            float db_rel = 0.0f;
+            (void)JsonFindFloat(json_str, "abs", &db_abs);
+            (void)JsonFindFloat(json_str, "rel", &db_rel);
+            g_telemetry_db_ok = SensorManager_SetDeadband(g_telemetry_db, db_abs, db_rel) ? 1 : 0;
+            DLOG(MAIN_DEADBAND, (const char*)g_telemetry_db, db_abs, db_rel,
+                 g_telemetry_db_ok ? "" : "（字段或参数无效）");
+        }
+        printf("[指令] HK 下传：%s，最长静默 %lu s%s\r\n", g_hk_gated ? "平静期省略" : "逐轮全量",
+               (unsigned long)(g_hk_heartbeat_ms / 1000u), z_note);
+        g_telemetry_report = 1;
+    }
+    /* 调度统计：{"cmd":"sched","reset":1}，回报 sched 事件；reset 非 0 时回报后清零 */
+    else if (strstr(json_str, "\"sched\"") != NULL) {
+        uint32_t reset = 0;
+        (void)JsonFindUint(json_str, "reset", &reset);
+        g_sched_report = reset ? 2 : 1;
+    }
     /* 可扩展其他指令类型 */
     else if (strstr(json_str, "ping") != NULL) {
         printf("[指令] 收到ping，系统正常运行\r\n");
@@ -656,9 +1268,259 @@ static void ParseBackendCommand(const char* json_str)
     }
 }
 
+/**
+ * @brief  模拟看门狗钩子（ADC 中断上下文）：立即切到高采样率并触发一次采样任务
+ */
+static void OnGasWatchdog(uint32_t adc_channel)
+{
+    (void)adc_channel;
+    g_sampling_interval_ms = HIGH_SAMPLE_RATE_MS;
+    g_gas_awd_tripped = 1;
+    Sched_Trigger(g_task_sample);
+}
+
+/**
+ * @brief  告警浓度按当前 R0 换算为原始码值写入模拟看门狗（R0 重新校准后自动更新）
+ * @param  arm: 1 = MQ-3 就绪且未告警，布防；0 = 撤防（告警期间由采样任务判定解除）
+ */
+static void UpdateGasWatchdog(uint8_t arm)
+{
+    static uint16_t programmed_code = 0;
+
+    if (!arm) {
+        if (AdcScan_WatchdogArmed()) {
+            AdcScan_DisarmWatchdog();
+        }
+        return;
+    }
+
+    uint16_t code = SensorManager_CodeForPpm(SENSOR_TYPE_MQ3_ALCOHOL, ALCOHOL_ALERT_PPM);
+    if (code == 0) {
+        return;
+    }
+    if (code != programmed_code) {
+        /* 窗口 [0, code-1]：原始码值达到 code（浓度 ≥ 告警阈值）即越界 */
+        if (!AdcScan_ConfigWatchdog(SensorManager_GetDesc(SENSOR_TYPE_MQ3_ALCOHOL)->adc_channel, 0, code - 1)) {
+            return;
+        }
+        programmed_code = code;
+        DLOG(MAIN_AWD_LEVEL, ALCOHOL_ALERT_PPM, code);
+    }
+    if (!AdcScan_WatchdogArmed()) {
+        AdcScan_ArmWatchdog();
+    }
+}
+
+/**
+ * @brief  TC 129/6 的回执：各任务 [运行次数, 平均 µs, 最大 µs, 最大释放延迟 ms, 超限次数]
+ */
+static void ReportSchedStats(void)
+{
+    char evt_payload[PUS_MAX_TM_JSON_LEN + 1];
+    TmWriter_t w;
+    TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "sched");
+    TmWriter_Uint(&w, "up", HAL_GetTick() / 1000u);
+    TmWriter_Fixed(&w, "load", Sched_Load(), 1);
+    TmWriter_BeginObject(&w, "tasks");
+    TmWriter_Reserve(&w, 2);   // 为结尾的 "}}" 预留
+
+    /* 任务多到放不下时截掉后面的任务，报文仍完整 */
+    for (int8_t id = 0; id < (int8_t)Sched_TaskCount(); id++) {
+        SchedStats_t st;
+        if (!Sched_GetStats(id, &st)) {
+            continue;
+        }
+        TmWriterMark_t mark = TmWriter_Mark(&w);
+        TmWriter_BeginArray(&w, st.name);
+        TmWriter_Uint(&w, NULL, st.runs);
+        TmWriter_Uint(&w, NULL, st.runs ? (uint32_t)(st.run_us_total / st.runs) : 0u);
+        TmWriter_Uint(&w, NULL, st.run_us_max);
+        TmWriter_Uint(&w, NULL, st.late_max_ms);
+        TmWriter_Uint(&w, NULL, st.misses);
+        TmWriter_EndArray(&w);
+        if (!TmWriter_Ok(&w)) {
+            TmWriter_Rollback(&w, mark);
+            break;
+        }
+    }
+    TmWriter_Reserve(&w, -2);
+    TmWriter_EndObject(&w);
+    TmWriter_EndObject(&w);
+    QueueEventTm(&w, PUS5_EVENT_INFO);
+}
+
+/**
+ * @brief  回报链路监护统计（随 TC 129/6 一起，累计自开机，不随 reset 清零）
+ */
+static void ReportLinkStats(void)
+{
+    char evt_payload[PUS_MAX_TM_JSON_LEN + 1];
+    TmWriter_t w;
+    TmWriter_Init(&w, evt_payload, sizeof(evt_payload), TM_ENC_JSON);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "link");
+    TmWriter_Uint(&w, "outages", g_net.outages);
+    TmWriter_Uint(&w, "out_ms", g_net.outage_ms_total);
+    TmWriter_Uint(&w, "out_max", g_net.outage_ms_max);
+    TmWriter_Uint(&w, "out_last", g_net.outage_ms_last);
+    TmWriter_Uint(&w, "wifi_drops", g_net.wifi_drops);
+    TmWriter_BeginArray(&w, "st");
+    TmWriter_Reserve(&w, 2);   // 为结尾的 "]}" 预留
+
+    for (uint8_t i = 0; i < GroundLink_StationCount(); i++) {
+        const GroundLinkStats_t* st = GroundLink_GetStats(i);
+        TmWriterMark_t mark = TmWriter_Mark(&w);
+        TmWriter_BeginArray(&w, NULL);
+        TmWriter_Uint(&w, NULL, GroundLink_IsUp(i));
+        TmWriter_Uint(&w, NULL, st->closed);
+        TmWriter_Uint(&w, NULL, st->tx_failures);
+        TmWriter_Uint(&w, NULL, st->reconnects);
+        TmWriter_Uint(&w, NULL, st->outages);
+        TmWriter_Uint(&w, NULL, st->outage_ms_total);
+        TmWriter_Uint(&w, NULL, st->outage_ms_max);
+        TmWriter_EndArray(&w);
+        if (!TmWriter_Ok(&w)) {
+            TmWriter_Rollback(&w, mark);
+            break;
+        }
+    }
+    TmWriter_Reserve(&w, -2);
+    TmWriter_EndArray(&w);
+    TmWriter_EndObject(&w);
+    QueueEventTm(&w, PUS5_EVENT_INFO);
+}
+
+/**
+ * @brief  结束事件报文并入队（要求 TM-ACK）；放不下时丢弃并打印，不下传截断的 JSON
+ */
+static void QueueEventTm(TmWriter_t* w, uint8_t event_subtype)
+{
+    if (TmWriter_Finish(w) == 0) {
+        printf("[事件] 报文超出缓冲区，未下传\r\n");
+        return;
+    }
+    GroundLink_QueueEvent(event_subtype, (const char*)w->buf, 1);
+}
+
+/**
+ * @brief  在指令 JSON 中查找 "key": 后的无符号整数
+ * @retval 1: 找到
+ */
+static uint8_t JsonFindUint(const char* json, const char* key, uint32_t* out)
+{
+    char pattern[24];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    const char* p = strstr(json, pattern);
+    if (p == NULL) {
+        return 0;
+    }
+    p += strlen(pattern);
+    while (*p == ':' || *p == ' ') {
+        p++;
+    }
+    if (*p < '0' || *p > '9') {
+        return 0;
+    }
+
+    uint32_t value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+    *out = value;
+    return 1;
+}
+
+/**
+ * @brief  在指令 JSON 中查找 "key": 后的字符串（不处理转义）
+ * @retval 1: 找到且完整放入 out
+ */
+static uint8_t JsonFindString(const char* json, const char* key, char* out, size_t size)
+{
+    char pattern[24];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    const char* p = strstr(json, pattern);
+    if (p == NULL) {
+        return 0;
+    }
+    p += strlen(pattern);
+    while (*p == ':' || *p == ' ') {
+        p++;
+    }
+    if (*p != '"') {
+        return 0;
+    }
+    p++;
+
+    size_t n = 0;
+    while (p[n] != '\0' && p[n] != '"') {
+        if (n + 1 >= size) {
+            return 0;
+        }
+        out[n] = p[n];
+        n++;
+    }
+    out[n] = '\0';
+    return (p[n] == '"') ? 1 : 0;
+}
+
+/**
+ * @brief  在指令 JSON 中查找 "key": 后的数值（可带小数点与符号）
+ * @retval 1: 找到
+ */
+static uint8_t JsonFindFloat(const char* json, const char* key, float* out)
+{
+    char pattern[24];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    const char* p = strstr(json, pattern);
+    if (p == NULL) {
+        return 0;
+    }
+    p += strlen(pattern);
+    while (*p == ':' || *p == ' ') {
+        p++;
+    }
+
+    char* end = NULL;
+    float value = strtof(p, &end);
+    if (end == p) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+/**
+ * @brief  历史下传：事件队列有余量时逐页生成并入队（要求 TM-ACK，丢包重传）
+ * @retval 本次入队的页数
+ */
+static uint8_t HistoryTransferStep(void)
+{
+    uint8_t pages = 0;
+
+    while (pages < HISTORY_PAGES_PER_LOOP && !g_history_cursor.done &&
+           GroundLink_EventQueueDepth() < HISTORY_QUEUE_LIMIT) {
+        char payload[PUS_MAX_TM_JSON_LEN + 1];
+        SensorHistoryCursor_t saved = g_history_cursor;
+        if (SensorManager_FormatHistory(payload, sizeof(payload), &g_history_cursor) == 0) {
+            g_history_cursor.done = true;
+            break;
+        }
+        if (GroundLink_QueueEvent(PUS5_EVENT_INFO, payload, 1) == 0) {
+            g_history_cursor = saved;   // 未能入队，下次重新生成这一页
+            break;
+        }
+        pages++;
+    }
+    return pages;
+}
+
 #ifdef USE_FULL_ASSERT
 void assert_failed(uint8_t *file, uint32_t line)
 {
     printf("Assert failed: %s:%lu\r\n", file, line);
+    DLog_Flush(100);
 }
 #endif
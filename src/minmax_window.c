@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file           : minmax_window.c
+ * @brief          : 按时间滑动的窗口最小/最大值实现
+ ******************************************************************************
+ */
+
+#include "minmax_window.h"
+
+#include <string.h>
+
+#define RING_AT(q, i) ((q)->ring[((q)->head + (i)) % MINMAX_WINDOW_CAPACITY])
+
+/**
+ * @brief 入队：先从队尾挤掉被新值支配的项（less=1 维护最小值队列）
+ */
+static void deque_push(MinMaxDeque_t* q, uint16_t value, uint32_t tick, bool less) {
+    while (q->len > 0) {
+        uint16_t back = RING_AT(q, q->len - 1).value;
+        if (less ? (back < value) : (back > value)) {
+            break;
+        }
+        q->len--;
+    }
+    if (q->len == MINMAX_WINDOW_CAPACITY) {
+        /* 桶宽保证不会发生；防御性地丢弃最旧项 */
+        q->head = (uint8_t)((q->head + 1) % MINMAX_WINDOW_CAPACITY);
+        q->len--;
+    }
+    MinMaxEntry_t* e = &RING_AT(q, q->len);
+    e->value = value;
+    e->tick = tick;
+    q->len++;
+}
+
+static void deque_expire(MinMaxDeque_t* q, uint32_t now, uint32_t window_ms) {
+    while (q->len > 0 && (now - q->ring[q->head].tick) > window_ms) {
+        q->head = (uint8_t)((q->head + 1) % MINMAX_WINDOW_CAPACITY);
+        q->len--;
+    }
+}
+
+void MinMaxWindow_Init(MinMaxWindow_t* w, uint32_t window_ms) {
+    memset(w, 0, sizeof(*w));
+    w->window_ms = window_ms;
+    w->bucket_ms = window_ms / (MINMAX_WINDOW_CAPACITY - 2);
+    if (w->bucket_ms == 0) {
+        w->bucket_ms = 1;
+    }
+}
+
+void MinMaxWindow_Reset(MinMaxWindow_t* w) {
+    MinMaxWindow_Init(w, w->window_ms);
+}
+
+void MinMaxWindow_Push(MinMaxWindow_t* w, uint16_t value, uint32_t now) {
+    if (!w->started) {
+        w->started = true;
+        w->start_tick = now;
+    }
+
+    /* 当前桶到期：以桶的极值入队 */
+    if (w->bucket_open && (now - w->bucket_tick) >= w->bucket_ms) {
+        deque_push(&w->min_q, w->bucket_min, w->bucket_tick, true);
+        deque_push(&w->max_q, w->bucket_max, w->bucket_tick, false);
+        w->bucket_open = false;
+    }
+
+    if (!w->bucket_open) {
+        w->bucket_open = true;
+        w->bucket_tick = now;
+        w->bucket_min = value;
+        w->bucket_max = value;
+    } else {
+        if (value < w->bucket_min) {
+            w->bucket_min = value;
+        }
+        if (value > w->bucket_max) {
+            w->bucket_max = value;
+        }
+    }
+
+    deque_expire(&w->min_q, now, w->window_ms);
+    deque_expire(&w->max_q, now, w->window_ms);
+}
+
+bool MinMaxWindow_Covered(const MinMaxWindow_t* w, uint32_t now) {
+    return w->started && (now - w->start_tick) >= w->window_ms;
+}
+
+uint16_t MinMaxWindow_Min(const MinMaxWindow_t* w) {
+    uint16_t v = (w->min_q.len > 0) ? w->min_q.ring[w->min_q.head].value : 0xFFFF;
+    if (w->bucket_open && w->bucket_min < v) {
+        v = w->bucket_min;
+    }
+    return v;
+}
+
+uint16_t MinMaxWindow_Max(const MinMaxWindow_t* w) {
+    uint16_t v = (w->max_q.len > 0) ? w->max_q.ring[w->max_q.head].value : 0;
+    if (w->bucket_open && w->bucket_max > v) {
+        v = w->bucket_max;
+    }
+    return v;
+}
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file           : minmax_window.h
+ * @brief          : 按时间滑动的窗口最小/最大值（单调双端队列，均摊 O(1)）
+ ******************************************************************************
+ * @description    : 维护最近 window_ms 内样本的最小值与最大值：
+ *                   - 最小值队列保持单调递增、最大值队列保持单调递减，
+ *                     新样本从队尾挤掉不可能再成为极值的旧项，过期项从队头移除；
+ *                   - 样本先按 bucket_ms = window_ms / (容量 - 2) 归入时间桶，
+ *                     桶关闭时才入队，因此队列长度与采样率无关，
+ *                     固定容量的环形缓冲永远不会溢出；窗口边界精度为一个桶。
+ *
+ *                   用法：每个样本调用 MinMaxWindow_Push，随时查询
+ *                   MinMaxWindow_Covered（是否已观察满一个窗口）与 Min/Max。
+ ******************************************************************************
+ */
+
+#ifndef __MINMAX_WINDOW_H
+#define __MINMAX_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MINMAX_WINDOW_CAPACITY 32    // 每个队列的环形缓冲项数（≥ 窗口内桶数 + 2）
+
+typedef struct {
+    uint16_t value;
+    uint32_t tick;                   // 桶起点
+} MinMaxEntry_t;
+
+typedef struct {
+    MinMaxEntry_t ring[MINMAX_WINDOW_CAPACITY];
+    uint8_t head;
+    uint8_t len;
+} MinMaxDeque_t;
+
+typedef struct {
+    MinMaxDeque_t min_q;             // 值单调递增，队头为最小
+    MinMaxDeque_t max_q;             // 值单调递减，队头为最大
+    uint32_t window_ms;
+    uint32_t bucket_ms;
+    uint32_t start_tick;             // 第一个样本时刻
+    uint32_t bucket_tick;            // 当前桶起点
+    uint16_t bucket_min;
+    uint16_t bucket_max;
+    bool started;
+    bool bucket_open;
+} MinMaxWindow_t;
+
+void MinMaxWindow_Init(MinMaxWindow_t* w, uint32_t window_ms);
+
+/**
+ * @brief 清空，从下一个样本重新开始观察
+ */
+void MinMaxWindow_Reset(MinMaxWindow_t* w);
+
+void MinMaxWindow_Push(MinMaxWindow_t* w, uint16_t value, uint32_t now);
+
+/**
+ * @brief 是否已连续观察满一个窗口
+ */
+bool MinMaxWindow_Covered(const MinMaxWindow_t* w, uint32_t now);
+
+/**
+ * @brief 窗口内最小/最大值（尚无样本时分别为 0xFFFF / 0）
+ */
+uint16_t MinMaxWindow_Min(const MinMaxWindow_t* w);
+uint16_t MinMaxWindow_Max(const MinMaxWindow_t* w);
+
+#endif /* __MINMAX_WINDOW_H */
@@ -0,0 +1,110 @@
+/**
+ ******************************************************************************
+ * @file           : mq_curve.c
+ * @brief          : MQ 系列传感器浓度查找表实现
+ ******************************************************************************
+ */
+
+#include "mq_curve.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#define MQ_CURVE_MIN_VOLTAGE 0.01f   // 与 Rs 计算中的防除零下限一致
+#define MQ_CURVE_NODE_CAP 4.0f       // 节点最多存到 ppm_max 的 4 倍，查表结果再限幅
+
+/**
+ * @brief 未限幅的曲线值（Vout ≥ Vc 时返回 +inf）
+ */
+static float curve_unclamped(const MqCurveParams_t* p, uint32_t code, uint8_t code_bits) {
+    float voltage = ((float)code / (float)(1u << code_bits)) * p->v_full_scale;
+
+    if (voltage <= MQ_CURVE_MIN_VOLTAGE) {
+        voltage = MQ_CURVE_MIN_VOLTAGE;
+    }
+    if (voltage >= p->vc) {
+        return INFINITY;   // Rs → 0
+    }
+
+    float rs = (p->vc - voltage) * p->rl_kohm / voltage;
+    return expf(logf(p->a) + p->b * logf(rs / p->r0_kohm));
+}
+
+float MqCurve_Reference(const MqCurveParams_t* p, uint32_t code, uint8_t code_bits) {
+    float ppm = curve_unclamped(p, code, code_bits);
+
+    if (ppm < 0.0f) ppm = 0.0f;
+    if (ppm > p->ppm_max) ppm = p->ppm_max;
+    return ppm;
+}
+
+uint32_t MqCurve_CodeForPpm(const MqCurveParams_t* p, float ppm, uint8_t code_bits) {
+    uint32_t full = (1u << code_bits) - 1u;
+
+    if (ppm <= 0.0f || p->b == 0.0f) {
+        return 0;
+    }
+    /* ppm = a (Rs/R0)^b → Rs → Vout = Vc·RL / (Rs + RL) */
+    float rs = p->r0_kohm * expf((logf(ppm) - logf(p->a)) / p->b);
+    float voltage = p->vc * p->rl_kohm / (rs + p->rl_kohm);
+    float code = ceilf(voltage / p->v_full_scale * (float)(1u << code_bits));
+
+    if (!(code < (float)full)) {
+        return full;
+    }
+    /* 浮点舍入：保证返回的码值确实达到 ppm */
+    uint32_t c = (uint32_t)code;
+    while (c < full && curve_unclamped(p, c, code_bits) < ppm) {
+        c++;
+    }
+    while (c > 0 && curve_unclamped(p, c - 1, code_bits) >= ppm) {
+        c--;
+    }
+    return c;
+}
+
+/**
+ * @brief 节点 k 对应的 x（与 MqCurve_Segment 的分段方式互逆）
+ */
+static uint32_t node_x(uint32_t k) {
+    if (k < (2u << MQ_CURVE_SUBSEG_BITS)) {
+        return k;
+    }
+    uint32_t w = (k >> MQ_CURVE_SUBSEG_BITS) - 1u;
+    uint32_t m = k & ((1u << MQ_CURVE_SUBSEG_BITS) - 1u);
+    return ((1u << MQ_CURVE_SUBSEG_BITS) + m) << w;
+}
+
+static int32_t node_value(const MqCurveParams_t* p, int64_t code, uint8_t code_bits) {
+    float cap = p->ppm_max * MQ_CURVE_NODE_CAP;
+    float ppm = curve_unclamped(p, (code < 0) ? 0u : (uint32_t)code, code_bits);
+
+    if (ppm > cap) {
+        ppm = cap;
+    }
+    return (int32_t)(ppm * (float)(1u << MQ_CURVE_PPM_FRAC_BITS) + 0.5f);
+}
+
+uint8_t MqCurve_Build(MqCurveLut_t* lut, const MqCurveParams_t* p, uint8_t code_bits) {
+    if (lut == NULL || p == NULL || code_bits == 0 || code_bits > 16 ||
+        p->a <= 0.0f || p->r0_kohm <= 0.0f || p->v_full_scale <= 0.0f || p->vc <= 0.0f ||
+        p->ppm_max <= 0.0f ||
+        p->ppm_max * MQ_CURVE_NODE_CAP * (float)(1u << MQ_CURVE_PPM_FRAC_BITS) >= 2147483520.0f) {
+        return 0;
+    }
+
+    float pole = p->vc / p->v_full_scale * (float)(1u << code_bits);
+    if (pole >= (float)node_x(MQ_CURVE_LUT_SIZE - 2)) {
+        return 0;   // 极点超出表覆盖范围
+    }
+    lut->pole_code = (uint32_t)pole;
+    lut->split_code = lut->pole_code / 2u;
+    lut->ppm_max_q = (uint32_t)(p->ppm_max * (float)(1u << MQ_CURVE_PPM_FRAC_BITS) + 0.5f);
+
+    for (uint32_t k = 0; k < MQ_CURVE_LUT_SIZE; k++) {
+        uint32_t x = node_x(k);
+        lut->rise[k] = node_value(p, (int64_t)x, code_bits);
+        lut->fall[k] = node_value(p, (int64_t)lut->pole_code - (int64_t)x, code_bits);
+    }
+    return 1;
+}
@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ * @file           : mq_curve.h
+ * @brief          : MQ 系列传感器 ADC 码值 → 浓度（ppm）查找表，定点插值
+ ******************************************************************************
+ * @description    : 采样路径上原为 电压 → Rs（浮点除法）→ powf(Rs/R0, B)，
+ *                   每个样本一次 powf。这里在初始化/校准时按曲线参数
+ *                   （A、B、RL、R0 等）预先算出节点，运行时只有整数运算。
+ *
+ *                   ppm ∝ (code / (pole - code))^(-B)：两端都是幂律
+ *                   （code → 0 与 Vout → Vc 的极点），按码值均匀分段误差很大。
+ *                   因此按对数分段：以半程为界，前半段用 x = code，
+ *                   后半段用 x = pole - code；与浮点数相同，指数（CLZ 求得）
+ *                   选倍程，高 4 位尾数在倍程内再分 16 段，相邻节点之比 ≤ 17/16，
+ *                   段内线性插值，最后统一限幅（节点本身不限幅，避免限幅拐点落在段内）。
+ *                   一次查表 = 比较 + CLZ + 移位/掩码 + 一次 32×32→64 乘法。
+ *
+ *                   输出 Q10 定点（1/1024 ppm）。精度可用 host_bench ppm_lut
+ *                   对照浮点参考逐码验证。R0 变化（重新校准）后需调用 MqCurve_Build 重建。
+ ******************************************************************************
+ */
+
+#ifndef __MQ_CURVE_H
+#define __MQ_CURVE_H
+
+#include <stdint.h>
+
+#define MQ_CURVE_SUBSEG_BITS 4            // 每个倍程 2^4 段
+#define MQ_CURVE_LUT_SIZE 257             // 每侧节点数，x 最大可到 2^19
+#define MQ_CURVE_PPM_FRAC_BITS 10         // 输出 Q10
+
+/* 曲线参数：ppm = a · (Rs/R0)^b，Rs = (vc - Vout) · rl / Vout */
+typedef struct {
+    float a;
+    float b;
+    float rl_kohm;          // 负载电阻 (kΩ)
+    float vc;               // 传感器供电电压 (V)
+    float v_full_scale;     // ADC 满量程对应的传感器输出电压（VREF × 分压比）
+    float r0_kohm;          // 清洁空气基准电阻 (kΩ)
+    float ppm_max;          // 输出上限
+} MqCurveParams_t;
+
+typedef struct {
+    int32_t rise[MQ_CURVE_LUT_SIZE];    // 前半段：code = x_k 处浓度（Q10，未限幅）
+    int32_t fall[MQ_CURVE_LUT_SIZE];    // 后半段：code = pole - x_k 处浓度
+    uint32_t pole_code;                 // Vout = Vc 对应的码值（向下取整）
+    uint32_t split_code;                // 前/后半段分界
+    uint32_t ppm_max_q;                 // 输出上限（Q10）
+} MqCurveLut_t;
+
+/**
+ * @brief 按曲线参数生成查找表
+ * @param code_bits 输入码值位数（12 为单次转换，过采样后 14~16）
+ * @return 1: 成功; 0: 参数不合法
+ */
+uint8_t MqCurve_Build(MqCurveLut_t* lut, const MqCurveParams_t* p, uint8_t code_bits);
+
+/**
+ * @brief 对数分段内插：x ∈ [16·2^w, 32·2^w) 落在节点 k = (w+1)·16 + 尾数，段宽 2^w
+ */
+static inline int32_t MqCurve_Segment(const int32_t* node, uint32_t x) {
+    if (x < (2u << MQ_CURVE_SUBSEG_BITS)) {
+        return node[x];   // 前两个倍程每个码值一个节点
+    }
+    uint32_t w = (uint32_t)(31 - MQ_CURVE_SUBSEG_BITS) - (uint32_t)__builtin_clz(x);
+    uint32_t k = ((w + 1u) << MQ_CURVE_SUBSEG_BITS) + ((x >> w) & ((1u << MQ_CURVE_SUBSEG_BITS) - 1u));
+    uint32_t frac = x & ((1u << w) - 1u);
+    int32_t y0 = node[k];
+    return y0 + (int32_t)(((int64_t)(node[k + 1] - y0) * frac) >> w);
+}
+
+/**
+ * @brief 码值 → 浓度（Q10 定点，ppm × 1024）
+ */
+static inline uint32_t MqCurve_Lookup(const MqCurveLut_t* lut, uint32_t code) {
+    int32_t y;
+
+    if (code >= lut->pole_code) {
+        return lut->ppm_max_q;
+    }
+    if (code < lut->split_code) {
+        y = MqCurve_Segment(lut->rise, code);
+    } else {
+        y = MqCurve_Segment(lut->fall, lut->pole_code - code);
+    }
+    if (y < 0) {
+        return 0;
+    }
+    return ((uint32_t)y > lut->ppm_max_q) ? lut->ppm_max_q : (uint32_t)y;
+}
+
+/**
+ * @brief 浮点参考实现（与查表同一模型，用于建表与精度对照）
+ */
+float MqCurve_Reference(const MqCurveParams_t* p, uint32_t code, uint8_t code_bits);
+
+/**
+ * @brief 反查：浓度达到 ppm 的最小码值（曲线的逆，用于硬件阈值）
+ * @return 码值；ppm 超出可测范围时返回满量程 (1 << code_bits) - 1
+ */
+uint32_t MqCurve_CodeForPpm(const MqCurveParams_t* p, float ppm, uint8_t code_bits);
+
+#endif /* __MQ_CURVE_H */
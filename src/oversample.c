@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file           : oversample.c
+ * @brief          : 过采样 + 抽取滤波器实现
+ ******************************************************************************
+ */
+
+#include "oversample.h"
+
+#include <string.h>
+
+uint8_t Oversample_Init(Oversample_t* f, uint16_t n, uint8_t order) {
+    uint8_t log2n = 0;
+
+    if (f == NULL || n < 2 || (n & (n - 1)) != 0 || order == 0 || order > OVERSAMPLE_MAX_ORDER) {
+        return 0;
+    }
+    while ((1u << log2n) < n) {
+        log2n++;
+    }
+    /* 输出位宽 = 12 + order*log2(N)，需 ≤ 32 */
+    if (order * log2n > 32 - OVERSAMPLE_INPUT_BITS) {
+        return 0;
+    }
+
+    memset(f, 0, sizeof(*f));
+    f->n = n;
+    f->order = order;
+    f->extra_bits = (uint8_t)(log2n / 2);
+    f->shift = (uint8_t)(order * log2n - f->extra_bits);
+    f->warmup = (uint8_t)(order - 1);
+    return 1;
+}
+
+uint8_t Oversample_Push(Oversample_t* f, uint16_t raw) {
+    uint32_t y = raw;
+
+    for (uint8_t i = 0; i < f->order; i++) {
+        f->integ[i] += y;
+        y = f->integ[i];
+    }
+    if (++f->count < f->n) {
+        return 0;
+    }
+    f->count = 0;
+
+    for (uint8_t i = 0; i < f->order; i++) {
+        uint32_t prev = f->comb[i];
+        f->comb[i] = y;
+        y -= prev;
+    }
+    if (f->warmup > 0) {
+        f->warmup--;
+        return 0;
+    }
+
+    /* 增益 N^order，右移后保留 extra_bits 位小数（四舍五入） */
+    if (f->shift > 0) {
+        y = (y + (1u << (f->shift - 1))) >> f->shift;
+    }
+    uint32_t max = (4096u << f->extra_bits) - 1;
+    f->out = (uint16_t)(y > max ? max : y);
+    f->out_seq = f->out_seq + 1;
+    return 1;
+}
+
+uint32_t Oversample_Read(const Oversample_t* f, uint16_t* out) {
+    uint32_t seq = f->out_seq;
+    if (out != NULL) {
+        *out = f->out;
+    }
+    return seq;
+}
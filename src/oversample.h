@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file           : oversample.h
+ * @brief          : 过采样 + 抽取滤波器（CIC，1 阶即 boxcar 累加平均）
+ ******************************************************************************
+ * @description    : 对 12 位原始转换流做 N 倍过采样：每 N 个输入输出一个样本，
+ *                   有效分辨率提高 log2(N)/2 位（N=16 → 14 位，N=256 → 16 位）。
+ *
+ *                   - order=1：N 点累加后整体输出（boxcar / sum-and-dump）；
+ *                   - order=2/3：CIC 积分-梳状结构，阻带衰减更好，
+ *                     启动后前 order 个输出为暂态，不对外发布。
+ *                   运算全部为 32 位整数（模运算下 CIC 溢出可自行抵消），
+ *                   要求 order × log2(N) ≤ 20，保证输出位宽不超过 32 位。
+ *
+ *                   一个滤波器对应一路通道，可放在中断中推入，在主循环中读取。
+ ******************************************************************************
+ */
+
+#ifndef __OVERSAMPLE_H
+#define __OVERSAMPLE_H
+
+#include <stdint.h>
+
+#define OVERSAMPLE_INPUT_BITS 12
+#define OVERSAMPLE_MAX_ORDER 3
+
+typedef struct {
+    uint32_t integ[OVERSAMPLE_MAX_ORDER];  // 积分器（输入速率）
+    uint32_t comb[OVERSAMPLE_MAX_ORDER];   // 梳状器延迟（输出速率）
+    uint16_t n;                            // 抽取比 N（2 的幂）
+    uint16_t count;                        // 本轮已输入样本数
+    uint8_t order;                         // CIC 阶数
+    uint8_t shift;                         // 输出右移位数
+    uint8_t extra_bits;                    // 相对 12 位增加的有效位数
+    uint8_t warmup;                        // 剩余暂态输出数
+    volatile uint16_t out;                 // 最近一个输出（12 + extra_bits 位）
+    volatile uint32_t out_seq;             // 已发布的输出个数
+} Oversample_t;
+
+/**
+ * @brief 初始化
+ * @param n 抽取比，2 的幂，16 ~ 256 为常用范围
+ * @param order 1 ~ OVERSAMPLE_MAX_ORDER
+ * @return 1: 成功; 0: 参数不合法
+ */
+uint8_t Oversample_Init(Oversample_t* f, uint16_t n, uint8_t order);
+
+/**
+ * @brief 推入一个 12 位原始样本
+ * @return 1: 产生了新的输出
+ */
+uint8_t Oversample_Push(Oversample_t* f, uint16_t raw);
+
+/**
+ * @brief 最近一个输出
+ * @param out 输出值（满量程 = 4096 << extra_bits）
+ * @return 输出序号；0 表示尚无输出
+ */
+uint32_t Oversample_Read(const Oversample_t* f, uint16_t* out);
+
+/**
+ * @brief 输出位宽（12 + extra_bits）
+ */
+static inline uint8_t Oversample_Bits(const Oversample_t* f) {
+    return (uint8_t)(OVERSAMPLE_INPUT_BITS + f->extra_bits);
+}
+
+#endif /* __OVERSAMPLE_H */
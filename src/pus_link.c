@@ -16,9 +16,6 @@
 #define PUS_C_TM_SEC_LEN 7
 #define PUS_C_CRC_LEN 2
 
-#define PUS_MAX_PACKET_LEN 256
-#define PUS_QUEUE_SIZE 16
-
 #define PUS_RETRY_INTERVAL_MS 1500
 #define PUS_MAX_RETRIES 5
 
@@ -40,31 +37,17 @@
 #define PUS_SERVICE_MISSION 129
 #define MISSION_SUBTYPE_SET_RATE 1
 #define MISSION_SUBTYPE_TM_ACK 2
+#define MISSION_SUBTYPE_CALIBRATE 3
+#define MISSION_SUBTYPE_HISTORY 4
+#define MISSION_SUBTYPE_TELEMETRY 5
+#define MISSION_SUBTYPE_SCHED 6
 
-typedef struct {
-    uint8_t used;
-    uint8_t prio;
-    uint8_t ack_required;
-    uint32_t last_send_ms;
-    uint8_t retries;
-    uint16_t len;
-    uint16_t packet_id;
-    uint16_t seq_ctrl;
-    uint8_t buf[PUS_MAX_PACKET_LEN];
-} pus_msg_t;
-
-static pus_link_send_fn_t g_send_fn = NULL;
-static pus_link_cmd_handler_t g_cmd_handler = NULL;
-static uint8_t g_connected = 0;
-
-static uint16_t g_tm_seq = 0;
-static uint16_t g_tm_subcounter = 0;
+/* 队列优先级：TC 回报最高，其次事件（0~3，见 event_subtype_to_prio） */
+#define PUS_PRIO_TC_VERIFICATION 4
 
-static uint16_t g_apid = 0x001;
-static uint16_t g_source_id = 0x0001;
-static uint16_t g_dest_id = 0x0000;
-
-static pus_msg_t g_queue[PUS_QUEUE_SIZE];
+/* 默认上下文（PusLink_* 接口） */
+static PusLink_t g_default;
+static pus_link_send_fn_t g_default_send_fn = NULL;
 
 static inline uint16_t rd_u16(const uint8_t* p) {
     return (uint16_t)((((uint16_t)p[0]) << 8) | ((uint16_t)p[1]));
@@ -90,43 +73,45 @@ static uint16_t crc16_ccitt(const uint8_t* data, uint16_t len) {
     return crc;
 }
 
-static void queue_clear_slot(int idx) {
+static void queue_clear_slot(PusLink_t* link, int idx) {
     if (idx < 0 || idx >= PUS_QUEUE_SIZE) {
         return;
     }
-    g_queue[idx].used = 0;
-    g_queue[idx].prio = 0;
-    g_queue[idx].ack_required = 0;
-    g_queue[idx].last_send_ms = 0;
-    g_queue[idx].retries = 0;
-    g_queue[idx].len = 0;
-    g_queue[idx].packet_id = 0;
-    g_queue[idx].seq_ctrl = 0;
-    memset(g_queue[idx].buf, 0, sizeof(g_queue[idx].buf));
+    pus_msg_t* m = &link->queue[idx];
+    m->used = 0;
+    m->prio = 0;
+    m->service = 0;
+    m->ack_required = 0;
+    m->last_send_ms = 0;
+    m->retries = 0;
+    m->len = 0;
+    m->packet_id = 0;
+    m->seq_ctrl = 0;
 }
 
-static int queue_find_free(void) {
+static int queue_find_free(const PusLink_t* link) {
     for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
-        if (!g_queue[i].used) {
+        if (!link->queue[i].used) {
             return i;
         }
     }
     return -1;
 }
 
-static int queue_find_evict(uint8_t new_prio) {
+static int queue_find_evict(const PusLink_t* link, uint8_t new_prio) {
+    const pus_msg_t* q = link->queue;
     /* 只淘汰 ack_required=0 的低优先级消息 */
     int best_idx = -1;
     uint8_t best_prio = 255;
     for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
-        if (!g_queue[i].used) {
+        if (!q[i].used) {
             continue;
         }
-        if (g_queue[i].ack_required) {
+        if (q[i].ack_required) {
             continue;
         }
-        if (g_queue[i].prio < best_prio) {
-            best_prio = g_queue[i].prio;
+        if (q[i].prio < best_prio) {
+            best_prio = q[i].prio;
             best_idx = i;
         }
     }
@@ -137,54 +122,60 @@ static int queue_find_evict(uint8_t new_prio) {
     return -1;
 }
 
-static uint8_t queue_enqueue(uint8_t prio, uint8_t ack_required, const uint8_t* packet, uint16_t len, uint16_t packet_id, uint16_t seq_ctrl) {
+static uint8_t queue_enqueue(PusLink_t* link, uint8_t service, uint8_t prio, uint8_t ack_required, const uint8_t* packet, uint16_t len, uint16_t packet_id, uint16_t seq_ctrl) {
     if (packet == NULL || len == 0 || len > PUS_MAX_PACKET_LEN) {
         return 0;
     }
 
-    int idx = queue_find_free();
+    int idx = queue_find_free(link);
     if (idx < 0) {
-        idx = queue_find_evict(prio);
+        link->dropped++;   // 放不下新消息，或淘汰一条旧消息
+        idx = queue_find_evict(link, prio);
         if (idx < 0) {
             return 0;
         }
-        queue_clear_slot(idx);
-    }
-
-    g_queue[idx].used = 1;
-    g_queue[idx].prio = prio;
-    g_queue[idx].ack_required = ack_required ? 1 : 0;
-    g_queue[idx].last_send_ms = 0;
-    g_queue[idx].retries = 0;
-    g_queue[idx].len = len;
-    g_queue[idx].packet_id = packet_id;
-    g_queue[idx].seq_ctrl = seq_ctrl;
-    memcpy(g_queue[idx].buf, packet, len);
+        queue_clear_slot(link, idx);
+    }
+
+    pus_msg_t* m = &link->queue[idx];
+    m->used = 1;
+    m->prio = prio;
+    m->service = service;
+    m->ack_required = ack_required ? 1 : 0;
+    m->last_send_ms = 0;
+    m->retries = 0;
+    m->len = len;
+    m->packet_id = packet_id;
+    m->seq_ctrl = seq_ctrl;
+    memcpy(m->buf, packet, len);
     return 1;
 }
 
-static void queue_ack(uint16_t packet_id, uint16_t seq_ctrl) {
+static void queue_ack(PusLink_t* link, uint16_t packet_id, uint16_t seq_ctrl) {
     for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
-        if (g_queue[i].used && g_queue[i].packet_id == packet_id && g_queue[i].seq_ctrl == seq_ctrl) {
-            queue_clear_slot(i);
+        const pus_msg_t* m = &link->queue[i];
+        if (m->used && m->packet_id == packet_id && m->seq_ctrl == seq_ctrl) {
+            queue_clear_slot(link, i);
             return;
         }
     }
 }
 
-static uint16_t alloc_tm_seq(void) {
-    uint16_t seq = (uint16_t)(g_tm_seq & 0x3FFF);
-    g_tm_seq = (uint16_t)((seq + 1) & 0x3FFF);
+static uint16_t alloc_tm_seq(PusLink_t* link) {
+    uint16_t* counter = (link->tm_seq_shared != NULL) ? link->tm_seq_shared : &link->tm_seq;
+    uint16_t seq = (uint16_t)(*counter & 0x3FFF);
+    *counter = (uint16_t)((seq + 1) & 0x3FFF);
     return seq;
 }
 
-static uint16_t alloc_tm_subcounter(void) {
-    uint16_t sc = g_tm_subcounter;
-    g_tm_subcounter = (uint16_t)(g_tm_subcounter + 1);
+static uint16_t alloc_tm_subcounter(PusLink_t* link) {
+    uint16_t sc = link->tm_subcounter;
+    link->tm_subcounter = (uint16_t)(link->tm_subcounter + 1);
     return sc;
 }
 
 static uint16_t build_tm_packet(
+    PusLink_t* link,
     uint8_t* out,
     uint16_t out_max,
     uint8_t service_type,
@@ -198,10 +189,10 @@ static uint16_t build_tm_packet(
         return 0;
     }
 
-    uint16_t seq_count = alloc_tm_seq();
-    uint16_t subcounter = alloc_tm_subcounter();
+    uint16_t seq_count = alloc_tm_seq(link);
+    uint16_t subcounter = alloc_tm_subcounter(link);
 
-    uint16_t packet_id = (uint16_t)(((CCSDS_VERSION & 0x7) << 13) | (0 << 12) | (1 << 11) | (g_apid & 0x07FF));
+    uint16_t packet_id = (uint16_t)(((CCSDS_VERSION & 0x7) << 13) | (0 << 12) | (1 << 11) | (link->apid & 0x07FF));
     uint16_t seq_ctrl = (uint16_t)(((CCSDS_SEQ_FLAG_UNSEGMENTED & 0x3) << 14) | (seq_count & 0x3FFF));
 
     uint16_t data_field_len = (uint16_t)(PUS_C_TM_SEC_LEN + user_len + PUS_C_CRC_LEN);
@@ -220,7 +211,7 @@ static uint16_t build_tm_packet(
     out[7] = service_type;
     out[8] = service_subtype;
     wr_u16(&out[9], subcounter);
-    wr_u16(&out[11], g_dest_id); /* DestId */
+    wr_u16(&out[11], link->dest_id); /* DestId */
 
     /* User data */
     if (user_len > 0 && user_data != NULL) {
@@ -240,15 +231,38 @@ static uint16_t build_tm_packet(
     return total_len;
 }
 
-static uint8_t send_packet_now(const uint8_t* packet, uint16_t len) {
-    if (!g_send_fn || !packet || len == 0) {
+static uint8_t send_packet_now(PusLink_t* link, const uint8_t* packet, uint16_t len) {
+    if (!link->send_fn || !packet || len == 0) {
+        return 0;
+    }
+    return link->send_fn(link->send_user, packet, len);
+}
+
+static uint8_t stream_usable(const PusLink_t* link) {
+    return (link->connected && link->send_fn != NULL) ? 1 : 0;
+}
+
+static uint8_t dgram_usable(const PusLink_t* link) {
+    return (link->dgram_ready && link->dgram_fn != NULL) ? 1 : 0;
+}
+
+/**
+ * @brief 该消息本次是否走数据报（已路由到数据报且数据报可用）
+ */
+static uint8_t route_is_dgram(const PusLink_t* link, const pus_msg_t* m) {
+    if (m->service >= 8 || !(link->dgram_services & (1u << m->service))) {
         return 0;
     }
-    return g_send_fn(packet, len);
+    return dgram_usable(link);
 }
 
-static void send_tc_verification(uint8_t subtype, uint16_t tc_packet_id, uint16_t tc_seq_ctrl) {
-    if (!g_connected) {
+/**
+ * @brief TC 回报以最高优先级入队，由下一次 Poll 发出
+ * @note  不在分帧回调里直接发送：FeedBytes 通常运行在驱动的 +IPD 投递回调中，
+ *        此时再调用传输层（AT+CIPSEND）会重入驱动的接收缓冲区。
+ */
+static void send_tc_verification(PusLink_t* link, uint8_t subtype, uint16_t tc_packet_id, uint16_t tc_seq_ctrl) {
+    if (!link->connected) {
         return;
     }
 
@@ -260,6 +274,7 @@ static void send_tc_verification(uint8_t subtype, uint16_t tc_packet_id, uint16_
     uint16_t tm_pid = 0;
     uint16_t tm_sc = 0;
     uint16_t n = build_tm_packet(
+        link,
         pkt,
         sizeof(pkt),
         PUS_SERVICE_TC_VERIFICATION,
@@ -272,7 +287,7 @@ static void send_tc_verification(uint8_t subtype, uint16_t tc_packet_id, uint16_
     if (n == 0) {
         return;
     }
-    send_packet_now(pkt, n);
+    queue_enqueue(link, PUS_SERVICE_TC_VERIFICATION, PUS_PRIO_TC_VERIFICATION, 0, pkt, n, tm_pid, tm_sc);
 }
 
 static uint8_t event_subtype_to_prio(uint8_t subtype) {
@@ -288,11 +303,6 @@ static uint8_t event_subtype_to_prio(uint8_t subtype) {
     return 0;
 }
 
-/* 接收缓冲：用于从字节流中拼出完整 PUS 包 */
-#define PUS_RX_BUF_SIZE 512
-static uint8_t g_rx_buf[PUS_RX_BUF_SIZE];
-static uint16_t g_rx_len = 0;
-
 static uint8_t looks_like_ccsds_header(const uint8_t* buf, uint16_t buf_len, uint16_t* out_total_len) {
     if (buf == NULL || buf_len < CCSDS_PRIMARY_HEADER_LEN) {
         return 0;
@@ -319,7 +329,7 @@ static uint8_t looks_like_ccsds_header(const uint8_t* buf, uint16_t buf_len, uin
     return 1;
 }
 
-static void handle_packet(const uint8_t* packet, uint16_t len) {
+static void handle_packet(PusLink_t* link, const uint8_t* packet, uint16_t len) {
     if (packet == NULL || len < (CCSDS_PRIMARY_HEADER_LEN + PUS_C_TC_SEC_LEN + PUS_C_CRC_LEN)) {
         return;
     }
@@ -371,98 +381,154 @@ static void handle_packet(const uint8_t* packet, uint16_t len) {
         if (user_len >= 4) {
             uint16_t tm_pid = rd_u16(&user_data[0]);
             uint16_t tm_sc = rd_u16(&user_data[2]);
-            queue_ack(tm_pid, tm_sc);
+            queue_ack(link, tm_pid, tm_sc);
         }
         return;
     }
 
-    /* 任务自定义：set_rate（129/1，user_data 为 JSON） */
+    /* 任务自定义：set_rate（129/1）、calibrate（129/3）、history（129/4）、telemetry（129/5）、sched（129/6），user_data 为 JSON */
     uint8_t need_accept = (ack & 0x01) ? 1 : 0;
     uint8_t need_completion = (ack & 0x08) ? 1 : 0;
 
-    uint8_t can_handle = (service_type == PUS_SERVICE_MISSION && service_subtype == MISSION_SUBTYPE_SET_RATE) ? 1 : 0;
+    uint8_t can_handle = (service_type == PUS_SERVICE_MISSION &&
+                          (service_subtype == MISSION_SUBTYPE_SET_RATE ||
+                           service_subtype == MISSION_SUBTYPE_CALIBRATE ||
+                           service_subtype == MISSION_SUBTYPE_HISTORY ||
+                           service_subtype == MISSION_SUBTYPE_TELEMETRY ||
+                           service_subtype == MISSION_SUBTYPE_SCHED)) ? 1 : 0;
     if (need_accept) {
-        send_tc_verification(can_handle ? PUS1_ACCEPTANCE_SUCCESS : PUS1_ACCEPTANCE_FAILURE, packet_id, seq_ctrl);
+        send_tc_verification(link, can_handle ? PUS1_ACCEPTANCE_SUCCESS : PUS1_ACCEPTANCE_FAILURE, packet_id, seq_ctrl);
     }
     if (!can_handle) {
         return;
     }
 
-    if (g_cmd_handler && user_len > 0) {
+    if (link->cmd_handler && user_len > 0) {
         char json_buf[256];
         uint16_t n = (user_len < (uint16_t)(sizeof(json_buf) - 1)) ? user_len : (uint16_t)(sizeof(json_buf) - 1);
         memcpy(json_buf, user_data, n);
         json_buf[n] = '\0';
-        g_cmd_handler(json_buf);
+        link->cmd_handler(json_buf);
     }
 
     if (need_completion) {
-        send_tc_verification(PUS1_COMPLETION_SUCCESS, packet_id, seq_ctrl);
+        send_tc_verification(link, PUS1_COMPLETION_SUCCESS, packet_id, seq_ctrl);
     }
 }
 
-void PusLink_Init(pus_link_send_fn_t send_fn, uint16_t apid, uint16_t source_id, uint16_t dest_id) {
-    g_send_fn = send_fn;
-    g_cmd_handler = NULL;
-    g_connected = 0;
-    g_tm_seq = 0;
-    g_tm_subcounter = 0;
-    g_apid = (uint16_t)(apid & 0x07FF);
-    g_source_id = source_id;
-    g_dest_id = dest_id;
-    g_rx_len = 0;
-    memset(g_rx_buf, 0, sizeof(g_rx_buf));
-    for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
-        queue_clear_slot(i);
+static void link_reset(PusLink_t* link, pus_link_send_ctx_fn_t send_fn, void* user, uint16_t apid, uint16_t source_id, uint16_t dest_id) {
+    memset(link, 0, sizeof(*link));
+    link->send_fn = send_fn;
+    link->send_user = user;
+    link->apid = (uint16_t)(apid & 0x07FF);
+    link->source_id = source_id;
+    link->dest_id = dest_id;
+}
+
+static uint8_t default_send(void* user, const uint8_t* data, uint16_t len) {
+    (void)user;
+    return g_default_send_fn ? g_default_send_fn(data, len) : 0;
+}
+
+void PusLinkCtx_Init(PusLink_t* link, pus_link_send_ctx_fn_t send_fn, void* user,
+                     uint16_t apid, uint16_t source_id, uint16_t dest_id) {
+    if (link == NULL) {
+        return;
     }
+    link_reset(link, send_fn, user, apid, source_id, dest_id);
 }
 
-void PusLink_SetConnected(uint8_t connected) {
-    g_connected = connected ? 1 : 0;
+void PusLinkCtx_SetConnected(PusLink_t* link, uint8_t connected) {
+    link->connected = connected ? 1 : 0;
 }
 
-void PusLink_SetCommandHandler(pus_link_cmd_handler_t handler) {
-    g_cmd_handler = handler;
+uint8_t PusLinkCtx_IsConnected(const PusLink_t* link) {
+    return link->connected;
 }
 
-void PusLink_FeedBytes(const uint8_t* data, uint16_t len) {
-    if (data == NULL || len == 0) {
+void PusLinkCtx_ShareSeqCounter(PusLink_t* link, uint16_t* counter) {
+    link->tm_seq_shared = counter;
+}
+
+void PusLinkCtx_SetDatagramTransport(PusLink_t* link, pus_link_send_ctx_fn_t send_fn, void* user) {
+    link->dgram_fn = send_fn;
+    link->dgram_user = user;
+}
+
+void PusLinkCtx_SetDatagramReady(PusLink_t* link, uint8_t ready) {
+    link->dgram_ready = ready ? 1 : 0;
+}
+
+void PusLinkCtx_RouteService(PusLink_t* link, uint8_t service_type, uint8_t route) {
+    if (service_type >= 8) {
         return;
     }
+    if (route == PUS_ROUTE_DATAGRAM) {
+        link->dgram_services |= (uint8_t)(1u << service_type);
+    } else {
+        link->dgram_services &= (uint8_t)~(1u << service_type);
+    }
+}
+
+void PusLinkCtx_SetCommandHandler(PusLink_t* link, pus_link_cmd_handler_t handler) {
+    link->cmd_handler = handler;
+}
 
+void PusLinkCtx_FeedBytes(PusLink_t* link, const uint8_t* data, uint16_t len) {
+    if (link == NULL || data == NULL || len == 0) {
+        return;
+    }
+
+    /*
+     * 增量分帧：先凑齐 6B 主头并校验，再把包体直接拷入 rx_buf 的对应位置，
+     * 每个输入字节只拷贝一次；失步时仅在 6B 主头内滑动 1 字节重新同步。
+     */
     while (len > 0) {
-        uint16_t space = (uint16_t)(sizeof(g_rx_buf) - g_rx_len);
-        uint16_t n = (len < space) ? len : space;
-        if (n == 0) {
-            /* 溢出：清空并重新同步 */
-            g_rx_len = 0;
-            break;
+        if (link->rx_len < CCSDS_PRIMARY_HEADER_LEN) {
+            uint16_t need = (uint16_t)(CCSDS_PRIMARY_HEADER_LEN - link->rx_len);
+            uint16_t n = (len < need) ? len : need;
+            memcpy(&link->rx_buf[link->rx_len], data, n);
+            link->rx_len = (uint16_t)(link->rx_len + n);
+            data += n;
+            len = (uint16_t)(len - n);
+
+            if (link->rx_len < CCSDS_PRIMARY_HEADER_LEN) {
+                break;
+            }
+            if (!looks_like_ccsds_header(link->rx_buf, link->rx_len, &link->rx_total)) {
+                /* 不像包头：丢 1 字节后继续找同步 */
+                memmove(link->rx_buf, &link->rx_buf[1], CCSDS_PRIMARY_HEADER_LEN - 1);
+                link->rx_len = CCSDS_PRIMARY_HEADER_LEN - 1;
+            }
+            continue;
         }
-        memcpy(&g_rx_buf[g_rx_len], data, n);
-        g_rx_len = (uint16_t)(g_rx_len + n);
+
+        uint16_t need = (uint16_t)(link->rx_total - link->rx_len);
+        uint16_t n = (len < need) ? len : need;
+        memcpy(&link->rx_buf[link->rx_len], data, n);
+        link->rx_len = (uint16_t)(link->rx_len + n);
         data += n;
         len = (uint16_t)(len - n);
 
-        while (g_rx_len >= CCSDS_PRIMARY_HEADER_LEN) {
-            uint16_t total = 0;
-            if (!looks_like_ccsds_header(g_rx_buf, g_rx_len, &total)) {
-                /* 不像包头：丢 1 字节后继续找同步 */
-                memmove(g_rx_buf, &g_rx_buf[1], (size_t)(g_rx_len - 1));
-                g_rx_len = (uint16_t)(g_rx_len - 1);
-                continue;
-            }
-            if (g_rx_len < total) {
-                break;
-            }
-            handle_packet(g_rx_buf, total);
-            memmove(g_rx_buf, &g_rx_buf[total], (size_t)(g_rx_len - total));
-            g_rx_len = (uint16_t)(g_rx_len - total);
+        if (link->rx_len == link->rx_total) {
+            handle_packet(link, link->rx_buf, link->rx_total);
+            link->rx_len = 0;
+            link->rx_total = 0;
         }
     }
 }
 
-uint8_t PusLink_QueueHousekeeping(const char* payload_json) {
-    if (payload_json == NULL) {
+void PusLinkCtx_FeedDatagram(PusLink_t* link, const uint8_t* data, uint16_t len) {
+    uint16_t total = 0;
+
+    if (link == NULL || data == NULL || !looks_like_ccsds_header(data, len, &total) || total != len) {
+        return;
+    }
+    handle_packet(link, data, len);
+}
+
+uint8_t PusLinkCtx_QueueHousekeeping(PusLink_t* link, const char* payload_json) {
+    if (link == NULL || payload_json == NULL) {
         return 0;
     }
     uint16_t user_len = (uint16_t)strlen(payload_json);
@@ -470,6 +536,7 @@ uint8_t PusLink_QueueHousekeeping(const char* payload_json) {
     uint16_t pid = 0;
     uint16_t sc = 0;
     uint16_t n = build_tm_packet(
+        link,
         pkt,
         sizeof(pkt),
         PUS_SERVICE_HOUSEKEEPING,
@@ -482,11 +549,12 @@ uint8_t PusLink_QueueHousekeeping(const char* payload_json) {
     if (n == 0) {
         return 0;
     }
-    return queue_enqueue(0, 0, pkt, n, pid, sc);
+    return queue_enqueue(link, PUS_SERVICE_HOUSEKEEPING, 0, 0, pkt, n, pid, sc);
 }
 
-uint8_t PusLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
-    if (payload_json == NULL) {
+uint8_t PusLinkCtx_QueueEventMulti(PusLink_t* const* links, uint8_t n_links,
+                                   uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
+    if (links == NULL || n_links == 0 || links[0] == NULL || payload_json == NULL) {
         return 0;
     }
     uint16_t user_len = (uint16_t)strlen(payload_json);
@@ -494,6 +562,7 @@ uint8_t PusLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint
     uint16_t pid = 0;
     uint16_t sc = 0;
     uint16_t n = build_tm_packet(
+        links[0],
         pkt,
         sizeof(pkt),
         PUS_SERVICE_EVENT_REPORTING,
@@ -506,31 +575,53 @@ uint8_t PusLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint
     if (n == 0) {
         return 0;
     }
+
     uint8_t prio = event_subtype_to_prio(event_subtype);
-    return queue_enqueue(prio, ack_required, pkt, n, pid, sc);
+    uint8_t queued = 0;
+    for (uint8_t i = 0; i < n_links; i++) {
+        if (links[i] != NULL) {
+            queued = (uint8_t)(queued + queue_enqueue(links[i], PUS_SERVICE_EVENT_REPORTING, prio, ack_required, pkt, n, pid, sc));
+        }
+    }
+    return queued;
 }
 
-uint8_t PusLink_Poll(void) {
-    if (!g_connected || g_send_fn == NULL) {
+uint8_t PusLinkCtx_QueueEvent(PusLink_t* link, uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
+    return PusLinkCtx_QueueEventMulti(&link, 1, event_subtype, payload_json, ack_required);
+}
+
+uint8_t PusLinkCtx_QueueDepth(const PusLink_t* link) {
+    uint8_t n = 0;
+    for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
+        if (link->queue[i].used) {
+            n++;
+        }
+    }
+    return n;
+}
+
+uint8_t PusLinkCtx_Poll(PusLink_t* link) {
+    if (link == NULL || (!stream_usable(link) && !dgram_usable(link))) {
         return 1;
     }
 
     uint32_t now = HAL_GetTick();
+    pus_msg_t* q = link->queue;
 
     int best_idx = -1;
     uint8_t best_prio = 0;
     uint8_t best_unsent = 0;
 
     for (int i = 0; i < PUS_QUEUE_SIZE; i++) {
-        if (!g_queue[i].used) {
+        if (!q[i].used) {
             continue;
         }
 
         uint8_t can_send = 0;
-        if (g_queue[i].last_send_ms == 0) {
+        if (q[i].last_send_ms == 0) {
             can_send = 1;
-        } else if (g_queue[i].ack_required) {
-            if ((now - g_queue[i].last_send_ms) >= PUS_RETRY_INTERVAL_MS && g_queue[i].retries < PUS_MAX_RETRIES) {
+        } else if (q[i].ack_required) {
+            if ((now - q[i].last_send_ms) >= PUS_RETRY_INTERVAL_MS && q[i].retries < PUS_MAX_RETRIES) {
                 can_send = 1;
             }
         }
@@ -538,24 +629,28 @@ uint8_t PusLink_Poll(void) {
         if (!can_send) {
             continue;
         }
+        /* 流断开时只有走数据报的消息能发 */
+        if (!route_is_dgram(link, &q[i]) && !stream_usable(link)) {
+            continue;
+        }
 
-        uint8_t unsent = (g_queue[i].last_send_ms == 0) ? 1 : 0;
+        uint8_t unsent = (q[i].last_send_ms == 0) ? 1 : 0;
 
         if (best_idx < 0) {
             best_idx = i;
-            best_prio = g_queue[i].prio;
+            best_prio = q[i].prio;
             best_unsent = unsent;
             continue;
         }
 
-        if (g_queue[i].prio > best_prio) {
+        if (q[i].prio > best_prio) {
             best_idx = i;
-            best_prio = g_queue[i].prio;
+            best_prio = q[i].prio;
             best_unsent = unsent;
             continue;
         }
 
-        if (g_queue[i].prio == best_prio && unsent > best_unsent) {
+        if (q[i].prio == best_prio && unsent > best_unsent) {
             best_idx = i;
             best_unsent = unsent;
             continue;
@@ -566,18 +661,66 @@ uint8_t PusLink_Poll(void) {
         return 1;
     }
 
-    uint8_t ok = send_packet_now(g_queue[best_idx].buf, g_queue[best_idx].len);
-    if (!ok) {
+    /* 发送期间可能收到下行数据（TM-ACK 清除/新回报入队改写槽位），先拷出再发 */
+    uint8_t pkt[PUS_MAX_PACKET_LEN];
+    uint16_t len = q[best_idx].len;
+    uint16_t pid = q[best_idx].packet_id;
+    uint16_t sc = q[best_idx].seq_ctrl;
+    memcpy(pkt, q[best_idx].buf, len);
+    if (route_is_dgram(link, &q[best_idx])) {
+        if (!link->dgram_fn(link->dgram_user, pkt, len)) {
+            /* 数据报不可用：保留该消息，之后回落到流传输 */
+            link->dgram_failed++;
+            link->dgram_ready = 0;
+            return 1;
+        }
+        link->dgram_sent++;
+    } else if (!send_packet_now(link, pkt, len)) {
         return 0;
     }
 
-    g_queue[best_idx].last_send_ms = now;
-    if (g_queue[best_idx].ack_required) {
-        if (g_queue[best_idx].retries < 255) {
-            g_queue[best_idx].retries++;
+    /* 槽位已被清除或改写则不再更新 */
+    if (!q[best_idx].used || q[best_idx].packet_id != pid || q[best_idx].seq_ctrl != sc) {
+        return 1;
+    }
+    q[best_idx].last_send_ms = now;
+    if (q[best_idx].ack_required) {
+        if (q[best_idx].retries < 255) {
+            q[best_idx].retries++;
         }
     } else {
-        queue_clear_slot(best_idx);
+        queue_clear_slot(link, best_idx);
     }
     return 1;
 }
+
+/* ----------------- 默认上下文 ----------------- */
+
+void PusLink_Init(pus_link_send_fn_t send_fn, uint16_t apid, uint16_t source_id, uint16_t dest_id) {
+    g_default_send_fn = send_fn;
+    link_reset(&g_default, default_send, NULL, apid, source_id, dest_id);
+}
+
+void PusLink_SetConnected(uint8_t connected) {
+    PusLinkCtx_SetConnected(&g_default, connected);
+}
+
+void PusLink_SetCommandHandler(pus_link_cmd_handler_t handler) {
+    PusLinkCtx_SetCommandHandler(&g_default, handler);
+}
+
+void PusLink_FeedBytes(const uint8_t* data, uint16_t len) {
+    PusLinkCtx_FeedBytes(&g_default, data, len);
+}
+
+uint8_t PusLink_QueueHousekeeping(const char* payload_json) {
+    return PusLinkCtx_QueueHousekeeping(&g_default, payload_json);
+}
+
+uint8_t PusLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint8_t ack_required) {
+    return PusLinkCtx_QueueEvent(&g_default, event_subtype, payload_json, ack_required);
+}
+
+uint8_t PusLink_Poll(void) {
+    return PusLinkCtx_Poll(&g_default);
+}
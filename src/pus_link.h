@@ -7,26 +7,89 @@
  * ECSS PUS-C（70-41C）星地应用层协议（SpaceNose Profile）
  *
  * - 上行：TM（Housekeeping 3/25；Event 5/1~4；TC Verification 1/*）
- * - 下行：TC（任务自定义 129/1 set_rate；129/2 TM-ACK）
+ * - 下行：TC（任务自定义 129/1 set_rate；129/2 TM-ACK；129/3 calibrate；129/4 history；129/5 telemetry；129/6 sched）
  *
  * 该模块负责：
  * - 断链缓存：消息队列（ring buffer）
- * - 优先级：高优先级先发（事件 > 遥测）
+ * - 优先级：高优先级先发（TC 回报 > 事件 > 遥测）
  * - 事件可靠下传：事件 TM 可要求地面回 TM-ACK（129/2），未收到会重传
  * - TC 接收：解析 TC 并回 Service 1 verification
  *
  * 传输层由上层注入 send_fn（可接 TCP/LoRa/串口等）。
+ * 另可注入一个数据报传输（UDP，一包一个数据报），按服务类型选择走哪条：
+ * 例如 HK 走 UDP 尽力而为，事件与 TC 回报仍走可靠流。数据报不可用时自动回落到流。
+ *
+ * 每条链路的全部状态（队列、分帧缓冲、序号）都在 PusLink_t 中，
+ * 多个地面站各用一个上下文（PusLinkCtx_*）；PusLink_* 操作内置的默认上下文，
+ * 供单链路场景使用。
  */
 
+#ifndef PUS_QUEUE_SIZE
+#define PUS_QUEUE_SIZE 16       // 每条链路的发送队列深度
+#endif
+#define PUS_MAX_PACKET_LEN 256
+#define PUS_MAX_TM_JSON_LEN (PUS_MAX_PACKET_LEN - 15)   // TM 用户数据上限：主头 6 + 副头 7 + CRC 2
+#define PUS_RX_BUF_SIZE 512     // 接收分帧缓冲
+
 typedef uint8_t (*pus_link_send_fn_t)(const uint8_t* data, uint16_t len);
+typedef uint8_t (*pus_link_send_ctx_fn_t)(void* user, const uint8_t* data, uint16_t len);
 typedef void (*pus_link_cmd_handler_t)(const char* json_cmd);
 
+/* 传输路由（PusLinkCtx_RouteService） */
+#define PUS_ROUTE_STREAM 0      // 走 send_fn（默认）
+#define PUS_ROUTE_DATAGRAM 1    // 走数据报传输
+
 /* Service 5（Event reporting）subtype: severity */
 #define PUS5_EVENT_INFO 1
 #define PUS5_EVENT_LOW 2
 #define PUS5_EVENT_MEDIUM 3
 #define PUS5_EVENT_HIGH 4
 
+/* 队列中的一条待发 TM */
+typedef struct {
+    uint8_t used;
+    uint8_t prio;
+    uint8_t service;      // PUS 服务类型（决定走哪条传输）
+    uint8_t ack_required;
+    uint32_t last_send_ms;
+    uint8_t retries;
+    uint16_t len;
+    uint16_t packet_id;
+    uint16_t seq_ctrl;
+    uint8_t buf[PUS_MAX_PACKET_LEN];
+} pus_msg_t;
+
+/* 一条 PUS 链路的上下文（由调用方分配，PusLinkCtx_Init 初始化） */
+typedef struct {
+    pus_link_send_ctx_fn_t send_fn;
+    void* send_user;
+    pus_link_cmd_handler_t cmd_handler;
+    uint8_t connected;
+
+    pus_link_send_ctx_fn_t dgram_fn;
+    void* dgram_user;
+    uint8_t dgram_ready;
+    uint8_t dgram_services;   // 走数据报的服务类型位图（bit n = 服务 n，n < 8）
+    uint32_t dgram_sent;
+    uint32_t dgram_failed;
+
+    uint16_t tm_seq;
+    uint16_t* tm_seq_shared;   // 非 NULL 时改用该计数器（同一设备的多条链路共用序号）
+    uint16_t tm_subcounter;
+    uint16_t apid;
+    uint16_t source_id;
+    uint16_t dest_id;
+
+    pus_msg_t queue[PUS_QUEUE_SIZE];
+    uint32_t dropped;     // 队列满时被淘汰或未能入队的 TM（断链缓存溢出）
+
+    uint8_t rx_buf[PUS_RX_BUF_SIZE];
+    uint16_t rx_len;
+    uint16_t rx_total;    // 当前包总长（主头校验通过后有效）
+} PusLink_t;
+
+/* ----------------- 默认上下文（单链路） ----------------- */
+
 void PusLink_Init(pus_link_send_fn_t send_fn, uint16_t apid, uint16_t source_id, uint16_t dest_id);
 void PusLink_SetConnected(uint8_t connected);
 void PusLink_SetCommandHandler(pus_link_cmd_handler_t handler);
@@ -41,5 +104,61 @@ uint8_t PusLink_QueueEvent(uint8_t event_subtype, const char* payload_json, uint
 /* 在主循环中周期调用：发送队列中待发消息（一次最多发一条） */
 uint8_t PusLink_Poll(void);
 
-#endif /* __PUS_LINK_H */
+/* ----------------- 指定上下文（多链路） ----------------- */
+
+/**
+ * @brief 初始化一条链路
+ * @param send_fn 发送函数，user 原样传回（例如连接号）
+ */
+void PusLinkCtx_Init(PusLink_t* link, pus_link_send_ctx_fn_t send_fn, void* user,
+                     uint16_t apid, uint16_t source_id, uint16_t dest_id);
+void PusLinkCtx_SetConnected(PusLink_t* link, uint8_t connected);
+uint8_t PusLinkCtx_IsConnected(const PusLink_t* link);
+void PusLinkCtx_SetCommandHandler(PusLink_t* link, pus_link_cmd_handler_t handler);
+
+/**
+ * @brief 让链路使用外部的 TM 序号计数器
+ * @note  同一设备（同一 APID）的多条链路共用一个计数器，各站看到的序号单调且不重复；
+ *        counter 为 NULL 时恢复使用链路自身的计数器。
+ */
+void PusLinkCtx_ShareSeqCounter(PusLink_t* link, uint16_t* counter);
+void PusLinkCtx_FeedBytes(PusLink_t* link, const uint8_t* data, uint16_t len);
+uint8_t PusLinkCtx_QueueHousekeeping(PusLink_t* link, const char* payload_json);
+uint8_t PusLinkCtx_QueueEvent(PusLink_t* link, uint8_t event_subtype, const char* payload_json, uint8_t ack_required);
+uint8_t PusLinkCtx_Poll(PusLink_t* link);
 
+/**
+ * @brief 注入数据报传输（一包一个数据报，失败不重试，由流传输补发）
+ */
+void PusLinkCtx_SetDatagramTransport(PusLink_t* link, pus_link_send_ctx_fn_t send_fn, void* user);
+void PusLinkCtx_SetDatagramReady(PusLink_t* link, uint8_t ready);
+
+/**
+ * @brief 输入一个完整的下行数据报：一个数据报恰好是一个包，不经流式分帧器，
+ *        长度与包头不符即整个丢弃（流上正在拼接的半包不受影响）
+ */
+void PusLinkCtx_FeedDatagram(PusLink_t* link, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief 设置某服务类型的上行传输
+ * @param service_type 1 / 3 / 5（仅支持 < 8 的服务号）
+ * @param route PUS_ROUTE_STREAM / PUS_ROUTE_DATAGRAM
+ * @note  需要 TM-ACK 的事件走数据报时仍按 ACK 超时重传
+ */
+void PusLinkCtx_RouteService(PusLink_t* link, uint8_t service_type, uint8_t route);
+
+/**
+ * @brief 队列中待发（含等待 ACK）的消息数
+ */
+uint8_t PusLinkCtx_QueueDepth(const PusLink_t* link);
+
+/**
+ * @brief 同一事件复制到多条链路
+ * @note  只组包一次（序号取自 links[0] 的计数器，多站时即共享计数器），各链路入队
+ *        完全相同的字节，地面按 (APID, 序号, 用户数据) 去重；每条链路各自等待本站的 TM-ACK。
+ * @return 成功入队的链路数
+ */
+uint8_t PusLinkCtx_QueueEventMulti(PusLink_t* const* links, uint8_t n_links,
+                                   uint8_t event_subtype, const char* payload_json, uint8_t ack_required);
+
+#endif /* __PUS_LINK_H */
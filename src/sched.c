@@ -0,0 +1,195 @@
+/**
+ ******************************************************************************
+ * @file           : sched.c
+ * @brief          : 协作式调度器实现
+ ******************************************************************************
+ */
+
+#include "sched.h"
+#include "stm32f4xx_hal.h"
+#include "dlog.h"
+
+#include <string.h>
+
+typedef struct {
+    SchedStats_t st;
+    SchedTaskFn_t fn;
+    uint32_t release;             // 下次周期释放时刻
+    uint32_t last_release;        // 上次周期释放时刻
+    uint8_t deadline_auto;        // 截止时间随周期变化（登记时 deadline_ms = 0）
+    volatile uint8_t triggered;   // Sched_Trigger 请求，运行一次后清除
+} SchedTask_t;
+
+static SchedTask_t g_tasks[SCHED_MAX_TASKS];
+static uint8_t g_task_count = 0;
+static uint32_t g_cycles_per_us = 0;
+static uint32_t g_window_start = 0;   // 统计窗口起点（ms）
+static uint64_t g_busy_us = 0;
+
+void Sched_Init(uint32_t cycles_per_us) {
+    memset(g_tasks, 0, sizeof(g_tasks));
+    g_task_count = 0;
+    g_cycles_per_us = cycles_per_us;
+    g_window_start = HAL_GetTick();
+    g_busy_us = 0;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+int8_t Sched_Add(const char* name, SchedTaskFn_t fn, uint32_t period_ms, uint32_t deadline_ms) {
+    if (g_task_count >= SCHED_MAX_TASKS || fn == NULL || (period_ms == 0 && deadline_ms == 0)) {
+        return -1;
+    }
+    SchedTask_t* t = &g_tasks[g_task_count];
+    memset(t, 0, sizeof(*t));
+    t->st.name = name;
+    t->st.period_ms = period_ms;
+    t->st.deadline_ms = (deadline_ms != 0) ? deadline_ms : period_ms;
+    t->deadline_auto = (deadline_ms == 0) ? 1 : 0;
+    t->fn = fn;
+    t->release = HAL_GetTick();
+    t->last_release = t->release - period_ms;
+    return (int8_t)g_task_count++;
+}
+
+void Sched_SetPeriod(int8_t id, uint32_t period_ms) {
+    if (id < 0 || id >= g_task_count) {
+        return;
+    }
+    SchedTask_t* t = &g_tasks[id];
+    uint32_t old = t->st.period_ms;
+    if (period_ms == old || (period_ms == 0 && t->deadline_auto)) {
+        return;
+    }
+    /* 任务运行期间调用也成立：运行前 release 已前移，last_release 即本次释放。
+     * 触发运行（Sched_Trigger）不更新 last_release，按上次周期释放算出的时刻可能早已过去：
+     * 此时从当前时刻起算，立即运行但不计为迟到 */
+    uint32_t now = HAL_GetTick();
+    t->release = (old != 0) ? t->last_release + period_ms : now;
+    if ((int32_t)(t->release - now) < 0) {
+        t->release = now;
+    }
+    t->st.period_ms = period_ms;
+    if (t->deadline_auto) {
+        t->st.deadline_ms = period_ms;
+    }
+}
+
+void Sched_Trigger(int8_t id) {
+    if (id >= 0 && id < g_task_count) {
+        g_tasks[id].triggered = 1;
+    }
+}
+
+uint8_t Sched_RunOnce(void) {
+    uint32_t now = HAL_GetTick();
+    int8_t best = -1;
+    uint32_t best_deadline = 0;
+    uint32_t best_release = 0;
+
+    for (uint8_t i = 0; i < g_task_count; i++) {
+        SchedTask_t* t = &g_tasks[i];
+        uint32_t release;
+        if (t->st.period_ms != 0 && (int32_t)(now - t->release) >= 0) {
+            release = t->release;
+        } else if (t->triggered) {
+            release = now;
+        } else {
+            continue;
+        }
+        uint32_t deadline = release + t->st.deadline_ms;
+        if (best < 0 || (int32_t)(deadline - best_deadline) < 0) {
+            best = (int8_t)i;
+            best_deadline = deadline;
+            best_release = release;
+        }
+    }
+    if (best < 0) {
+        return 0;
+    }
+
+    SchedTask_t* t = &g_tasks[best];
+    uint32_t late = now - best_release;
+    if ((int32_t)(now - best_deadline) > 0) {
+        t->st.misses++;
+        if (late > t->st.late_max_ms) {
+            DLOG(SCHED_MISS, t->st.name, (unsigned long)late);   // 只记录创新高的超限，阻塞发送期间不刷屏
+        }
+    }
+    if (late > t->st.late_max_ms) {
+        t->st.late_max_ms = late;
+    }
+
+    t->triggered = 0;
+    uint8_t periodic = (t->st.period_ms != 0 && (int32_t)(now - t->release) >= 0) ? 1 : 0;
+    if (periodic) {
+        t->last_release = t->release;
+        t->release += t->st.period_ms;
+    }
+    uint32_t c0 = DWT->CYCCNT;
+    t->fn();
+    uint32_t c1 = DWT->CYCCNT;
+    uint32_t end = HAL_GetTick();
+
+    /* CYCCNT 在 168 MHz 下约 25 s 回绕：超过 1 s 的运行改用毫秒节拍 */
+    uint32_t ms = end - now;
+    uint32_t us = (g_cycles_per_us != 0) ? (c1 - c0) / g_cycles_per_us : 0;
+    if (ms > 1000u || us == 0u) {
+        us = ms * 1000u;
+    }
+    t->st.runs++;
+    t->st.run_us_last = us;
+    t->st.run_us_total += us;
+    if (us > t->st.run_us_max) {
+        t->st.run_us_max = us;
+    }
+    g_busy_us += us;
+
+    /* 周期释放按固定节拍前移；落后整个周期以上时不补跑，从当前时刻重新起算 */
+    if (periodic && t->st.period_ms != 0 && (int32_t)(end - t->release) >= (int32_t)t->st.period_ms) {
+        t->release = end;
+    }
+    return 1;
+}
+
+void Sched_Run(void) {
+    for (;;) {
+        if (!Sched_RunOnce()) {
+            __WFI();   // SysTick（1 ms）或外设中断唤醒
+        }
+    }
+}
+
+uint8_t Sched_TaskCount(void) {
+    return g_task_count;
+}
+
+uint8_t Sched_GetStats(int8_t id, SchedStats_t* out) {
+    if (id < 0 || id >= g_task_count || out == NULL) {
+        return 0;
+    }
+    *out = g_tasks[id].st;
+    return 1;
+}
+
+float Sched_Load(void) {
+    uint32_t elapsed_ms = HAL_GetTick() - g_window_start;
+    if (elapsed_ms == 0) {
+        return 0.0f;
+    }
+    return (float)((double)g_busy_us / 10.0 / (double)elapsed_ms);
+}
+
+void Sched_ResetStats(void) {
+    for (uint8_t i = 0; i < g_task_count; i++) {
+        SchedStats_t* st = &g_tasks[i].st;
+        st->runs = 0;
+        st->misses = 0;
+        st->late_max_ms = 0;
+        st->run_us_last = 0;
+        st->run_us_max = 0;
+        st->run_us_total = 0;
+    }
+    g_busy_us = 0;
+    g_window_start = HAL_GetTick();
+}
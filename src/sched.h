@@ -0,0 +1,93 @@
+/**
+ ******************************************************************************
+ * @file           : sched.h
+ * @brief          : 节拍驱动的协作式调度器（运行到完成，无抢占）
+ ******************************************************************************
+ * @description    : 主循环拆成若干周期任务（采样、PUS 发送、TC 接收、网络监护、日志），
+ *                   各自按周期释放，互不等待：
+ *                   - 时间基准为 HAL_GetTick（SysTick 1 ms）；空闲时 __WFI，
+ *                     SysTick / ADC / UART 中断唤醒；
+ *                   - 多个任务同时到期时先运行绝对截止时间（释放时刻 + deadline）最早的；
+ *                   - 任务按固定节拍释放（不随运行耗时漂移），错过整个周期时不补跑，
+ *                     从当前时刻重新起算；
+ *                   - Sched_Trigger 可在中断中调用，使任务尽快运行一次（如模拟看门狗越限
+ *                     立即采样），不改变其周期节拍；
+ *                   - 逐任务统计：运行次数、耗时（DWT 周期计数换算为 µs，平均/最大）、
+ *                     释放到开始运行的延迟与截止时间超限次数。
+ *
+ *                   任务函数必须尽快返回；仍会阻塞数秒的操作（ESP8266 连网）在它运行期间
+ *                   推迟其余任务，超限计入统计。
+ ******************************************************************************
+ */
+
+#ifndef __SCHED_H
+#define __SCHED_H
+
+#include <stdint.h>
+
+#define SCHED_MAX_TASKS 8
+
+typedef void (*SchedTaskFn_t)(void);
+
+/* 单个任务的运行统计 */
+typedef struct {
+    const char* name;
+    uint32_t period_ms;
+    uint32_t deadline_ms;
+    uint32_t runs;
+    uint32_t misses;              // 开始运行时已超过截止时间的次数
+    uint32_t late_max_ms;         // 释放到开始运行的最大延迟
+    uint32_t run_us_last;
+    uint32_t run_us_max;
+    uint64_t run_us_total;
+} SchedStats_t;
+
+/**
+ * @brief 初始化调度器并开启 DWT 周期计数
+ * @param cycles_per_us CPU 主频（MHz），用于把周期数换算为 µs；主机端 DWT 不计数，耗时统计为 0
+ */
+void Sched_Init(uint32_t cycles_per_us);
+
+/**
+ * @brief 登记一个任务，首次在登记后立即释放
+ * @param period_ms   释放周期；0 表示只由 Sched_Trigger 触发
+ * @param deadline_ms 释放后必须开始运行的期限；0 表示等于周期
+ * @return 任务号；表满或参数无效时返回 -1
+ */
+int8_t Sched_Add(const char* name, SchedTaskFn_t fn, uint32_t period_ms, uint32_t deadline_ms);
+
+/**
+ * @brief 修改周期：下次释放 = 上次释放 + 新周期（已过则立即释放），缩短周期不必等旧周期走完
+ */
+void Sched_SetPeriod(int8_t id, uint32_t period_ms);
+
+/**
+ * @brief 请求任务尽快运行一次（可在中断中调用）
+ */
+void Sched_Trigger(int8_t id);
+
+/**
+ * @brief 运行一个到期任务
+ * @return 1: 运行了一个任务; 0: 没有到期任务
+ */
+uint8_t Sched_RunOnce(void);
+
+/**
+ * @brief 调度主循环（不返回）：依次运行到期任务，没有到期任务时休眠等待中断
+ */
+void Sched_Run(void);
+
+uint8_t Sched_TaskCount(void);
+uint8_t Sched_GetStats(int8_t id, SchedStats_t* out);
+
+/**
+ * @brief 统计窗口内任务运行时间占比（%，按毫秒节拍计的墙钟时间）
+ */
+float Sched_Load(void);
+
+/**
+ * @brief 清零全部任务统计并重新开始统计窗口
+ */
+void Sched_ResetStats(void);
+
+#endif /* __SCHED_H */
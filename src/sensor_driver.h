@@ -0,0 +1,35 @@
+/**
+ ******************************************************************************
+ * @file           : sensor_driver.h
+ * @brief          : 传感器驱动接口（虚函数表）
+ ******************************************************************************
+ * @description    : sensor_manager 按注册表（sensor_table.h）逐个调用驱动：
+ *                     poll → sample → convert → status
+ *                   一个驱动实例服务注册表中所有使用它的行，行号（SensorType_t）
+ *                   作为参数传入，驱动自己的状态按行号下标存放。
+ *                   可选项为 NULL 表示不支持。
+ ******************************************************************************
+ */
+
+#ifndef __SENSOR_DRIVER_H
+#define __SENSOR_DRIVER_H
+
+#include "sensor_manager.h"
+
+typedef struct SensorDriver {
+    const char* name;                                                       // 驱动名（日志用）
+    void (*init)(SensorType_t id);
+    void (*poll)(SensorType_t id);                                          // 可选：每次更新前调用（后台任务/超时）
+    uint8_t (*sample)(SensorType_t id, uint16_t* code, uint32_t* tick);     // 取最新样本码值，0 表示尚无数据
+    void (*convert)(SensorType_t id, uint16_t code, SensorData_t* data);    // 码值 → 电压/浓度
+    SensorStatus_t (*status)(SensorType_t id, const SensorData_t* data);    // 预热/就绪判定
+    void (*on_sample_isr)(SensorType_t id, uint16_t code);                  // 可选：每个过采样输出（中断上下文）
+    uint8_t (*calibrate)(SensorType_t id);                                  // 可选：启动后台校准
+    bool (*take_cal_result)(SensorType_t id, SensorCalResult_t* out);       // 可选：取走校准结果
+    uint16_t (*code_for_ppm)(SensorType_t id, float ppm);                   // 可选：浓度 → 12 位原始码值（硬件阈值）
+} SensorDriver_t;
+
+/* 驱动实例（注册表“驱动”列 xxx 对应 g_sensor_driver_xxx） */
+extern const SensorDriver_t g_sensor_driver_mq;
+
+#endif /* __SENSOR_DRIVER_H */
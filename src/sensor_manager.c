@@ -9,48 +9,172 @@
  */
 
 #include "sensor_manager.h"
-#include <math.h>
+#include "sensor_driver.h"
+#include "adc_scan.h"
+#include "oversample.h"
+#include "history.h"
+#include "anomaly.h"
+#include "deadband.h"
+#include "exposure.h"
+#include "tinyml.h"
+#include "gas_model_weights.h"
+#include "tm_writer.h"
 #include <stdio.h>
+#include <string.h>
+
+/* 过采样抽取：扫描 ADC_SCAN_DEFAULT_RATE_HZ 帧/秒，每 N 帧输出一个样本
+ * N=16 → 14位，N=64 → 15位，N=256 → 16位；1000帧/秒、N=256 时约 3.9 个输出/秒 */
+#define SENSOR_OVERSAMPLE_N     256
+#define SENSOR_OVERSAMPLE_ORDER 1       // 1: boxcar 累加平均；2~3: CIC
+
+#define SENSOR_HISTORY_PAGE     16      // 每页最多读出的历史记录（实际条数受缓冲区限制）
+
+/* 异常检测：α = 1/32（约 8 s 时间常数），预热 16 个样本，σ 下限 4 LSB（16 位码值） */
+#define SENSOR_ANOMALY_SHIFT    5
+#define SENSOR_ANOMALY_WARMUP   16
+#define SENSOR_ANOMALY_MIN_SIGMA 4
+#define SENSOR_ANOMALY_Z        4.0f
+
+/* 暴露事件特征：高出基线 24 个 12 位 LSB（约 20 mV）判定开始，最长 10 分钟 */
+#define SENSOR_EXPOSURE_ON_LSB  24
+#define SENSOR_EXPOSURE_MAX_MS  600000u
+
+/* HK 死区默认值（TC 129/5 可按字段修改）：宽度 max(abs, rel·|上次下传值|) */
+#define SENSOR_DB_ADC_ABS       8.0f    // 12 位码值
+#define SENSOR_DB_VOLTAGE_ABS   0.005f  // V
+#define SENSOR_DB_PPM_ABS       1.0f    // ppm
+#define SENSOR_DB_PPM_REL       0.05f
+
+/* 每个传感器参与死区判定的 HK 字段 */
+enum {
+    SENSOR_FIELD_ADC = 0,         // <key>_adc
+    SENSOR_FIELD_VOLTAGE,         // <key>_voltage
+    SENSOR_FIELD_PPM,             // ppm_key
+    SENSOR_FIELD_COUNT
+};
+
+/* 板上分类器预算（168 MHz）：单次推理 ≤ 1 ms；工作区 + 输入窗口 ≤ 1 KB */
+#define SENSOR_CLASSIFY_CYCLE_BUDGET 168000u
+#define SENSOR_CLASSIFY_RAM_BUDGET   1024u
+#define SENSOR_CLASSIFY_WINDOW       (GAS_MODEL_IN_FEATURES * GAS_MODEL_SEQ_LEN)
+
+#if GAS_MODEL_ARENA_BYTES + SENSOR_CLASSIFY_WINDOW > SENSOR_CLASSIFY_RAM_BUDGET
+#error "板上分类器超出 RAM 预算，请缩小模型后重新导出（tools/tinyml_export.py）"
+#endif
+
+/* 注册表展开 */
+static const SensorDesc_t k_sensors[SENSOR_TYPE_MAX] = {
+#define SENSOR_ENTRY(id, drv, ch, a, b, rl, r0, ppm_max, preheat_ms, hk_key, ppm_key) \
+    {#id, &g_sensor_driver_##drv, ch, a, b, rl, r0, ppm_max, preheat_ms, hk_key, ppm_key},
+#include "sensor_table.h"
+#undef SENSOR_ENTRY
+};
 
 /* 私有变量 */
-static ADC_HandleTypeDef* g_hadc = NULL;
-static MQ3_Config_t mq3_config = {0};
+static Oversample_t g_adc_filters[ADC_SCAN_NUM_CHANNELS];   // 每个扫描通道一个过采样滤波器
+static int8_t g_scan_index[SENSOR_TYPE_MAX];                 // 传感器通道在扫描帧中的下标
+static History_t g_history[SENSOR_TYPE_MAX];                 // 中断中推入，主循环关中断读取
+static Anomaly_t g_anomaly[SENSOR_TYPE_MAX];                 // 同上；只在传感器正常时学习
+static Deadband_t g_deadband[SENSOR_TYPE_MAX][SENSOR_FIELD_COUNT];   // 参考值为上次下传的 HK
+static Exposure_t g_exposure[SENSOR_TYPE_MAX];               // 中断中推入，主循环关中断取走结果
+
+static int8_t g_classify_arena[GAS_MODEL_ARENA_BYTES];
+static int8_t g_classify_input[SENSOR_CLASSIFY_WINDOW];
+static int8_t g_classify_sensor[GAS_MODEL_IN_FEATURES];     // 模型输入通道 → 传感器编号，-1 表示缺失
+static bool g_classify_enabled = false;
+static SensorClassification_t g_classification;
+
+static void SensorManager_Classify(void);
 
 /* 全局传感器数据数组 */
 SensorData_t g_sensor_data[SENSOR_TYPE_MAX] = {0};
 
-/* MQ-3 校准参数 */
-#define MQ3_RL_VALUE            10.0f   // 负载电阻 (kΩ)
-#define MQ3_R0_CLEAN_AIR        60.0f   // 清洁空气中的R0基准值 (kΩ)
-#define MQ3_PREHEAT_TIME_MS     180000  // 预热时间：3分钟（正式使用需20小时）
-#define MQ3_ADC_CHANNEL         ADC_CHANNEL_5  // 使用PA5 (ADC1_CH5)
-#define MQ3_STABLE_WINDOW_MS    90000   // 稳定性检测窗口时长（采样周期为5s时，覆盖~18次采样）
-#define MQ3_STABLE_DELTA_ADC    15      // 窗口内ADC最大波动阈值（越小越严格）
+/**
+ * @brief  扫描帧钩子（DMA 中断中逐帧调用）：各通道原始值送入过采样滤波器，
+ *         有新输出的通道记入历史、送入异常检测与暴露特征提取，并转交给对应传感器驱动（如后台校准）
+ */
+static void SensorManager_OnScanFrame(const volatile uint16_t* raw)
+{
+    uint32_t new_output = 0;
 
-/* 电压分压比（根据你的硬件电路调整） */
-// 方案：10kΩ（上臂，靠近AO） + 15kΩ（下臂，接地） ⇒ 5V → 3.0V，ADC安全
-#define VOLTAGE_DIVIDER_RATIO   (5.0f / 3.0f)    // ≈1.6667，分压后最大约3.0V
-#define ADC_VREF                3.3f    // STM32参考电压
-#define ADC_RESOLUTION          4096.0f // 12位ADC
+    for (uint8_t i = 0; i < ADC_SCAN_NUM_CHANNELS; i++) {
+        if (Oversample_Push(&g_adc_filters[i], raw[i])) {
+            new_output |= 1u << i;
+        }
+    }
+    if (new_output == 0) {
+        return;
+    }
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        int8_t ch = g_scan_index[id];
+        if (ch < 0 || (new_output & (1u << ch)) == 0) {
+            continue;
+        }
+        History_Push(&g_history[id], g_adc_filters[ch].out, HAL_GetTick());
+        if (g_sensor_data[id].status == SENSOR_STATUS_OK) {
+            (void)Anomaly_Push(&g_anomaly[id], g_adc_filters[ch].out, HAL_GetTick());
+            (void)Exposure_Push(&g_exposure[id], g_adc_filters[ch].out, HAL_GetTick());
+        } else if (g_anomaly[id].seen != 0 || g_exposure[id].started) {
+            /* 预热/故障期间的漂移不是异常也不是暴露，恢复后重新学习基线 */
+            Anomaly_Reset(&g_anomaly[id]);
+            Exposure_Reset(&g_exposure[id]);
+        }
+        if (k_sensors[id].driver->on_sample_isr != NULL) {
+            k_sensors[id].driver->on_sample_isr((SensorType_t)id, g_adc_filters[ch].out);
+        }
+    }
+}
 
 /**
  * @brief  传感器管理器初始化
- * @param  hadc: ADC句柄
+ * @note   ADC 由 adc_scan 模块定时扫描（需先 AdcScan_Init/AdcScan_Start），
+ *         这里为每个扫描通道挂接过采样滤波器，再逐个初始化注册表中的传感器
  */
-void SensorManager_Init(ADC_HandleTypeDef* hadc)
+void SensorManager_Init(void)
 {
-    g_hadc = hadc;
-
-    /* 初始化所有传感器数据 */
-    for (int i = 0; i < SENSOR_TYPE_MAX; i++) {
-        g_sensor_data[i].type = i;
-        g_sensor_data[i].status = SENSOR_STATUS_NOT_READY;
+    for (uint8_t i = 0; i < ADC_SCAN_NUM_CHANNELS; i++) {
+        if (!Oversample_Init(&g_adc_filters[i], SENSOR_OVERSAMPLE_N, SENSOR_OVERSAMPLE_ORDER)) {
+            printf("[传感器管理器] 过采样参数不合法\r\n");
+        }
     }
 
-    /* 初始化MQ-3 */
-    MQ3_Init(MQ3_ADC_CHANNEL);
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        g_sensor_data[id].type = (SensorType_t)id;
+        g_sensor_data[id].status = SENSOR_STATUS_NOT_READY;
+        g_scan_index[id] = AdcScan_ChannelIndex(k_sensors[id].adc_channel);
+        History_Init(&g_history[id]);
+        Anomaly_Init(&g_anomaly[id], SENSOR_ANOMALY_SHIFT, SENSOR_ANOMALY_WARMUP,
+                     SENSOR_ANOMALY_MIN_SIGMA, SENSOR_ANOMALY_Z);
+        Exposure_Init(&g_exposure[id],
+                      (uint16_t)(SENSOR_EXPOSURE_ON_LSB << ((g_scan_index[id] < 0) ? 0 : g_adc_filters[g_scan_index[id]].extra_bits)),
+                      SENSOR_EXPOSURE_MAX_MS);
+        Deadband_Init(&g_deadband[id][SENSOR_FIELD_ADC], SENSOR_DB_ADC_ABS, 0.0f);
+        Deadband_Init(&g_deadband[id][SENSOR_FIELD_VOLTAGE], SENSOR_DB_VOLTAGE_ABS, 0.0f);
+        Deadband_Init(&g_deadband[id][SENSOR_FIELD_PPM], SENSOR_DB_PPM_ABS, SENSOR_DB_PPM_REL);
+        if (g_scan_index[id] < 0) {
+            printf("[传感器管理器] %s 的通道不在 ADC 扫描序列中（见 adc_scan.h）\r\n", k_sensors[id].name);
+        }
+        k_sensors[id].driver->init((SensorType_t)id);
+    }
+    AdcScan_SetFrameHook(SensorManager_OnScanFrame);
+
+    /* 板上分类器：模型输入通道按 HK 前缀对应到注册表中的传感器 */
+    g_classify_enabled = true;
+    for (uint8_t f = 0; f < GAS_MODEL_IN_FEATURES; f++) {
+        SensorType_t id = SensorManager_FindByKey(k_gas_model.feature_keys[f]);
+        g_classify_sensor[f] = (id < SENSOR_TYPE_MAX) ? (int8_t)id : -1;
+        if (id >= SENSOR_TYPE_MAX) {
+            printf("[传感器管理器] 分类器输入 %s 不在传感器注册表中，分类器停用\r\n", k_gas_model.feature_keys[f]);
+            g_classify_enabled = false;
+        }
+    }
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   // 开启 DWT 周期计数，测量推理耗时
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    printf("[传感器管理器] 分类器：%u×%u 窗口，%u 类，%lu 乘加，工作区 %u B，权重 %u B%s\r\n",
+           GAS_MODEL_IN_FEATURES, GAS_MODEL_SEQ_LEN, GAS_MODEL_N_CLASSES, (unsigned long)GAS_MODEL_MACS,
+           GAS_MODEL_ARENA_BYTES, GAS_MODEL_WEIGHT_BYTES, GAS_MODEL_PLACEHOLDER ? "（占位模型，不上报）" : "");
 
-    printf("[传感器管理器] 初始化完成\r\n");
+    printf("[传感器管理器] 初始化完成，共 %u 个传感器\r\n", SENSOR_TYPE_MAX);
 }
 
 /**
@@ -58,57 +182,55 @@ void SensorManager_Init(ADC_HandleTypeDef* hadc)
  */
 void SensorManager_Update(void)
 {
-    /* 更新MQ-3数据 */
-    SensorData_t* mq3_data = &g_sensor_data[SENSOR_TYPE_MQ3_ALCOHOL];
-
-    mq3_data->adc_raw = MQ3_ReadADC();
-    mq3_data->voltage = MQ3_ReadVoltage();
-    mq3_data->concentration = MQ3_ReadConcentration();
-    mq3_data->timestamp = HAL_GetTick();
-
-    /* 检查预热状态 */
-    if (!mq3_config.is_preheated) {
-        uint32_t now = mq3_data->timestamp;
-        uint32_t elapsed = now - mq3_config.preheat_start_time;
-
-        /* 窗口初始化 */
-        if (mq3_config.stable_window_start == 0) {
-            mq3_config.stable_window_start = now;
-            mq3_config.stable_adc_min = mq3_data->adc_raw;
-            mq3_config.stable_adc_max = mq3_data->adc_raw;
-        }
-
-        /* 更新当前窗口的波动范围 */
-        if (mq3_data->adc_raw < mq3_config.stable_adc_min) {
-            mq3_config.stable_adc_min = mq3_data->adc_raw;
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        const struct SensorDriver* drv = k_sensors[id].driver;
+        SensorData_t* data = &g_sensor_data[id];
+        uint16_t code;
+        uint32_t tick;
+
+        if (drv->poll != NULL) {
+            drv->poll((SensorType_t)id);
         }
-        if (mq3_data->adc_raw > mq3_config.stable_adc_max) {
-            mq3_config.stable_adc_max = mq3_data->adc_raw;
+        if (!drv->sample((SensorType_t)id, &code, &tick)) {
+            continue;   // 尚未产生数据，保持原状态
         }
+        /* 同一个样本换算原始值、电压与浓度，三者一致 */
+        drv->convert((SensorType_t)id, code, data);
+        data->timestamp = tick;   // 采样时刻（扫描帧完成时），不受主循环抖动影响
+        data->status = drv->status((SensorType_t)id, data);
+    }
+    SensorManager_Classify();
+}
 
-        bool time_ready = (elapsed >= MQ3_PREHEAT_TIME_MS);
-        bool window_ready = (now - mq3_config.stable_window_start) >= MQ3_STABLE_WINDOW_MS;
-        bool is_stable = window_ready &&
-            ((mq3_config.stable_adc_max - mq3_config.stable_adc_min) <= MQ3_STABLE_DELTA_ADC);
-
-        if (time_ready && is_stable) {
-            /* 预热完成且读数稳定，自动校准 R0 */
-            MQ3_Calibrate();
-            mq3_config.is_preheated = true;
-            mq3_data->status = SENSOR_STATUS_OK;
-            printf("[MQ-3] 预热完成且读数稳定，R0 已校准。\r\n");
-        } else {
-            /* 若窗口已结束但不稳定，重置窗口重新观察 */
-            if (window_ready && !is_stable) {
-                mq3_config.stable_window_start = now;
-                mq3_config.stable_adc_min = mq3_data->adc_raw;
-                mq3_config.stable_adc_max = mq3_data->adc_raw;
-            }
-            mq3_data->status = SENSOR_STATUS_PREHEATING;
-        }
-    } else {
-        mq3_data->status = SENSOR_STATUS_OK;
+/**
+ * @brief  读取传感器所在扫描通道的过采样输出
+ * @param  code: 过采样抽取后的值（满量程 4096 << extra_bits）；滤波器尚无输出时
+ *               以最近一帧原始值补位
+ * @param  bits: code 的位数，可为NULL（通道有效时总会写入）
+ * @param  tick: 采样时刻，可为NULL
+ * @retval 1: 成功; 0: 尚无数据
+ */
+uint8_t SensorManager_ReadChannel(SensorType_t type, uint16_t* code, uint8_t* bits, uint32_t* tick)
+{
+    AdcScanFrame_t frame;
+
+    if (type >= SENSOR_TYPE_MAX || g_scan_index[type] < 0) {
+        return 0;
+    }
+    const Oversample_t* f = &g_adc_filters[g_scan_index[type]];
+    if (bits != NULL) {
+        *bits = Oversample_Bits(f);   // 尚无数据时也给出位数，便于驱动初始化
     }
+    if (!AdcScan_GetLatest(&frame)) {
+        return 0;
+    }
+    if (Oversample_Read(f, code) == 0) {
+        *code = (uint16_t)(frame.raw[g_scan_index[type]] << f->extra_bits);
+    }
+    if (tick != NULL) {
+        *tick = frame.tick;
+    }
+    return 1;
 }
 
 /**
@@ -124,6 +246,17 @@ SensorData_t* SensorManager_GetData(SensorType_t type)
     return &g_sensor_data[type];
 }
 
+/**
+ * @brief  获取注册表中的静态描述
+ */
+const SensorDesc_t* SensorManager_GetDesc(SensorType_t type)
+{
+    if (type >= SENSOR_TYPE_MAX) {
+        return NULL;
+    }
+    return &k_sensors[type];
+}
+
 /**
  * @brief  检查传感器是否就绪
  */
@@ -135,146 +268,530 @@ bool SensorManager_IsReady(SensorType_t type)
     return g_sensor_data[type].status == SENSOR_STATUS_OK;
 }
 
-/* ========== MQ-3 酒精传感器专用函数 ========== */
+/**
+ * @brief  启动后台校准（非阻塞，结果见 SensorManager_TakeCalibrationResult）
+ * @param  type: 传感器类型；SENSOR_ALL 表示全部支持校准的传感器
+ * @retval 启动的传感器个数
+ */
+uint8_t SensorManager_StartCalibration(SensorType_t type)
+{
+    uint8_t started = 0;
+
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        if ((type == SENSOR_ALL || type == id) && k_sensors[id].driver->calibrate != NULL) {
+            started += k_sensors[id].driver->calibrate((SensorType_t)id);
+        }
+    }
+    return started;
+}
 
 /**
- * @brief  MQ-3初始化
- * @param  adc_channel: ADC通道
+ * @brief  取走一条校准结果（每次结果只返回一次，多个时逐次调用）
+ * @retval true: 有新结果
  */
-void MQ3_Init(uint32_t adc_channel)
+bool SensorManager_TakeCalibrationResult(SensorCalResult_t* out)
 {
-    mq3_config.adc_channel = adc_channel;
-    mq3_config.r0 = MQ3_R0_CLEAN_AIR;
-    mq3_config.is_preheated = false;
-    mq3_config.preheat_start_time = HAL_GetTick();
-    mq3_config.stable_window_start = 0;
-    mq3_config.stable_adc_min = 0xFFFF;
-    mq3_config.stable_adc_max = 0;
-
-    printf("[MQ-3] 初始化成功，开始预热...\r\n");
-    printf("[MQ-3] 预计预热时间: %d 秒\r\n", MQ3_PREHEAT_TIME_MS / 1000);
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        if (k_sensors[id].driver->take_cal_result != NULL &&
+            k_sensors[id].driver->take_cal_result((SensorType_t)id, out)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
- * @brief  读取MQ-3的ADC原始值
- * @retval ADC值 (0-4095)
+ * @brief  写出 HK 对象的开头与各传感器字段（遍历注册表）
+ * @note   主传感器（第 0 行）另填兼容字段 adc / voltage / sensor_status，
+ *         其余传感器的状态为 <key>_status；调用方随后可追加字段，
+ *         最后以 SensorManager_WriteHousekeepingEnd 闭合
  */
-uint16_t MQ3_ReadADC(void)
+void SensorManager_WriteHousekeeping(TmWriter_t* w, uint32_t counter)
 {
-    if (g_hadc == NULL) {
+    const SensorData_t* primary = &g_sensor_data[0];
+
+    TmWriter_BeginObject(w, NULL);
+    TmWriter_Uint(w, "counter", counter);
+    TmWriter_Uint(w, "adc", primary->adc_raw);
+    TmWriter_Fixed(w, "voltage", primary->voltage, 3);
+
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        const SensorDesc_t* desc = &k_sensors[id];
+        const SensorData_t* data = &g_sensor_data[id];
+        TmWriter_Key(w, desc->hk_key, "_adc");
+        TmWriter_Uint(w, NULL, data->adc_raw);
+        TmWriter_Key(w, desc->hk_key, "_voltage");
+        TmWriter_Fixed(w, NULL, data->voltage, 3);
+        TmWriter_Fixed(w, desc->ppm_key, data->concentration, 2);
+        if (id > 0) {
+            TmWriter_Key(w, desc->hk_key, "_status");
+            TmWriter_Int(w, NULL, (int32_t)data->status);
+        }
+    }
+    if (g_classification.valid) {
+        TmWriter_Str(w, "cls", g_classification.class_name);
+        TmWriter_Fixed(w, "cls_conf", g_classification.confidence, 2);
+    }
+}
+
+/**
+ * @brief  写出 sensor_status 并闭合 HK 对象
+ */
+void SensorManager_WriteHousekeepingEnd(TmWriter_t* w)
+{
+    TmWriter_Int(w, "sensor_status", (int32_t)g_sensor_data[0].status);
+    TmWriter_EndObject(w);
+}
+
+/**
+ * @brief  浓度阈值对应的 12 位原始码值（用于 ADC 模拟看门狗）
+ * @retval 码值；驱动不支持时返回 0
+ */
+uint16_t SensorManager_CodeForPpm(SensorType_t type, float ppm)
+{
+    if (type >= SENSOR_TYPE_MAX || k_sensors[type].driver->code_for_ppm == NULL) {
         return 0;
     }
+    return k_sensors[type].driver->code_for_ppm(type, ppm);
+}
+
+/**
+ * @brief  按 HK 字段前缀查找传感器
+ * @retval 传感器编号；未找到时为 SENSOR_TYPE_MAX
+ */
+SensorType_t SensorManager_FindByKey(const char* hk_key)
+{
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        if (hk_key != NULL && strcmp(k_sensors[id].hk_key, hk_key) == 0) {
+            return (SensorType_t)id;
+        }
+    }
+    return SENSOR_TYPE_MAX;
+}
+
+/**
+ * @brief  开始一次历史下传
+ * @param  res_s: 0（原始样本）/ 1 / 10 / 60
+ * @param  from_s/to_s: 时间段，以“距现在多少秒”表示（from_s ≥ to_s）
+ * @retval false: 参数不合法
+ */
+bool SensorManager_StartHistory(SensorHistoryCursor_t* cur, SensorType_t type, uint16_t res_s,
+                                uint32_t from_s, uint32_t to_s)
+{
+    uint32_t now = HAL_GetTick();
 
-    ADC_ChannelConfTypeDef sConfig = {0};
-    sConfig.Channel = mq3_config.adc_channel;
-    sConfig.Rank = 1;
-    sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;  // 增加采样时间提高精度
-    HAL_ADC_ConfigChannel(g_hadc, &sConfig);
+    if (type >= SENSOR_TYPE_MAX || History_LevelForResolution(res_s) < 0 || from_s < to_s) {
+        return false;
+    }
+    /* 超出开机时长的部分从第一个样本算起 */
+    cur->sensor = type;
+    cur->res_s = res_s;
+    cur->next_tick = (from_s >= now / 1000u) ? 0 : now - from_s * 1000u;
+    cur->to_tick = (to_s >= now / 1000u) ? 0 : now - to_s * 1000u;
+    cur->seq = 0;
+    cur->done = false;
+    return true;
+}
 
-    HAL_ADC_Start(g_hadc);
-    HAL_ADC_PollForConversion(g_hadc, 100);
-    uint16_t adc_value = HAL_ADC_GetValue(g_hadc);
-    HAL_ADC_Stop(g_hadc);
+/* 码值按驱动当前的换算（含 R0）折算为浓度 */
+static float SensorManager_CodeToPpm(SensorType_t type, uint16_t code)
+{
+    SensorData_t tmp;
 
-    return adc_value;
+    k_sensors[type].driver->convert(type, code, &tmp);
+    return tmp.concentration;
 }
 
 /**
- * @brief  读取MQ-3的电压值
- * @retval 电压值 (V)
+ * @brief  生成下一页历史 JSON（kind = history），并推进游标
+ * @note   r 中每条为 [相对 t0 的 ms, min, max, mean]（原始层为 [ms, 值]），浓度单位 ppm；
+ *         now / t0 为设备开机毫秒数，地面按收到时刻换算绝对时间。
+ *         最后一页带 "last":1，此后 cur->done 为 true。
+ * @retval 写入长度；无可生成内容或缓冲区不足时返回 0
  */
-float MQ3_ReadVoltage(void)
+int SensorManager_FormatHistory(char* buf, size_t size, SensorHistoryCursor_t* cur)
 {
-    uint16_t adc_raw = MQ3_ReadADC();
+    static const char tail[] = "],\"last\":0}";
+    HistoryRecord_t rec[SENSOR_HISTORY_PAGE];
+    int8_t level = History_LevelForResolution(cur->res_s);
+    TmWriter_t w;
 
-    /* ADC转电压 */
-    float voltage = (adc_raw / ADC_RESOLUTION) * ADC_VREF;
+    if (cur->done || cur->sensor >= SENSOR_TYPE_MAX || level < 0) {
+        return 0;
+    }
 
-    /* 如果使用了分压电路，需要还原真实电压 */
-    voltage *= VOLTAGE_DIVIDER_RATIO;
+    __disable_irq();
+    uint16_t count = History_Read(&g_history[cur->sensor], (uint8_t)level, cur->next_tick, cur->to_tick,
+                                  rec, SENSOR_HISTORY_PAGE);
+    __enable_irq();
+
+    uint32_t t0 = (count > 0) ? rec[0].tick : cur->next_tick;
+    TmWriter_Init(&w, buf, size, TM_ENC_JSON);
+    TmWriter_BeginObject(&w, NULL);
+    TmWriter_Str(&w, "kind", "history");
+    TmWriter_Str(&w, "sensor", k_sensors[cur->sensor].hk_key);
+    TmWriter_Uint(&w, "res", cur->res_s);
+    TmWriter_Uint(&w, "seq", cur->seq);
+    TmWriter_Uint(&w, "now", HAL_GetTick());
+    TmWriter_Uint(&w, "t0", t0);
+    TmWriter_BeginArray(&w, "r");
+    TmWriter_Reserve(&w, (int32_t)sizeof(tail) - 1);
+    if (!TmWriter_Ok(&w)) {
+        return 0;
+    }
 
-    return voltage;
+    uint16_t used = 0;
+    for (; used < count; used++) {
+        TmWriterMark_t mark = TmWriter_Mark(&w);
+        float mean = SensorManager_CodeToPpm(cur->sensor, rec[used].mean);
+
+        TmWriter_BeginArray(&w, NULL);
+        TmWriter_Uint(&w, NULL, rec[used].tick - t0);
+        if (level != HISTORY_LEVEL_RAW) {
+            float lo = SensorManager_CodeToPpm(cur->sensor, rec[used].min);
+            float hi = SensorManager_CodeToPpm(cur->sensor, rec[used].max);
+            if (lo > hi) {
+                float t = lo;
+                lo = hi;
+                hi = t;
+            }
+            TmWriter_Fixed(&w, NULL, lo, 1);
+            TmWriter_Fixed(&w, NULL, hi, 1);
+        }
+        TmWriter_Fixed(&w, NULL, mean, 1);
+        TmWriter_EndArray(&w);
+        if (!TmWriter_Ok(&w)) {
+            TmWriter_Rollback(&w, mark);
+            break;
+        }
+    }
+
+    if (used > 0) {
+        cur->next_tick = rec[used - 1].tick + 1;
+    }
+    /* 本页读空（或一条都放不下）即结束 */
+    cur->done = (used == count && count < SENSOR_HISTORY_PAGE) || used == 0;
+    cur->seq++;
+    TmWriter_Reserve(&w, -((int32_t)sizeof(tail) - 1));
+    TmWriter_EndArray(&w);
+    TmWriter_Uint(&w, "last", cur->done ? 1u : 0u);
+    TmWriter_EndObject(&w);
+    return (int)TmWriter_Finish(&w);
 }
 
 /**
- * @brief  计算传感器电阻Rs
- * @param  voltage: 传感器输出电压
- * @retval Rs (kΩ)
+ * @brief  板上分类：取各输入传感器最近 GAS_MODEL_SEQ_LEN 个过采样样本（换算为浓度）推理一次
+ * @note   窗口中最新样本与上次相同则跳过；任一输入传感器未就绪时结果置为无效
  */
-static float MQ3_CalculateRs(float voltage)
+static void SensorManager_Classify(void)
 {
-    /* 公式：Rs = (Vc - Vout) * RL / Vout
-     * Vc = 5V (传感器供电电压)
-     * Vout = 测量到的电压
-     * RL = 负载电阻
-     */
-    if (voltage <= 0.01f) {
-        voltage = 0.01f;  // 防止除零
+    float window[SENSOR_CLASSIFY_WINDOW];
+    HistorySample_t samples[GAS_MODEL_SEQ_LEN];
+    int8_t logits[GAS_MODEL_N_CLASSES];
+    uint32_t newest = 0;
+
+    if (!g_classify_enabled) {
+        return;
+    }
+    for (uint8_t f = 0; f < GAS_MODEL_IN_FEATURES; f++) {
+        SensorType_t id = (SensorType_t)g_classify_sensor[f];
+        if (g_sensor_data[id].status != SENSOR_STATUS_OK) {
+            g_classification.valid = false;
+            return;
+        }
+        __disable_irq();
+        uint16_t n = History_Latest(&g_history[id], samples, GAS_MODEL_SEQ_LEN);
+        __enable_irq();
+        if (n < GAS_MODEL_SEQ_LEN) {
+            return;
+        }
+        if (f == 0) {
+            newest = samples[n - 1].tick;
+            if (g_classification.runs > 0 && newest == g_classification.tick) {
+                return;
+            }
+        }
+        for (uint16_t t = 0; t < GAS_MODEL_SEQ_LEN; t++) {
+            window[f * GAS_MODEL_SEQ_LEN + t] = SensorManager_CodeToPpm(id, samples[t].value);
+        }
     }
 
-    float rs = (5.0f - voltage) * MQ3_RL_VALUE / voltage;
-    return rs;
+    TinyMl_Quantize(&k_gas_model, window, g_classify_input);
+    uint32_t start = DWT->CYCCNT;
+    uint8_t ok = TinyMl_Run(&k_gas_model, g_classify_input, g_classify_arena, sizeof(g_classify_arena), logits);
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    if (!ok) {
+        printf("[传感器管理器] 分类器层表不合法，停用\r\n");
+        g_classify_enabled = false;
+        g_classification.valid = false;
+        return;
+    }
+    g_classification.class_id = TinyMl_Classify(&k_gas_model, logits, &g_classification.confidence);
+    g_classification.class_name = k_gas_model.class_names[g_classification.class_id];
+    g_classification.valid = !GAS_MODEL_PLACEHOLDER;
+    g_classification.tick = newest;
+    g_classification.runs++;
+    g_classification.cycles = cycles;
+    if (cycles > g_classification.cycles_max) {
+        g_classification.cycles_max = cycles;
+    }
+    if (cycles > SENSOR_CLASSIFY_CYCLE_BUDGET) {
+        g_classification.over_budget++;
+    }
 }
 
 /**
- * @brief  根据Rs/R0比值计算PPM浓度
- * @param  rs_r0_ratio: Rs/R0比值
- * @retval 酒精浓度 (ppm)
- *
- * @note   基于MQ-3数据手册的对数曲线拟合
- *         公式: ppm = A * (Rs/R0)^B
- *         对于MQ-3酒精检测: A ≈ 0.4, B ≈ -1.431
+ * @brief  最近一次板上分类结果
  */
-float MQ3_CalculatePPM(float rs_r0_ratio)
+const SensorClassification_t* SensorManager_GetClassification(void)
 {
-    /* MQ-3酒精检测曲线参数（根据数据手册调整） */
-    const float A = 0.4f;
-    const float B = -1.431f;
+    return &g_classification;
+}
 
-    /* 计算浓度 */
-    float ppm = A * powf(rs_r0_ratio, B);
+/**
+ * @brief  汇总各传感器的异常检测状态，并取走自上次调用以来的峰值 z
+ * @param  hold_ms: 最后一次越限后仍视为“异常进行中”的时长
+ */
+void SensorManager_TakeAnomaly(SensorAnomaly_t* out, uint32_t hold_ms)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t peak = 0;
+
+    out->active = false;
+    out->sensor = (SensorType_t)0;
+    out->hits = 0;
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        __disable_irq();
+        uint32_t p = Anomaly_TakePeak(&g_anomaly[id]);
+        uint32_t hits = g_anomaly[id].hits;
+        uint32_t hit_tick = g_anomaly[id].hit_tick;
+        __enable_irq();
+
+        out->hits += hits;
+        if (hits > 0 && now - hit_tick <= hold_ms && g_sensor_data[id].status == SENSOR_STATUS_OK) {
+            out->active = true;
+        }
+        if (p > peak) {
+            peak = p;
+            out->sensor = (SensorType_t)id;
+        }
+    }
+    out->z_peak = Anomaly_Z(peak);
+}
+
+/**
+ * @brief  设置全部传感器的异常阈值 z
+ */
+void SensorManager_SetAnomalyThreshold(float z)
+{
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        __disable_irq();
+        Anomaly_SetThreshold(&g_anomaly[id], z);
+        __enable_irq();
+    }
+}
 
-    /* 限制范围 */
-    if (ppm < 0) ppm = 0;
-    if (ppm > 1000) ppm = 1000;
+/**
+ * @brief  from_tick 以来的浓度摘要（1 s 聚合层，只含已关闭的桶）
+ * @param  lo/hi/mean: 最小、最大与按样本数加权的平均浓度 (ppm)
+ * @retval false: 这段时间内没有已关闭的桶
+ */
+bool SensorManager_Summarize(SensorType_t type, uint32_t from_tick, float* lo, float* hi, float* mean)
+{
+    HistoryRecord_t rec[SENSOR_HISTORY_PAGE];
+    uint32_t to_tick = HAL_GetTick();
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    uint16_t cmin = 0xFFFF;
+    uint16_t cmax = 0;
 
-    return ppm;
+    if (type >= SENSOR_TYPE_MAX) {
+        return false;
+    }
+    for (;;) {
+        __disable_irq();
+        uint16_t n = History_Read(&g_history[type], (uint8_t)History_LevelForResolution(1), from_tick, to_tick, rec, SENSOR_HISTORY_PAGE);
+        __enable_irq();
+
+        for (uint16_t i = 0; i < n; i++) {
+            cmin = (rec[i].min < cmin) ? rec[i].min : cmin;
+            cmax = (rec[i].max > cmax) ? rec[i].max : cmax;
+            sum += (uint64_t)rec[i].mean * rec[i].count;
+            count += rec[i].count;
+        }
+        if (n < SENSOR_HISTORY_PAGE) {
+            break;
+        }
+        from_tick = rec[n - 1].tick + 1;
+    }
+    if (count == 0) {
+        return false;
+    }
+    /* 浓度随码值可能递减（MQ 系列即如此），换算后重新排序 */
+    *lo = SensorManager_CodeToPpm(type, cmin);
+    *hi = SensorManager_CodeToPpm(type, cmax);
+    if (*lo > *hi) {
+        float t = *lo;
+        *lo = *hi;
+        *hi = t;
+    }
+    *mean = SensorManager_CodeToPpm(type, (uint16_t)((sum + count / 2) / count));
+    return true;
+}
+
+/* 参与死区判定的字段当前值 */
+static float SensorManager_FieldValue(uint8_t id, uint8_t field)
+{
+    const SensorData_t* data = &g_sensor_data[id];
+
+    switch (field) {
+    case SENSOR_FIELD_ADC:
+        return (float)data->adc_raw;
+    case SENSOR_FIELD_VOLTAGE:
+        return data->voltage;
+    default:
+        return data->concentration;
+    }
 }
 
 /**
- * @brief  读取MQ-3的酒精浓度
- * @retval 酒精浓度 (ppm)
+ * @brief  HK 字段名 → 传感器与字段（主传感器的兼容字段 adc / voltage 同样可用）
+ * @retval false: 不是参与死区判定的字段
  */
-float MQ3_ReadConcentration(void)
+static bool SensorManager_FindField(const char* name, uint8_t* id, uint8_t* field)
 {
-    float voltage = MQ3_ReadVoltage();
-    float rs = MQ3_CalculateRs(voltage);
-    float rs_r0_ratio = rs / mq3_config.r0;
-    float ppm = MQ3_CalculatePPM(rs_r0_ratio);
+    static const char* const suffix[] = { "_adc", "_voltage" };
 
-    return ppm;
+    if (strcmp(name, "adc") == 0) {
+        *id = 0;
+        *field = SENSOR_FIELD_ADC;
+        return true;
+    }
+    if (strcmp(name, "voltage") == 0) {
+        *id = 0;
+        *field = SENSOR_FIELD_VOLTAGE;
+        return true;
+    }
+    for (uint8_t i = 0; i < SENSOR_TYPE_MAX; i++) {
+        size_t key_len = strlen(k_sensors[i].hk_key);
+        if (strcmp(name, k_sensors[i].ppm_key) == 0) {
+            *id = i;
+            *field = SENSOR_FIELD_PPM;
+            return true;
+        }
+        if (strncmp(name, k_sensors[i].hk_key, key_len) != 0) {
+            continue;
+        }
+        for (uint8_t f = 0; f < 2; f++) {
+            if (strcmp(name + key_len, suffix[f]) == 0) {
+                *id = i;
+                *field = f;
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 /**
- * @brief  校准MQ-3传感器（在清洁空气中校准R0）
- * @note   需要在清洁空气环境中调用此函数
+ * @brief  设置某个 HK 字段的死区
+ * @param  field: HK 字段名，如 alcohol_ppm / mq3_adc / voltage
+ * @param  abs/rel: 绝对死区（字段单位）与相对死区（比例）；0 表示不启用
+ * @retval false: 字段不存在或参数不合法
  */
-void MQ3_Calibrate(void)
+bool SensorManager_SetDeadband(const char* field, float abs, float rel)
 {
-    printf("[MQ-3] 开始校准，请确保传感器处于清洁空气中...\r\n");
+    uint8_t id;
+    uint8_t f;
+
+    if (field == NULL || !(abs >= 0.0f) || !(rel >= 0.0f) || !SensorManager_FindField(field, &id, &f)) {
+        return false;
+    }
+    Deadband_SetThreshold(&g_deadband[id][f], abs, rel);
+    return true;
+}
 
-    /* 多次采样取平均 */
-    const int samples = 50;
-    float sum_rs = 0;
+/**
+ * @brief  正常工作的传感器中是否有字段越出死区（与上次下传的 HK 相比）
+ * @param  field: 第一个越出死区的 HK 字段名，可为 NULL
+ */
+bool SensorManager_DeadbandExceeded(char* field, size_t size)
+{
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        if (g_sensor_data[id].status != SENSOR_STATUS_OK) {
+            continue;   // 预热/故障期间由状态事件报告
+        }
+        for (uint8_t f = 0; f < SENSOR_FIELD_COUNT; f++) {
+            if (!Deadband_Exceeded(&g_deadband[id][f], SensorManager_FieldValue(id, f))) {
+                continue;
+            }
+            if (field != NULL && size > 0) {
+                if (f == SENSOR_FIELD_PPM) {
+                    snprintf(field, size, "%s", k_sensors[id].ppm_key);
+                } else {
+                    snprintf(field, size, "%s_%s", k_sensors[id].hk_key,
+                             (f == SENSOR_FIELD_ADC) ? "adc" : "voltage");
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
 
-    for (int i = 0; i < samples; i++) {
-        float voltage = MQ3_ReadVoltage();
-        float rs = MQ3_CalculateRs(voltage);
-        sum_rs += rs;
-        HAL_Delay(100);
+/**
+ * @brief  HK 已下传：以当前值作为各字段死区判定的参考
+ */
+void SensorManager_DeadbandCommit(void)
+{
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        for (uint8_t f = 0; f < SENSOR_FIELD_COUNT; f++) {
+            Deadband_Commit(&g_deadband[id][f], SensorManager_FieldValue(id, f));
+        }
     }
+}
 
-    mq3_config.r0 = sum_rs / samples;
+/**
+ * @brief  取走一个已结束的暴露事件特征（每个结果只返回一次，多个时逐次调用）
+ * @note   基线/峰值按驱动当前换算折算为浓度；斜率与积分响应按电压（线性于码值）给出
+ * @retval true: 有新结果
+ */
+bool SensorManager_TakeExposure(SensorExposure_t* out)
+{
+    for (uint8_t id = 0; id < SENSOR_TYPE_MAX; id++) {
+        ExposureEvent_t ev;
+
+        __disable_irq();
+        bool ready = g_exposure[id].ready;
+        if (ready) {
+            ev = g_exposure[id].result;
+            g_exposure[id].ready = false;
+        }
+        __enable_irq();
+        if (!ready) {
+            continue;
+        }
 
-    printf("[MQ-3] 校准完成！R0 = %.2f kΩ\r\n", mq3_config.r0);
+        SensorData_t base;
+        SensorData_t peak;
+        k_sensors[id].driver->convert((SensorType_t)id, ev.base, &base);
+        k_sensors[id].driver->convert((SensorType_t)id, ev.peak, &peak);
+        float v_per_code = (ev.peak > 0) ? peak.voltage / (float)ev.peak : 0.0f;
+
+        out->sensor = (SensorType_t)id;
+        out->recovered = (ev.reason == EXPOSURE_END_RECOVERED);
+        out->t_start = ev.t_start;
+        out->base_ppm = base.concentration;
+        out->peak_ppm = peak.concentration;
+        out->dv = peak.voltage - base.voltage;
+        out->slope = (float)ev.slope_max * v_per_code;
+        out->t_rise_s = (float)(ev.t_peak - ev.t_start) / 1000.0f;
+        out->tau_rise_s = (float)ev.tau_rise_ms / 1000.0f;
+        out->tau_rec_s = (float)ev.tau_rec_ms / 1000.0f;
+        out->area = (float)ev.area / 1000.0f * v_per_code;
+        out->duration_s = (float)(ev.t_end - ev.t_start) / 1000.0f;
+        return true;
+    }
+    return false;
 }
@@ -7,8 +7,14 @@
  * @version        : 1.0
  ******************************************************************************
  * @description    : 支持多种气体传感器的统一管理接口
- *                   - MQ-3 酒精传感器
- *                   - 可扩展其他MQ系列传感器
+ *                   - 传感器在 sensor_table.h 中登记，一行一个
+ *                   - 所有传感器共用一次 ADC 扫描，每个扫描通道一个过采样滤波器
+ *                   - 具体换算/预热/校准由驱动实现（sensor_driver.h，MQ 系列见 sensor_mq.c）
+ *                   - 每个传感器保留多分辨率历史（history.h），可按时间段分页下传
+ *                   - 板上 int8 分类器（tinyml.h）对最近一个样本窗口分类，结果进 HK/事件
+ *                   - 每个过采样输出送入流式异常检测（anomaly.h），供主循环决定 HK 下传粒度
+ *                   - HK 字段各有死区（deadband.h），与上次下传值相比没有越出死区时可省略
+ *                   - 每次暴露（响应升起又回落）提取一组响应特征（exposure.h），以事件下传
  ******************************************************************************
  */
 
@@ -16,17 +22,21 @@
 #define __SENSOR_MANAGER_H
 
 #include "stm32f4xx_hal.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "tm_writer.h"
 
-/* 传感器类型枚举 */
+/* 传感器编号：sensor_table.h 的行序号 */
 typedef enum {
-    SENSOR_TYPE_MQ3_ALCOHOL = 0,  // MQ-3 酒精传感器
-    SENSOR_TYPE_TEMPERATURE,      // 温度传感器（预留）
-    SENSOR_TYPE_HUMIDITY,         // 湿度传感器（预留）
+#define SENSOR_ENTRY(id, drv, ch, a, b, rl, r0, ppm_max, preheat_ms, hk_key, ppm_key) SENSOR_TYPE_##id,
+#include "sensor_table.h"
+#undef SENSOR_ENTRY
     SENSOR_TYPE_MAX               // 传感器数量
 } SensorType_t;
 
+#define SENSOR_ALL SENSOR_TYPE_MAX   // SensorManager_StartCalibration：全部传感器
+
 /* 传感器状态 */
 typedef enum {
     SENSOR_STATUS_OK = 0,         // 正常
@@ -38,37 +48,116 @@ typedef enum {
 /* 传感器数据结构 */
 typedef struct {
     SensorType_t type;            // 传感器类型
-    uint16_t adc_raw;             // ADC原始值 (0-4095)
+    uint16_t adc_raw;             // ADC值，折算到12位 (0-4095)
+    uint16_t adc_filtered;        // 过采样抽取后的高分辨率值 (满量程 1 << adc_bits)
+    uint8_t adc_bits;             // adc_filtered 的有效位数
     float voltage;                // 电压值 (V)
     float concentration;          // 气体浓度 (ppm)
     uint32_t timestamp;           // 时间戳 (ms)
     SensorStatus_t status;        // 状态
 } SensorData_t;
 
-/* MQ-3 传感器配置 */
+struct SensorDriver;
+
+/* 注册表中一行的静态描述 */
 typedef struct {
+    const char* name;             // 传感器名（枚举 ID）
+    const struct SensorDriver* driver;
     uint32_t adc_channel;         // ADC通道 (ADC_CHANNEL_x)
-    float r0;                     // 传感器在清洁空气中的基准电阻 (kΩ)
-    bool is_preheated;            // 是否已预热
-    uint32_t preheat_start_time;  // 预热开始时间
-    uint32_t stable_window_start; // 稳定性检测窗口起点
-    uint16_t stable_adc_min;      // 窗口内ADC最小值
-    uint16_t stable_adc_max;      // 窗口内ADC最大值
-} MQ3_Config_t;
+    float curve_a;                // 浓度曲线 ppm = A * (Rs/R0)^B
+    float curve_b;
+    float rl_kohm;                // 负载电阻 (kΩ)
+    float r0_kohm;                // 清洁空气中的R0初值 (kΩ)，校准后由驱动更新
+    float ppm_max;                // 浓度输出上限
+    uint32_t preheat_ms;          // 预热时间
+    const char* hk_key;           // HK 字段前缀：<key>_adc / <key>_voltage
+    const char* ppm_key;          // HK 浓度字段名
+} SensorDesc_t;
+
+/* R0 校准结果（非阻塞校准结束后由主循环取走） */
+typedef struct {
+    SensorType_t sensor;          // 哪个传感器
+    bool ok;                      // 是否已提交新的 R0
+    bool from_preheat;            // 由预热流程自动触发（否则为遥控指令触发）
+    float r0;                     // 提交后的 R0 (kΩ)；失败时为沿用的旧值
+    float rsd;                    // 采纳样本的相对标准差
+    uint16_t samples;             // 采纳样本数
+    uint16_t rejected;            // 剔除的离群样本数
+} SensorCalResult_t;
+
+/* 历史下传的一次请求（按页推进，见 SensorManager_FormatHistory） */
+typedef struct {
+    SensorType_t sensor;
+    uint16_t res_s;               // 0 = 原始样本；1 / 10 / 60 秒聚合
+    uint32_t next_tick;           // 下一页起点（含）
+    uint32_t to_tick;             // 终点（含）
+    uint16_t seq;                 // 已生成的页数
+    bool done;                    // 最后一页已生成
+} SensorHistoryCursor_t;
+
+/* 板上分类结果（每次 SensorManager_Update 最多推理一次） */
+typedef struct {
+    bool valid;                   // 有结果且可上报（传感器未就绪或占位模型时为 false）
+    uint8_t class_id;
+    const char* class_name;
+    float confidence;             // softmax 最大概率
+    uint32_t tick;                // 窗口中最新样本的时刻
+    uint32_t runs;                // 推理次数
+    uint32_t cycles;              // 最近一次推理的 CPU 周期（DWT；主机端为 0）
+    uint32_t cycles_max;
+    uint32_t over_budget;         // 超出周期预算的次数
+} SensorClassification_t;
+
+/* 异常检测汇总（SensorManager_TakeAnomaly） */
+typedef struct {
+    bool active;                  // 保持时间内有正常工作的传感器越限
+    SensorType_t sensor;          // 峰值 z 所在的传感器
+    float z_peak;                 // 自上次取走以来的最大 z
+    uint32_t hits;                // 越限样本累计数（全部传感器）
+} SensorAnomaly_t;
+
+/* 一次暴露事件的响应特征（SensorManager_TakeExposure） */
+typedef struct {
+    SensorType_t sensor;
+    bool recovered;               // false: 超过最长时间仍未恢复（tau_rec 无效）
+    uint32_t t_start;             // 暴露开始时刻 (ms)
+    float base_ppm;               // 基线浓度
+    float peak_ppm;               // 峰值浓度
+    float dv;                     // 响应幅度：峰值与基线的电压差 (V)
+    float slope;                  // 最大上升斜率 (V/s)
+    float t_rise_s;               // 开始到峰值的时间
+    float tau_rise_s;             // 上升时间常数（一阶响应拟合）
+    float tau_rec_s;              // 恢复时间常数
+    float area;                   // 积分响应 (V·s)
+    float duration_s;             // 开始到结束的时间
+} SensorExposure_t;
 
 /* 公共API */
-void SensorManager_Init(ADC_HandleTypeDef* hadc);
+void SensorManager_Init(void);
 void SensorManager_Update(void);
 SensorData_t* SensorManager_GetData(SensorType_t type);
+const SensorDesc_t* SensorManager_GetDesc(SensorType_t type);
 bool SensorManager_IsReady(SensorType_t type);
+uint8_t SensorManager_StartCalibration(SensorType_t type);
+bool SensorManager_TakeCalibrationResult(SensorCalResult_t* out);
+void SensorManager_WriteHousekeeping(TmWriter_t* w, uint32_t counter);
+void SensorManager_WriteHousekeepingEnd(TmWriter_t* w);
+SensorType_t SensorManager_FindByKey(const char* hk_key);
+uint16_t SensorManager_CodeForPpm(SensorType_t type, float ppm);
+bool SensorManager_StartHistory(SensorHistoryCursor_t* cur, SensorType_t type, uint16_t res_s,
+                                uint32_t from_s, uint32_t to_s);
+int SensorManager_FormatHistory(char* buf, size_t size, SensorHistoryCursor_t* cur);
+const SensorClassification_t* SensorManager_GetClassification(void);
+void SensorManager_TakeAnomaly(SensorAnomaly_t* out, uint32_t hold_ms);
+void SensorManager_SetAnomalyThreshold(float z);
+bool SensorManager_Summarize(SensorType_t type, uint32_t from_tick, float* lo, float* hi, float* mean);
+bool SensorManager_SetDeadband(const char* field, float abs, float rel);
+bool SensorManager_DeadbandExceeded(char* field, size_t size);
+void SensorManager_DeadbandCommit(void);
+bool SensorManager_TakeExposure(SensorExposure_t* out);
 
-/* MQ-3 专用API */
-void MQ3_Init(uint32_t adc_channel);
-uint16_t MQ3_ReadADC(void);
-float MQ3_ReadVoltage(void);
-float MQ3_ReadConcentration(void);
-float MQ3_CalculatePPM(float rs_r0_ratio);
-void MQ3_Calibrate(void);
+/* 供驱动使用：读取传感器所在扫描通道的过采样输出 */
+uint8_t SensorManager_ReadChannel(SensorType_t type, uint16_t* code, uint8_t* bits, uint32_t* tick);
 
 /* 全局变量声明 */
 extern SensorData_t g_sensor_data[SENSOR_TYPE_MAX];
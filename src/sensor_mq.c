@@ -0,0 +1,381 @@
+/**
+ ******************************************************************************
+ * @file           : sensor_mq.c
+ * @brief          : MQ 系列气体传感器驱动（注册表中所有 mq 行共用）
+ ******************************************************************************
+ * @description    : - 码值 → ppm：按每行的曲线参数与 R0 建查找表（mq_curve.c）
+ *                   - 预热：预热时间到且最近一个稳定性窗口内波动足够小后，后台校准 R0
+ *                     （采样中断逐个过采样输出推入滑动窗口，minmax_window.c）
+ *                   - 校准：采样中断里逐个过采样输出累积（Welford 均值/方差，
+ *                     3σ 剔除离群），主循环提交 R0 并重建查找表
+ *                   各传感器状态按注册表行号下标存放（结构体数组化，SoA），
+ *                   采样路径只访问用到的那几列。
+ ******************************************************************************
+ */
+
+#include "sensor_driver.h"
+#include "mq_curve.h"
+#include "minmax_window.h"
+#include "oversample.h"
+#include "dlog.h"
+#include <math.h>
+#include <stdio.h>
+
+/* 硬件（所有 MQ 传感器相同的分压接法） */
+#define MQ_SUPPLY_VOLTAGE       5.0f    // 传感器供电电压 Vc
+/* 电压分压比（根据你的硬件电路调整） */
+// 方案：10kΩ（上臂，靠近AO） + 15kΩ（下臂，接地） ⇒ 5V → 3.0V，ADC安全
+#define VOLTAGE_DIVIDER_RATIO   (5.0f / 3.0f)    // ≈1.6667，分压后最大约3.0V
+#define ADC_VREF                3.3f    // STM32参考电压
+#define ADC_RESOLUTION          4096.0f // 12位ADC
+
+/* 预热稳定性判定 */
+#define MQ_STABLE_WINDOW_MS     90000   // 稳定性检测窗口时长（滑动窗口，与采样率无关）
+#define MQ_STABLE_DELTA_ADC     15      // 窗口内ADC最大波动阈值（12位刻度，越小越严格）
+
+/* R0 校准（每个过采样输出一个样本） */
+#define MQ_CAL_SAMPLES          50      // 采纳样本数
+#define MQ_CAL_WARMUP           8       // 前若干样本只累积，不做离群判断
+#define MQ_CAL_OUTLIER_SIGMA    3.0f    // 偏离均值超过 3σ 视为离群
+#define MQ_CAL_SIGMA_FLOOR      0.005f  // σ 下限（相对均值），避免噪声极小时误剔
+#define MQ_CAL_MAX_REJECTS      25      // 剔除超过此数视为环境不稳定
+#define MQ_CAL_MAX_RSD          0.05f   // 相对标准差上限
+#define MQ_CAL_TIMEOUT_MS       60000   // 采样停滞等异常时的超时
+
+typedef enum {
+    MQ_CAL_IDLE = 0,
+    MQ_CAL_RUNNING,                     // 中断中累积样本
+    MQ_CAL_DONE,                        // 样本已足够，等待主循环提交
+    MQ_CAL_FAILED                       // 离群过多或超时
+} MqCalState_t;
+
+/* 各传感器状态（按注册表行号下标；非 mq 行的列不使用） */
+static struct {
+    /* 换算 */
+    float r0[SENSOR_TYPE_MAX];
+    uint8_t bits[SENSOR_TYPE_MAX];
+    MqCurveLut_t lut[SENSOR_TYPE_MAX];
+    /* 预热 */
+    bool preheated[SENSOR_TYPE_MAX];
+    uint32_t preheat_start[SENSOR_TYPE_MAX];
+    MinMaxWindow_t stable[SENSOR_TYPE_MAX];  // 中断中推入，主循环关中断读取
+    /* 校准：cal_state 只在 IDLE 时由主循环改写其余 cal_* 列 */
+    volatile uint8_t cal_state[SENSOR_TYPE_MAX];
+    bool cal_from_preheat[SENSOR_TYPE_MAX];
+    uint32_t cal_start[SENSOR_TYPE_MAX];
+    uint16_t cal_n[SENSOR_TYPE_MAX];
+    uint16_t cal_rejected[SENSOR_TYPE_MAX];
+    float cal_mean[SENSOR_TYPE_MAX];    // Welford：Rs 均值 (kΩ)
+    float cal_m2[SENSOR_TYPE_MAX];      // Welford：离差平方和
+    bool cal_result_pending[SENSOR_TYPE_MAX];
+    SensorCalResult_t cal_result[SENSOR_TYPE_MAX];
+} g_mq;
+
+/**
+ * @brief  ADC值换算为传感器输出电压
+ * @param  code: ADC值
+ * @param  bits: code 的位数（12 为单次转换，过采样后更高）
+ */
+static float mq_code_to_voltage(uint16_t code, uint8_t bits)
+{
+    /* ADC转电压 */
+    float voltage = (code / (ADC_RESOLUTION * (float)(1u << (bits - OVERSAMPLE_INPUT_BITS)))) * ADC_VREF;
+
+    /* 如果使用了分压电路，需要还原真实电压 */
+    voltage *= VOLTAGE_DIVIDER_RATIO;
+
+    return voltage;
+}
+
+/**
+ * @brief  计算传感器电阻Rs
+ * @param  voltage: 传感器输出电压
+ * @retval Rs (kΩ)
+ */
+static float mq_calculate_rs(SensorType_t id, float voltage)
+{
+    /* 公式：Rs = (Vc - Vout) * RL / Vout */
+    if (voltage <= 0.01f) {
+        voltage = 0.01f;  // 防止除零
+    }
+    return (MQ_SUPPLY_VOLTAGE - voltage) * SensorManager_GetDesc(id)->rl_kohm / voltage;
+}
+
+/**
+ * @brief  当前 R0 下的曲线参数
+ */
+static MqCurveParams_t mq_curve_params(SensorType_t id)
+{
+    const SensorDesc_t* desc = SensorManager_GetDesc(id);
+    const MqCurveParams_t params = {
+        .a = desc->curve_a,
+        .b = desc->curve_b,
+        .rl_kohm = desc->rl_kohm,
+        .vc = MQ_SUPPLY_VOLTAGE,
+        .v_full_scale = ADC_VREF * VOLTAGE_DIVIDER_RATIO,
+        .r0_kohm = g_mq.r0[id],
+        .ppm_max = desc->ppm_max,
+    };
+    return params;
+}
+
+/**
+ * @brief  按当前 R0 与过采样位数重建码值 → ppm 查找表
+ */
+static void mq_build_curve(SensorType_t id)
+{
+    const SensorDesc_t* desc = SensorManager_GetDesc(id);
+    const MqCurveParams_t params = mq_curve_params(id);
+
+    if (!MqCurve_Build(&g_mq.lut[id], &params, g_mq.bits[id])) {
+        printf("[%s] 浓度查找表参数不合法\r\n", desc->name);
+    }
+}
+
+static uint8_t mq_begin_calibration(SensorType_t id, bool from_preheat)
+{
+    if (g_mq.cal_state[id] != MQ_CAL_IDLE) {
+        return 0;
+    }
+    g_mq.cal_from_preheat[id] = from_preheat;
+    g_mq.cal_start[id] = HAL_GetTick();
+    g_mq.cal_n[id] = 0;
+    g_mq.cal_rejected[id] = 0;
+    g_mq.cal_mean[id] = 0.0f;
+    g_mq.cal_m2[id] = 0.0f;
+    g_mq.cal_state[id] = MQ_CAL_RUNNING;   // 最后置位，中断此后才开始累积
+    return 1;
+}
+
+/**
+ * @brief  主循环中检查校准：超时判定，结束后提交 R0 并重建查找表
+ */
+static void mq_service_calibration(SensorType_t id)
+{
+    const char* name = SensorManager_GetDesc(id)->name;
+    uint8_t state = g_mq.cal_state[id];
+
+    if (state == MQ_CAL_RUNNING) {
+        if ((HAL_GetTick() - g_mq.cal_start[id]) < MQ_CAL_TIMEOUT_MS) {
+            return;
+        }
+        __disable_irq();
+        if (g_mq.cal_state[id] == MQ_CAL_RUNNING) {
+            g_mq.cal_state[id] = MQ_CAL_FAILED;
+        }
+        state = g_mq.cal_state[id];
+        __enable_irq();
+    }
+    if (state != MQ_CAL_DONE && state != MQ_CAL_FAILED) {
+        return;
+    }
+
+    /* 中断已停止累积，以下字段只由主循环访问 */
+    uint16_t n = g_mq.cal_n[id];
+    float mean = g_mq.cal_mean[id];
+    float rsd = (n > 1 && mean > 0.0f) ? sqrtf(g_mq.cal_m2[id] / (float)(n - 1)) / mean : 0.0f;
+    bool ok = (state == MQ_CAL_DONE) && (rsd <= MQ_CAL_MAX_RSD);
+
+    if (ok) {
+        g_mq.r0[id] = mean;
+        mq_build_curve(id);
+        DLOG(MQ_CAL_OK, name, mean, n, g_mq.cal_rejected[id], rsd * 100.0f);
+    } else {
+        DLOG(MQ_CAL_FAIL, name, n, g_mq.cal_rejected[id], rsd * 100.0f, g_mq.r0[id]);
+    }
+
+    if (g_mq.cal_from_preheat[id]) {
+        if (ok) {
+            g_mq.preheated[id] = true;
+            printf("[%s] 预热完成，传感器就绪。\r\n", name);
+        } else {
+            __disable_irq();
+            MinMaxWindow_Reset(&g_mq.stable[id]);   // 重新观察满一个窗口后再试
+            __enable_irq();
+        }
+    }
+
+    SensorCalResult_t* r = &g_mq.cal_result[id];
+    r->sensor = id;
+    r->ok = ok;
+    r->from_preheat = g_mq.cal_from_preheat[id];
+    r->r0 = g_mq.r0[id];
+    r->rsd = rsd;
+    r->samples = n;
+    r->rejected = g_mq.cal_rejected[id];
+    g_mq.cal_result_pending[id] = true;
+
+    g_mq.cal_state[id] = MQ_CAL_IDLE;
+}
+
+/* ========== 驱动接口 ========== */
+
+static void mq_init(SensorType_t id)
+{
+    const SensorDesc_t* desc = SensorManager_GetDesc(id);
+    uint16_t code;
+
+    g_mq.r0[id] = desc->r0_kohm;
+    g_mq.bits[id] = OVERSAMPLE_INPUT_BITS;
+    (void)SensorManager_ReadChannel(id, &code, &g_mq.bits[id], NULL);
+    g_mq.preheated[id] = false;
+    g_mq.preheat_start[id] = HAL_GetTick();
+    MinMaxWindow_Init(&g_mq.stable[id], MQ_STABLE_WINDOW_MS);
+    g_mq.cal_state[id] = MQ_CAL_IDLE;
+    g_mq.cal_result_pending[id] = false;
+    mq_build_curve(id);
+
+    printf("[%s] 初始化成功，开始预热...\r\n", desc->name);
+    printf("[%s] 预计预热时间: %lu 秒\r\n", desc->name, (unsigned long)(desc->preheat_ms / 1000));
+}
+
+static void mq_poll(SensorType_t id)
+{
+    /* 提交已结束的校准（新 R0 与查找表一并替换） */
+    mq_service_calibration(id);
+}
+
+static uint8_t mq_sample(SensorType_t id, uint16_t* code, uint32_t* tick)
+{
+    uint8_t bits;
+
+    if (!SensorManager_ReadChannel(id, code, &bits, tick)) {
+        return 0;
+    }
+    if (bits != g_mq.bits[id]) {
+        g_mq.bits[id] = bits;   // 过采样配置变化：按新位数重建
+        mq_build_curve(id);
+    }
+    return 1;
+}
+
+static void mq_convert(SensorType_t id, uint16_t code, SensorData_t* data)
+{
+    uint8_t bits = g_mq.bits[id];
+
+    data->adc_filtered = code;
+    data->adc_bits = bits;
+    data->adc_raw = (uint16_t)(code >> (bits - OVERSAMPLE_INPUT_BITS));
+    data->voltage = mq_code_to_voltage(code, bits);
+    data->concentration = (float)MqCurve_Lookup(&g_mq.lut[id], code) / (float)(1u << MQ_CURVE_PPM_FRAC_BITS);
+}
+
+static SensorStatus_t mq_status(SensorType_t id, const SensorData_t* data)
+{
+    if (g_mq.preheated[id]) {
+        return SENSOR_STATUS_OK;
+    }
+
+    uint32_t now = data->timestamp;
+    uint32_t elapsed = now - g_mq.preheat_start[id];
+    uint8_t extra = data->adc_bits - OVERSAMPLE_INPUT_BITS;
+
+    /* 最近 MQ_STABLE_WINDOW_MS 内的波动范围（窗口随每个样本滑动，不整窗丢弃） */
+    __disable_irq();
+    bool window_ready = MinMaxWindow_Covered(&g_mq.stable[id], HAL_GetTick());
+    uint16_t window_min = MinMaxWindow_Min(&g_mq.stable[id]);
+    uint16_t window_max = MinMaxWindow_Max(&g_mq.stable[id]);
+    __enable_irq();
+
+    bool time_ready = (elapsed >= SensorManager_GetDesc(id)->preheat_ms);
+    bool is_stable = window_ready && window_max >= window_min &&
+        ((uint16_t)(window_max - window_min) <= (MQ_STABLE_DELTA_ADC << extra));
+
+    if (g_mq.cal_state[id] != MQ_CAL_IDLE) {
+        /* 校准进行中，等待结果（成功后由 mq_service_calibration 置为已预热） */
+    } else if (time_ready && is_stable) {
+        /* 预热完成且读数稳定，后台校准 R0 */
+        mq_begin_calibration(id, true);
+        printf("[%s] 预热完成且读数稳定，开始校准 R0...\r\n", SensorManager_GetDesc(id)->name);
+    }
+    return SENSOR_STATUS_PREHEATING;
+}
+
+/**
+ * @brief  采样中断中、每个过采样输出调用一次：预热期间推入稳定性窗口，
+ *         校准时累积样本
+ * @note   Welford 在线均值/方差；热身后偏离均值超过 3σ 的样本剔除
+ */
+static void mq_on_sample_isr(SensorType_t id, uint16_t code)
+{
+    if (!g_mq.preheated[id]) {
+        MinMaxWindow_Push(&g_mq.stable[id], code, HAL_GetTick());
+    }
+    if (g_mq.cal_state[id] != MQ_CAL_RUNNING) {
+        return;
+    }
+
+    float rs = mq_calculate_rs(id, mq_code_to_voltage(code, g_mq.bits[id]));
+    uint16_t n = g_mq.cal_n[id];
+
+    if (n >= MQ_CAL_WARMUP) {
+        float sigma = sqrtf(g_mq.cal_m2[id] / (float)(n - 1));
+        float floor = g_mq.cal_mean[id] * MQ_CAL_SIGMA_FLOOR;
+        if (sigma < floor) {
+            sigma = floor;
+        }
+        if (fabsf(rs - g_mq.cal_mean[id]) > MQ_CAL_OUTLIER_SIGMA * sigma) {
+            if (++g_mq.cal_rejected[id] > MQ_CAL_MAX_REJECTS) {
+                g_mq.cal_state[id] = MQ_CAL_FAILED;
+            }
+            return;
+        }
+    }
+
+    n++;
+    float delta = rs - g_mq.cal_mean[id];
+    g_mq.cal_mean[id] += delta / (float)n;
+    g_mq.cal_m2[id] += delta * (rs - g_mq.cal_mean[id]);
+    g_mq.cal_n[id] = n;
+
+    if (n >= MQ_CAL_SAMPLES) {
+        g_mq.cal_state[id] = MQ_CAL_DONE;
+    }
+}
+
+/**
+ * @brief  开始 R0 校准（非阻塞，需在清洁空气中）
+ * @retval 1: 已开始; 0: 已有校准在进行
+ */
+static uint8_t mq_calibrate(SensorType_t id)
+{
+    if (!mq_begin_calibration(id, false)) {
+        return 0;
+    }
+    printf("[%s] 开始校准，请确保传感器处于清洁空气中...\r\n", SensorManager_GetDesc(id)->name);
+    return 1;
+}
+
+static bool mq_take_cal_result(SensorType_t id, SensorCalResult_t* out)
+{
+    if (!g_mq.cal_result_pending[id]) {
+        return false;
+    }
+    if (out != NULL) {
+        *out = g_mq.cal_result[id];
+    }
+    g_mq.cal_result_pending[id] = false;
+    return true;
+}
+
+/**
+ * @brief  浓度阈值 → 12 位原始码值（随当前 R0 变化）
+ */
+static uint16_t mq_code_for_ppm(SensorType_t id, float ppm)
+{
+    const MqCurveParams_t params = mq_curve_params(id);
+    return (uint16_t)MqCurve_CodeForPpm(&params, ppm, OVERSAMPLE_INPUT_BITS);
+}
+
+const SensorDriver_t g_sensor_driver_mq = {
+    .name = "mq",
+    .init = mq_init,
+    .poll = mq_poll,
+    .sample = mq_sample,
+    .convert = mq_convert,
+    .status = mq_status,
+    .on_sample_isr = mq_on_sample_isr,
+    .calibrate = mq_calibrate,
+    .take_cal_result = mq_take_cal_result,
+    .code_for_ppm = mq_code_for_ppm,
+};
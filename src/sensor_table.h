@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file           : sensor_table.h
+ * @brief          : 传感器注册表（每行一个传感器）
+ ******************************************************************************
+ * @description    : 每行 SENSOR_ENTRY(...) 定义一个传感器，ID 即行序号（从 0 开始），
+ *                   由 sensor_manager 展开为 SensorType_t 枚举与描述表。
+ *
+ *                   新增 MQ 系列传感器：
+ *                   1) 在 adc_scan.h 的 ADC_SCAN_CHANNELS 追加通道，并在
+ *                      HAL_ADC_MspInit 中把引脚配置为模拟输入；
+ *                   2) 在本表追加一行（曲线参数见数据手册 Rs/R0–ppm 双对数曲线）。
+ *                   其他类型的传感器另写一个驱动（见 sensor_driver.h）。
+ *
+ *                   第 0 行为主传感器：其读数同时填入 HK 的兼容字段
+ *                   adc / voltage / sensor_status。HK 总长受 PUS_MAX_PACKET_LEN 限制。
+ *
+ *                   列：ID, 驱动, ADC 通道, 曲线 A, 曲线 B, RL(kΩ), R0 初值(kΩ),
+ *                       浓度上限(ppm), 预热时间(ms), HK 字段前缀, HK 浓度字段名
+ ******************************************************************************
+ */
+
+SENSOR_ENTRY(MQ3_ALCOHOL, mq, ADC_CHANNEL_5, 0.4f, -1.431f, 10.0f, 60.0f, 1000.0f, 180000, "mq3", "alcohol_ppm")
+
+/* 示例：PA1 上的 MQ-135（空气质量），接线后取消注释
+SENSOR_ENTRY(MQ135_AIR,  mq, ADC_CHANNEL_1, 110.47f, -2.862f, 20.0f, 76.63f, 1000.0f, 180000, "mq135", "air_ppm")
+*/
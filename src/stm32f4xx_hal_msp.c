@@ -7,6 +7,10 @@
 
 #include "stm32f4xx_hal.h"
 
+extern DMA_HandleTypeDef hdma_usart1_tx;  // main.c
+extern DMA_HandleTypeDef hdma_adc1;       // main.c
+void Error_Handler(void);
+
 /**
  * @brief  初始化全局MSP
  */
@@ -55,6 +59,27 @@ void HAL_UART_MspInit(UART_HandleTypeDef* huart)
         GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
         GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
         HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+        /* USART1_TX DMA：DMA2 Stream7 Channel4（延迟日志后台发送） */
+        hdma_usart1_tx.Instance = DMA2_Stream7;
+        hdma_usart1_tx.Init.Channel = DMA_CHANNEL_4;
+        hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+        hdma_usart1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_usart1_tx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+        hdma_usart1_tx.Init.Priority = DMA_PRIORITY_LOW;
+        hdma_usart1_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+        {
+            Error_Handler();
+        }
+        __HAL_LINKDMA(huart, hdmatx, hdma_usart1_tx);
+
+        /* 使能USART1中断（DMA 发送结束后由 TC 中断完成收尾） */
+        HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
+        HAL_NVIC_EnableIRQ(USART1_IRQn);
     }
     else if(huart->Instance == USART2)
     {
@@ -88,6 +113,8 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* huart)
     {
         __HAL_RCC_USART1_CLK_DISABLE();
         HAL_GPIO_DeInit(GPIOA, GPIO_PIN_9 | GPIO_PIN_10);
+        HAL_DMA_DeInit(huart->hdmatx);
+        HAL_NVIC_DisableIRQ(USART1_IRQn);
     }
     else if(huart->Instance == USART2)
     {
@@ -117,6 +144,27 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* hadc)
         GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
         GPIO_InitStruct.Pull = GPIO_NOPULL;
         HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+        /* ADC1 DMA：DMA2 Stream0 Channel0，循环模式（双帧缓冲，见 adc_scan.c） */
+        hdma_adc1.Instance = DMA2_Stream0;
+        hdma_adc1.Init.Channel = DMA_CHANNEL_0;
+        hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+        hdma_adc1.Init.Mode = DMA_CIRCULAR;
+        hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;
+        hdma_adc1.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        if (HAL_DMA_Init(&hdma_adc1) != HAL_OK)
+        {
+            Error_Handler();
+        }
+        __HAL_LINKDMA(hadc, DMA_Handle, hdma_adc1);
+
+        /* ADC 全局中断：模拟看门狗（与扫描 DMA 同一优先级，不互相嵌套）与溢出 */
+        HAL_NVIC_SetPriority(ADC_IRQn, 6, 0);
+        HAL_NVIC_EnableIRQ(ADC_IRQn);
     }
 }
 
@@ -127,7 +175,31 @@ void HAL_ADC_MspDeInit(ADC_HandleTypeDef* hadc)
 {
     if(hadc->Instance == ADC1)
     {
+        HAL_NVIC_DisableIRQ(ADC_IRQn);
         __HAL_RCC_ADC1_CLK_DISABLE();
-        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_0);
+        HAL_GPIO_DeInit(GPIOA, GPIO_PIN_5 | GPIO_PIN_1);
+        HAL_DMA_DeInit(hadc->DMA_Handle);
+    }
+}
+
+/**
+ * @brief  TIM Base MSP初始化（TIM2 只用作 ADC 触发源，不开中断）
+ */
+void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* htim)
+{
+    if(htim->Instance == TIM2)
+    {
+        __HAL_RCC_TIM2_CLK_ENABLE();
+    }
+}
+
+/**
+ * @brief  TIM Base MSP反初始化
+ */
+void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* htim)
+{
+    if(htim->Instance == TIM2)
+    {
+        __HAL_RCC_TIM2_CLK_DISABLE();
     }
 }
@@ -8,10 +8,15 @@
 #include "stm32f4xx_hal.h"
 #include "stm32f4xx_it.h"
 #include "esp8266_driver.h"
+#include "dlog.h"
+#include "adc_scan.h"
 
 // 从main.c中引用的句柄
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
+extern DMA_HandleTypeDef hdma_usart1_tx;
+extern DMA_HandleTypeDef hdma_adc1;
+extern ADC_HandleTypeDef hadc1;
 
 /**
  * @brief  NMI中断处理
@@ -96,6 +101,38 @@ void SysTick_Handler(void)
 /*    please refer to the startup file (startup_stm32f4xx.s).                 */
 /******************************************************************************/
 
+/**
+  * @brief This function handles USART1 global interrupt.
+  */
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
+
+/**
+  * @brief This function handles DMA2 stream0 global interrupt (ADC1 scan).
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_adc1);
+}
+
+/**
+  * @brief This function handles ADC1/2/3 global interrupt (ADC1 analog watchdog / overrun).
+  */
+void ADC_IRQHandler(void)
+{
+  HAL_ADC_IRQHandler(&hadc1);
+}
+
+/**
+  * @brief This function handles DMA2 stream7 global interrupt (USART1 TX).
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
 /**
   * @brief This function handles USART2 global interrupt.
   */
@@ -119,3 +156,64 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
     ESP8266_RxCallback();
   }
 }
+
+/**
+  * @brief  Tx Transfer completed callback.
+  * @param  huart: UART handle
+  * @note   USART1 的 DMA 发送完成后, 延迟日志继续发送缓冲区中的下一段。
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart->Instance == USART1)
+  {
+    DLog_OnTxComplete();
+  }
+}
+
+/**
+  * @brief  Conversion DMA half-transfer callback.
+  * @note   ADC1 扫描缓冲的前一帧已写满。
+  */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    AdcScan_OnHalfComplete();
+  }
+}
+
+/**
+  * @brief  Regular conversion complete callback in non blocking mode.
+  * @note   ADC1 扫描缓冲的后一帧已写满（循环 DMA 随后回到缓冲区起点）。
+  */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    AdcScan_OnComplete();
+  }
+}
+
+/**
+  * @brief  ADC error callback (overrun / DMA error).
+  */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    AdcScan_OnError();
+  }
+}
+
+/**
+  * @brief  Analog watchdog callback.
+  * @note   ADC1 被监视通道的转换结果越出窗口（见 AdcScan_ConfigWatchdog）。
+  */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    AdcScan_OnWatchdog();
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file           : tinyml.c
+ * @brief          : int8 量化小模型推理实现
+ ******************************************************************************
+ */
+
+#include "tinyml.h"
+#include "dsp.h"
+
+#include <math.h>
+
+/* int32 累加值 → int8：乘 Q31 倍率后右移 31 + shift 位，四舍五入（.5 向上） */
+static inline int32_t requant(int32_t acc, int32_t mult, int8_t shift) {
+    int32_t total = 31 + shift;
+    int64_t p = (int64_t)acc * mult;
+    return (int32_t)((p + ((int64_t)1 << (total - 1))) >> total);
+}
+
+static inline int8_t clamp_i8(int32_t v, uint8_t relu) {
+    int32_t lo = relu ? 0 : -128;
+    if (v < lo) {
+        return (int8_t)lo;
+    }
+    return (int8_t)((v > 127) ? 127 : v);
+}
+
+/* 整数除法，四舍五入（.5 远离 0） */
+static inline int32_t div_round(int32_t sum, int32_t n) {
+    return (sum >= 0) ? (sum + n / 2) / n : -((-sum + n / 2) / n);
+}
+
+static void conv1d(const TinyMlLayer_t* l, const int8_t* x, uint16_t len, int8_t* y) {
+    int32_t pad = l->kernel / 2;
+
+    for (uint16_t o = 0; o < l->out_ch; o++) {
+        const int8_t* wo = l->weight + (uint32_t)o * l->in_ch * l->kernel;
+        for (int32_t t = 0; t < len; t++) {
+            /* 只累加落在 [0, len) 内的抽头，补零部分贡献为 0 */
+            int32_t k_lo = (t < pad) ? pad - t : 0;
+            int32_t k_hi = (t + l->kernel - pad > len) ? len - t + pad : l->kernel;
+            int32_t acc = l->bias[o];
+            for (uint16_t i = 0; i < l->in_ch; i++) {
+                const int8_t* w = wo + (uint32_t)i * l->kernel;
+                const int8_t* xi = x + (uint32_t)i * len + t - pad;
+                acc += Dsp_DotQ7(w + k_lo, xi + k_lo, (uint32_t)(k_hi - k_lo));
+            }
+            y[(uint32_t)o * len + (uint32_t)t] = clamp_i8(requant(acc, l->mult[o], l->shift[o]), l->relu);
+        }
+    }
+}
+
+static void dense(const TinyMlLayer_t* l, const int8_t* x, int8_t* y) {
+    for (uint16_t o = 0; o < l->out_ch; o++) {
+        const int8_t* w = l->weight + (uint32_t)o * l->in_ch;
+        int32_t acc = l->bias[o] + Dsp_DotQ7(w, x, l->in_ch);
+        y[o] = clamp_i8(requant(acc, l->mult[o], l->shift[o]), l->relu);
+    }
+}
+
+void TinyMl_Quantize(const TinyMlModel_t* m, const float* x, int8_t* q) {
+    for (uint16_t f = 0; f < m->in_features; f++) {
+        for (uint16_t t = 0; t < m->seq_len; t++) {
+            uint32_t idx = (uint32_t)f * m->seq_len + t;
+            long v = lroundf((x[idx] - m->in_offset[f]) * m->in_gain[f]);
+            q[idx] = (int8_t)((v < -128) ? -128 : (v > 127) ? 127 : v);
+        }
+    }
+}
+
+uint8_t TinyMl_Run(const TinyMlModel_t* m, const int8_t* input, int8_t* arena, size_t arena_size,
+                   int8_t* logits) {
+    const int8_t* x = input;
+    uint16_t ch = m->in_features;
+    uint16_t len = m->seq_len;
+    uint8_t slot = 0;
+
+    if (arena_size < 2u * m->max_tensor || m->n_layers == 0) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < m->n_layers; i++) {
+        const TinyMlLayer_t* l = &m->layers[i];
+        int8_t* y = arena + (size_t)slot * m->max_tensor;
+
+        switch (l->op) {
+        case TINYML_OP_CONV1D:
+            if (l->in_ch != ch || (uint32_t)l->out_ch * len > m->max_tensor) {
+                return 0;
+            }
+            conv1d(l, x, len, y);
+            ch = l->out_ch;
+            break;
+        case TINYML_OP_MAXPOOL2: {
+            const int8_t* row = x;
+            uint16_t out_len = len / 2;
+            for (uint16_t c = 0; c < ch; c++, row += len) {
+                for (uint16_t t = 0; t < out_len; t++) {
+                    int8_t a = row[2u * t];
+                    int8_t b = row[2u * t + 1];
+                    y[(uint32_t)c * out_len + t] = (a > b) ? a : b;
+                }
+            }
+            len = out_len;
+            break;
+        }
+        case TINYML_OP_GAP:
+            for (uint16_t c = 0; c < ch; c++) {
+                int32_t sum = 0;
+                for (uint16_t t = 0; t < len; t++) {
+                    sum += x[(uint32_t)c * len + t];
+                }
+                y[c] = (int8_t)div_round(sum, len);
+            }
+            len = 1;
+            break;
+        case TINYML_OP_DENSE:
+            if (l->in_ch != (uint32_t)ch * len || l->out_ch > m->max_tensor) {
+                return 0;
+            }
+            dense(l, x, y);
+            ch = l->out_ch;
+            len = 1;
+            break;
+        default:
+            return 0;
+        }
+        x = y;
+        slot ^= 1u;
+    }
+    if (ch != m->n_classes || len != 1) {
+        return 0;
+    }
+    for (uint16_t c = 0; c < m->n_classes; c++) {
+        logits[c] = x[c];
+    }
+    return 1;
+}
+
+uint8_t TinyMl_Classify(const TinyMlModel_t* m, const int8_t* logits, float* confidence) {
+    uint8_t best = 0;
+    float sum = 0.0f;
+
+    for (uint16_t c = 1; c < m->n_classes; c++) {
+        if (logits[c] > logits[best]) {
+            best = (uint8_t)c;
+        }
+    }
+    for (uint16_t c = 0; c < m->n_classes; c++) {
+        sum += expf((float)(logits[c] - logits[best]) * m->out_scale);
+    }
+    if (confidence != NULL) {
+        *confidence = 1.0f / sum;
+    }
+    return best;
+}
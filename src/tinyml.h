@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ * @file           : tinyml.h
+ * @brief          : int8 量化小模型推理（1D-CNN / MLP）
+ ******************************************************************************
+ * @description    : 层表由 tools/tinyml_export.py 从后端训练的 PyTorch 模型生成
+ *                   （BatchNorm 已折叠进卷积，Dropout 推理时为恒等）。
+ *
+ *                   量化方案：权重按输出通道对称 int8，偏置 int32（尺度 s_w·s_in），
+ *                   激活按张量对称 int8（零点 0，补零填充与 ReLU 都是精确的）。
+ *                   卷积/全连接累加为 int32，再按每通道定点倍率 mult·2^-(31+shift)
+ *                   四舍五入回 int8；池化不改变尺度。全部为整数运算，
+ *                   与导出工具中的 Python 整数参考逐位一致（host_bench tinyml 校验）。
+ *
+ *                   张量布局为 [通道][时间]；MLP 的输入同样按 [特征][时间] 展平
+ *                   （导出时已重排第一层权重的列）。
+ ******************************************************************************
+ */
+
+#ifndef __TINYML_H
+#define __TINYML_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    TINYML_OP_CONV1D = 0,         // 步长 1，补零 kernel/2（same）
+    TINYML_OP_MAXPOOL2,           // 窗口 2、步长 2，长度向下取整
+    TINYML_OP_GAP,                // 全局平均池化，时间维变为 1
+    TINYML_OP_DENSE               // 全连接：输入为 in_ch × 当前长度 展平
+} TinyMlOp_t;
+
+typedef struct {
+    uint8_t op;                   // TinyMlOp_t
+    uint8_t relu;                 // 输出是否融合 ReLU
+    uint8_t kernel;               // 卷积核长度（仅卷积）
+    uint16_t in_ch;               // 输入通道数（全连接为输入特征数）
+    uint16_t out_ch;              // 输出通道数（池化与输入相同）
+    const int8_t* weight;         // 卷积 [out][in][k]；全连接 [out][in]
+    const int32_t* bias;          // [out]
+    const int32_t* mult;          // [out]，Q31 定点倍率 ∈ [2^30, 2^31)
+    const int8_t* shift;          // [out]，额外右移位数（可为负）
+} TinyMlLayer_t;
+
+typedef struct {
+    const TinyMlLayer_t* layers;
+    uint8_t n_layers;
+    uint16_t in_features;         // 输入特征（通道）数
+    uint16_t seq_len;             // 输入时间长度
+    uint16_t n_classes;
+    uint16_t max_tensor;          // 最大中间张量元素数（工作区需 2 倍）
+    const float* in_offset;       // [in_features]：q = round((x - offset) · gain)
+    const float* in_gain;
+    float out_scale;              // logits 反量化尺度
+    const char* const* class_names;
+    const char* const* feature_keys;   // 每个输入特征对应传感器的 HK 前缀
+} TinyMlModel_t;
+
+/**
+ * @brief 浮点输入窗口 [in_features][seq_len] 量化为 int8
+ */
+void TinyMl_Quantize(const TinyMlModel_t* m, const float* x, int8_t* q);
+
+/**
+ * @brief 执行一次推理
+ * @param input  已量化的输入 [in_features][seq_len]
+ * @param arena  工作区，至少 2 × max_tensor 字节（两块交替使用）
+ * @param logits 输出 [n_classes]（int8，尺度 out_scale）
+ * @return 1: 成功; 0: 工作区不足或层表不合法
+ */
+uint8_t TinyMl_Run(const TinyMlModel_t* m, const int8_t* input, int8_t* arena, size_t arena_size,
+                   int8_t* logits);
+
+/**
+ * @brief logits → 类别与置信度（softmax 最大概率）
+ * @return 类别下标
+ */
+uint8_t TinyMl_Classify(const TinyMlModel_t* m, const int8_t* logits, float* confidence);
+
+#endif /* __TINYML_H */
@@ -0,0 +1,474 @@
+/**
+ ******************************************************************************
+ * @file           : tm_writer.c
+ * @brief          : 遥测流式序列化实现
+ ******************************************************************************
+ */
+
+#include "tm_writer.h"
+
+#include <string.h>
+
+#define TM_FIXED_MAX_DECIMALS 6
+#define TM_FIXED_TEXT_MAX     56   // 符号 + 39 位整数 + '.' + 6 位小数
+
+static const uint32_t k_pow10[TM_FIXED_MAX_DECIMALS + 1] = {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u};
+
+/* ========================= 底层写入 ========================= */
+
+static void put(TmWriter_t* w, const void* data, size_t n) {
+    if (w->overflow) {
+        return;
+    }
+    if (n > w->size - w->len) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+}
+
+static void put_byte(TmWriter_t* w, uint8_t b) {
+    put(w, &b, 1);
+}
+
+/* 无符号整数 → 十进制（不加 '\0'），返回位数 */
+static uint8_t utoa64(uint64_t v, char* out) {
+    char tmp[20];
+    uint8_t n = 0;
+
+    /* 32 位以内走 32 位除法（M4 上 64 位除法是库函数调用） */
+    while (v > 0xFFFFFFFFull) {
+        tmp[n++] = (char)('0' + (uint32_t)(v % 10u));
+        v /= 10u;
+    }
+    uint32_t v32 = (uint32_t)v;
+    do {
+        tmp[n++] = (char)('0' + v32 % 10u);
+        v32 /= 10u;
+    } while (v32 != 0);
+    for (uint8_t i = 0; i < n; i++) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+/* CBOR 头：主类型 + 参数（按最短形式） */
+static void cbor_head(TmWriter_t* w, uint8_t major, uint64_t v) {
+    uint8_t b[9];
+    uint8_t n;
+
+    if (v < 24u) {
+        b[0] = (uint8_t)((major << 5) | v);
+        n = 1;
+    } else if (v <= 0xFFu) {
+        b[0] = (uint8_t)((major << 5) | 24u);
+        b[1] = (uint8_t)v;
+        n = 2;
+    } else if (v <= 0xFFFFu) {
+        b[0] = (uint8_t)((major << 5) | 25u);
+        b[1] = (uint8_t)(v >> 8);
+        b[2] = (uint8_t)v;
+        n = 3;
+    } else if (v <= 0xFFFFFFFFu) {
+        b[0] = (uint8_t)((major << 5) | 26u);
+        for (uint8_t i = 0; i < 4; i++) {
+            b[1 + i] = (uint8_t)(v >> (24 - 8 * i));
+        }
+        n = 5;
+    } else {
+        b[0] = (uint8_t)((major << 5) | 27u);
+        for (uint8_t i = 0; i < 8; i++) {
+            b[1 + i] = (uint8_t)(v >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+    put(w, b, n);
+}
+
+static void cbor_int(TmWriter_t* w, bool negative, uint64_t magnitude) {
+    if (negative && magnitude != 0) {
+        cbor_head(w, 1, magnitude - 1);
+    } else {
+        cbor_head(w, 0, magnitude);
+    }
+}
+
+static void json_string_body(TmWriter_t* w, const char* s) {
+    static const char hex[] = "0123456789abcdef";
+    const char* run = s;
+
+    for (; *s != '\0'; s++) {
+        uint8_t c = (uint8_t)*s;
+        if (c != '"' && c != '\\' && c >= 0x20u) {
+            continue;
+        }
+        put(w, run, (size_t)(s - run));
+        if (c == '"' || c == '\\') {
+            char esc[2] = {'\\', (char)c};
+            put(w, esc, 2);
+        } else {
+            char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xFu]};
+            put(w, esc, 6);
+        }
+        run = s + 1;
+    }
+    put(w, run, (size_t)(s - run));
+}
+
+static void write_key(TmWriter_t* w, const char* prefix, const char* suffix) {
+    if (w->enc == TM_ENC_CBOR) {
+        size_t a = strlen(prefix);
+        size_t b = (suffix != NULL) ? strlen(suffix) : 0;
+        cbor_head(w, 3, a + b);
+        put(w, prefix, a);
+        put(w, suffix, b);
+        return;
+    }
+    put_byte(w, '"');
+    json_string_body(w, prefix);
+    if (suffix != NULL) {
+        json_string_body(w, suffix);
+    }
+    put(w, "\":", 2);
+}
+
+/* 值之前：分隔符与键 */
+static void begin_value(TmWriter_t* w, const char* key) {
+    if (w->key_pending) {
+        w->key_pending = false;
+        return;
+    }
+    if (w->depth > 0) {
+        uint32_t bit = 1u << w->depth;
+        if (!(w->first & bit) && w->enc == TM_ENC_JSON) {
+            put_byte(w, ',');
+        }
+        w->first &= ~bit;
+    }
+    if (key != NULL) {
+        write_key(w, key, NULL);
+    }
+}
+
+/* ========================= 定点数 ========================= */
+
+/* 整数部分超出 64 位（|v| ≥ 2^40 且无小数部分）：以 10^9 为基的大数逐段乘 2 */
+static size_t big_integer_text(uint32_t m, int32_t e, char* out) {
+    uint32_t limb[6] = {m % 1000000000u, m / 1000000000u, 0, 0, 0, 0};
+    uint8_t used = (limb[1] != 0) ? 2 : 1;
+
+    while (e > 0) {
+        uint8_t k = (e > 29) ? 29 : (uint8_t)e;
+        uint64_t carry = 0;
+        for (uint8_t i = 0; i < used; i++) {
+            uint64_t t = ((uint64_t)limb[i] << k) + carry;
+            limb[i] = (uint32_t)(t % 1000000000u);
+            carry = t / 1000000000u;
+        }
+        while (carry != 0 && used < 6) {
+            limb[used++] = (uint32_t)(carry % 1000000000u);
+            carry /= 1000000000u;
+        }
+        e -= k;
+    }
+
+    size_t n = utoa64(limb[used - 1], out);
+    for (int8_t i = (int8_t)used - 2; i >= 0; i--) {
+        char digits[10];
+        uint8_t d = utoa64(limb[i], digits);
+        memset(out + n, '0', (size_t)(9 - d));
+        memcpy(out + n + 9 - d, digits, d);
+        n += 9;
+    }
+    return n;
+}
+
+typedef enum {
+    FIXED_FINITE = 0,             // 值 = (negative ? -1 : 1) × scaled / 10^decimals
+    FIXED_BIG,                    // 整数，scaled 不够放：m × 2^e
+    FIXED_NAN,
+    FIXED_INF
+} FixedKind_t;
+
+typedef struct {
+    uint8_t kind;
+    bool negative;
+    uint64_t scaled;
+    uint32_t m;
+    int32_t e;
+} FixedValue_t;
+
+/* 单精度精确值 × 10^decimals，四舍五入（恰为一半时取偶，与 printf 一致） */
+static void fixed_decompose(float v, uint8_t decimals, FixedValue_t* out) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+
+    uint32_t exp = (bits >> 23) & 0xFFu;
+    uint32_t frac = bits & 0x7FFFFFu;
+    out->negative = (bits >> 31) != 0;
+    out->scaled = 0;
+
+    if (exp == 0xFFu) {
+        out->kind = (frac != 0) ? FIXED_NAN : FIXED_INF;
+        return;
+    }
+    uint32_t m = (exp == 0) ? frac : (frac | 0x800000u);
+    int32_t e = (exp == 0) ? -149 : (int32_t)exp - 150;
+    out->kind = FIXED_FINITE;
+
+    if (e >= 0) {
+        /* 整数：m × 2^e × 10^d，m < 2^24、10^6 < 2^20 */
+        if (e <= 63 - 24 - 20) {
+            out->scaled = ((uint64_t)m << e) * k_pow10[decimals];
+        } else {
+            out->kind = FIXED_BIG;
+            out->m = m;
+            out->e = e;
+        }
+        return;
+    }
+
+    uint64_t p = (uint64_t)m * k_pow10[decimals];   // < 2^44
+    uint32_t s = (uint32_t)(-e);
+    if (s >= 63) {
+        return;   // |v| × 10^d < 2^44 / 2^63，舍入为 0
+    }
+    uint64_t q = p >> s;
+    uint64_t r = p & ((1ull << s) - 1u);
+    uint64_t half = 1ull << (s - 1);
+    if (r > half || (r == half && (q & 1u))) {
+        q++;
+    }
+    out->scaled = q;
+}
+
+static size_t fixed_text(const FixedValue_t* fv, uint8_t decimals, char* out) {
+    size_t n = 0;
+
+    /* NaN 不带符号（newlib 的 printf 如此） */
+    if (fv->kind == FIXED_NAN) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (fv->negative) {
+        out[n++] = '-';
+    }
+    if (fv->kind == FIXED_INF) {
+        memcpy(out + n, "inf", 3);
+        return n + 3;
+    }
+    if (fv->kind == FIXED_BIG) {
+        n += big_integer_text(fv->m, fv->e, out + n);
+        if (decimals > 0) {
+            out[n++] = '.';
+            memset(out + n, '0', decimals);
+            n += decimals;
+        }
+        return n;
+    }
+
+    char digits[20];
+    uint8_t d = utoa64(fv->scaled, digits);
+    if (d <= decimals) {
+        /* 补足前导 0：至少一位整数 */
+        uint8_t pad = (uint8_t)(decimals + 1 - d);
+        memmove(digits + pad, digits, d);
+        memset(digits, '0', pad);
+        d = (uint8_t)(decimals + 1);
+    }
+    uint8_t int_len = (uint8_t)(d - decimals);
+    memcpy(out + n, digits, int_len);
+    n += int_len;
+    if (decimals > 0) {
+        out[n++] = '.';
+        memcpy(out + n, digits + int_len, decimals);
+        n += decimals;
+    }
+    return n;
+}
+
+size_t TmWriter_FormatFixed(char* out, size_t size, float v, uint8_t decimals) {
+    char text[TM_FIXED_TEXT_MAX];
+    FixedValue_t fv;
+
+    if (decimals > TM_FIXED_MAX_DECIMALS) {
+        decimals = TM_FIXED_MAX_DECIMALS;
+    }
+    fixed_decompose(v, decimals, &fv);
+    size_t n = fixed_text(&fv, decimals, text);
+    if (n > size) {
+        return 0;
+    }
+    memcpy(out, text, n);
+    return n;
+}
+
+/* ========================= 公共接口 ========================= */
+
+void TmWriter_Init(TmWriter_t* w, void* buf, size_t size, TmEncoding_t enc) {
+    memset(w, 0, sizeof(*w));
+    w->buf = (uint8_t*)buf;
+    w->enc = (uint8_t)enc;
+    /* JSON 为结尾的 '\0' 留一个字节 */
+    if (enc == TM_ENC_JSON) {
+        w->size = (size > 0) ? size - 1 : 0;
+        w->overflow = (size == 0);
+    } else {
+        w->size = size;
+    }
+}
+
+static void begin_container(TmWriter_t* w, const char* key, uint8_t json_open, uint8_t cbor_open) {
+    begin_value(w, key);
+    put_byte(w, (w->enc == TM_ENC_CBOR) ? cbor_open : json_open);
+    if (w->depth + 1 >= TM_WRITER_MAX_DEPTH) {
+        w->overflow = true;
+        return;
+    }
+    w->depth++;
+    w->first |= 1u << w->depth;
+}
+
+static void end_container(TmWriter_t* w, uint8_t json_close) {
+    if (w->depth == 0) {
+        w->overflow = true;
+        return;
+    }
+    w->depth--;
+    put_byte(w, (w->enc == TM_ENC_CBOR) ? 0xFFu : json_close);
+}
+
+void TmWriter_BeginObject(TmWriter_t* w, const char* key) {
+    begin_container(w, key, '{', 0xBFu);
+}
+
+void TmWriter_EndObject(TmWriter_t* w) {
+    end_container(w, '}');
+}
+
+void TmWriter_BeginArray(TmWriter_t* w, const char* key) {
+    begin_container(w, key, '[', 0x9Fu);
+}
+
+void TmWriter_EndArray(TmWriter_t* w) {
+    end_container(w, ']');
+}
+
+void TmWriter_Key(TmWriter_t* w, const char* prefix, const char* suffix) {
+    begin_value(w, NULL);
+    write_key(w, prefix, suffix);
+    w->key_pending = true;
+}
+
+void TmWriter_Uint(TmWriter_t* w, const char* key, uint32_t v) {
+    begin_value(w, key);
+    if (w->enc == TM_ENC_CBOR) {
+        cbor_head(w, 0, v);
+        return;
+    }
+    char text[10];
+    put(w, text, utoa64(v, text));
+}
+
+void TmWriter_Int(TmWriter_t* w, const char* key, int32_t v) {
+    uint32_t mag = (v < 0) ? 0u - (uint32_t)v : (uint32_t)v;
+
+    begin_value(w, key);
+    if (w->enc == TM_ENC_CBOR) {
+        cbor_int(w, v < 0, mag);
+        return;
+    }
+    char text[11];
+    uint8_t n = 0;
+    if (v < 0) {
+        text[n++] = '-';
+    }
+    n = (uint8_t)(n + utoa64(mag, text + n));
+    put(w, text, n);
+}
+
+void TmWriter_Str(TmWriter_t* w, const char* key, const char* s) {
+    if (s == NULL) {
+        s = "";
+    }
+    begin_value(w, key);
+    if (w->enc == TM_ENC_CBOR) {
+        size_t n = strlen(s);
+        cbor_head(w, 3, n);
+        put(w, s, n);
+        return;
+    }
+    put_byte(w, '"');
+    json_string_body(w, s);
+    put_byte(w, '"');
+}
+
+void TmWriter_Fixed(TmWriter_t* w, const char* key, float v, uint8_t decimals) {
+    FixedValue_t fv;
+
+    if (decimals > TM_FIXED_MAX_DECIMALS) {
+        decimals = TM_FIXED_MAX_DECIMALS;
+    }
+    fixed_decompose(v, decimals, &fv);
+    begin_value(w, key);
+
+    if (w->enc == TM_ENC_JSON) {
+        char text[TM_FIXED_TEXT_MAX];
+        put(w, text, fixed_text(&fv, decimals, text));
+        return;
+    }
+
+    if (fv.kind == FIXED_NAN || fv.kind == FIXED_INF) {
+        uint8_t half[3] = {0xF9u, (fv.kind == FIXED_NAN) ? 0x7Eu : (fv.negative ? 0xFCu : 0x7Cu), 0x00u};
+        put(w, half, sizeof(half));
+    } else if (fv.kind == FIXED_BIG) {
+        /* 超出 64 位尾数：直接写 float32，单精度本身即精确值 */
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        uint8_t b[5] = {0xFAu, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits};
+        put(w, b, sizeof(b));
+    } else if (decimals == 0) {
+        cbor_int(w, fv.negative, fv.scaled);
+    } else {
+        /* 十进制分数 tag 4：[指数 -decimals, 尾数] */
+        uint8_t head[3] = {0xC4u, 0x82u, (uint8_t)(0x20u | (decimals - 1u))};
+        put(w, head, sizeof(head));
+        cbor_int(w, fv.negative, fv.scaled);
+    }
+}
+
+TmWriterMark_t TmWriter_Mark(const TmWriter_t* w) {
+    TmWriterMark_t m = {w->len, w->first, w->depth, w->key_pending, w->overflow};
+    return m;
+}
+
+void TmWriter_Rollback(TmWriter_t* w, TmWriterMark_t m) {
+    w->len = m.len;
+    w->first = m.first;
+    w->depth = m.depth;
+    w->key_pending = m.key_pending;
+    w->overflow = m.overflow;
+}
+
+void TmWriter_Reserve(TmWriter_t* w, int32_t bytes) {
+    if (bytes >= 0) {
+        if ((size_t)bytes > w->size - w->len) {
+            w->overflow = true;
+            return;
+        }
+        w->size -= (size_t)bytes;
+    } else {
+        w->size += (size_t)(-bytes);
+    }
+}
+
+size_t TmWriter_Finish(TmWriter_t* w) {
+    if (w->overflow || w->depth != 0 || w->key_pending) {
+        return 0;
+    }
+    if (w->enc == TM_ENC_JSON) {
+        w->buf[w->len] = '\0';
+    }
+    return w->len;
+}
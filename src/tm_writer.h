@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file           : tm_writer.h
+ * @brief          : 遥测流式序列化（JSON / CBOR），不分配内存、不用浮点 printf
+ ******************************************************************************
+ * @description    : 直接写入调用方给出的缓冲区，每次写入都做边界检查；放不下时置溢出标志，
+ *                   之后的写入全部忽略，TmWriter_Finish 返回 0（不会发出截断的包）。
+ *
+ *                   - 分隔符（逗号）与嵌套由写入器维护，调用方只按顺序给出键和值；
+ *                   - TmWriter_Fixed 按 IEEE 754 单精度的精确值四舍五入（恰为一半时取偶），
+ *                     与 printf("%.Nf", (double)v) 逐字节一致，只用整数运算；
+ *                   - JSON 输出与原先 snprintf 拼出的报文逐字节相同（地面解析不变）；
+ *                     CBOR 用不定长 map/array，定点数编码为十进制分数（tag 4：[-N, 尾数]），
+ *                     数值同样精确；
+ *                   - TmWriter_Mark / TmWriter_Rollback：可选字段放不下时整体撤销，
+ *                     TmWriter_Reserve 为随后必写的结尾预留空间。
+ *
+ *                   PUS 用户数据约定为 JSON（pus_link.h），固件下传一律用 TM_ENC_JSON；
+ *                   CBOR 供二进制链路使用，体积对比见 host_bench tm_writer。
+ ******************************************************************************
+ */
+
+#ifndef __TM_WRITER_H
+#define __TM_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define TM_WRITER_MAX_DEPTH 8
+
+typedef enum {
+    TM_ENC_JSON = 0,
+    TM_ENC_CBOR
+} TmEncoding_t;
+
+typedef struct {
+    uint8_t* buf;
+    size_t size;                  // 可写上限（扣除预留与 JSON 结尾的 '\0'）
+    size_t len;
+    uint32_t first;               // 第 d 位：第 d 层容器尚无元素
+    uint8_t depth;
+    uint8_t enc;
+    bool key_pending;             // 已由 TmWriter_Key 写出键，下一个值不再加分隔符
+    bool overflow;
+} TmWriter_t;
+
+/* 回退点 */
+typedef struct {
+    size_t len;
+    uint32_t first;
+    uint8_t depth;
+    bool key_pending;
+    bool overflow;
+} TmWriterMark_t;
+
+void TmWriter_Init(TmWriter_t* w, void* buf, size_t size, TmEncoding_t enc);
+
+/* key 为 NULL 时写入数组元素（或顶层值），否则写入对象成员 */
+void TmWriter_BeginObject(TmWriter_t* w, const char* key);
+void TmWriter_EndObject(TmWriter_t* w);
+void TmWriter_BeginArray(TmWriter_t* w, const char* key);
+void TmWriter_EndArray(TmWriter_t* w);
+
+/**
+ * @brief 写出由前缀与后缀拼成的键（如 "mq3" + "_adc"），随后的值以 key = NULL 写入
+ */
+void TmWriter_Key(TmWriter_t* w, const char* prefix, const char* suffix);
+
+void TmWriter_Uint(TmWriter_t* w, const char* key, uint32_t v);
+void TmWriter_Int(TmWriter_t* w, const char* key, int32_t v);
+void TmWriter_Str(TmWriter_t* w, const char* key, const char* s);
+
+/**
+ * @brief 定点数：小数点后 decimals 位（0~6），与 printf("%.*f") 一致（含 "-0.00"、"nan"、"inf"）
+ */
+void TmWriter_Fixed(TmWriter_t* w, const char* key, float v, uint8_t decimals);
+
+TmWriterMark_t TmWriter_Mark(const TmWriter_t* w);
+
+/**
+ * @brief 回到回退点（溢出标志恢复为设回退点时的状态）
+ */
+void TmWriter_Rollback(TmWriter_t* w, TmWriterMark_t m);
+
+/**
+ * @brief 预留（bytes > 0）或归还（bytes < 0）结尾所需的空间
+ */
+void TmWriter_Reserve(TmWriter_t* w, int32_t bytes);
+
+static inline bool TmWriter_Ok(const TmWriter_t* w) {
+    return !w->overflow;
+}
+
+/**
+ * @brief 结束写入：JSON 补 '\0'
+ * @return 报文长度（不含 '\0'）；溢出或容器未闭合时为 0
+ */
+size_t TmWriter_Finish(TmWriter_t* w);
+
+/**
+ * @brief 把定点数格式化为文本（不加 '\0'），供日志等非遥测场合使用
+ * @return 写入长度；放不下时为 0
+ */
+size_t TmWriter_FormatFixed(char* out, size_t size, float v, uint8_t decimals);
+
+#endif /* __TM_WRITER_H */
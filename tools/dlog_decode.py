@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""
+延迟日志（src/dlog.c）二进制流解码器
+
+固件的 DLOG(...) 只在 USART1 上输出“消息ID + 原始参数”，格式串保存在
+src/dlog_catalog.h。本工具读取目录，把记录还原成与原 printf 相同的文本：
+
+    [0xA5][len][id:2][tick_ms:4][args...][xor]     （小端）
+
+- ID 即目录中 DLOG_MSG 的行序号（从 0 开始）；
+- 参数按格式串解析：整数/浮点各 4 字节，%s 为 1 字节长度前缀 + 内容；
+- TEXT 记录（ID 0）是 printf 的文本透传，原样输出；
+- 校验失败或帧不完整时向后滑动 1 字节重新同步，并计入统计。
+
+用法：
+    python tools/dlog_decode.py capture.bin              # 解码抓包文件
+    cat /dev/ttyUSB0 | python tools/dlog_decode.py -     # 从标准输入
+    python tools/dlog_decode.py --port /dev/ttyUSB0      # 直接读串口（需要 pyserial）
+    python tools/dlog_decode.py --tick capture.bin       # 每条消息前加 [tick_ms]
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import re
+import struct
+import sys
+from typing import BinaryIO, Iterator, List, Optional, Tuple
+
+SYNC = 0xA5
+ID_TEXT = 0
+
+DEFAULT_CATALOG = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "dlog_catalog.h")
+
+MSG_RE = re.compile(r'^\s*DLOG_MSG\(\s*(\w+)\s*,\s*((?:"(?:[^"\\]|\\.)*"\s*)+)\)', re.M)
+STR_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+SPEC_RE = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z)?([diuxXcfeEgGs%])")
+
+C_ESCAPES = {"n": "\n", "r": "\r", "t": "\t", "\\": "\\", '"': '"', "0": "\0"}
+
+
+def c_unescape(s: str) -> str:
+    return re.sub(r"\\(.)", lambda m: C_ESCAPES.get(m.group(1), m.group(1)), s)
+
+
+def load_catalog(path: str) -> List[Tuple[str, str]]:
+    with open(path, "r", encoding="utf-8") as f:
+        text = f.read()
+    # 去掉注释，避免注释里的示例被当成消息
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    catalog = []
+    for m in MSG_RE.finditer(text):
+        fmt = "".join(c_unescape(s) for s in STR_RE.findall(m.group(2)))
+        catalog.append((m.group(1), fmt))
+    return catalog
+
+
+def format_record(fmt: str, payload: bytes) -> str:
+    """按格式串逐个说明符消费 payload，返回格式化后的文本。"""
+    out = []
+    pos = 0
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, _length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+
+        spec = "%" + flags + width + ("." + prec if prec is not None else "")
+        if conv == "s":
+            if pos >= len(payload):
+                out.append("<?>")
+                continue
+            n = payload[pos]
+            s = payload[pos + 1:pos + 1 + n].decode("utf-8", errors="replace")
+            pos += 1 + n
+            out.append((spec + "s") % s)
+            continue
+
+        if pos + 4 > len(payload):
+            out.append("<?>")
+            continue
+        raw = payload[pos:pos + 4]
+        pos += 4
+        if conv in "feEgG":
+            out.append((spec + conv) % struct.unpack("<f", raw)[0])
+        elif conv in "di":
+            out.append((spec + "d") % struct.unpack("<i", raw)[0])
+        elif conv == "c":
+            out.append((spec + "c") % chr(raw[0]))
+        else:
+            out.append((spec + ("d" if conv == "u" else conv)) % struct.unpack("<I", raw)[0])
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, catalog: List[Tuple[str, str]], show_tick: bool = False):
+        self.catalog = catalog
+        self.show_tick = show_tick
+        self.buf = bytearray()
+        self.records = 0
+        self.resyncs = 0
+        self.unknown = 0
+
+    def feed(self, data: bytes) -> Iterator[str]:
+        self.buf.extend(data)
+        buf = self.buf
+        while True:
+            start = buf.find(SYNC)
+            if start < 0:
+                if buf:
+                    self.resyncs += 1
+                buf.clear()
+                return
+            if start > 0:
+                self.resyncs += 1
+                del buf[:start]
+            if len(buf) < 2:
+                return
+            body_len = buf[1]
+            total = 2 + body_len + 1
+            if body_len < 6:
+                self.resyncs += 1
+                del buf[:1]
+                continue
+            if len(buf) < total:
+                return
+
+            x = 0
+            for b in buf[1:2 + body_len]:
+                x ^= b
+            if x != buf[total - 1]:
+                self.resyncs += 1
+                del buf[:1]
+                continue
+
+            msg_id, tick = struct.unpack_from("<HI", buf, 2)
+            payload = bytes(buf[8:2 + body_len])
+            del buf[:total]
+            self.records += 1
+            yield self.render(msg_id, tick, payload)
+
+    def render(self, msg_id: int, tick: int, payload: bytes) -> str:
+        prefix = "[%10u] " % tick if self.show_tick else ""
+        if msg_id == ID_TEXT and payload:
+            n = payload[0]
+            return prefix + payload[1:1 + n].decode("utf-8", errors="replace")
+        if msg_id >= len(self.catalog):
+            self.unknown += 1
+            return prefix + "<未知消息 id=%u payload=%s>\n" % (msg_id, payload.hex())
+        return prefix + format_record(self.catalog[msg_id][1], payload)
+
+
+def open_source(args: argparse.Namespace) -> BinaryIO:
+    if args.port:
+        try:
+            import serial  # type: ignore
+        except ImportError:
+            sys.exit("读取串口需要 pyserial：pip install pyserial（或用 cat 端口 | dlog_decode.py -）")
+        return serial.Serial(args.port, args.baud, timeout=0.2)
+    if args.input in (None, "-"):
+        return sys.stdin.buffer
+    return open(args.input, "rb")
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    ap = argparse.ArgumentParser(description="解码 spaceNose 延迟日志（DLOG）二进制流")
+    ap.add_argument("input", nargs="?", default="-", help="抓包文件，- 表示标准输入")
+    ap.add_argument("--catalog", default=DEFAULT_CATALOG, help="消息目录（默认 src/dlog_catalog.h）")
+    ap.add_argument("--port", help="直接读取串口设备（需要 pyserial）")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--tick", action="store_true", help="每条消息前显示设备 tick（毫秒）")
+    ap.add_argument("--list", action="store_true", help="列出目录中的消息 ID 后退出")
+    args = ap.parse_args(argv)
+
+    catalog = load_catalog(args.catalog)
+    if args.list:
+        for i, (name, fmt) in enumerate(catalog):
+            print("%3d  %-18s %r" % (i, name, fmt))
+        return 0
+
+    dec = Decoder(catalog, show_tick=args.tick)
+    src = open_source(args)
+    out = sys.stdout
+    try:
+        while True:
+            chunk = src.read(4096) if not args.port else src.read(src.in_waiting or 1)
+            if not chunk:
+                if args.port:
+                    continue
+                break
+            for line in dec.feed(chunk):
+                out.write(line)
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print("\n[dlog] 记录 %d 条，重同步 %d 次，未知ID %d 条"
+              % (dec.records, dec.resyncs, dec.unknown), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
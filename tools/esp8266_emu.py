@@ -0,0 +1,761 @@
+#!/usr/bin/env python3
+"""
+ESP8266 AT 固件模拟器（主机端，无需硬件）
+
+在 Linux 上模拟本项目用到的 AT 指令子集，让 src/esp8266_driver.c 可以在
+没有 STM32/ESP8266 的情况下被驱动：
+
+- 串口侧：创建一个伪终端（pty），主机 HAL 垫片（host/hal）通过环境变量
+  SPACENOSE_ESP_TTY 打开它；也可以用 --serial 直接挂到 USB 串口，
+  让真实 STM32 的 USART2 接上来。
+- 网络侧：CIPSTART 会真正连到本机 TCP 服务器（例如 backend/main.py 的 8888 端口），
+  上下行字节原样桥接，下行按 +IPD,<len>:<data> 格式交给驱动。
+  "UDP" 连接每次 CIPSEND 发一个数据报，收到的每个数据报作为一条 +IPD 交给驱动。
+
+支持的指令：AT, ATE0/ATE1, AT+GMR, AT+RST, AT+CWMODE, AT+CWJAP, AT+CWQAP, AT+CWAUTOCONN,
+AT+CIFSR, AT+CIPMUX, AT+CIPMODE, AT+CIPSTART, AT+CIPSEND, AT+CIPCLOSE, AT+CIPSTATUS
+（CWMODE/CWJAP 接受 _CUR/_DEF 后缀；CWJAP_DEF 保存热点，开启自动连接时上电/AT+RST 后自行连接）
+
+链路注入（全部可由 --seed 复现）：
+- --latency-ms       每个方向的单程时延
+- --bandwidth-Bps    空口带宽（字节/秒，0 表示不限）
+- --uart-baud        串口速率（影响模拟器→驱动的字节节拍）
+- --loss             下行 +IPD payload 的逐字节丢失概率（模拟串口噪声）
+- --up-loss          上行 payload 的逐字节丢失概率（UDP 连接按整个数据报丢弃）
+- --disconnect-every-s / --wifi-drop-every-s  周期性断开 TCP / WiFi
+
+运行期间每 --report-every-s 秒打印一次统计；Ctrl+C 退出时打印汇总，
+并可用 --stats-json 写出 JSON（吞吐、连接次数、每次重连耗时等）。
+
+示例：
+    python tools/esp8266_emu.py --link /tmp/spacenose-esp8266 --remote-host 127.0.0.1 \\
+        --latency-ms 20 --bandwidth-Bps 20000 --disconnect-every-s 30 --seed 1
+"""
+
+from __future__ import annotations
+
+import argparse
+import heapq
+import json
+import os
+import random
+import re
+import selectors
+import signal
+import socket
+import sys
+import termios
+import time
+import tty
+from dataclasses import dataclass, field
+from typing import Callable, Dict, List, Optional, Tuple
+
+FIRMWARE_VERSION = [
+    "AT version:1.7.4.0(May 11 2020 19:13:04)",
+    "SDK version:3.0.4(9532ceb)",
+    "compile time:May 27 2020 10:12:17",
+    "Bin version(Wroom 02):1.7.4",
+]
+
+CIPSEND_MAX = 2048  # ESP8266 AT 单次 CIPSEND 上限
+IPD_CHUNK = 1460  # 下行按 TCP MSS 切分 +IPD
+
+
+@dataclass
+class Link:
+    link_id: int
+    kind: str
+    remote_ip: str
+    remote_port: int
+    sock: socket.socket
+    local_port: int
+    opened_at: float
+    up_busy_until: float = 0.0
+    down_busy_until: float = 0.0
+
+
+@dataclass
+class Stats:
+    started_at: float = field(default_factory=time.monotonic)
+    up_bytes: int = 0
+    down_bytes: int = 0
+    up_dropped: int = 0
+    down_dropped: int = 0
+    up_datagrams: int = 0
+    up_datagrams_dropped: int = 0
+    cipsend_count: int = 0
+    connects: int = 0
+    connect_failures: int = 0
+    disconnects_injected: int = 0
+    wifi_drops_injected: int = 0
+    remote_closes: int = 0
+    reconnect_ms: List[int] = field(default_factory=list)
+
+    def summary(self) -> Dict[str, object]:
+        elapsed = max(1e-6, time.monotonic() - self.started_at)
+        rc = sorted(self.reconnect_ms)
+        return {
+            "elapsed_s": round(elapsed, 3),
+            "up_bytes": self.up_bytes,
+            "down_bytes": self.down_bytes,
+            "up_Bps": round(self.up_bytes / elapsed, 1),
+            "down_Bps": round(self.down_bytes / elapsed, 1),
+            "up_dropped": self.up_dropped,
+            "down_dropped": self.down_dropped,
+            "up_datagrams": self.up_datagrams,
+            "up_datagrams_dropped": self.up_datagrams_dropped,
+            "cipsend_count": self.cipsend_count,
+            "connects": self.connects,
+            "connect_failures": self.connect_failures,
+            "disconnects_injected": self.disconnects_injected,
+            "wifi_drops_injected": self.wifi_drops_injected,
+            "remote_closes": self.remote_closes,
+            "reconnect_ms": rc,
+            "reconnect_ms_avg": round(sum(rc) / len(rc), 1) if rc else None,
+            "reconnect_ms_max": rc[-1] if rc else None,
+        }
+
+
+class Scheduler:
+    """按时间排序的回调队列：所有时延/带宽效果都通过它实现。"""
+
+    def __init__(self) -> None:
+        self._heap: List[Tuple[float, int, Callable[[], None]]] = []
+        self._seq = 0
+
+    def at(self, when: float, fn: Callable[[], None]) -> None:
+        self._seq += 1
+        heapq.heappush(self._heap, (when, self._seq, fn))
+
+    def run_due(self, now: float) -> None:
+        while self._heap and self._heap[0][0] <= now:
+            _, _, fn = heapq.heappop(self._heap)
+            fn()
+
+    def next_timeout(self, now: float, default: float) -> float:
+        if not self._heap:
+            return default
+        return max(0.0, min(default, self._heap[0][0] - now))
+
+
+class Esp8266Emulator:
+    def __init__(self, fd: int, args: argparse.Namespace) -> None:
+        self.fd = fd
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.sched = Scheduler()
+        self.sel = selectors.DefaultSelector()
+        self.stats = Stats()
+
+        self.echo = True
+        self.cwmode = 1
+        self.cipmux = 0
+        self.cipmode = 0
+        self.wifi_up = False
+        self.ip = "0.0.0.0"
+        self.autoconn = True            # 出厂默认开启
+        self.saved_ap = args.saved_ap   # flash 中已保存热点（CWJAP_DEF）
+        self.links: Dict[int, Link] = {}
+
+        self.line_buf = bytearray()
+        self.send_expect = 0  # CIPSEND 数据模式下剩余字节数
+        self.send_link = 0
+        self.send_buf = bytearray()
+        self.passthrough = False
+        self.pass_buf = bytearray()
+        self.pass_last_rx = 0.0
+
+        self.uart_out = bytearray()
+        self.uart_next = 0.0
+        self.uart_Bps = max(1.0, args.uart_baud / 10.0)
+
+        self.down_since: Optional[float] = None  # 链路中断起点（用于重连耗时）
+
+        os.set_blocking(fd, False)
+        self.sel.register(fd, selectors.EVENT_READ, ("uart", None))
+
+        now = time.monotonic()
+        if args.disconnect_every_s > 0:
+            self.sched.at(now + args.disconnect_every_s, self._inject_disconnect)
+        if args.wifi_drop_every_s > 0:
+            self.sched.at(now + args.wifi_drop_every_s, self._inject_wifi_drop)
+        if args.report_every_s > 0:
+            self.sched.at(now + args.report_every_s, self._report)
+        self._boot_autojoin(now)
+
+    # ----------------- 串口输出 -----------------
+
+    def uart_write(self, data: bytes) -> None:
+        self.uart_out.extend(data)
+
+    def reply(self, text: str) -> None:
+        self.uart_write(text.encode("utf-8"))
+
+    def reply_later(self, delay_s: float, text: str) -> None:
+        self.sched.at(time.monotonic() + delay_s, lambda: self.reply(text))
+
+    def _pump_uart(self, now: float) -> None:
+        if not self.uart_out:
+            self.uart_next = now
+            return
+        budget = int((now - self.uart_next) * self.uart_Bps)
+        if budget <= 0:
+            return
+        chunk = bytes(self.uart_out[:budget])
+        try:
+            n = os.write(self.fd, chunk)
+        except BlockingIOError:
+            return
+        except OSError:
+            # 对端（驱动进程）尚未打开 pty：丢弃，与真实模块上电输出无人接收一致
+            n = len(chunk)
+        del self.uart_out[:n]
+        self.uart_next += n / self.uart_Bps
+
+    # ----------------- 串口输入 -----------------
+
+    def on_uart_readable(self) -> None:
+        try:
+            data = os.read(self.fd, 4096)
+        except (BlockingIOError, OSError):
+            return
+        for b in data:
+            self._on_uart_byte(b)
+
+    def _on_uart_byte(self, b: int) -> None:
+        if self.send_expect > 0:
+            self.send_buf.append(b)
+            self.send_expect -= 1
+            if self.send_expect == 0:
+                self._finish_cipsend()
+            return
+
+        if self.passthrough:
+            self.pass_buf.append(b)
+            self.pass_last_rx = time.monotonic()
+            return
+
+        self.line_buf.append(b)
+        if self.line_buf.endswith(b"\r\n"):
+            line = bytes(self.line_buf[:-2]).decode("utf-8", errors="replace")
+            self.line_buf.clear()
+            if self.echo:
+                self.reply(line + "\r\r\n")
+            self.handle_command(line.strip())
+        elif len(self.line_buf) > 512:
+            self.line_buf.clear()
+
+    # ----------------- AT 指令 -----------------
+
+    def handle_command(self, line: str) -> None:
+        if not line:
+            return
+        up = line.upper()
+        lat = self.args.latency_ms / 1000.0
+
+        if up == "AT":
+            self.reply("\r\nOK\r\n")
+        elif up in ("ATE0", "ATE1"):
+            self.echo = up == "ATE1"
+            self.reply("\r\nOK\r\n")
+        elif up == "AT+GMR":
+            self.reply("".join(v + "\r\n" for v in FIRMWARE_VERSION) + "OK\r\n")
+        elif up == "AT+RST":
+            self._close_all_links(notify=False)
+            self.wifi_up = False
+            self.reply("\r\nOK\r\n")
+            self.reply_later(0.5, "\r\n ets Jan  8 2013,rst cause:2, boot mode:(3,7)\r\n\r\nready\r\n")
+            self._boot_autojoin(time.monotonic() + 0.5)
+        elif up.startswith("AT+CWMODE"):
+            m = re.match(r"AT\+CWMODE(?:_CUR|_DEF)?=(\d)", up)
+            if m:
+                self.cwmode = int(m.group(1))
+                self.reply("\r\nOK\r\n")
+            else:
+                self.reply("+CWMODE:%d\r\n\r\nOK\r\n" % self.cwmode)
+        elif up.startswith("AT+CWJAP"):
+            self._cmd_cwjap(line)
+        elif up == "AT+CWQAP":
+            was_up = self.wifi_up
+            self._close_all_links(notify=True)
+            self.wifi_up = False
+            self.reply("\r\nOK\r\n" + ("WIFI DISCONNECT\r\n" if was_up else ""))
+        elif up == "AT+CIFSR":
+            self.reply('+CIFSR:STAIP,"%s"\r\n+CIFSR:STAMAC,"5c:cf:7f:00:00:01"\r\n\r\nOK\r\n' % self.ip)
+        elif up.startswith("AT+CWAUTOCONN="):
+            self.autoconn = up.endswith("1")
+            self.reply("\r\nOK\r\n")
+        elif up == "AT+CIPMUX?":
+            self.reply("+CIPMUX:%d\r\n\r\nOK\r\n" % self.cipmux)
+        elif up.startswith("AT+CIPMUX="):
+            if self.links:
+                # 真实固件：有连接时不允许切换
+                self.reply("link is builded\r\n\r\nERROR\r\n")
+                return
+            self.cipmux = 1 if up.endswith("1") else 0
+            self.reply("\r\nOK\r\n")
+        elif up.startswith("AT+CIPMODE="):
+            self.cipmode = 1 if up.endswith("1") else 0
+            self.reply("\r\nOK\r\n")
+        elif up.startswith("AT+CIPSTART="):
+            self._cmd_cipstart(line)
+        elif up.startswith("AT+CIPSEND"):
+            self._cmd_cipsend(up)
+        elif up.startswith("AT+CIPCLOSE"):
+            m = re.match(r"AT\+CIPCLOSE=(\d)", up)
+            link_id = int(m.group(1)) if m else 0
+            if self.cipmux and link_id == 5:
+                # 多连接模式下 id=5 表示关闭全部连接
+                for lid in list(self.links):
+                    self._close_link(lid, notify=False)
+                    self.reply("%d,CLOSED\r\n" % lid)
+                self.reply_later(lat, "\r\nOK\r\n")
+            elif link_id in self.links:
+                self._close_link(link_id, notify=False)
+                prefix = "%d," % link_id if self.cipmux else ""
+                self.reply_later(lat, prefix + "CLOSED\r\n\r\nOK\r\n")
+            else:
+                self.reply("\r\nERROR\r\n")
+        elif up == "AT+CIPSTATUS":
+            self._cmd_cipstatus()
+        else:
+            self.reply("\r\nERROR\r\n")
+
+    def _cmd_cwjap(self, line: str) -> None:
+        m = re.match(r'AT\+CWJAP(?:_CUR|_DEF)?="((?:[^"\\]|\\.)*)","((?:[^"\\]|\\.)*)"', line, re.I)
+        if not m:
+            status = "+CWJAP:\"%s\"\r\n\r\nOK\r\n" % self.args.ssid if self.wifi_up else "No AP\r\n\r\nOK\r\n"
+            self.reply(status)
+            return
+        ssid, password = m.group(1), m.group(2)
+        if self.args.check_credentials and (ssid != self.args.ssid or password != self.args.password):
+            self.reply_later(self.args.join_ms / 1000.0, "+CWJAP:1\r\n\r\nFAIL\r\n")
+            return
+        self._close_all_links(notify=False)
+        was_up = self.wifi_up
+        self.wifi_up = False
+        pre = "WIFI DISCONNECT\r\n" if was_up else ""
+
+        def joined() -> None:
+            self.wifi_up = True
+            if m.group(0).upper().startswith("AT+CWJAP_DEF"):
+                self.saved_ap = True
+            self.ip = self.args.sta_ip
+            self.reply(pre + "WIFI CONNECTED\r\nWIFI GOT IP\r\n\r\nOK\r\n")
+
+        self.sched.at(time.monotonic() + self.args.join_ms / 1000.0, joined)
+
+    def _boot_autojoin(self, boot_at: float) -> None:
+        """上电/复位后按 flash 中保存的热点自行连接（不需要 MCU 发 CWJAP）。"""
+        if not (self.autoconn and self.saved_ap):
+            return
+
+        def joined() -> None:
+            if not self.wifi_up:
+                self.wifi_up = True
+                self.ip = self.args.sta_ip
+                self.reply("WIFI CONNECTED\r\nWIFI GOT IP\r\n")
+        self.sched.at(boot_at + self.args.join_ms / 1000.0, joined)
+
+    def _cmd_cipstart(self, line: str) -> None:
+        if self.cipmux:
+            m = re.match(r'AT\+CIPSTART=(\d),"(\w+)","([^"]+)",(\d+)', line, re.I)
+        else:
+            m = re.match(r'AT\+CIPSTART=()"(\w+)","([^"]+)",(\d+)', line, re.I)
+        if not m:
+            self.reply("\r\nERROR\r\n")
+            return
+        link_id = int(m.group(1)) if m.group(1) else 0
+        kind = m.group(2).upper()
+        remote_ip, remote_port = m.group(3), int(m.group(4))
+        prefix = "%d," % link_id if self.cipmux else ""
+        lat = self.args.latency_ms / 1000.0
+
+        if not self.wifi_up:
+            self.reply("\r\nERROR\r\n")
+            return
+        if link_id in self.links:
+            self.reply("ALREADY CONNECTED\r\n\r\nERROR\r\n")
+            return
+        if kind == "UDP":
+            self._start_udp(link_id, remote_ip, remote_port, prefix)
+            return
+        if kind != "TCP":
+            self.reply("\r\nERROR\r\n")
+            return
+
+        host = self.args.remote_host or remote_ip
+        port = self.args.remote_port or remote_port
+        try:
+            sock = socket.create_connection((host, port), timeout=5.0)
+        except OSError as e:
+            self.stats.connect_failures += 1
+            self._log("CIPSTART %s:%d 失败: %s" % (host, port, e))
+            self.reply_later(lat * 2, "\r\nERROR\r\n" + prefix + "CLOSED\r\n")
+            return
+
+        sock.setblocking(False)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        link = Link(link_id, kind, remote_ip, remote_port, sock, sock.getsockname()[1], time.monotonic())
+
+        def established() -> None:
+            self.links[link_id] = link
+            self.sel.register(sock, selectors.EVENT_READ, ("net", link_id))
+            self.stats.connects += 1
+            if self.down_since is not None:
+                self.stats.reconnect_ms.append(int((time.monotonic() - self.down_since) * 1000))
+                self.down_since = None
+            self.reply(prefix + "CONNECT\r\n\r\nOK\r\n")
+
+        # TCP 三次握手 ≈ 1 个 RTT
+        self.sched.at(time.monotonic() + lat * 2, established)
+
+    def _start_udp(self, link_id: int, remote_ip: str, remote_port: int, prefix: str) -> None:
+        # UDP 无握手：模块立即回 CONNECT
+        host = self.args.remote_host or remote_ip
+        port = self.args.remote_udp_port or remote_port
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.connect((host, port))
+        sock.setblocking(False)
+        link = Link(link_id, "UDP", remote_ip, remote_port, sock, sock.getsockname()[1], time.monotonic())
+        self.links[link_id] = link
+        self.sel.register(sock, selectors.EVENT_READ, ("net", link_id))
+        self.stats.connects += 1
+        self.reply(prefix + "CONNECT\r\n\r\nOK\r\n")
+
+    def _cmd_cipsend(self, up: str) -> None:
+        if up == "AT+CIPSEND":
+            if self.cipmode != 1 or self.cipmux or 0 not in self.links:
+                self.reply("\r\nERROR\r\n")
+                return
+            self.passthrough = True
+            self.pass_buf.clear()
+            self.reply("\r\nOK\r\n\r\n>")
+            return
+
+        if self.cipmux:
+            m = re.match(r"AT\+CIPSEND=(\d),(\d+)", up)
+            link_id, length = (int(m.group(1)), int(m.group(2))) if m else (0, 0)
+        else:
+            m = re.match(r"AT\+CIPSEND=(\d+)", up)
+            link_id, length = (0, int(m.group(1))) if m else (0, 0)
+        if not m or length <= 0 or length > CIPSEND_MAX:
+            self.reply("\r\nERROR\r\n")
+            return
+        if link_id not in self.links:
+            self.reply("link is not valid\r\n\r\nERROR\r\n")
+            return
+        self.send_link = link_id
+        self.send_expect = length
+        self.send_buf.clear()
+        self.reply("\r\nOK\r\n> ")
+
+    def _finish_cipsend(self) -> None:
+        data = bytes(self.send_buf)
+        self.send_buf.clear()
+        self.stats.cipsend_count += 1
+        self.reply("\r\nRecv %d bytes\r\n" % len(data))
+        link = self.links.get(self.send_link)
+        if link is None:
+            self.reply("\r\nSEND FAIL\r\n")
+            return
+        done_at = self._net_send(link, data)
+        self.sched.at(done_at, lambda: self.reply("\r\nSEND OK\r\n"))
+
+    def _cmd_cipstatus(self) -> None:
+        if not self.wifi_up:
+            status = 5
+        elif self.links:
+            status = 3
+        elif self.stats.connects > 0:
+            status = 4
+        else:
+            status = 2
+        out = "STATUS:%d\r\n" % status
+        for link in self.links.values():
+            out += '+CIPSTATUS:%d,"%s","%s",%d,%d,0\r\n' % (
+                link.link_id, link.kind, link.remote_ip, link.remote_port, link.local_port)
+        self.reply(out + "\r\nOK\r\n")
+
+    # ----------------- 网络侧 -----------------
+
+    def _air_time(self, nbytes: int) -> float:
+        bw = self.args.bandwidth_Bps
+        return (nbytes / bw) if bw > 0 else 0.0
+
+    def _net_send(self, link: Link, data: bytes) -> float:
+        """按带宽/时延调度上行发送，返回“空口发完”的时刻（用于 SEND OK）。"""
+        now = time.monotonic()
+        start = max(now, link.up_busy_until)
+        link.up_busy_until = start + self._air_time(len(data))
+        arrive = link.up_busy_until + self.args.latency_ms / 1000.0
+
+        udp = link.kind == "UDP"
+        if udp:
+            self.stats.up_datagrams += 1
+            if self.args.up_loss > 0 and self.rng.random() < self.args.up_loss:
+                self.stats.up_datagrams_dropped += 1
+                self.stats.up_dropped += len(data)
+                return link.up_busy_until
+        elif self.args.up_loss > 0:
+            kept = bytes(b for b in data if self.rng.random() >= self.args.up_loss)
+            self.stats.up_dropped += len(data) - len(kept)
+            data = kept
+
+        def deliver() -> None:
+            if self.links.get(link.link_id) is not link:
+                return
+            try:
+                if udp:
+                    link.sock.send(data)
+                else:
+                    link.sock.sendall(data)
+                self.stats.up_bytes += len(data)
+            except OSError:
+                # UDP 对端未监听（ICMP 不可达）时数据报直接丢失，连接保持
+                if not udp:
+                    self._on_remote_closed(link.link_id)
+
+        self.sched.at(arrive, deliver)
+        return link.up_busy_until
+
+    def on_net_readable(self, link_id: int) -> None:
+        link = self.links.get(link_id)
+        if link is None:
+            return
+        try:
+            data = link.sock.recv(4096)
+        except BlockingIOError:
+            return
+        except OSError:
+            if link.kind == "UDP":
+                return
+            data = b""
+        if not data:
+            if link.kind != "UDP":
+                self._on_remote_closed(link_id)
+            return
+
+        for off in range(0, len(data), IPD_CHUNK):
+            chunk = data[off:off + IPD_CHUNK]
+            now = time.monotonic()
+            start = max(now, link.down_busy_until)
+            link.down_busy_until = start + self._air_time(len(chunk))
+            arrive = link.down_busy_until + self.args.latency_ms / 1000.0
+            self.sched.at(arrive, lambda c=chunk, l=link: self._deliver_ipd(l, c))
+
+    def _deliver_ipd(self, link: Link, chunk: bytes) -> None:
+        if self.links.get(link.link_id) is not link:
+            return
+        self.stats.down_bytes += len(chunk)
+        payload = chunk
+        if self.args.loss > 0:
+            payload = bytes(b for b in chunk if self.rng.random() >= self.args.loss)
+            self.stats.down_dropped += len(chunk) - len(payload)
+        if self.passthrough:
+            self.uart_write(payload)
+            return
+        # +IPD 头里的长度是模块收到的真实长度；丢字节发生在串口线上
+        if self.cipmux:
+            header = "\r\n+IPD,%d,%d:" % (link.link_id, len(chunk))
+        else:
+            header = "\r\n+IPD,%d:" % len(chunk)
+        self.uart_write(header.encode("ascii") + payload)
+
+    def _on_remote_closed(self, link_id: int) -> None:
+        if link_id not in self.links:
+            return
+        self.stats.remote_closes += 1
+        self._close_link(link_id, notify=True)
+
+    def _close_link(self, link_id: int, notify: bool) -> None:
+        link = self.links.pop(link_id, None)
+        if link is None:
+            return
+        try:
+            self.sel.unregister(link.sock)
+        except (KeyError, ValueError):
+            pass
+        link.sock.close()
+        if self.passthrough and link_id == 0:
+            self.passthrough = False
+        if notify:
+            if self.down_since is None:
+                self.down_since = time.monotonic()
+            prefix = "%d," % link_id if self.cipmux else ""
+            self.reply(prefix + "CLOSED\r\n")
+
+    def _close_all_links(self, notify: bool) -> None:
+        for link_id in list(self.links.keys()):
+            self._close_link(link_id, notify)
+
+    # ----------------- 透传 -----------------
+
+    def _pump_passthrough(self, now: float) -> None:
+        if not self.passthrough or not self.pass_buf:
+            return
+        # "+++" 单独成包（前后各 ≥1s 静默）才退出透传；这里只检查尾部静默
+        if bytes(self.pass_buf) == b"+++":
+            if now - self.pass_last_rx >= 1.0:
+                self.passthrough = False
+                self.pass_buf.clear()
+            return
+        # ESP8266 透传按 20ms 间隔或 2048 字节打包
+        if now - self.pass_last_rx >= 0.02 or len(self.pass_buf) >= CIPSEND_MAX:
+            link = self.links.get(0)
+            if link is not None:
+                self._net_send(link, bytes(self.pass_buf))
+            self.pass_buf.clear()
+
+    # ----------------- 故障注入 -----------------
+
+    def _inject_disconnect(self) -> None:
+        target = self.args.disconnect_link
+        if target >= 0:
+            if target in self.links:
+                self.stats.disconnects_injected += 1
+                self._log("注入: 连接 %d 断开" % target)
+                self._close_link(target, notify=True)
+        elif self.links:
+            self.stats.disconnects_injected += 1
+            self._log("注入: TCP 断开")
+            self._close_all_links(notify=True)
+        self.sched.at(time.monotonic() + self.args.disconnect_every_s, self._inject_disconnect)
+
+    def _inject_wifi_drop(self) -> None:
+        if self.wifi_up:
+            self.stats.wifi_drops_injected += 1
+            self._log("注入: WiFi 断开 %.1fs" % self.args.wifi_down_s)
+            if self.down_since is None:
+                self.down_since = time.monotonic()
+            self._close_all_links(notify=True)
+            self.wifi_up = False
+            self.reply("WIFI DISCONNECT\r\n")
+
+            def rejoin() -> None:
+                if not self.wifi_up:
+                    self.wifi_up = True
+                    self.reply("WIFI CONNECTED\r\nWIFI GOT IP\r\n")
+
+            if self.args.wifi_down_s > 0:
+                self.sched.at(time.monotonic() + self.args.wifi_down_s, rejoin)
+        self.sched.at(time.monotonic() + self.args.wifi_drop_every_s, self._inject_wifi_drop)
+
+    # ----------------- 统计 -----------------
+
+    def _log(self, msg: str) -> None:
+        print("[esp8266-emu] %s" % msg, file=sys.stderr, flush=True)
+
+    def _report(self) -> None:
+        self._log("stats %s" % json.dumps(self.stats.summary(), ensure_ascii=False))
+        self.sched.at(time.monotonic() + self.args.report_every_s, self._report)
+
+    # ----------------- 主循环 -----------------
+
+    def run(self, stop: Callable[[], bool]) -> None:
+        while not stop():
+            now = time.monotonic()
+            timeout = self.sched.next_timeout(now, 0.01 if (self.uart_out or self.pass_buf) else 0.1)
+            for key, _ in self.sel.select(timeout):
+                kind, link_id = key.data
+                if kind == "uart":
+                    self.on_uart_readable()
+                else:
+                    self.on_net_readable(link_id)
+            now = time.monotonic()
+            self.sched.run_due(now)
+            self._pump_passthrough(now)
+            self._pump_uart(now)
+
+
+def open_serial(path: str, baud: int) -> int:
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    speed = getattr(termios, "B%d" % baud)
+    attrs[4] = speed
+    attrs[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def open_pty(link_path: Optional[str]) -> Tuple[int, str]:
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    slave_name = os.ttyname(slave)
+    # 保持 slave 打开，避免驱动进程未连接时 master 读到 EIO
+    if link_path:
+        try:
+            os.unlink(link_path)
+        except FileNotFoundError:
+            pass
+        os.symlink(slave_name, link_path)
+    return master, slave_name
+
+
+def parse_args(argv: Optional[List[str]] = None) -> argparse.Namespace:
+    p = argparse.ArgumentParser(description="ESP8266 AT 固件模拟器（pty ↔ TCP 桥接）")
+    p.add_argument("--link", default="/tmp/spacenose-esp8266", help="pty 的固定符号链接路径（默认 /tmp/spacenose-esp8266）")
+    p.add_argument("--serial", default=None, help="改用真实串口设备（例如 /dev/ttyUSB0，接 STM32 的 USART2）")
+    p.add_argument("--baud", type=int, default=115200, help="--serial 时的波特率")
+    p.add_argument("--remote-host", default=None, help="忽略 CIPSTART 中的 IP，改连此主机（例如 127.0.0.1）")
+    p.add_argument("--remote-port", type=int, default=0, help="忽略 CIPSTART 中的端口，改连此端口（仅 TCP）")
+    p.add_argument("--remote-udp-port", type=int, default=0, help="忽略 UDP 连接 CIPSTART 中的端口，改发到此端口")
+    p.add_argument("--ssid", default="spacenose", help="AP 名称（配合 --check-credentials）")
+    p.add_argument("--password", default="spacenose", help="AP 密码（配合 --check-credentials）")
+    p.add_argument("--check-credentials", action="store_true", help="CWJAP 校验 SSID/密码")
+    p.add_argument("--sta-ip", default="192.168.137.10", help="CIFSR 返回的 Station IP")
+    p.add_argument("--saved-ap", action="store_true", help="模块 flash 中已保存热点：启动后自动连接（模拟模块复位）")
+    p.add_argument("--join-ms", type=int, default=1500, help="CWJAP 到 WIFI GOT IP 的耗时")
+    p.add_argument("--latency-ms", type=float, default=0.0, help="单程网络时延")
+    p.add_argument("--bandwidth-Bps", type=float, default=0.0, help="空口带宽（字节/秒，0=不限）")
+    p.add_argument("--uart-baud", type=int, default=115200, help="模拟器→驱动的串口节拍")
+    p.add_argument("--loss", type=float, default=0.0, help="下行 payload 逐字节丢失概率")
+    p.add_argument("--up-loss", type=float, default=0.0, help="上行 payload 逐字节丢失概率")
+    p.add_argument("--disconnect-every-s", type=float, default=0.0, help="每隔 N 秒断开 TCP（0=关闭）")
+    p.add_argument("--disconnect-link", type=int, default=-1, help="只断开该连接号（CIPMUX=1；-1=全部）")
+    p.add_argument("--wifi-drop-every-s", type=float, default=0.0, help="每隔 N 秒断开 WiFi（0=关闭）")
+    p.add_argument("--wifi-down-s", type=float, default=3.0, help="WiFi 断开后自动恢复的时间（0=不自动恢复）")
+    p.add_argument("--seed", type=int, default=0, help="随机数种子（丢包可复现）")
+    p.add_argument("--report-every-s", type=float, default=0.0, help="周期打印统计（0=仅退出时）")
+    p.add_argument("--stats-json", default=None, help="退出时把统计写入该 JSON 文件")
+    return p.parse_args(argv)
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    args = parse_args(argv)
+
+    if args.serial:
+        fd = open_serial(args.serial, args.baud)
+        where = args.serial
+    else:
+        fd, slave_name = open_pty(args.link)
+        where = "%s -> %s" % (args.link, slave_name) if args.link else slave_name
+
+    emu = Esp8266Emulator(fd, args)
+    stopping = {"flag": False}
+
+    def on_signal(signum, frame):  # noqa: ARG001
+        stopping["flag"] = True
+
+    signal.signal(signal.SIGINT, on_signal)
+    signal.signal(signal.SIGTERM, on_signal)
+
+    emu._log("就绪: %s（export SPACENOSE_ESP_TTY=%s）" % (where, args.link or where))
+    emu.run(lambda: stopping["flag"])
+
+    summary = emu.stats.summary()
+    emu._log("汇总 %s" % json.dumps(summary, ensure_ascii=False))
+    if args.stats_json:
+        with open(args.stats_json, "w", encoding="utf-8") as f:
+            json.dump(summary, f, ensure_ascii=False, indent=2)
+    if args.link and not args.serial:
+        try:
+            os.unlink(args.link)
+        except FileNotFoundError:
+            pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,553 @@
+#!/usr/bin/env python3
+"""
+板上气体分类器导出：后端训练的 PyTorch 模型 → int8 量化 C 头文件（src/tinyml.c 执行）
+
+支持的结构（与 tinyml.c 的算子一一对应）：
+  - GasClassifier1DCNN（backend/ml_models.py）：
+        [Conv1d → BatchNorm1d → ReLU → MaxPool1d(2)] × N → 全局平均池化 → Linear → ReLU → Dropout → Linear
+  - MLP：若干 Linear，除最后一层外每层后接 ReLU；输入按 [seq, feat] 展平（与 TinyAutoencoder 一致）
+GRU / HybridGasClassifier 不支持（会报错退出）。
+
+模型输入必须是星上传感器的浓度窗口：n_features = 参与分类的传感器个数（HK 前缀由
+--features 给出，按顺序对应输入通道），seq_length = 窗口样本数（过采样输出约 3.9 个/秒）。
+
+量化（与 tinyml.h 的说明一致）：
+  - BatchNorm 折叠进卷积；权重按输出通道对称 int8；偏置 int32；
+  - 激活按张量对称 int8，尺度取校准窗口上的最大绝对值 / 127；
+  - 重新量化倍率 M = s_w · s_in / s_out 表示为 Q31 尾数 + 右移位数。
+本工具同时实现逐位一致的 Python 整数参考：生成的测试向量（输入 int8 → 期望 logits int8）
+由 host_bench tinyml 拿固件实现逐位比对；整数模型与浮点模型（有 PyTorch 时即原模型）
+在校准窗口上的 top-1 一致率写入头文件注释。
+
+用法：
+    # 导出训练好的检查点（torch.save 的 dict：model_state_dict / config / classes，
+    # 可选 input_norm = {"mean": [...], "std": [...]}，单位与 HK 浓度字段相同）
+    python tools/tinyml_export.py --checkpoint backend/ml_models/onboard_cnn.pt --features mq3 \\
+        --calib windows.jsonl
+    # 未训练的确定性占位模型（无需 PyTorch；固件会运行推理但不上报类别）
+    python tools/tinyml_export.py --placeholder
+
+--calib 为 JSON Lines，每行 {"window": [[x_f0, x_f1, ...], ...]}（seq_length 行，原始单位）；
+缺省时按 input_norm 生成正态随机窗口。
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import os
+import random
+import sys
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+DEFAULT_HEADER = os.path.join(ROOT, "src", "gas_model_weights.h")
+DEFAULT_VECTORS = os.path.join(ROOT, "host", "bench", "gas_model_vectors.h")
+
+OP_CONV1D, OP_MAXPOOL2, OP_GAP, OP_DENSE = 0, 1, 2, 3
+OP_NAMES = {OP_CONV1D: "TINYML_OP_CONV1D", OP_MAXPOOL2: "TINYML_OP_MAXPOOL2",
+            OP_GAP: "TINYML_OP_GAP", OP_DENSE: "TINYML_OP_DENSE"}
+
+Matrix = List[List[float]]
+
+
+class FloatLayer:
+    """折叠后的浮点层：conv 的 w 为 [out][in][k]，dense 的 w 为 [out][in]"""
+
+    def __init__(self, op: int, relu: bool = False, w: Any = None, b: Optional[List[float]] = None):
+        self.op = op
+        self.relu = relu
+        self.w = w
+        self.b = b
+
+
+# ============================================================================
+# 浮点前向（纯 Python，张量为 [通道][时间]）
+# ============================================================================
+
+def float_forward(layers: Sequence[FloatLayer], x: Matrix, trace: Optional[List[float]] = None) -> List[float]:
+    for layer in layers:
+        if layer.op == OP_CONV1D:
+            k = len(layer.w[0][0])
+            pad = k // 2
+            length = len(x[0])
+            y = []
+            for o, wo in enumerate(layer.w):
+                row = []
+                for t in range(length):
+                    acc = layer.b[o]
+                    for i, wi in enumerate(wo):
+                        xi = x[i]
+                        for j in range(k):
+                            tt = t + j - pad
+                            if 0 <= tt < length:
+                                acc += wi[j] * xi[tt]
+                    row.append(max(acc, 0.0) if layer.relu else acc)
+                y.append(row)
+            x = y
+        elif layer.op == OP_MAXPOOL2:
+            x = [[max(r[2 * t], r[2 * t + 1]) for t in range(len(r) // 2)] for r in x]
+        elif layer.op == OP_GAP:
+            x = [[sum(r) / len(r)] for r in x]
+        else:
+            flat = [v for r in x for v in r]
+            y = []
+            for o, wo in enumerate(layer.w):
+                acc = layer.b[o] + sum(w * v for w, v in zip(wo, flat))
+                y.append(max(acc, 0.0) if layer.relu else acc)
+            x = [[v] for v in y]
+        if trace is not None:
+            trace.append(max(abs(v) for r in x for v in r))
+    return [r[0] for r in x]
+
+
+# ============================================================================
+# 量化与整数参考（逐位对应 src/tinyml.c）
+# ============================================================================
+
+def round_half_away(v: float) -> int:
+    return int(math.floor(abs(v) + 0.5)) * (1 if v >= 0 else -1)
+
+
+def clamp(v: int, lo: int, hi: int) -> int:
+    return lo if v < lo else hi if v > hi else v
+
+
+def quantize_multiplier(m: float) -> Tuple[int, int]:
+    """M → (mult, shift)：M ≈ mult · 2^-(31 + shift)，mult ∈ [2^30, 2^31)"""
+    if m <= 0.0:
+        return 0, 0
+    frac, exp = math.frexp(m)
+    mult = int(round(frac * (1 << 31)))
+    if mult == (1 << 31):
+        mult //= 2
+        exp += 1
+    shift = -exp
+    if not (-30 <= shift <= 31):
+        raise SystemExit(f"重新量化倍率超出范围：{m}")
+    return mult, shift
+
+
+def requant(acc: int, mult: int, shift: int) -> int:
+    total = 31 + shift
+    return (acc * mult + (1 << (total - 1))) >> total
+
+
+def div_round(s: int, n: int) -> int:
+    return (s + n // 2) // n if s >= 0 else -((-s + n // 2) // n)
+
+
+class QuantLayer:
+    def __init__(self, op: int, relu: bool, in_ch: int, out_ch: int, kernel: int = 0):
+        self.op = op
+        self.relu = relu
+        self.in_ch = in_ch
+        self.out_ch = out_ch
+        self.kernel = kernel
+        self.w: List[int] = []
+        self.b: List[int] = []
+        self.mult: List[int] = []
+        self.shift: List[int] = []
+
+
+def quantize_model(layers: Sequence[FloatLayer], n_features: int, seq_len: int,
+                   calib: Sequence[Matrix]) -> Tuple[List[QuantLayer], float, float, int]:
+    """返回 (整数层表, 输入尺度, logits 尺度, 最大张量元素数)"""
+    in_max = max(abs(v) for x in calib for r in x for v in r) or 1.0
+    out_max = [0.0] * len(layers)
+    for x in calib:
+        trace: List[float] = []
+        float_forward(layers, x, trace)
+        out_max = [max(a, b) for a, b in zip(out_max, trace)]
+
+    s = in_max / 127.0
+    s_in = s
+    ch, length = n_features, seq_len
+    max_tensor = ch * length
+    qlayers = []
+    for layer, amax in zip(layers, out_max):
+        if layer.op in (OP_CONV1D, OP_DENSE):
+            s_out = (amax or 1e-6) / 127.0
+            if layer.op == OP_CONV1D:
+                q = QuantLayer(OP_CONV1D, layer.relu, ch, len(layer.w), len(layer.w[0][0]))
+                rows = [[v for wi in wo for v in wi] for wo in layer.w]
+            else:
+                q = QuantLayer(OP_DENSE, layer.relu, ch * length, len(layer.w))
+                rows = layer.w
+            for o, row in enumerate(rows):
+                s_w = (max(abs(v) for v in row) / 127.0) or 1.0
+                q.w.extend(clamp(round_half_away(v / s_w), -127, 127) for v in row)
+                q.b.append(clamp(round_half_away(layer.b[o] / (s_w * s)), -(1 << 31), (1 << 31) - 1))
+                mult, shift = quantize_multiplier(s_w * s / s_out)
+                q.mult.append(mult)
+                q.shift.append(shift)
+            s = s_out
+            ch = q.out_ch
+            length = length if layer.op == OP_CONV1D else 1
+        elif layer.op == OP_MAXPOOL2:
+            q = QuantLayer(OP_MAXPOOL2, False, ch, ch)
+            length //= 2
+        else:
+            q = QuantLayer(OP_GAP, False, ch, ch)
+            length = 1
+        max_tensor = max(max_tensor, ch * length)
+        qlayers.append(q)
+    return qlayers, s_in, s, max_tensor
+
+
+def int_forward(qlayers: Sequence[QuantLayer], x: List[int], seq_len: int) -> List[int]:
+    """整数参考：x 为展平的 [通道][时间] int8"""
+    length = seq_len
+    for q in qlayers:
+        lo = 0 if q.relu else -128
+        if q.op == OP_CONV1D:
+            k = q.kernel
+            pad = k // 2
+            y = []
+            for o in range(q.out_ch):
+                for t in range(length):
+                    acc = q.b[o]
+                    for i in range(q.in_ch):
+                        base = (o * q.in_ch + i) * k
+                        for j in range(k):
+                            tt = t + j - pad
+                            if 0 <= tt < length:
+                                acc += q.w[base + j] * x[i * length + tt]
+                    y.append(clamp(requant(acc, q.mult[o], q.shift[o]), lo, 127))
+        elif q.op == OP_MAXPOOL2:
+            half = length // 2
+            y = [max(x[c * length + 2 * t], x[c * length + 2 * t + 1]) for c in range(q.in_ch) for t in range(half)]
+            length = half
+        elif q.op == OP_GAP:
+            y = [div_round(sum(x[c * length:(c + 1) * length]), length) for c in range(q.in_ch)]
+            length = 1
+        else:
+            y = []
+            for o in range(q.out_ch):
+                acc = q.b[o] + sum(w * v for w, v in zip(q.w[o * q.in_ch:(o + 1) * q.in_ch], x))
+                y.append(clamp(requant(acc, q.mult[o], q.shift[o]), lo, 127))
+            length = 1
+        x = y
+    return x
+
+
+def quantize_input(window: Matrix, mean: Sequence[float], std: Sequence[float], s_in: float) -> List[int]:
+    """原始单位窗口 [时间][特征] → 展平的 [特征][时间] int8（与 TinyMl_Quantize 相同）"""
+    n_features = len(mean)
+    return [clamp(round_half_away((row[f] - mean[f]) / (std[f] * s_in)), -128, 127)
+            for f in range(n_features) for row in window]
+
+
+def normalize(window: Matrix, mean: Sequence[float], std: Sequence[float]) -> Matrix:
+    """[时间][特征] 原始单位 → [特征][时间] 归一化浮点"""
+    return [[(row[f] - mean[f]) / std[f] for row in window] for f in range(len(mean))]
+
+
+# ============================================================================
+# 模型来源
+# ============================================================================
+
+def layers_from_state_dict(sd: Dict[str, Any], n_features: int, seq_len: int) -> List[FloatLayer]:
+    def t(name: str) -> Any:
+        return sd[name].detach().cpu().tolist()
+
+    if any("gru" in k for k in sd):
+        raise SystemExit("GRU / HybridGasClassifier 不支持板上推理，请改用 GasClassifier1DCNN 或 MLP")
+
+    layers: List[FloatLayer] = []
+    if any(k.startswith("conv_layers.") for k in sd):
+        idx = sorted({int(k.split(".")[1]) for k in sd if k.startswith("conv_layers.")})
+        convs = [i for i in idx if f"conv_layers.{i}.weight" in sd and len(sd[f"conv_layers.{i}.weight"].shape) == 3]
+        for i in convs:
+            w = t(f"conv_layers.{i}.weight")
+            b = t(f"conv_layers.{i}.bias")
+            bn = f"conv_layers.{i + 1}"
+            if f"{bn}.running_mean" in sd:
+                eps = 1e-5
+                gamma, beta = t(f"{bn}.weight"), t(f"{bn}.bias")
+                mean, var = t(f"{bn}.running_mean"), t(f"{bn}.running_var")
+                for o in range(len(w)):
+                    scale = gamma[o] / math.sqrt(var[o] + eps)
+                    w[o] = [[v * scale for v in wi] for wi in w[o]]
+                    b[o] = (b[o] - mean[o]) * scale + beta[o]
+            layers.append(FloatLayer(OP_CONV1D, True, w, b))
+            layers.append(FloatLayer(OP_MAXPOOL2))
+        layers.append(FloatLayer(OP_GAP))
+        prefix = "classifier."
+    else:
+        prefix = ""
+    dense_keys = sorted((k for k in sd if k.startswith(prefix) and k.endswith(".weight") and len(sd[k].shape) == 2),
+                        key=lambda k: [int(p) if p.isdigit() else p for p in k[len(prefix):].split(".")])
+    if not dense_keys:
+        raise SystemExit("检查点中没有可识别的层")
+    for n, key in enumerate(dense_keys):
+        w = t(key)
+        b = t(key[:-len("weight")] + "bias")
+        if n == 0 and not layers:
+            # MLP 输入按 [seq, feat] 展平；固件张量为 [feat][seq]，重排列
+            w = [[row[tt * n_features + f] for f in range(n_features) for tt in range(seq_len)] for row in w]
+        layers.append(FloatLayer(OP_DENSE, n + 1 < len(dense_keys), w, b))
+    return layers
+
+
+def placeholder_layers(n_features: int, seq_len: int, channels: Sequence[int], kernel: int,
+                       hidden: int, n_classes: int, seed: int) -> List[FloatLayer]:
+    """与 GasClassifier1DCNN 同结构的随机初始化（Kaiming 均匀），仅用于打通流程与测预算"""
+    rng = random.Random(seed)
+
+    def uni(fan_in: int) -> float:
+        bound = 1.0 / math.sqrt(fan_in)
+        return rng.uniform(-bound, bound)
+
+    layers: List[FloatLayer] = []
+    in_ch = n_features
+    for out_ch in channels:
+        fan = in_ch * kernel
+        w = [[[uni(fan) * math.sqrt(6.0) for _ in range(kernel)] for _ in range(in_ch)] for _ in range(out_ch)]
+        b = [uni(fan) for _ in range(out_ch)]
+        layers += [FloatLayer(OP_CONV1D, True, w, b), FloatLayer(OP_MAXPOOL2)]
+        in_ch = out_ch
+    layers.append(FloatLayer(OP_GAP))
+    for n_in, n_out, relu in ((in_ch, hidden, True), (hidden, n_classes, False)):
+        w = [[uni(n_in) * math.sqrt(6.0) for _ in range(n_in)] for _ in range(n_out)]
+        layers.append(FloatLayer(OP_DENSE, relu, w, [uni(n_in) for _ in range(n_out)]))
+    return layers
+
+
+def load_calibration(path: Optional[str], n: int, seq_len: int, mean: Sequence[float],
+                     std: Sequence[float], seed: int) -> List[Matrix]:
+    if path:
+        windows = []
+        with open(path, "r", encoding="utf-8") as f:
+            for line in f:
+                if line.strip():
+                    w = json.loads(line)["window"]
+                    if len(w) != seq_len or any(len(r) != len(mean) for r in w):
+                        raise SystemExit(f"{path}: 窗口形状应为 {seq_len} × {len(mean)}")
+                    windows.append(w)
+        return windows
+    rng = random.Random(seed + 1)
+    return [[[rng.gauss(mean[f], std[f]) for f in range(len(mean))] for _ in range(seq_len)] for _ in range(n)]
+
+
+# ============================================================================
+# 输出
+# ============================================================================
+
+def c_array(ctype: str, name: str, values: Sequence[Any], per_line: int = 16) -> str:
+    body = []
+    for i in range(0, len(values), per_line):
+        body.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return f"static const {ctype} {name}[{len(values)}] = {{\n" + "\n".join(body) + "\n};\n"
+
+
+def c_float(v: float) -> str:
+    return f"{v:.9g}f" if ("e" in f"{v:.9g}" or "." in f"{v:.9g}") else f"{v:.9g}.0f"
+
+
+def write_header(path: str, qlayers: Sequence[QuantLayer], args: argparse.Namespace, classes: Sequence[str],
+                 features: Sequence[str], mean: Sequence[float], gain: Sequence[float], out_scale: float,
+                 max_tensor: int, seq_len: int, agreement: str) -> None:
+    weight_bytes = sum(len(q.w) + 4 * (len(q.b) + len(q.mult)) + len(q.shift) for q in qlayers)
+    macs, length = 0, seq_len
+    for q in qlayers:
+        if q.op == OP_CONV1D:
+            macs += q.out_ch * q.in_ch * q.kernel * length
+        elif q.op == OP_MAXPOOL2:
+            length //= 2
+        elif q.op == OP_GAP:
+            length = 1
+        else:
+            macs += q.out_ch * q.in_ch
+            length = 1
+
+    out = [
+        "/**",
+        " ******************************************************************************",
+        " * @file           : gas_model_weights.h",
+        " * @brief          : 板上气体分类器（int8）层表与权重 —— 由 tools/tinyml_export.py 生成，勿手改",
+        " ******************************************************************************",
+        f" * @description    : 来源：{args.source}",
+        f" *                   int8 与浮点模型 top-1 一致率：{agreement}",
+        " *                   只由一个源文件包含（sensor_manager.c；主机端另有 bench_tinyml.c）。",
+        " ******************************************************************************",
+        " */",
+        "",
+        "#ifndef __GAS_MODEL_WEIGHTS_H",
+        "#define __GAS_MODEL_WEIGHTS_H",
+        "",
+        '#include "tinyml.h"',
+        "",
+    ]
+    for name, value, note in (
+        ("GAS_MODEL_PLACEHOLDER", int(args.placeholder), "1 = 未训练的占位模型，不上报类别"),
+        ("GAS_MODEL_IN_FEATURES", len(features), ""),
+        ("GAS_MODEL_SEQ_LEN", seq_len, ""),
+        ("GAS_MODEL_N_CLASSES", len(classes), ""),
+        ("GAS_MODEL_ARENA_BYTES", 2 * max_tensor, "工作区（两块交替）"),
+        ("GAS_MODEL_WEIGHT_BYTES", weight_bytes, "权重 + 偏置 + 倍率（Flash）"),
+        ("GAS_MODEL_MACS", macs, "每次推理的乘加次数"),
+    ):
+        line = f"#define {name} {value}"
+        out.append(f"{line:<36}// {note}" if note else line)
+    out.append("")
+    for i, q in enumerate(qlayers):
+        if q.op in (OP_CONV1D, OP_DENSE):
+            out.append(c_array("int8_t", f"k_gas_l{i}_w", q.w))
+            out.append(c_array("int32_t", f"k_gas_l{i}_b", q.b, 8))
+            out.append(c_array("int32_t", f"k_gas_l{i}_mult", q.mult, 6))
+            out.append(c_array("int8_t", f"k_gas_l{i}_shift", q.shift))
+    out.append(f"static const TinyMlLayer_t k_gas_layers[{len(qlayers)}] = {{")
+    for i, q in enumerate(qlayers):
+        if q.op in (OP_CONV1D, OP_DENSE):
+            refs = f"k_gas_l{i}_w, k_gas_l{i}_b, k_gas_l{i}_mult, k_gas_l{i}_shift"
+        else:
+            refs = "NULL, NULL, NULL, NULL"
+        out.append(f"    {{{OP_NAMES[q.op]}, {int(q.relu)}, {q.kernel}, {q.in_ch}, {q.out_ch}, {refs}}},")
+    out.append("};")
+    out.append("")
+    out.append(f"static const float k_gas_in_offset[{len(mean)}] = {{{', '.join(c_float(v) for v in mean)}}};")
+    out.append(f"static const float k_gas_in_gain[{len(gain)}] = {{{', '.join(c_float(v) for v in gain)}}};")
+    out.append(f"static const char* const k_gas_classes[{len(classes)}] = {{"
+               + ", ".join(f'"{c}"' for c in classes) + "};")
+    out.append(f"static const char* const k_gas_features[{len(features)}] = {{"
+               + ", ".join(f'"{f}"' for f in features) + "};")
+    out.append("")
+    out.append("static const TinyMlModel_t k_gas_model = {")
+    out.append(f"    k_gas_layers, {len(qlayers)}, GAS_MODEL_IN_FEATURES, GAS_MODEL_SEQ_LEN, GAS_MODEL_N_CLASSES, {max_tensor},")
+    out.append(f"    k_gas_in_offset, k_gas_in_gain, {c_float(out_scale)}, k_gas_classes, k_gas_features,")
+    out.append("};")
+    out.append("")
+    out.append("#endif /* __GAS_MODEL_WEIGHTS_H */")
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def write_vectors(path: str, inputs: Sequence[List[int]], logits: Sequence[List[int]]) -> None:
+    out = [
+        "/**",
+        " ******************************************************************************",
+        " * @file           : gas_model_vectors.h",
+        " * @brief          : gas_model_weights.h 的整数参考测试向量 —— 由 tools/tinyml_export.py 生成，勿手改",
+        " ******************************************************************************",
+        " */",
+        "",
+        "#ifndef __GAS_MODEL_VECTORS_H",
+        "#define __GAS_MODEL_VECTORS_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        f"#define GAS_MODEL_VECTOR_COUNT {len(inputs)}",
+        "",
+        f"static const int8_t k_gas_vec_in[{len(inputs)}][{len(inputs[0])}] = {{",
+    ]
+    out += ["    {" + ", ".join(str(v) for v in x) + "}," for x in inputs]
+    out.append("};")
+    out.append("")
+    out.append(f"static const int8_t k_gas_vec_logits[{len(logits)}][{len(logits[0])}] = {{")
+    out += ["    {" + ", ".join(str(v) for v in y) + "}," for y in logits]
+    out.append("};")
+    out.append("")
+    out.append("#endif /* __GAS_MODEL_VECTORS_H */")
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="导出 int8 板上气体分类器")
+    ap.add_argument("--checkpoint", help="torch.save 的检查点（GasClassifier1DCNN 或 MLP）")
+    ap.add_argument("--placeholder", action="store_true", help="生成未训练的确定性占位模型")
+    ap.add_argument("--features", default="mq3", help="输入通道对应的 HK 前缀，逗号分隔（默认 mq3）")
+    ap.add_argument("--seq-len", type=int, default=16, help="窗口样本数（检查点 config 优先）")
+    ap.add_argument("--in-mean", help="输入均值，逗号分隔（检查点 input_norm 优先）")
+    ap.add_argument("--in-std", help="输入标准差，逗号分隔")
+    ap.add_argument("--calib", help="校准窗口 JSON Lines")
+    ap.add_argument("--calib-count", type=int, default=256, help="无 --calib 时的随机窗口数")
+    ap.add_argument("--vectors", type=int, default=32, help="测试向量个数")
+    ap.add_argument("--seed", type=int, default=0)
+    ap.add_argument("--out", default=DEFAULT_HEADER)
+    ap.add_argument("--vectors-out", default=DEFAULT_VECTORS)
+    args = ap.parse_args()
+
+    if bool(args.checkpoint) == bool(args.placeholder):
+        ap.error("需要且只能指定 --checkpoint 或 --placeholder 之一")
+
+    features = [f.strip() for f in args.features.split(",") if f.strip()]
+    n_features = len(features)
+    seq_len = args.seq_len
+    mean = [float(v) for v in args.in_mean.split(",")] if args.in_mean else [0.0] * n_features
+    std = [float(v) for v in args.in_std.split(",")] if args.in_std else [1.0] * n_features
+    torch_model = None
+
+    if args.placeholder:
+        sys.path.insert(0, os.path.join(ROOT, "backend"))
+        from ml_models import IntelligentDecisionEngine, ModelConfig  # 无 PyTorch 时也可导入
+
+        cfg = ModelConfig(n_features=n_features, seq_length=seq_len)
+        classes = list(IntelligentDecisionEngine.CLASS_NAMES)
+        if not args.in_mean:
+            mean, std = [10.0] * n_features, [30.0] * n_features
+        layers = placeholder_layers(n_features, seq_len, cfg.cnn_channels, cfg.cnn_kernel_size,
+                                    16, len(classes), args.seed)
+        args.source = f"占位模型（GasClassifier1DCNN 结构，随机初始化 seed={args.seed}，未训练）"
+    else:
+        try:
+            import torch
+        except ImportError:
+            raise SystemExit("读取检查点需要 PyTorch（pip install torch）")
+        ckpt = torch.load(args.checkpoint, map_location="cpu")
+        sd = ckpt["model_state_dict"]
+        cfg_dict = ckpt.get("config") or {}
+        seq_len = int(cfg_dict.get("seq_length", seq_len))
+        if int(cfg_dict.get("n_features", n_features)) != n_features:
+            raise SystemExit(f"模型输入 {cfg_dict.get('n_features')} 个特征，--features 给出 {n_features} 个")
+        classes = list(ckpt.get("classes") or [f"class{i}" for i in range(cfg_dict.get("n_classes", 0))])
+        norm = ckpt.get("input_norm") or {}
+        mean = [float(v) for v in norm.get("mean", mean)]
+        std = [float(v) for v in norm.get("std", std)]
+        layers = layers_from_state_dict(sd, n_features, seq_len)
+        args.source = f"{os.path.basename(args.checkpoint)}（训练于 {ckpt.get('trained_at', '?')}）"
+
+        sys.path.insert(0, os.path.join(ROOT, "backend"))
+        from ml_models import GasClassifier1DCNN, ModelConfig
+
+        if any(k.startswith("conv_layers.") for k in sd):
+            torch_model = GasClassifier1DCNN(ModelConfig(**cfg_dict))
+            torch_model.load_state_dict(sd)
+            torch_model.eval()
+
+    calib = load_calibration(args.calib, args.calib_count, seq_len, mean, std, args.seed)
+    normed = [normalize(w, mean, std) for w in calib]
+    qlayers, s_in, out_scale, max_tensor = quantize_model(layers, n_features, seq_len, normed)
+    gain = [1.0 / (s * s_in) for s in std]
+
+    # 整数模型 vs 浮点模型（有 PyTorch 模型时以其为准，否则为折叠后的纯 Python 浮点前向）
+    agree = 0
+    int_logits = []
+    int_inputs = []
+    for w, xn in zip(calib, normed):
+        xq = quantize_input(w, mean, std, s_in)
+        yq = int_forward(qlayers, xq, seq_len)
+        if torch_model is not None:
+            import torch
+            with torch.no_grad():
+                ref = torch_model(torch.tensor([[[(r[f] - mean[f]) / std[f] for f in range(n_features)]
+                                                 for r in w]], dtype=torch.float32))[0].tolist()
+        else:
+            ref = float_forward(layers, xn)
+        agree += int(max(range(len(yq)), key=lambda c: (yq[c], -c)) == max(range(len(ref)), key=lambda c: ref[c]))
+        int_inputs.append(xq)
+        int_logits.append(yq)
+    agreement = f"{agree}/{len(calib)}（{'PyTorch' if torch_model is not None else '折叠后浮点'}参考，校准窗口）"
+
+    write_header(args.out, qlayers, args, classes, features, mean, gain, out_scale, max_tensor, seq_len, agreement)
+    n_vec = min(args.vectors, len(int_inputs))
+    write_vectors(args.vectors_out, int_inputs[:n_vec], int_logits[:n_vec])
+    print(f"已写出 {args.out}（{len(qlayers)} 层，工作区 {2 * max_tensor} B）与 {args.vectors_out}（{n_vec} 组向量）")
+    print(f"int8 与浮点 top-1 一致率：{agreement}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())